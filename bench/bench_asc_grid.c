@@ -0,0 +1,163 @@
+/**********
+ bench_asc_grid.c
+
+ micro-benchmark for reading arc ascii grid files: read_asc_grid() versus the per-value fscanf() loop it replaced
+ 
+ a synthetic working grid file (NUM_LAT x NUM_LON) is written to the given path, with values similar to the
+    hyde land use area files (mostly zeros, some small areas, and nodata), then it is read both ways
+ the read rate (MB/s) of each method is reported, and the values are checked to be identical
+ the file is deleted at the end
+ 
+ build and run from the project directory:
+    make bench_asc_grid
+    bin/bench_asc_grid [file name] [repetitions]
+ the default file name is ./bench_asc_grid.asc and the default number of repetitions is 3
+ 
+ return value:
+	0 if the values are identical, otherwise 1
+
+ Created 17 Oct 2026
+
+ Moirai Land Data System (Moirai) Copyright (c) 2019, The
+ Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S.
+ Dept. of Energy).  All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Intellectual Property Office at
+ IPO@lbl.gov.
+
+ NOTICE.  This Software was developed under funding from the U.S. Department
+ of Energy and the U.S. Government consequently retains certain rights.  As
+ such, the U.S. Government has been granted for itself and others acting on
+ its behalf a paid-up, nonexclusive, irrevocable, worldwide license in the
+ Software to reproduce, distribute copies to the public, prepare derivative
+ works, and perform publicly and display publicly, and to permit other to do
+ so.
+
+ This file is part of Moirai.
+
+ Moirai is free software: you can use it under the terms of the modified BSD-3 license (see …/moirai/license.txt)
+
+ **********/
+
+// clock_gettime is posix
+#define _POSIX_C_SOURCE 200809L
+
+#include <sys/stat.h>
+
+#include "moirai.h"
+
+static double bench_seconds(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1.0e9;
+}
+
+// the original fscanf() read loop
+static int bench_read_fscanf(char *fname, float *grid, int ncells) {
+	
+	int i;
+	FILE *fpin;
+	
+	if((fpin = fopen(fname, "r")) == NULL) {
+		return ERROR_FILE;
+	}
+	if(fscanf(fpin,"%*[^\r\n]\r\n%*[^\r\n]\r\n%*[^\r\n]\r\n%*[^\r\n]\r\n%*[^\r\n]\r\n%*[^\r\n]\r\n") == EOF) {
+		fclose(fpin);
+		return ERROR_FILE;
+	}
+	for(i = 0; i < ncells; i++) {
+		if(fscanf(fpin, "%f", &grid[i]) == EOF) {
+			fclose(fpin);
+			return ERROR_FILE;
+		}
+	}
+	fclose(fpin);
+	return OK;
+}
+
+int main(int argc, const char * argv[]) {
+	
+	int i, r;
+	int nreps = 3;
+	int ncols, nrows;
+	char fname[MAXCHAR] = "./bench_asc_grid.asc";
+	float *grid_fscanf;
+	float *grid_fast;
+	double t0, t_fscanf = 0, t_fast = 0;
+	double mbytes;
+	struct stat fstat_in;
+	FILE *fpout;
+	
+	fplog = stderr;
+	if (argc > 1) {
+		strcpy(fname, argv[1]);
+	}
+	if (argc > 2) {
+		nreps = atoi(argv[2]);
+	}
+	
+	grid_fscanf = calloc(NUM_CELLS, sizeof(float));
+	grid_fast = calloc(NUM_CELLS, sizeof(float));
+	if (grid_fscanf == NULL || grid_fast == NULL) {
+		fprintf(stderr, "Failed to allocate memory for the grids: bench_asc_grid\n");
+		return 1;
+	}
+	
+	// write the synthetic grid file
+	if ((fpout = fopen(fname, "wb")) == NULL) {
+		fprintf(stderr, "Failed to open file %s: bench_asc_grid\n", fname);
+		return 1;
+	}
+	fprintf(fpout, "ncols         %i\r\nnrows         %i\r\nxllcorner     -180\r\nyllcorner     -90\r\n", NUM_LON, NUM_LAT);
+	fprintf(fpout, "cellsize      0.083333333333333\r\nNODATA_value  -9999\r\n");
+	srand(1);
+	for (i = 0; i < NUM_CELLS; i++) {
+		r = rand() % 10;
+		if (r < 3) {
+			fprintf(fpout, "-9999");
+		} else if (r < 7) {
+			fprintf(fpout, "0");
+		} else {
+			fprintf(fpout, "%.9g", (float) (85.0 * rand() / RAND_MAX));
+		}
+		fprintf(fpout, (i + 1) % NUM_LON == 0 ? "\r\n" : " ");
+	}
+	fclose(fpout);
+	stat(fname, &fstat_in);
+	mbytes = fstat_in.st_size / (1024.0 * 1024.0);
+	
+	for (r = 0; r < nreps; r++) {
+		t0 = bench_seconds();
+		if (bench_read_fscanf(fname, grid_fscanf, NUM_CELLS) != OK) {
+			fprintf(stderr, "Failed to read %s with fscanf: bench_asc_grid\n", fname);
+			return 1;
+		}
+		t_fscanf = t_fscanf + bench_seconds() - t0;
+		
+		t0 = bench_seconds();
+		if (read_asc_grid(fname, grid_fast, NUM_CELLS, &ncols, &nrows) != OK) {
+			fprintf(stderr, "Failed to read %s with read_asc_grid: bench_asc_grid\n", fname);
+			return 1;
+		}
+		t_fast = t_fast + bench_seconds() - t0;
+	}
+	remove(fname);
+	
+	printf("file: %.1f MB, %i values, %i repetitions\n", mbytes, NUM_CELLS, nreps);
+	printf("fscanf:        %8.3f s/read  %8.1f MB/s\n", t_fscanf / nreps, mbytes * nreps / t_fscanf);
+	printf("read_asc_grid: %8.3f s/read  %8.1f MB/s\n", t_fast / nreps, mbytes * nreps / t_fast);
+	printf("speedup:       %8.1f x\n", t_fscanf / t_fast);
+	
+	if (memcmp(grid_fscanf, grid_fast, NUM_CELLS * sizeof(float)) != 0) {
+		printf("values differ\n");
+		return 1;
+	}
+	printf("values are identical\n");
+	
+	free(grid_fscanf);
+	free(grid_fast);
+	
+	return 0;
+}
@@ -0,0 +1,498 @@
+/**********
+ bench_gen_inputs.c
+
+ write the synthetic inputs of the moirai benchmark suite to a directory (see bench_synth.h)
+    hyde/: the 12 hyde 3.2 arc ascii files (5 arcmin) of each year
+    isam/: the gzipped isam land cover netcdf (0.25 degree) of each year
+    sage/: BENCH_NUM_SAGE_NC sage crop netcdf files (5 arcmin)
+    fao/: the fao yield, harvested area, and production csv files, with all countries and crops
+ the years are BENCH_FIRST_YEAR and every BENCH_YEAR_STEP years after it
+ the stamp file BENCH_STAMP_FNAME is written last; if it matches, the inputs are current and are not written again
+ 
+ build and run from the project directory (make bench does both this and bench_moirai):
+    make bench_gen_inputs
+    bin/bench_gen_inputs <directory> [number of years]
+ the default number of years is BENCH_NUM_YEARS
+ about 0.6 GB of hyde files are written for each year, and 0.7 GB of sage files
+ 
+ return value:
+	integer error code: OK = 0, otherwise a non-zero error code
+
+ Created 17 Oct 2026
+
+ Moirai Land Data System (Moirai) Copyright (c) 2019, The
+ Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S.
+ Dept. of Energy).  All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Intellectual Property Office at
+ IPO@lbl.gov.
+
+ NOTICE.  This Software was developed under funding from the U.S. Department
+ of Energy and the U.S. Government consequently retains certain rights.  As
+ such, the U.S. Government has been granted for itself and others acting on
+ its behalf a paid-up, nonexclusive, irrevocable, worldwide license in the
+ Software to reproduce, distribute copies to the public, prepare derivative
+ works, and perform publicly and display publicly, and to permit other to do
+ so.
+
+ This file is part of Moirai.
+
+ Moirai is free software: you can use it under the terms of the modified BSD-3 license (see …/moirai/license.txt)
+
+ **********/
+
+// mkdir and clock_gettime are posix
+#define _POSIX_C_SOURCE 200809L
+
+#include <sys/stat.h>
+#include <errno.h>
+
+#include "bench_synth.h"
+
+static double bench_seconds(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1.0e9;
+}
+
+static int make_dir(char *dname) {
+	if (mkdir(dname, 0755) != 0 && errno != EEXIST) {
+		fprintf(fplog, "Failed to create directory %s: make_dir()\n", dname);
+		return ERROR_FILE;
+	}
+	return OK;
+}
+
+// the hyde 3.2 arc ascii grids of one year, one file per land use type, written row by row
+static int gen_hyde(char *dname, int year, float *land_area) {
+
+	int i, k;
+	char fname[MAXCHAR];
+	double vals[BENCH_NUM_HYDE_TYPES];
+	FILE *fpout[BENCH_NUM_HYDE_TYPES];
+
+	for (k = 0; k < BENCH_NUM_HYDE_TYPES; k++) {
+		sprintf(fname, "%shyde/%s%iAD.asc", dname, bench_hyde_names[k], year);
+		if ((fpout[k] = fopen(fname, "wb")) == NULL) {
+			fprintf(fplog, "Failed to open file %s: gen_hyde()\n", fname);
+			return ERROR_FILE;
+		}
+		setvbuf(fpout[k], NULL, _IOFBF, 1024 * 1024);
+		fprintf(fpout[k], "ncols         %i\r\nnrows         %i\r\nxllcorner     -180\r\nyllcorner     -90\r\n", NUM_LON, NUM_LAT);
+		fprintf(fpout[k], "cellsize      0.083333333333333\r\nNODATA_value  -9999\r\n");
+	}
+
+	for (i = 0; i < NUM_CELLS; i++) {
+		if (land_area[i] == NODATA) {
+			for (k = 0; k < BENCH_NUM_HYDE_TYPES; k++) {
+				fputs("-9999", fpout[k]);
+			}
+		} else {
+			bench_hyde_vals(i, year, land_area[i], vals);
+			for (k = 0; k < BENCH_NUM_HYDE_TYPES; k++) {
+				if (vals[k] == 0) {
+					fputc('0', fpout[k]);
+				} else {
+					fprintf(fpout[k], "%.6g", vals[k]);
+				}
+			}
+		}
+		for (k = 0; k < BENCH_NUM_HYDE_TYPES; k++) {
+			fputs((i + 1) % NUM_LON == 0 ? "\r\n" : " ", fpout[k]);
+		}
+	}
+
+	for (k = 0; k < BENCH_NUM_HYDE_TYPES; k++) {
+		if (fclose(fpout[k]) != 0) {
+			fprintf(fplog, "Failed to write hyde file %i for year %i: gen_hyde()\n", k, year);
+			return ERROR_FILE;
+		}
+	}
+
+	return OK;
+}
+
+// the gzipped isam land cover netcdf file of one year, at 30 arcmin with the lower left origin at 0 lon
+// LC_fraction is the fraction of the whole cell area * 10000, and Grid_area is the whole cell area in m^2
+static int gen_isam(char *dname, int year, float *land_area) {
+
+	int i, j, m, n;
+	int num_split = NUM_LON / NUM_LON_LULC;	// working grid cells in one dimension of a lulc cell
+	int grid_ind, grid_y_ul, grid_x_ul, cell;
+	int lc_main, lc_other;		// the two land cover types of a cell
+	int ncid, ncerr;
+	int dimids[3];
+	int frac_varid, area_varid;
+	size_t start[3] = {0, 0, 0};
+	size_t count[3] = {BENCH_NUM_LULC_TYPES, NUM_LAT_LULC, NUM_LON_LULC};
+	double cell_area, land, remain;
+	double lu[NUM_HYDE_TYPES_MAIN];
+	double vals[BENCH_NUM_HYDE_TYPES];
+	double crop_share, share_sum;
+	float *frac;				// [type][input cell]
+	float *area;				// [input cell]
+	char fname[MAXCHAR];
+	char gzname[MAXCHAR];
+	char buf[64 * 1024];
+	size_t nread;
+	FILE *fpin;
+	gzFile gzout;
+
+	frac = calloc((size_t) BENCH_NUM_LULC_TYPES * NUM_CELLS_LULC, sizeof(float));
+	area = calloc(NUM_CELLS_LULC, sizeof(float));
+	if (frac == NULL || area == NULL) {
+		fprintf(fplog, "Failed to allocate memory for the isam year %i: gen_isam()\n", year);
+		return ERROR_MEM;
+	}
+
+	for (i = 0; i < NUM_CELLS_LULC; i++) {
+		grid_ind = bench_lulc_in2grid(i);
+		grid_y_ul = (grid_ind / NUM_LON_LULC) * num_split;
+		grid_x_ul = (grid_ind % NUM_LON_LULC) * num_split;
+		cell_area = 0;
+		land = 0;
+		lu[0] = lu[1] = lu[2] = 0;
+		for (m = grid_y_ul; m < grid_y_ul + num_split; m++) {
+			for (n = grid_x_ul; n < grid_x_ul + num_split; n++) {
+				cell = m * NUM_LON + n;
+				cell_area = cell_area + bench_cell_area(m);
+				if (land_area[cell] != NODATA) {
+					land = land + land_area[cell];
+					bench_hyde_vals(cell, year, land_area[cell], vals);
+					lu[0] = lu[0] + vals[0];
+					lu[1] = lu[1] + vals[1];
+					lu[2] = lu[2] + vals[2];
+				}
+			}
+		}
+		area[i] = (float) (cell_area / MSQ2KMSQ);
+		if (land == 0) {
+			continue;
+		}
+
+		// the land use types, with the crops spread over the five crop types
+		frac[(size_t) NUM_LULC_LC_TYPES * NUM_CELLS_LULC + i] = (float) (lu[0] / cell_area);
+		share_sum = 0;
+		for (j = 1; j <= 5; j++) {
+			crop_share = (j < 5) ? 0.05 + 0.15 * bench_unit(i * 8 + j, BENCH_SALT_LULC) : 1 - share_sum;
+			share_sum = share_sum + crop_share;
+			frac[(size_t) (NUM_LULC_LC_TYPES + j) * NUM_CELLS_LULC + i] = (float) (lu[1] * crop_share / cell_area);
+		}
+		frac[(size_t) (NUM_LULC_LC_TYPES + 6) * NUM_CELLS_LULC + i] = (float) (0.6 * lu[2] / cell_area);
+		frac[(size_t) (NUM_LULC_LC_TYPES + 7) * NUM_CELLS_LULC + i] = (float) (0.4 * lu[2] / cell_area);
+
+		// the rest of the land is split between the pot veg type of the cell and another land cover type
+		remain = (land - lu[0] - lu[1] - lu[2]) / cell_area;
+		if (remain < 0) {
+			remain = 0;
+		}
+		cell = (grid_y_ul + num_split / 2) * NUM_LON + grid_x_ul + num_split / 2;
+		lc_main = bench_cell_potveg(cell);
+		lc_main = (lc_main == NODATA) ? 0 : lc_main - 1;
+		lc_other = bench_hash(i, BENCH_SALT_LULC) % NUM_LULC_LC_TYPES;
+		frac[(size_t) lc_main * NUM_CELLS_LULC + i] += (float) (0.7 * remain);
+		frac[(size_t) lc_other * NUM_CELLS_LULC + i] += (float) (0.3 * remain);
+	} // end for i loop over the input cells
+
+	// the fractions are stored as integer values of fraction * 10000
+	for (i = 0; i < BENCH_NUM_LULC_TYPES * NUM_CELLS_LULC; i++) {
+		frac[i] = roundf(frac[i] * 10000);
+	}
+
+	sprintf(fname, "%sisam/ISAM_HYDE32_LANDCOVER_%i.nc", dname, year);
+	if ((ncerr = nc_create(fname, NC_CLOBBER | NC_64BIT_OFFSET, &ncid))) {
+		fprintf(fplog, "Failed to create %s: gen_isam(); %s\n", fname, nc_strerror(ncerr));
+		return ERROR_FILE;
+	}
+	if ((ncerr = nc_def_dim(ncid, "lctype", BENCH_NUM_LULC_TYPES, &dimids[0])) ||
+		(ncerr = nc_def_dim(ncid, "lat", NUM_LAT_LULC, &dimids[1])) ||
+		(ncerr = nc_def_dim(ncid, "lon", NUM_LON_LULC, &dimids[2])) ||
+		(ncerr = nc_def_var(ncid, "LC_fraction", NC_FLOAT, 3, dimids, &frac_varid)) ||
+		(ncerr = nc_def_var(ncid, "Grid_area", NC_FLOAT, 2, &dimids[1], &area_varid)) ||
+		(ncerr = nc_enddef(ncid)) ||
+		(ncerr = nc_put_vara_float(ncid, frac_varid, start, count, frac)) ||
+		(ncerr = nc_put_vara_float(ncid, area_varid, start, &count[1], area)) ||
+		(ncerr = nc_close(ncid))) {
+		fprintf(fplog, "Failed to write %s: gen_isam(); %s\n", fname, nc_strerror(ncerr));
+		return ERROR_FILE;
+	}
+	free(frac);
+	free(area);
+
+	// gzip the file, as the isam files are distributed, and remove the unzipped file so that the gzipped file is read
+	sprintf(gzname, "%s.gz", fname);
+	if ((fpin = fopen(fname, "rb")) == NULL || (gzout = gzopen(gzname, "wb6")) == NULL) {
+		fprintf(fplog, "Failed to open %s or %s: gen_isam()\n", fname, gzname);
+		return ERROR_FILE;
+	}
+	while ((nread = fread(buf, 1, sizeof(buf), fpin)) > 0) {
+		if (gzwrite(gzout, buf, (unsigned int) nread) != (int) nread) {
+			fprintf(fplog, "Failed to write %s: gen_isam()\n", gzname);
+			return ERROR_FILE;
+		}
+	}
+	fclose(fpin);
+	if (gzclose(gzout) != Z_OK) {
+		fprintf(fplog, "Failed to write %s: gen_isam()\n", gzname);
+		return ERROR_FILE;
+	}
+	remove(fname);
+
+	return OK;
+}
+
+// the sage 2000 harvested area and yield netcdf file of one crop
+// the variable <crop>Data has dims time (1), level (BENCH_SAGE_NUM_LEVELS), latitude (2160), longitude (4320), upper left start
+static int gen_sage(char *dname, int crop_ind, float *land_area) {
+
+	int i, lev;
+	int ncid, ncerr, varid;
+	int dimids[4];
+	size_t start[4] = {0, 0, 0, 0};
+	size_t count[4] = {1, 1, NUM_LAT, NUM_LON};
+	double vals[BENCH_NUM_HYDE_TYPES];
+	double harv, yield;
+	float *grid;
+	char fname[MAXCHAR];
+	char varname[MAXCHAR];
+	const char *crop = bench_sage_nc_crops[crop_ind];
+
+	grid = calloc(NUM_CELLS, sizeof(float));
+	if (grid == NULL) {
+		fprintf(fplog, "Failed to allocate memory for the sage crop %s: gen_sage()\n", crop);
+		return ERROR_MEM;
+	}
+
+	sprintf(fname, "%ssage/%s_AreaYieldProduction.nc", dname, crop);
+	sprintf(varname, "%sData", crop);
+	if ((ncerr = nc_create(fname, NC_CLOBBER | NC_64BIT_OFFSET, &ncid)) ||
+		(ncerr = nc_def_dim(ncid, "time", 1, &dimids[0])) ||
+		(ncerr = nc_def_dim(ncid, "level", BENCH_SAGE_NUM_LEVELS, &dimids[1])) ||
+		(ncerr = nc_def_dim(ncid, "latitude", NUM_LAT, &dimids[2])) ||
+		(ncerr = nc_def_dim(ncid, "longitude", NUM_LON, &dimids[3])) ||
+		(ncerr = nc_def_var(ncid, varname, NC_FLOAT, 4, dimids, &varid)) ||
+		(ncerr = nc_enddef(ncid))) {
+		fprintf(fplog, "Failed to create %s: gen_sage(); %s\n", fname, nc_strerror(ncerr));
+		return ERROR_FILE;
+	}
+
+	// levels: harvested area fraction of land, yield (t/ha), their quality flags, production (t), its quality flag
+	for (lev = 0; lev < BENCH_SAGE_NUM_LEVELS; lev++) {
+		for (i = 0; i < NUM_CELLS; i++) {
+			if (land_area[i] == NODATA) {
+				grid[i] = BENCH_SAGE_NODATA;
+				continue;
+			}
+			harv = 0;
+			if (bench_unit(i, BENCH_SALT_SAGE + crop_ind) < 0.5) {
+				bench_hyde_vals(i, BENCH_FIRST_YEAR, land_area[i], vals);
+				harv = vals[1] / land_area[i] * (0.05 + 0.3 * bench_unit(i, BENCH_SALT_SAGE + 100 + crop_ind));
+			}
+			yield = (harv > 0) ? 1 + 9 * bench_unit(i, BENCH_SALT_SAGE + 200 + crop_ind) : 0;
+			switch (lev) {
+				case 0:
+					grid[i] = (float) harv;
+					break;
+				case 1:
+					grid[i] = (float) yield;
+					break;
+				case 4:
+					grid[i] = (float) (harv * land_area[i] * KMSQ2HA * yield);
+					break;
+				default:
+					grid[i] = (harv > 0) ? 1 : 0;
+					break;
+			}
+		}
+		start[1] = lev;
+		if ((ncerr = nc_put_vara_float(ncid, varid, start, count, grid))) {
+			fprintf(fplog, "Failed to write %s: gen_sage(); %s\n", fname, nc_strerror(ncerr));
+			return ERROR_FILE;
+		}
+	} // end for lev loop over the levels
+
+	if ((ncerr = nc_close(ncid))) {
+		fprintf(fplog, "Failed to write %s: gen_sage(); %s\n", fname, nc_strerror(ncerr));
+		return ERROR_FILE;
+	}
+	free(grid);
+
+	return OK;
+}
+
+// one faostat csv file; type 0 = yield, 1 = harvested area, 2 = production
+// every fao country X sage crop record is present with probability BENCH_FAO_FRAC, the same in all three files,
+//	plus records of countries and crops that are not in the mappings, which the readers skip
+// some values are missing, and some names are quoted and contain the delimiter
+static int gen_fao(char *dname, int type) {
+
+	int i, j, y;
+	uint32_t key;
+	double area, yield;
+	char fname[MAXCHAR];
+	const char *fnames[3] = {"FAOSTAT_yield.csv", "FAOSTAT_harvestarea.csv", "FAOSTAT_production.csv"};
+	const char *elements[3] = {"5419,Yield,hg/ha", "5312,Area harvested,ha", "5510,Production,tonnes"};
+	const char *flags[4] = {"", "F", "Im", "*"};
+	FILE *fpout;
+
+	sprintf(fname, "%sfao/%s", dname, fnames[type]);
+	if ((fpout = fopen(fname, "wb")) == NULL) {
+		fprintf(fplog, "Failed to open file %s: gen_fao()\n", fname);
+		return ERROR_FILE;
+	}
+	setvbuf(fpout, NULL, _IOFBF, 1024 * 1024);
+
+	fprintf(fpout, "Country Code,Country,Item Code,Item,Element Code,Element,Unit");
+	for (y = 0; y < BENCH_FAO_NUM_YRS; y++) {
+		fprintf(fpout, ",Y%i,Y%iF", BENCH_FAO_START_YEAR + y, BENCH_FAO_START_YEAR + y);
+	}
+	fprintf(fpout, "\n");
+
+	for (i = 0; i < BENCH_NUM_FAO_CTRY + 10; i++) {
+		for (j = 0; j < BENCH_NUM_SAGE_CROP + 15; j++) {
+			key = i * 1000 + j;
+			if (bench_unit(key, BENCH_SALT_FAO) >= BENCH_FAO_FRAC) {
+				continue;
+			}
+			if (i % 7 == 0) {
+				fprintf(fpout, "%i,\"Country %i, Rep. of\"", bench_ctry_code(i), i);
+			} else {
+				fprintf(fpout, "%i,Country %i", bench_ctry_code(i), i);
+			}
+			fprintf(fpout, ",%i,\"Crop %i\",%s", bench_crop_code(j), j, elements[type]);
+			for (y = 0; y < BENCH_FAO_NUM_YRS; y++) {
+				if (bench_unit(key * 64 + y, BENCH_SALT_FAO + 1) < 0.08) {
+					fprintf(fpout, ",,");
+					continue;
+				}
+				area = (100 + 1e6 * pow(bench_unit(key, BENCH_SALT_FAO + 2), 3)) * (1 + 0.02 * y);
+				yield = 10000 + 60000 * bench_unit(key * 64 + y, BENCH_SALT_FAO + 3);
+				if (type == 0) {
+					fprintf(fpout, ",%.0f", yield);
+				} else if (type == 1) {
+					fprintf(fpout, ",%.0f", area);
+				} else {
+					fprintf(fpout, ",%.0f", area * yield / 10000);
+				}
+				fprintf(fpout, ",%s", flags[bench_hash(key * 64 + y, BENCH_SALT_FAO + 4) % 4]);
+			}
+			fprintf(fpout, "\n");
+		}
+	}
+
+	if (fclose(fpout) != 0) {
+		fprintf(fplog, "Failed to write file %s: gen_fao()\n", fname);
+		return ERROR_FILE;
+	}
+
+	return OK;
+}
+
+int main(int argc, const char * argv[]) {
+
+	int i, k;
+	int num_years = BENCH_NUM_YEARS;
+	int err = OK;
+	char dname[MAXCHAR];
+	char fname[MAXCHAR];
+	char stamp[MAXCHAR];
+	char old_stamp[MAXCHAR] = "";
+	float *land_area;
+	double t0;
+	FILE *fp;
+
+	fplog = stderr;
+	if (argc < 2) {
+		fprintf(stderr, "Usage: bench_gen_inputs <directory> [number of years, 1 to %i]\n", BENCH_MAX_YEARS);
+		return ERROR_USAGE;
+	}
+	sprintf(dname, "%s/", argv[1]);
+	if (argc > 2) {
+		num_years = atoi(argv[2]);
+	}
+	if (num_years < 1 || num_years > BENCH_MAX_YEARS) {
+		fprintf(stderr, "The number of years must be 1 to %i: bench_gen_inputs\n", BENCH_MAX_YEARS);
+		return ERROR_USAGE;
+	}
+
+	// the inputs are only generated if they are missing or are from a different version or year set
+	sprintf(stamp, "version %i\nyears %i\n", BENCH_INPUTS_VERSION, num_years);
+	sprintf(fname, "%s%s", dname, BENCH_STAMP_FNAME);
+	if ((fp = fopen(fname, "rb")) != NULL) {
+		old_stamp[fread(old_stamp, 1, MAXCHAR - 1, fp)] = '\0';
+		fclose(fp);
+		if (strcmp(stamp, old_stamp) == 0) {
+			printf("synthetic inputs in %s are current\n", dname);
+			return OK;
+		}
+		remove(fname);
+	}
+
+	if ((err = make_dir(dname)) != OK) {
+		return err;
+	}
+	sprintf(fname, "%shyde", dname);
+	if ((err = make_dir(fname)) != OK) {
+		return err;
+	}
+	sprintf(fname, "%sisam", dname);
+	if ((err = make_dir(fname)) != OK) {
+		return err;
+	}
+	sprintf(fname, "%ssage", dname);
+	if ((err = make_dir(fname)) != OK) {
+		return err;
+	}
+	sprintf(fname, "%sfao", dname);
+	if ((err = make_dir(fname)) != OK) {
+		return err;
+	}
+
+	// the land area of each working grid cell (km^2), NODATA for ocean
+	land_area = calloc(NUM_CELLS, sizeof(float));
+	if (land_area == NULL) {
+		fprintf(stderr, "Failed to allocate memory for land_area: bench_gen_inputs\n");
+		return ERROR_MEM;
+	}
+	for (i = 0; i < NUM_CELLS; i++) {
+		land_area[i] = (float) (bench_land_frac(i) * bench_cell_area(i / NUM_LON));
+		if (land_area[i] == 0) {
+			land_area[i] = NODATA;
+		}
+	}
+
+	for (k = 0; k < num_years; k++) {
+		t0 = bench_seconds();
+		if ((err = gen_hyde(dname, bench_year(k), land_area)) != OK ||
+			(err = gen_isam(dname, bench_year(k), land_area)) != OK) {
+			return err;
+		}
+		printf("year %i: hyde and isam files written in %.1f s\n", bench_year(k), bench_seconds() - t0);
+	}
+	for (k = 0; k < BENCH_NUM_SAGE_NC; k++) {
+		t0 = bench_seconds();
+		if ((err = gen_sage(dname, k, land_area)) != OK) {
+			return err;
+		}
+		printf("sage crop %s written in %.1f s\n", bench_sage_nc_crops[k], bench_seconds() - t0);
+	}
+	for (k = 0; k < 3; k++) {
+		if ((err = gen_fao(dname, k)) != OK) {
+			return err;
+		}
+	}
+	printf("fao files written\n");
+	free(land_area);
+
+	sprintf(fname, "%s%s", dname, BENCH_STAMP_FNAME);
+	if ((fp = fopen(fname, "wb")) == NULL) {
+		fprintf(stderr, "Failed to open file %s: bench_gen_inputs\n", fname);
+		return ERROR_FILE;
+	}
+	fputs(stamp, fp);
+	fclose(fp);
+
+	return OK;
+}
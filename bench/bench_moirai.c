@@ -0,0 +1,956 @@
+/**********
+ bench_moirai.c
+
+ the moirai benchmark suite: time the hot kernels and a reduced end-to-end run on the synthetic inputs from bench_gen_inputs
+    read_asc_grid(), read_hyde32() with and without its caches, read_lulc_isam(), read_sage_crop()
+    split_fields() and get_*_fld() on the fao records, and the read_*_fao() functions
+    proc_lulc_area() over all lulc cells, calc_carbon_quantiles() over skewed buckets
+    the land type area years (read_lta_inputs() and proc_land_type_area_year()), which is the reduced end-to-end run
+    the land type area csv table, with fprintf() and with the csv_out_*() functions; the two files must be identical
+ the info arrays and ancillary rasters are set from bench_synth.h rather than read from the input files
+ 
+ the throughput of each kernel is printed and appended, with the tag and date, to BENCH_RESULTS_FNAME in the directory
+    so that runs of different commits can be compared
+ 
+ build and run from the project directory:
+    make bench
+ or
+    make bench_moirai
+    bin/bench_moirai <directory> [tag] [repetitions]
+ the default repetitions is 3; the file reads of the large inputs are timed once
+ the log file is BENCH_LOG_FNAME in the directory
+ 
+ return value:
+	integer error code: OK = 0, otherwise a non-zero error code
+
+ Created 17 Oct 2026
+
+ Moirai Land Data System (Moirai) Copyright (c) 2019, The
+ Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S.
+ Dept. of Energy).  All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Intellectual Property Office at
+ IPO@lbl.gov.
+
+ NOTICE.  This Software was developed under funding from the U.S. Department
+ of Energy and the U.S. Government consequently retains certain rights.  As
+ such, the U.S. Government has been granted for itself and others acting on
+ its behalf a paid-up, nonexclusive, irrevocable, worldwide license in the
+ Software to reproduce, distribute copies to the public, prepare derivative
+ works, and perform publicly and display publicly, and to permit other to do
+ so.
+
+ This file is part of Moirai.
+
+ Moirai is free software: you can use it under the terms of the modified BSD-3 license (see …/moirai/license.txt)
+
+ **********/
+
+// clock_gettime is posix
+#define _POSIX_C_SOURCE 200809L
+
+#include <sys/stat.h>
+
+#include "bench_synth.h"
+
+#define BENCH_MAX_RESULTS		32
+#define BENCH_RESULTS_FNAME		"bench_results.csv"	// the results of every run are appended to this file in the data directory
+#define BENCH_LOG_FNAME			"bench_moirai.log"
+#define BENCH_CARBON_VALUES		4000000		// number of cell values in the carbon buckets
+#define BENCH_CARBON_MAX_BUCKET	20000		// the largest carbon bucket
+
+// one benchmark result: amount units processed in seconds
+typedef struct {
+	char name[64];
+	double amount;
+	char unit[16];
+	double seconds;
+} bench_result_struct;
+
+static bench_result_struct results[BENCH_MAX_RESULTS];
+static int num_results = 0;
+
+static double bench_seconds(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1.0e9;
+}
+
+static double bench_file_mb(char *fname) {
+	struct stat fstat_in;
+	if (stat(fname, &fstat_in) != 0) {
+		return 0;
+	}
+	return fstat_in.st_size / (1024.0 * 1024.0);
+}
+
+static void bench_report(const char *name, double amount, const char *unit, double seconds) {
+	printf("%-36s %9.3f s %14.1f %s/s\n", name, seconds, amount / seconds, unit);
+	if (num_results < BENCH_MAX_RESULTS) {
+		strcpy(results[num_results].name, name);
+		results[num_results].amount = amount;
+		strcpy(results[num_results].unit, unit);
+		results[num_results].seconds = seconds;
+		num_results++;
+	}
+}
+
+// set the moirai inputs that the kernels use, as the input file, the info files, and the ancillary rasters would
+static int bench_setup(char *dname, args_struct *in_args, rinfo_struct *raster_info) {
+
+	int i, j, k;
+	int err = OK;
+	int row;
+	int ctry_ind;
+	int ord;
+	double land;
+	double vals[BENCH_NUM_HYDE_TYPES];
+	char *glu_in_ctry;			// [ctry][glu code] flags for building ctry_aez_list
+
+	if ((err = init_moirai(in_args)) != OK) {
+		return err;
+	}
+	sprintf(in_args->hydepath, "%shyde/", dname);
+	sprintf(in_args->lulcpath, "%sisam/", dname);
+	sprintf(in_args->sagepath, "%ssage/", dname);
+	sprintf(in_args->inpath, "%sfao/", dname);
+	sprintf(in_args->outpath, "%s", dname);
+	strcpy(in_args->yield_fao_fname, "FAOSTAT_yield.csv");
+	strcpy(in_args->harvestarea_fao_fname, "FAOSTAT_harvestarea.csv");
+	strcpy(in_args->production_fao_fname, "FAOSTAT_production.csv");
+	in_args->diagnostics = 0;
+	in_args->lulc_out_year = 0;
+
+	memset(raster_info, 0, sizeof(rinfo_struct));
+	raster_info->lu_nodata = NODATA;
+	raster_info->land_area_hyde_nodata = NODATA;
+	raster_info->land_area_sage_nodata = NODATA;
+	raster_info->cropland_sage_nodata = BENCH_SAGE_NODATA;
+	raster_info->potveg_nodata = NODATA;
+	raster_info->aez_new_nodata = NODATA;
+	raster_info->lulc_input_ncells = NUM_CELLS_LULC;
+	raster_info->lulc_input_nodata = -99.0;
+
+	// the info file records
+	NUM_HYDE_TYPES = BENCH_NUM_HYDE_TYPES;
+	NUM_LULC_TYPES = BENCH_NUM_LULC_TYPES;
+	NUM_SAGE_PVLT = BENCH_NUM_SAGE_PVLT;
+	NUM_FAO_CTRY = BENCH_NUM_FAO_CTRY;
+	NUM_SAGE_CROP = BENCH_NUM_SAGE_CROP;
+	NUM_NEW_AEZ = BENCH_NUM_GLU;
+	NUM_GTAP_CTRY87 = 0;
+
+	lutypenames_hyde = calloc(NUM_HYDE_TYPES, sizeof(char*));
+	landtypecodes_sage = calloc(NUM_SAGE_PVLT, sizeof(int));
+	landtypenames_sage = calloc(NUM_SAGE_PVLT, sizeof(char*));
+	lulc2sagecodes = calloc(NUM_LULC_TYPES, sizeof(int));
+	lulc2hydecodes = calloc(NUM_LULC_TYPES, sizeof(int));
+	countrycodes_fao = calloc(NUM_FAO_CTRY, sizeof(int));
+	countryabbrs_iso = calloc(NUM_FAO_CTRY, sizeof(char*));
+	ctry2ctry87codes_gtap = calloc(NUM_FAO_CTRY, sizeof(int));
+	cropcodes_sage = calloc(NUM_SAGE_CROP, sizeof(int));
+	cropcodes_sage2fao = calloc(NUM_SAGE_CROP, sizeof(int));
+	if (lutypenames_hyde == NULL || landtypecodes_sage == NULL || landtypenames_sage == NULL || lulc2sagecodes == NULL ||
+		lulc2hydecodes == NULL || countrycodes_fao == NULL || countryabbrs_iso == NULL || ctry2ctry87codes_gtap == NULL ||
+		cropcodes_sage == NULL || cropcodes_sage2fao == NULL) {
+		fprintf(fplog, "Failed to allocate memory for the info arrays: bench_setup()\n");
+		return ERROR_MEM;
+	}
+	for (i = 0; i < NUM_HYDE_TYPES; i++) {
+		if ((lutypenames_hyde[i] = calloc(MAXCHAR, sizeof(char))) == NULL) {
+			fprintf(fplog, "Failed to allocate memory for lutypenames_hyde: bench_setup()\n");
+			return ERROR_MEM;
+		}
+		strcpy(lutypenames_hyde[i], bench_hyde_names[i]);
+	}
+	for (i = 0; i < NUM_SAGE_PVLT; i++) {
+		landtypecodes_sage[i] = i + 1;
+		if ((landtypenames_sage[i] = calloc(MAXCHAR, sizeof(char))) == NULL) {
+			fprintf(fplog, "Failed to allocate memory for landtypenames_sage: bench_setup()\n");
+			return ERROR_MEM;
+		}
+		sprintf(landtypenames_sage[i], "pvlt_%i", i + 1);
+	}
+	for (i = 0; i < NUM_LULC_TYPES; i++) {
+		lulc2sagecodes[i] = bench_lulc2sage(i);
+		lulc2hydecodes[i] = bench_lulc2hyde(i);
+	}
+	for (i = 0; i < NUM_FAO_CTRY; i++) {
+		countrycodes_fao[i] = bench_ctry_code(i);
+		if ((countryabbrs_iso[i] = calloc(MAXCHAR, sizeof(char))) == NULL) {
+			fprintf(fplog, "Failed to allocate memory for countryabbrs_iso: bench_setup()\n");
+			return ERROR_MEM;
+		}
+		sprintf(countryabbrs_iso[i], "%c%c%c", 'a' + i / 676, 'a' + (i / 26) % 26, 'a' + i % 26);
+		// a few countries have no land rent region, so they are not in the outputs
+		ctry2ctry87codes_gtap[i] = (i % 50 == 49) ? NOMATCH : 1 + i % 87;
+	}
+	for (i = 0; i < NUM_SAGE_CROP; i++) {
+		cropcodes_sage[i] = i + 1;
+		cropcodes_sage2fao[i] = bench_crop_code(i);
+	}
+	if ((err = get_fao_code_ind(*in_args)) != OK) {
+		return err;
+	}
+
+	// the ancillary rasters
+	land_area_hyde = calloc(NUM_CELLS, sizeof(float));
+	land_area_sage = calloc(NUM_CELLS, sizeof(float));
+	cropland_area_sage = calloc(NUM_CELLS, sizeof(float));
+	cropland_area = calloc(NUM_CELLS, sizeof(float));
+	potveg_thematic = calloc(NUM_CELLS, sizeof(int));
+	aez_bounds_new = calloc(NUM_CELLS, sizeof(int));
+	country_fao = calloc(NUM_CELLS, sizeof(short));
+	cell_ctry_ind = calloc(NUM_CELLS, sizeof(int));
+	cell_aez_ind = calloc(NUM_CELLS, sizeof(int));
+	land_ord_hyde = calloc(NUM_CELLS, sizeof(int));
+	land_cells_hyde = calloc(NUM_CELLS, sizeof(int));
+	glu_in_ctry = calloc((size_t) NUM_FAO_CTRY * (BENCH_NUM_GLU + 1), sizeof(char));
+	if (land_area_hyde == NULL || land_area_sage == NULL || cropland_area_sage == NULL || cropland_area == NULL ||
+		potveg_thematic == NULL || aez_bounds_new == NULL || country_fao == NULL || cell_ctry_ind == NULL ||
+		cell_aez_ind == NULL || land_ord_hyde == NULL || land_cells_hyde == NULL || glu_in_ctry == NULL) {
+		fprintf(fplog, "Failed to allocate memory for the ancillary rasters: bench_setup()\n");
+		return ERROR_MEM;
+	}
+	num_land_cells_hyde = 0;
+	for (i = 0; i < NUM_CELLS; i++) {
+		row = i / NUM_LON;
+		land = bench_land_frac(i) * bench_cell_area(row);
+		if (land == 0) {
+			land_area_hyde[i] = NODATA;
+			land_area_sage[i] = NODATA;
+			potveg_thematic[i] = NODATA;
+			aez_bounds_new[i] = NODATA;
+			country_fao[i] = NODATA;
+			cell_ctry_ind[i] = NOMATCH;
+			land_ord_hyde[i] = NOMATCH;
+			continue;
+		}
+		land_area_hyde[i] = (float) land;
+		land_area_sage[i] = (float) land;
+		bench_hyde_vals(i, BENCH_FIRST_YEAR, land_area_hyde[i], vals);
+		cropland_area[i] = (float) vals[1];
+		cropland_area_sage[i] = (float) vals[1];
+		potveg_thematic[i] = bench_cell_potveg(i);
+		aez_bounds_new[i] = bench_cell_glu(i);
+		cell_ctry_ind[i] = bench_cell_ctry(i);
+		country_fao[i] = (short) countrycodes_fao[cell_ctry_ind[i]];
+		glu_in_ctry[(size_t) cell_ctry_ind[i] * (BENCH_NUM_GLU + 1) + aez_bounds_new[i]] = 1;
+		land_ord_hyde[i] = num_land_cells_hyde;
+		land_cells_hyde[num_land_cells_hyde++] = i;
+	}
+
+	// the glus of each country, in code order, and the glu index of each cell
+	ctry_aez_num = calloc(NUM_FAO_CTRY, sizeof(int));
+	ctry_aez_list = calloc(NUM_FAO_CTRY, sizeof(int*));
+	if (ctry_aez_num == NULL || ctry_aez_list == NULL) {
+		fprintf(fplog, "Failed to allocate memory for the country glu lists: bench_setup()\n");
+		return ERROR_MEM;
+	}
+	for (i = 0; i < NUM_FAO_CTRY; i++) {
+		ctry_aez_list[i] = calloc(BENCH_NUM_GLU, sizeof(int));
+		if (ctry_aez_list[i] == NULL) {
+			fprintf(fplog, "Failed to allocate memory for ctry_aez_list: bench_setup()\n");
+			return ERROR_MEM;
+		}
+		for (j = 1; j <= BENCH_NUM_GLU; j++) {
+			if (glu_in_ctry[(size_t) i * (BENCH_NUM_GLU + 1) + j]) {
+				// store the index + 1 of the glu in the flag table, for the cells
+				glu_in_ctry[(size_t) i * (BENCH_NUM_GLU + 1) + j] = 0;
+				ctry_aez_list[i][ctry_aez_num[i]++] = j;
+			}
+		}
+	}
+	free(glu_in_ctry);
+	for (i = 0; i < NUM_CELLS; i++) {
+		cell_aez_ind[i] = NOMATCH;
+		ctry_ind = cell_ctry_ind[i];
+		if (ctry_ind != NOMATCH) {
+			for (j = 0; j < ctry_aez_num[ctry_ind]; j++) {
+				if (ctry_aez_list[ctry_ind][j] == aez_bounds_new[i]) {
+					cell_aez_ind[i] = j;
+					break;
+				}
+			}
+		}
+	}
+
+	// the suitability and protection fractions of each land cell; most cells are in one category
+	protected_EPA = calloc(NUM_EPA_PROTECTED, sizeof(float*));
+	if (protected_EPA == NULL) {
+		fprintf(fplog, "Failed to allocate memory for protected_EPA: bench_setup()\n");
+		return ERROR_MEM;
+	}
+	for (k = 0; k < NUM_EPA_PROTECTED; k++) {
+		protected_EPA[k] = calloc(num_land_cells_hyde, sizeof(float));
+		if (protected_EPA[k] == NULL) {
+			fprintf(fplog, "Failed to allocate memory for protected_EPA[%i]: bench_setup()\n", k);
+			return ERROR_MEM;
+		}
+	}
+	for (ord = 0; ord < num_land_cells_hyde; ord++) {
+		k = bench_hash(ord, BENCH_SALT_PROT) % NUM_EPA_PROTECTED;
+		if (bench_unit(ord, BENCH_SALT_PROT + 1) < 0.2) {
+			protected_EPA[k][ord] = 0.5;
+			protected_EPA[(k + 1) % NUM_EPA_PROTECTED][ord] = 0.5;
+		} else {
+			protected_EPA[k][ord] = 1;
+		}
+	}
+
+	// the land type categories, as in write_glu_mapping()
+	num_lt_cats = (NUM_SAGE_PVLT + 1) * NUM_LU_CATS * NUM_EPA_PROTECTED;
+	lt_cats = calloc(num_lt_cats, sizeof(int));
+	max_sage_code = NUM_SAGE_PVLT;
+	sage_code2ind = calloc(max_sage_code + 1, sizeof(int));
+	lt_cat_code2ind = calloc((max_sage_code + 1) * SCALE_POTVEG, sizeof(int));
+	if (lt_cats == NULL || sage_code2ind == NULL || lt_cat_code2ind == NULL) {
+		fprintf(fplog, "Failed to allocate memory for the land type categories: bench_setup()\n");
+		return ERROR_MEM;
+	}
+	ord = 0;
+	for (k = 0; k <= NUM_SAGE_PVLT; k++) {
+		for (j = 0; j < NUM_LU_CATS; j++) {
+			for (i = 0; i < NUM_EPA_PROTECTED; i++) {
+				lt_cats[ord++] = (k * SCALE_POTVEG) + (j * 10) + i;
+			}
+		}
+	}
+	sage_code2ind[0] = NOMATCH;
+	for (i = 0; i < NUM_SAGE_PVLT; i++) {
+		sage_code2ind[landtypecodes_sage[i]] = i;
+	}
+	for (i = 0; i < (max_sage_code + 1) * SCALE_POTVEG; i++) {
+		lt_cat_code2ind[i] = NOMATCH;
+	}
+	for (i = num_lt_cats - 1; i >= 0; i--) {
+		lt_cat_code2ind[lt_cats[i]] = i;
+	}
+
+	// the lulc topology, the random lu cell order, and the nearby pot veg
+	if ((err = get_lulc_topology(*in_args)) != OK ||
+		(err = get_rand_order(*in_args)) != OK ||
+		(err = get_potveg_nearest(*raster_info)) != OK) {
+		return err;
+	}
+
+	return OK;
+}
+
+// the arc ascii grid reader, on one hyde file
+static int bench_read_asc_grid(args_struct in_args, int reps, float *grid) {
+
+	int r, ncols, nrows;
+	int err = OK;
+	char fname[MAXCHAR];
+	double t0, secs = 0;
+
+	sprintf(fname, "%s%s%iAD.asc", in_args.hydepath, bench_hyde_names[1], BENCH_FIRST_YEAR);
+	for (r = 0; r < reps; r++) {
+		t0 = bench_seconds();
+		if ((err = read_asc_grid(fname, grid, NUM_CELLS, &ncols, &nrows)) != OK) {
+			fprintf(fplog, "Failed to read %s: bench_read_asc_grid()\n", fname);
+			return err;
+		}
+		secs = secs + bench_seconds() - t0;
+	}
+	bench_report("read_asc_grid", reps * bench_file_mb(fname), "MB", secs);
+
+	return OK;
+}
+
+// the hyde reads of all years: first parsing the ascii files and writing the caches, then from the caches
+static int bench_read_hyde32(args_struct in_args, rinfo_struct *raster_info, int num_years, lta_scratch_struct *scratch) {
+
+	int k, y;
+	int err = OK;
+	char fname[MAXCHAR];
+	double t0, mbytes = 0;
+
+	for (y = 0; y < num_years; y++) {
+		for (k = 0; k < BENCH_NUM_HYDE_TYPES; k++) {
+			sprintf(fname, "%s%s%iAD.asc", in_args.hydepath, bench_hyde_names[k], bench_year(y));
+			mbytes = mbytes + bench_file_mb(fname);
+			strcat(fname, ASC_CACHE_TAG);
+			remove(fname);
+		}
+	}
+
+	t0 = bench_seconds();
+	for (y = 0; y < num_years; y++) {
+		if ((err = read_hyde32(in_args, raster_info, bench_year(y), scratch->crop_grid, scratch->pasture_grid,
+							   scratch->urban_grid, scratch->lu_detail_grid)) != OK) {
+			return err;
+		}
+	}
+	bench_report("read_hyde32 (parse and cache)", mbytes, "MB", bench_seconds() - t0);
+
+	t0 = bench_seconds();
+	for (y = 0; y < num_years; y++) {
+		if ((err = read_hyde32(in_args, raster_info, bench_year(y), scratch->crop_grid, scratch->pasture_grid,
+							   scratch->urban_grid, scratch->lu_detail_grid)) != OK) {
+			return err;
+		}
+	}
+	bench_report("read_hyde32 (cached)", mbytes, "MB", bench_seconds() - t0);
+
+	return OK;
+}
+
+// the gzipped isam netcdf reads of all years
+static int bench_read_lulc_isam(args_struct in_args, int num_years, lta_scratch_struct *scratch) {
+
+	int y;
+	int err = OK;
+	char fname[MAXCHAR];
+	double t0, mbytes = 0;
+
+	t0 = bench_seconds();
+	for (y = 0; y < num_years; y++) {
+		if ((err = read_lulc_isam(in_args, bench_year(y), scratch->lulc_temp_grid)) != OK) {
+			return err;
+		}
+	}
+	for (y = 0; y < num_years; y++) {
+		sprintf(fname, "%sISAM_HYDE32_LANDCOVER_%i.nc.gz", in_args.lulcpath, bench_year(y));
+		mbytes = mbytes + bench_file_mb(fname);
+	}
+	bench_report("read_lulc_isam (gzip)", mbytes, "MB", bench_seconds() - t0);
+
+	return OK;
+}
+
+// the sage crop netcdf reads
+static int bench_read_sage_crop(args_struct in_args, rinfo_struct raster_info) {
+
+	int k;
+	int err = OK;
+	char fname[MAXCHAR];
+	char crop[MAXCHAR];
+	float *harv, *yield;
+	double t0, mbytes = 0;
+
+	harv = calloc(NUM_CELLS, sizeof(float));
+	yield = calloc(NUM_CELLS, sizeof(float));
+	if (harv == NULL || yield == NULL) {
+		fprintf(fplog, "Failed to allocate memory for the sage crop grids: bench_read_sage_crop()\n");
+		return ERROR_MEM;
+	}
+
+	t0 = bench_seconds();
+	for (k = 0; k < BENCH_NUM_SAGE_NC; k++) {
+		strcpy(crop, bench_sage_nc_crops[k]);
+		sprintf(fname, "%s%s", in_args.sagepath, crop);
+		if ((err = read_sage_crop(fname, in_args.sagepath, crop, raster_info, harv, yield)) != OK) {
+			return err;
+		}
+	}
+	for (k = 0; k < BENCH_NUM_SAGE_NC; k++) {
+		sprintf(fname, "%s%s_AreaYieldProduction.nc", in_args.sagepath, bench_sage_nc_crops[k]);
+		mbytes = mbytes + bench_file_mb(fname);
+	}
+	bench_report("read_sage_crop", mbytes, "MB", bench_seconds() - t0);
+
+	free(harv);
+	free(yield);
+
+	return OK;
+}
+
+// the csv field parsing of the fao production records, as in the fao readers, then the fao readers themselves
+static int bench_fao(args_struct in_args, int reps) {
+
+	int j, r, y;
+	int err = OK;
+	int num_lines = 0;
+	int ctry_code, crop_code;
+	float val;
+	long flen;
+	char fname[MAXCHAR];
+	char *sptr, *cptr;
+	char **lines;
+	fields_struct fields = {0, 0, NULL, NULL};
+	double t0, secs = 0, mbytes;
+	FILE *fpin;
+
+	// the production file records, terminated in place so that only the parsing is timed
+	sprintf(fname, "%s%s", in_args.inpath, in_args.production_fao_fname);
+	if ((fpin = fopen(fname, "rb")) == NULL) {
+		fprintf(fplog, "Failed to open file %s: bench_fao()\n", fname);
+		return ERROR_FILE;
+	}
+	fseek(fpin, 0L, SEEK_END);
+	flen = ftell(fpin);
+	rewind(fpin);
+	sptr = calloc(flen + 1, sizeof(char));
+	lines = calloc(flen / 2 + 1, sizeof(char*));
+	if (sptr == NULL || lines == NULL) {
+		fprintf(fplog, "Failed to allocate memory for file %s: bench_fao()\n", fname);
+		fclose(fpin);
+		return ERROR_MEM;
+	}
+	if (fread(sptr, 1, flen, fpin) != (size_t) flen) {
+		fprintf(fplog, "Failed to read file %s: bench_fao()\n", fname);
+		fclose(fpin);
+		return ERROR_FILE;
+	}
+	fclose(fpin);
+	cptr = sptr;
+	while (*cptr) {
+		lines[num_lines++] = cptr;
+		while (*cptr && *cptr != '\n') {
+			cptr++;
+		}
+		if (*cptr) {
+			*cptr++ = '\0';
+		}
+	}
+
+	// skip the header record
+	for (r = 0; r < reps; r++) {
+		t0 = bench_seconds();
+		for (j = 1; j < num_lines; j++) {
+			if ((err = split_fields(lines[j], ",", &fields)) != OK ||
+				(err = get_int_fld(&fields, 1, &ctry_code)) != OK ||
+				(err = get_int_fld(&fields, 3, &crop_code)) != OK) {
+				fprintf(fplog, "Failed to parse record %i of file %s: bench_fao()\n", j, fname);
+				return err;
+			}
+			for (y = 0; y < BENCH_FAO_NUM_YRS; y++) {
+				if ((err = get_float_fld(&fields, y * 2 + 8, &val)) != OK) {
+					fprintf(fplog, "Failed to parse record %i of file %s: bench_fao()\n", j, fname);
+					return err;
+				}
+			}
+		}
+		secs = secs + bench_seconds() - t0;
+	}
+	bench_report("split_fields + get_*_fld", (double) reps * (num_lines - 1), "rec", secs);
+	free(lines);
+	free(sptr);
+	free_fields(&fields);
+
+	// the three readers, in the order of moirai_main()
+	mbytes = bench_file_mb(fname);
+	sprintf(fname, "%s%s", in_args.inpath, in_args.yield_fao_fname);
+	mbytes = mbytes + bench_file_mb(fname);
+	sprintf(fname, "%s%s", in_args.inpath, in_args.harvestarea_fao_fname);
+	mbytes = mbytes + bench_file_mb(fname);
+	secs = 0;
+	for (r = 0; r < reps; r++) {
+		t0 = bench_seconds();
+		if ((err = read_yield_fao(in_args)) != OK ||
+			(err = read_harvestarea_fao(in_args)) != OK ||
+			(err = read_production_fao(in_args)) != OK) {
+			return err;
+		}
+		secs = secs + bench_seconds() - t0;
+		free_fao_data(&yield_fao);
+		free_fao_data(&harvestarea_fao);
+		free_fao_data(&production_fao);
+	}
+	bench_report("read_*_fao", reps * mbytes, "MB", secs);
+
+	return OK;
+}
+
+// proc_lulc_area() over all lulc cells of the first year, serially, with the inputs gathered as in proc_land_type_area_year()
+static int bench_proc_lulc_area(args_struct in_args, rinfo_struct raster_info, lta_scratch_struct *scratch, int reps) {
+
+	int i, j, r, lu_count;
+	int err = OK;
+	int *cell_lu_indices;
+	lulc_work_struct cell_work;
+	double t0, secs = 0;
+
+	for (r = 0; r < reps; r++) {
+		t0 = bench_seconds();
+		for (i = 0; i < raster_info.lulc_input_ncells; i++) {
+			cell_work = scratch->lulc_work[0];
+			cell_work.lu_area = scratch->chunk_lu_area;
+			cell_work.refveg_area_out = scratch->chunk_refveg_area;
+			cell_work.refveg_them = scratch->chunk_refveg_them;
+			for (j = 0; j < NUM_LULC_TYPES; j++) {
+				cell_work.lulc_area[j] = (double) scratch->lulc_temp_grid[j][i];
+			}
+			cell_lu_indices = &lulc_child_cells[i * NUM_LU_CELLS];
+			for (lu_count = 0; lu_count < NUM_LU_CELLS; lu_count++) {
+				cell_work.lu_area[lu_count * NUM_HYDE_TYPES] = (double) scratch->urban_grid[cell_lu_indices[lu_count]];
+				cell_work.lu_area[lu_count * NUM_HYDE_TYPES + 1] = (double) scratch->crop_grid[cell_lu_indices[lu_count]];
+				cell_work.lu_area[lu_count * NUM_HYDE_TYPES + 2] = (double) scratch->pasture_grid[cell_lu_indices[lu_count]];
+				for (j = NUM_HYDE_TYPES_MAIN; j < NUM_HYDE_TYPES; j++) {
+					cell_work.lu_area[lu_count * NUM_HYDE_TYPES + j] =
+						(double) scratch->lu_detail_grid[j - NUM_HYDE_TYPES_MAIN][cell_lu_indices[lu_count]];
+				}
+				cell_work.refveg_area_out[lu_count] = 0;
+				cell_work.refveg_them[lu_count] = 0;
+			}
+			if ((err = proc_lulc_area(in_args, raster_info, &cell_work, cell_lu_indices, NUM_LU_CELLS, i)) != OK) {
+				fprintf(fplog, "Failed to process lulc cell %i: bench_proc_lulc_area()\n", i);
+				return err;
+			}
+		}
+		secs = secs + bench_seconds() - t0;
+	}
+	bench_report("proc_lulc_area", (double) reps * raster_info.lulc_input_ncells, "cell", secs);
+
+	return OK;
+}
+
+// the carbon quantile step on buckets with a skewed size distribution, like the country X glu X land type buckets
+static int bench_carbon_quantiles(int reps) {
+
+	int i, k, r, b;
+	int err = OK;
+	int num_buckets = 0;
+	int size, start;
+	int *bucket_start, *bucket_nodata;
+	float *orig[NUM_CARBON], *work[NUM_CARBON];
+	float *state_vals[NUM_CARBON];
+	float state_out[NUM_CARBON];
+	double t0, secs = 0;
+
+	bucket_start = calloc(BENCH_CARBON_VALUES + 1, sizeof(int));
+	bucket_nodata = calloc(BENCH_CARBON_VALUES, sizeof(int));
+	if (bucket_start == NULL || bucket_nodata == NULL) {
+		fprintf(fplog, "Failed to allocate memory for the carbon buckets: bench_carbon_quantiles()\n");
+		return ERROR_MEM;
+	}
+	for (k = 0; k < NUM_CARBON; k++) {
+		orig[k] = calloc(BENCH_CARBON_VALUES, sizeof(float));
+		work[k] = calloc(BENCH_CARBON_VALUES, sizeof(float));
+		if (orig[k] == NULL || work[k] == NULL) {
+			fprintf(fplog, "Failed to allocate memory for the carbon values: bench_carbon_quantiles()\n");
+			return ERROR_MEM;
+		}
+	}
+
+	// many small buckets and a few large ones; some cells of some buckets are nodata for all states
+	start = 0;
+	while (start < BENCH_CARBON_VALUES) {
+		size = 1 + (int) (BENCH_CARBON_MAX_BUCKET * pow(bench_unit(num_buckets, BENCH_SALT_CARBON), 6));
+		if (start + size > BENCH_CARBON_VALUES) {
+			size = BENCH_CARBON_VALUES - start;
+		}
+		bucket_start[num_buckets] = start;
+		for (i = start; i < start + size; i++) {
+			if (bench_unit(num_buckets, BENCH_SALT_CARBON + 1) < 0.1 && bench_unit(i, BENCH_SALT_CARBON + 2) < 0.2) {
+				bucket_nodata[num_buckets]++;
+				for (k = 1; k < NUM_CARBON; k++) {
+					orig[k][i] = NODATA;
+				}
+			} else {
+				for (k = 1; k < NUM_CARBON; k++) {
+					orig[k][i] = (float) (200.0 * bench_unit(i, BENCH_SALT_CARBON + 2 + k));
+				}
+			}
+		}
+		start = start + size;
+		num_buckets++;
+	}
+	bucket_start[num_buckets] = start;
+
+	// restore the values before each pass because they are reordered in place
+	for (r = 0; r < reps; r++) {
+		for (k = 1; k < NUM_CARBON; k++) {
+			memcpy(work[k], orig[k], BENCH_CARBON_VALUES * sizeof(float));
+		}
+		t0 = bench_seconds();
+		for (b = 0; b < num_buckets; b++) {
+			state_vals[0] = NULL;
+			for (k = 1; k < NUM_CARBON; k++) {
+				state_vals[k] = &work[k][bucket_start[b]];
+			}
+			if ((err = calc_carbon_quantiles(state_vals, bucket_start[b + 1] - bucket_start[b], bucket_nodata[b], state_out)) != OK) {
+				return err;
+			}
+		}
+		secs = secs + bench_seconds() - t0;
+	}
+	bench_report("calc_carbon_quantiles", (double) reps * BENCH_CARBON_VALUES, "val", secs);
+
+	for (k = 0; k < NUM_CARBON; k++) {
+		free(orig[k]);
+		free(work[k]);
+	}
+	free(bucket_start);
+	free(bucket_nodata);
+
+	return OK;
+}
+
+// the reduced end-to-end run: the land type area years, read and processed as in proc_land_type_area()
+static int bench_land_type_area(args_struct in_args, rinfo_struct raster_info, int num_years, int *hyde_years,
+								lta_scratch_struct *scratch, double ****area_out) {
+
+	int year_ind;
+	int err = OK;
+	double t0, t_read = 0, t_proc = 0;
+
+	for (year_ind = 0; year_ind < num_years; year_ind++) {
+		t0 = bench_seconds();
+		if ((err = read_lta_inputs(in_args, raster_info, year_ind, hyde_years, scratch)) != OK) {
+			return err;
+		}
+		t_read = t_read + bench_seconds() - t0;
+		t0 = bench_seconds();
+		if ((err = proc_land_type_area_year(in_args, raster_info, year_ind, hyde_years, scratch, area_out)) != OK) {
+			return err;
+		}
+		t_proc = t_proc + bench_seconds() - t0;
+	}
+	bench_report("land type area: read inputs", num_years, "year", t_read);
+	bench_report("land type area: process", num_years, "year", t_proc);
+	bench_report("land type area: total", num_years, "year", t_read + t_proc);
+
+	return OK;
+}
+
+// the land type area table, written with fprintf() as before the buffered writer, and with the csv_out_*() functions
+static int bench_csv_write(char *dname, int num_years, int *hyde_years, double ****area_out) {
+
+	int i, j, k, y, w;
+	int err = OK;
+	int c1, c2;
+	double outval;
+	char fname[2][MAXCHAR];
+	csv_out_struct csv_out;
+	double t0;
+	FILE *fpout, *fpin[2];
+
+	for (w = 0; w < 2; w++) {
+		sprintf(fname[w], "%sbench_land_type_area_%i.csv", dname, w);
+		if ((fpout = fopen(fname[w], "w")) == NULL) {
+			fprintf(fplog, "Failed to open file %s for write: bench_csv_write()\n", fname[w]);
+			return ERROR_FILE;
+		}
+		t0 = bench_seconds();
+		fprintf(fpout, "iso,glu_code,land_type,year,value");
+		if (w == 1 && (err = csv_out_open(&csv_out, fpout)) != OK) {
+			fclose(fpout);
+			return err;
+		}
+		for (i = 0; i < NUM_FAO_CTRY; i++) {
+			for (j = 0; j < ctry_aez_num[i]; j++) {
+				for (k = 0; k < num_lt_cats; k++) {
+					for (y = 0; y < num_years; y++) {
+						outval = floor(0.5 + area_out[i][j][k][y] * KMSQ2HA);
+						if (outval > 0) {
+							if (w == 0) {
+								fprintf(fpout, "\n%s,%i,%i,%i,%.0f", countryabbrs_iso[i], ctry_aez_list[i][j], lt_cats[k],
+										hyde_years[y], outval);
+							} else {
+								csv_out_rec(&csv_out, countryabbrs_iso[i]);
+								csv_out_int(&csv_out, ctry_aez_list[i][j]);
+								csv_out_int(&csv_out, lt_cats[k]);
+								csv_out_int(&csv_out, hyde_years[y]);
+								csv_out_fixed(&csv_out, outval, 0, 0);
+							}
+						}
+					}
+				}
+			}
+		}
+		// csv_out_close() also closes the file
+		if (w == 0) {
+			fclose(fpout);
+		} else if ((err = csv_out_close(&csv_out)) != OK) {
+			fprintf(fplog, "Error writing file %s: bench_csv_write()\n", fname[w]);
+			return err;
+		}
+		bench_report((w == 0) ? "land type area csv: fprintf" : "land type area csv: csv_out_*", bench_file_mb(fname[w]),
+					 "MB", bench_seconds() - t0);
+	}
+
+	// the two writers must produce the same file
+	fpin[0] = fopen(fname[0], "rb");
+	fpin[1] = fopen(fname[1], "rb");
+	if (fpin[0] == NULL || fpin[1] == NULL) {
+		fprintf(fplog, "Failed to open the csv files for comparison: bench_csv_write()\n");
+		return ERROR_FILE;
+	}
+	do {
+		c1 = getc(fpin[0]);
+		c2 = getc(fpin[1]);
+	} while (c1 == c2 && c1 != EOF);
+	fclose(fpin[0]);
+	fclose(fpin[1]);
+	if (c1 != c2) {
+		fprintf(fplog, "The csv files %s and %s differ: bench_csv_write()\n", fname[0], fname[1]);
+		return ERROR_CALC;
+	}
+	remove(fname[0]);
+	remove(fname[1]);
+
+	return OK;
+}
+
+// append this run's results to the results file, which starts with a header
+static int bench_write_results(char *dname, const char *tag) {
+
+	int i;
+	char fname[MAXCHAR];
+	char date[MAXCHAR];
+	time_t now = time(NULL);
+	FILE *fp;
+
+	strftime(date, MAXCHAR, "%Y-%m-%d %H:%M:%S", localtime(&now));
+	sprintf(fname, "%s%s", dname, BENCH_RESULTS_FNAME);
+	if ((fp = fopen(fname, "r")) == NULL) {
+		if ((fp = fopen(fname, "w")) == NULL) {
+			fprintf(fplog, "Failed to open file %s for write: bench_write_results()\n", fname);
+			return ERROR_FILE;
+		}
+		fprintf(fp, "tag,date,kernel,amount,unit,seconds,rate\n");
+	} else {
+		fclose(fp);
+		if ((fp = fopen(fname, "a")) == NULL) {
+			fprintf(fplog, "Failed to open file %s for append: bench_write_results()\n", fname);
+			return ERROR_FILE;
+		}
+	}
+	for (i = 0; i < num_results; i++) {
+		fprintf(fp, "%s,%s,%s,%.6g,%s,%.6f,%.6g\n", tag, date, results[i].name, results[i].amount, results[i].unit,
+				results[i].seconds, results[i].amount / results[i].seconds);
+	}
+	fclose(fp);
+	printf("results appended to %s\n", fname);
+
+	return OK;
+}
+
+int main(int argc, const char * argv[]) {
+
+	int i, j, k;
+	int err = OK;
+	int reps = 3;
+	int num_years = 0;
+	int version = 0;
+	int num_cell_threads = 1;
+	int hyde_years[BENCH_MAX_YEARS];
+	char dname[MAXCHAR];
+	char fname[MAXCHAR];
+	char tag[MAXCHAR] = "untagged";
+	double ****area_out;
+	double t0;
+	args_struct in_args;
+	rinfo_struct raster_info;
+	lta_scratch_struct scratch;
+	FILE *fp;
+
+	if (argc < 2) {
+		fprintf(stderr, "Usage: bench_moirai <directory> [tag] [repetitions]\n");
+		return ERROR_USAGE;
+	}
+	sprintf(dname, "%s/", argv[1]);
+	if (argc > 2) {
+		strcpy(tag, argv[2]);
+	}
+	if (argc > 3) {
+		reps = atoi(argv[3]);
+	}
+	if (reps < 1) {
+		reps = 1;
+	}
+
+	// the inputs must be from bench_gen_inputs of this version
+	sprintf(fname, "%s%s", dname, BENCH_STAMP_FNAME);
+	if ((fp = fopen(fname, "r")) != NULL) {
+		if (fscanf(fp, "version %i years %i", &version, &num_years) != 2) {
+			version = 0;
+		}
+		fclose(fp);
+	}
+	if (version != BENCH_INPUTS_VERSION || num_years < 1 || num_years > BENCH_MAX_YEARS) {
+		fprintf(stderr, "No current synthetic inputs in %s; run bench_gen_inputs first\n", dname);
+		return ERROR_FILE;
+	}
+	for (i = 0; i < num_years; i++) {
+		hyde_years[i] = bench_year(i);
+	}
+
+	sprintf(fname, "%s%s", dname, BENCH_LOG_FNAME);
+	if ((fplog = fopen(fname, "w")) == NULL) {
+		fprintf(stderr, "Failed to open file %s for write\n", fname);
+		return ERROR_FILE;
+	}
+
+	t0 = bench_seconds();
+	if ((err = bench_setup(dname, &in_args, &raster_info)) != OK) {
+		fprintf(stderr, "Failed to set up the benchmark inputs; see %s%s\n", dname, BENCH_LOG_FNAME);
+		return err;
+	}
+#ifdef _OPENMP
+	num_cell_threads = omp_get_max_threads();
+	if (num_cell_threads > 1 && omp_get_max_active_levels() < 2) {
+		omp_set_max_active_levels(2);
+	}
+#endif
+	if ((err = alloc_lta_scratch(&scratch, num_cell_threads)) != OK) {
+		return err;
+	}
+	area_out = calloc(NUM_FAO_CTRY, sizeof(double***));
+	if (area_out == NULL) {
+		fprintf(fplog, "Failed to allocate memory for area_out: main()\n");
+		return ERROR_MEM;
+	}
+	for (i = 0; i < NUM_FAO_CTRY; i++) {
+		area_out[i] = calloc(ctry_aez_num[i], sizeof(double**));
+		if (area_out[i] == NULL) {
+			fprintf(fplog, "Failed to allocate memory for area_out[%i]: main()\n", i);
+			return ERROR_MEM;
+		}
+		for (j = 0; j < ctry_aez_num[i]; j++) {
+			area_out[i][j] = calloc(num_lt_cats, sizeof(double*));
+			if (area_out[i][j] == NULL) {
+				fprintf(fplog, "Failed to allocate memory for area_out[%i][%i]: main()\n", i, j);
+				return ERROR_MEM;
+			}
+			for (k = 0; k < num_lt_cats; k++) {
+				area_out[i][j][k] = calloc(num_years, sizeof(double));
+				if (area_out[i][j][k] == NULL) {
+					fprintf(fplog, "Failed to allocate memory for area_out[%i][%i][%i]: main()\n", i, j, k);
+					return ERROR_MEM;
+				}
+			}
+		}
+	}
+	printf("moirai benchmark: tag %s, %i years, %i repetitions, %i threads, setup %.1f s\n", tag, num_years, reps,
+		   num_cell_threads, bench_seconds() - t0);
+	printf("%-36s %11s %16s\n", "kernel", "time", "throughput");
+
+	// the hyde and isam reads leave the last year in the scratch space for proc_lulc_area()
+	if ((err = bench_read_asc_grid(in_args, reps, scratch.refveg_area_grid)) != OK ||
+		(err = bench_read_hyde32(in_args, &raster_info, num_years, &scratch)) != OK ||
+		(err = bench_read_lulc_isam(in_args, num_years, &scratch)) != OK ||
+		(err = bench_proc_lulc_area(in_args, raster_info, &scratch, reps)) != OK ||
+		(err = bench_read_sage_crop(in_args, raster_info)) != OK ||
+		(err = bench_fao(in_args, reps)) != OK ||
+		(err = bench_carbon_quantiles(reps)) != OK ||
+		(err = bench_land_type_area(in_args, raster_info, num_years, hyde_years, &scratch, area_out)) != OK ||
+		(err = bench_csv_write(dname, num_years, hyde_years, area_out)) != OK) {
+		fprintf(stderr, "Benchmark failed; see %s%s\n", dname, BENCH_LOG_FNAME);
+		return err;
+	}
+
+	if ((err = bench_write_results(dname, tag)) != OK) {
+		return err;
+	}
+
+	for (i = 0; i < NUM_FAO_CTRY; i++) {
+		for (j = 0; j < ctry_aez_num[i]; j++) {
+			for (k = 0; k < num_lt_cats; k++) {
+				free(area_out[i][j][k]);
+			}
+			free(area_out[i][j]);
+		}
+		free(area_out[i]);
+	}
+	free(area_out);
+	free_lta_scratch(&scratch);
+	fclose(fplog);
+
+	return OK;
+}
@@ -0,0 +1,207 @@
+/**********
+ bench_synth.h
+
+ the synthetic global inputs of the moirai benchmark suite, shared by bench_gen_inputs.c and bench_moirai.c
+ 
+ every input value is a function of the cell (or record) and a salt, so the generator writes the files
+    and the benchmark sets the matching ancillary rasters and info arrays without reading them
+ the land mask, countries, glus, and potential vegetation are smooth or blocky fields on the 5 arcmin working grid,
+    and the hyde, isam, sage, and fao values are consistent with them
+
+ Created 17 Oct 2026
+
+ Moirai Land Data System (Moirai) Copyright (c) 2019, The
+ Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S.
+ Dept. of Energy).  All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Intellectual Property Office at
+ IPO@lbl.gov.
+
+ NOTICE.  This Software was developed under funding from the U.S. Department
+ of Energy and the U.S. Government consequently retains certain rights.  As
+ such, the U.S. Government has been granted for itself and others acting on
+ its behalf a paid-up, nonexclusive, irrevocable, worldwide license in the
+ Software to reproduce, distribute copies to the public, prepare derivative
+ works, and perform publicly and display publicly, and to permit other to do
+ so.
+
+ This file is part of Moirai.
+
+ Moirai is free software: you can use it under the terms of the modified BSD-3 license (see …/moirai/license.txt)
+
+ **********/
+
+#ifndef BENCHSYNTHHDR
+#define BENCHSYNTHHDR
+
+#include "moirai.h"
+
+#define BENCH_INPUTS_VERSION	1			// increment when the synthetic inputs change, so that they are regenerated
+#define BENCH_STAMP_FNAME		"bench_inputs.txt"	// written last by bench_gen_inputs; lists the version and the years
+
+// the synthetic year set: BENCH_FIRST_YEAR, then every BENCH_YEAR_STEP years
+#define BENCH_FIRST_YEAR		2000
+#define BENCH_YEAR_STEP			5
+#define BENCH_NUM_YEARS			2			// default number of years
+#define BENCH_MAX_YEARS			4			// the years must be hyde years that are also isam years (annual after 2000)
+
+// input cardinality
+#define BENCH_NUM_HYDE_TYPES	12			// urban, crop, grazing, then the detailed types, as in the hyde 3.2 files
+#define BENCH_NUM_LULC_TYPES	32			// NUM_LULC_LC_TYPES land cover types, then the land use types
+#define BENCH_NUM_SAGE_PVLT		15			// sage potential vegetation types, codes 1 to 15
+#define BENCH_NUM_FAO_CTRY		250			// fao countries
+#define BENCH_NUM_SAGE_CROP		175			// sage crops, each with an fao crop code
+#define BENCH_NUM_GLU			235			// glu (basin) codes 1 to 235
+#define BENCH_NUM_SAGE_NC		3			// number of sage crop netcdf files
+#define BENCH_FAO_START_YEAR	1961		// the fao csv year columns
+#define BENCH_FAO_NUM_YRS		56
+#define BENCH_FAO_FRAC			0.4			// fraction of the country X crop records that are in the fao files
+
+// the land mask threshold; about 29% of the global area is land
+#define BENCH_LAND_THRESH		0.12
+
+// the sage netcdf nodata value and number of levels (harvested area, yield, their quality flags, production, its flag)
+#define BENCH_SAGE_NODATA		9E20
+#define BENCH_SAGE_NUM_LEVELS	6
+
+// the hashing salts for the different synthetic fields
+enum {BENCH_SALT_LAND = 1, BENCH_SALT_CTRY, BENCH_SALT_GLU, BENCH_SALT_POTVEG, BENCH_SALT_HYDE, BENCH_SALT_LULC,
+	BENCH_SALT_SAGE, BENCH_SALT_FAO, BENCH_SALT_PROT, BENCH_SALT_CARBON};
+
+// the hyde 3.2 land use type file name prefixes; the order is used by proc_lulc_area()
+static const char *bench_hyde_names[BENCH_NUM_HYDE_TYPES] = {"uopp_", "cropland", "grazing", "pasture", "rangeland",
+	"ir_norice", "rf_norice", "ir_rice", "rf_rice", "tot_irri", "tot_rainfed", "tot_rice"};
+
+// the sage crops with netcdf files
+static const char *bench_sage_nc_crops[BENCH_NUM_SAGE_NC] = {"maize", "wheat", "rice"};
+
+// a well mixed 32 bit hash of two values (the splitmix64 finalizer)
+static inline uint32_t bench_hash(uint32_t a, uint32_t b) {
+	uint64_t z = (((uint64_t) a << 32) | b) + 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	z = z ^ (z >> 31);
+	return (uint32_t) (z >> 32);
+}
+
+// a uniform value in [0,1) for a key and salt
+static inline double bench_unit(uint32_t key, uint32_t salt) {
+	return bench_hash(key, salt) / 4294967296.0;
+}
+
+static inline int bench_year(int year_ind) {
+	return BENCH_FIRST_YEAR + year_ind * BENCH_YEAR_STEP;
+}
+
+// the area (km^2) of a working grid cell in row (from the top)
+static inline double bench_cell_area(int row) {
+	double lat_top = 90.0 - row * GRID_RES;
+	double lat_bot = lat_top - GRID_RES;
+	return (AVE_ER / 1000.0) * (AVE_ER / 1000.0) * GRID_RES * DEG2RAD * (sin(lat_top * DEG2RAD) - sin(lat_bot * DEG2RAD));
+}
+
+// the land fraction of a working grid cell, from a few smooth functions on the sphere; 0 is ocean (nodata)
+static inline double bench_land_frac(int cell) {
+	double lat = (90.0 - (cell / NUM_LON + 0.5) * GRID_RES) * DEG2RAD;
+	double lon = (-180.0 + (cell % NUM_LON + 0.5) * GRID_RES) * DEG2RAD;
+	double x = cos(lat) * cos(lon);
+	double y = cos(lat) * sin(lon);
+	double z = sin(lat);
+	double f = sin(3 * x + 1.3) * cos(2 * y - 0.4) + 0.7 * sin(4 * z + 2 * y + 0.5) + 0.5 * cos(5 * x - 3 * z);
+
+	if (f <= BENCH_LAND_THRESH) {
+		return 0;
+	}
+	// the coastal cells are partly land
+	f = (f - BENCH_LAND_THRESH) * 8;
+	return (f < 1) ? f : 1;
+}
+
+// the fao country index of a land cell; the countries are 6 degree blocks
+static inline int bench_cell_ctry(int cell) {
+	return bench_hash((cell / NUM_LON / 72) * 60 + (cell % NUM_LON) / 72, BENCH_SALT_CTRY) % BENCH_NUM_FAO_CTRY;
+}
+
+// the glu code of a land cell; the glus are 3 degree blocks
+static inline int bench_cell_glu(int cell) {
+	return 1 + bench_hash((cell / NUM_LON / 36) * 120 + (cell % NUM_LON) / 36, BENCH_SALT_GLU) % BENCH_NUM_GLU;
+}
+
+// the potential vegetation of a land cell, 1 degree blocks; some cells have none
+static inline int bench_cell_potveg(int cell) {
+	if (bench_unit(cell, BENCH_SALT_POTVEG) < 0.05) {
+		return NODATA;
+	}
+	return 1 + bench_hash((cell / NUM_LON / 12) * 360 + (cell % NUM_LON) / 12, BENCH_SALT_POTVEG) % BENCH_NUM_SAGE_PVLT;
+}
+
+static inline int bench_ctry_code(int ctry_ind) {
+	return 1 + ctry_ind + ctry_ind / 3;
+}
+
+static inline int bench_crop_code(int crop_ind) {
+	return 15 + 4 * crop_ind + crop_ind % 3;
+}
+
+// the hyde land use areas (km^2) of a land cell with land_area km^2 in a year, in bench_hyde_names order
+static inline void bench_hyde_vals(int cell, int year, double land_area, double *vals) {
+	double grow = 1.0 + 0.01 * (year - BENCH_FIRST_YEAR);	// the land use grows a little each year
+	double crop = 0, grazing = 0, urban = 0;
+	double pasture_share, rice_share = 0, irr_share;
+
+	if (bench_unit(cell, BENCH_SALT_HYDE) < 0.6) {
+		crop = 0.35 * pow(bench_unit(cell, BENCH_SALT_HYDE + 100), 2) * grow * land_area;
+	}
+	if (bench_unit(cell, BENCH_SALT_HYDE + 200) < 0.5) {
+		grazing = 0.4 * bench_unit(cell, BENCH_SALT_HYDE + 300) * grow * land_area;
+	}
+	if (bench_unit(cell, BENCH_SALT_HYDE + 400) < 0.15) {
+		urban = 0.02 * bench_unit(cell, BENCH_SALT_HYDE + 500) * grow * land_area;
+	}
+	pasture_share = bench_unit(cell, BENCH_SALT_HYDE + 600);
+	if (bench_unit(cell, BENCH_SALT_HYDE + 700) < 0.2) {
+		rice_share = bench_unit(cell, BENCH_SALT_HYDE + 800);
+	}
+	irr_share = 0.5 * bench_unit(cell, BENCH_SALT_HYDE + 900);
+
+	vals[0] = urban;
+	vals[1] = crop;
+	vals[2] = grazing;
+	vals[3] = grazing * pasture_share;
+	vals[4] = grazing * (1 - pasture_share);
+	vals[5] = crop * (1 - rice_share) * irr_share;
+	vals[6] = crop * (1 - rice_share) * (1 - irr_share);
+	vals[7] = crop * rice_share * irr_share;
+	vals[8] = crop * rice_share * (1 - irr_share);
+	vals[9] = vals[5] + vals[7];
+	vals[10] = vals[6] + vals[8];
+	vals[11] = vals[7] + vals[8];
+}
+
+// the working grid lulc cell index of an isam input cell (the input starts at the lower left, at 0 lon), as in get_lulc_topology()
+static inline int bench_lulc_in2grid(int in_cell) {
+	int in_row = in_cell / NUM_LON_LULC;
+	int in_col = in_cell % NUM_LON_LULC;
+	return (NUM_LAT_LULC - in_row - 1) * NUM_LON_LULC + (in_col + NUM_LON_LULC / 2) % NUM_LON_LULC;
+}
+
+// the isam type mappings: land cover types to sage pot veg codes (-1 = none), land use types to hyde main types (-1 = none)
+static inline int bench_lulc2sage(int lulc_ind) {
+	// the last land cover type is water
+	if (lulc_ind >= NUM_LULC_LC_TYPES - 1) {
+		return -1;
+	}
+	return 1 + lulc_ind % BENCH_NUM_SAGE_PVLT;
+}
+static inline int bench_lulc2hyde(int lulc_ind) {
+	// urban, five crop types, pasture and rangeland, and one unmapped type
+	static const int lu2hyde[BENCH_NUM_LULC_TYPES - NUM_LULC_LC_TYPES] = {1, 2, 2, 2, 2, 2, 3, 3, -1};
+	if (lulc_ind < NUM_LULC_LC_TYPES) {
+		return -1;
+	}
+	return lu2hyde[lulc_ind - NUM_LULC_LC_TYPES];
+}
+
+#endif
@@ -57,16 +57,24 @@
 #include <stdio.h>
 #include <math.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 #include <time.h>
 #include <ctype.h>
 #include <netcdf.h>
+#include <netcdf_mem.h>
+#include <zlib.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 
 #define CODENAME				"moirai"				// name of the compiled program
 #define VERSION         		"3.2"           			// current version
 #define MAXCHAR					1000						// maximum string length
 #define MAXRECSIZE				10000						// maximum record (csv line) length in characters
+#define ASC_CACHE_TAG			".bin"						// appended to an arc ascii file name for its binary cache file
+#define SAGE_SPILL_TAG			".spill"					// appended to a sage crop file base name for its temporary recalibration file
 
 // year of HYDE data to read in for calculating potential vegetation area (for carbon and forest land rent) and pasture animal land rent
 #define REF_YEAR				2000
@@ -80,16 +88,26 @@
 // counts of useful variables
 //kbn 2020-06-01 Updating input arguments to include 6 new carbon states for soil_carbon
 //map 2023-01-19 update input arguments to include carbon boolean
-#define NUM_IN_ARGS						131					// number of input variables in the input file
+#define NUM_IN_ARGS						137					// number of input variables in the input file
 #define NUM_ORIG_AEZ						18							// number of original GTAP/GCAM AEZs
 
+// the stage timers of the run report, see run_report.c
+#define MAX_STAGES					256			// maximum number of stages recorded
+#define MAXSTAGENAME				64			// maximum stage name length
+
+// the buffer size (characters) for the csv output files, see csv_out_utils.c
+#define CSV_OUT_BUFSIZE				(1 << 20)
+
+// the binary land type area output, see write_land_type_area_bin()
+#define LTA_BIN_MAGIC				"MOIRLTA"	// file identifier; written with its terminating null as the first 8 bytes
+#define LTA_BIN_VERSION				1			// layout version
+#define LTA_BIN_BYTE_ORDER			0x01020304	// written in the native byte order so that a reader can check it
+
 // necessary FAO input data info
 // this applies to the yield, harvest area, production, and prod price input FAO data
-// these four files all need to be in the same format with the same years, in order and contiguous
+// these four files all need to be in the same format, with year and flag column pairs in order and contiguous
+// the years of each file are read from its header, see get_fao_years()
 #define FAO_START_YEAR_COL					8		// the column of the start year in the fao input data
-#define FAO_START_YEAR						1993	// first year in fao yield, HA, prod, and prodprice files
-#define FAO_END_YEAR						2016	// last year in fao yield, HA, prod, and prodprice files
-#define NUM_FAO_YRS							(FAO_END_YEAR - FAO_START_YEAR + 1)	// number of years in the files
 
 // averaging periods and years for production, harvest area, yield, and land rent data
 #define SAGE_AVG_PERIOD			7
@@ -149,6 +167,7 @@
 #define NUM_LAT_LULC			360							// number of lats in input lulc data
 #define NUM_LON_LULC			720							// number of lons in input lulc
 #define NUM_CELLS_LULC			(NUM_LAT_LULC * NUM_LON_LULC)			// number of grid cells in input lulc data
+#define NUM_LULC_CHUNK			1024						// number of lulc cells processed concurrently before their areas are summed in order
 
 // some constants for calculating the area of a grid cell
 #define AVE_ER					6371007.181		// average earth radius; from MODIS land products WGS84 average spherical radius;  meters
@@ -182,7 +201,15 @@ int NUM_LULC_TYPES;						// number of input lulc types
 
 // for downscaling the lulc data to the working grid
 int NUM_LU_CELLS;		// the number of lu working grid cells within a coarser res lulc cell
-float **rand_order;		// the array to store the within-coarse-cell-index of the lu cell, or each lulc cell
+int *lulc_in2grid;		// the lulc grid index of each lulc input cell (input starts at lower left, 0 lon); dim = NUM_CELLS_LULC
+int *lulc_child_cells;	// the working grid indices of the lu cells in each lulc grid cell; dim = NUM_CELLS_LULC * NUM_LU_CELLS
+int *potveg_nearest;	// the substitute pot veg value for each lu cell position in a lulc cell, for cells without pot veg; dim = NUM_LU_CELLS
+// the isam lulc read buffers, kept across years; the lulc netcdf reads are serialized, so these are shared
+char *lulc_nc_buf;			// the decompressed gzipped lulc netcdf file; from open_lulc_isam()
+size_t lulc_nc_buf_size;	// the allocated size (bytes) of lulc_nc_buf
+float *lulc_frac_buf;		// the lulc fraction of each type, as read; [lc type * NUM_CELLS_LULC + input cell]
+float *lulc_area_buf;		// the lulc input cell area (m^2), as read; dim = NUM_CELLS_LULC
+uint16_t *rand_order;	// the within-lulc-cell index of the lu cell to process at each step, for each lulc cell; dim = NUM_CELLS_LULC * NUM_LU_CELLS
 float *****refveg_carbon_out;		// the potveg carbon out table;4th dim is the state of carbon; 5th dim is the two carbon density values and the area
 
 
@@ -213,6 +240,15 @@ int *reggcam_aez_num;                   // number of AEZs for each gcam region
 // list of land type category mappings for the land type area and potveg carbon csv outputs
 int num_lt_cats;        // the number of categories
 int *lt_cats;           // the list of categories
+int *lt_cat_code2ind;   // index in lt_cats for each category code, NOMATCH if not a category; dim = (max_sage_code + 1) * SCALE_POTVEG
+int max_sage_code;      // the largest sage pot veg code, or NUM_SAGE_PVLT if larger
+int *sage_code2ind;     // index in landtypecodes_sage for each sage code 0 to max_sage_code, NOMATCH if not a sage code
+// direct lookups of the fao codes in the input files, from get_fao_code_ind()
+int max_fao_ctry_code;  // the largest fao country code
+int *fao_ctry_code2ind; // index in countrycodes_fao for each fao country code 0 to max_fao_ctry_code, NOMATCH if not a country
+int max_fao_crop_code;  // the largest fao crop code of the sage crops
+int *fao_crop_code2ind; // index in cropcodes_sage2fao for each fao crop code 0 to max_fao_crop_code, NOMATCH if not a sage crop
+int *ctry2ctry87_ind;   // index in country87codes_gtap of the land rent region of each fao country, NOMATCH if none
 
 // variables to track taiwan and hong kong GLU areas for land rent separation
 // probably not more than 10 GLUs in each of these, but use NUM_ORIG_AEZ to allocate space for now
@@ -239,6 +275,8 @@ int *potveg_thematic;                   // potential vegetation thematic data (i
 int *refveg_thematic;                   // reference vegetation thematic data (integers 1 to NUM_SAGE_PVLT)
 int *refvegcarbon_thematic;                   // reference vegetation thematic data (integers 1 to NUM_SAGE_PVLT)
 short *country_fao;                     // fao country codes (integer fao code values)
+int *cell_ctry_ind;                     // fao country index of each cell, with scg merged; NOMATCH if none
+int *cell_aez_ind;                      // glu index of each cell within ctry_aez_list[cell_ctry_ind]; NOMATCH if none
 float *cell_area;                       // total area of grid cell; calculated based on spherical earth (km^2)
 float *cell_area_hyde;                  // total area of hyde land grid cells; from hyde data set (km^2)
 float *land_area_sage;                  // max land area of sage working grid cell (km^2)
@@ -262,33 +300,39 @@ float *crop_grid_carbon;
 float *pasture_grid_carbon;
 float *urban_grid_carbon;
 
+// the protected area and carbon state arrays below are stored only for the hyde land cells, indexed by land cell ordinal
+// they are expanded to full rasters only when a diagnostic raster is written, with write_raster_land_float()
 //kbn 2020-02-29 Introducing objects for protected area rasters from Category 1 to 7
-float **protected_EPA; //dim 1 is the type of protected area, dim 2 is the grid cell
+float **protected_EPA; //dim 1 is the type of protected area, dim 2 is the hyde land cell ordinal (see land_cells_hyde)
 //kbn 2020-06-01 Changing soil carbon variable
 //kbn 2020-06-29 Changing vegetation carbon variable
-float **soil_carbon_sage; //dim 1 is the type of state, dim 2 is the grid cell
-float **soil_carbon_crop_sage; //dim 1 is the type of state, dim 2 is the grid cell
-float **soil_carbon_pasture_sage; //dim 1 is the type of state, dim 2 is the grid cell
-float **soil_carbon_urban_sage; //dim 1 is the type of state, dim 2 is the grid cell
+float **soil_carbon_sage; //dim 1 is the type of state, dim 2 is the hyde land cell ordinal
+float **soil_carbon_crop_sage; //dim 1 is the type of state, dim 2 is the hyde land cell ordinal
+float **soil_carbon_pasture_sage; //dim 1 is the type of state, dim 2 is the hyde land cell ordinal
+float **soil_carbon_urban_sage; //dim 1 is the type of state, dim 2 is the hyde land cell ordinal
 int ***soil_carbon_array_cells;//These are the total number of cells contained within each array
 float *****soil_carbon_array; //soil carbon array to calculate the soil carbon values for each state
 //float *****soil_carbon_crop_array; //soil carbon array to calculate the soil carbon values for each state
 //float *****soil_carbon_pasture_array; //soil carbon array to calculate the soil carbon values for each state
 //float *****soil_carbon_urban_array; //soil carbon array to calculate the soil carbon values for each state
 float *****veg_carbon_array; //vegetation carbon array to calculate vegetation carbon values for each state
-float **veg_carbon_crop_sage;  //dim 1 is the type of state, dim 2 is the grid cell
-float **veg_carbon_urban_sage;  //dim 1 is the type of state, dim 2 is the grid cell
-float **veg_carbon_pasture_sage;  //dim 1 is the type of state, dim 2 is the grid cell
-float **veg_carbon_sage;  //dim 1 is the type of state, dim 2 is the grid cell
+float **soil_carbon_slab;   //contiguous soil carbon bucket values for each state; soil_carbon_array points into these
+float **veg_carbon_slab;    //contiguous veg carbon bucket values for each state; veg_carbon_array points into these
+float **soil_carbon_bucket_states;  //the state pointers for all soil carbon buckets, NUM_CARBON per bucket
+float **veg_carbon_bucket_states;   //the state pointers for all veg carbon buckets, NUM_CARBON per bucket
+float **veg_carbon_crop_sage;  //dim 1 is the type of state, dim 2 is the hyde land cell ordinal
+float **veg_carbon_urban_sage;  //dim 1 is the type of state, dim 2 is the hyde land cell ordinal
+float **veg_carbon_pasture_sage;  //dim 1 is the type of state, dim 2 is the hyde land cell ordinal
+float **veg_carbon_sage;  //dim 1 is the type of state, dim 2 is the hyde land cell ordinal
 //Add above and below ground ratio for vegetation carbon
-float **above_ground_ratio; //dim 1 is the type of state, dim 2 is the grid cell
-float **below_ground_ratio; //dim 1 is the type of state, dim 2 is the grid cell
-float **above_ground_ratio_crop; //dim 1 is the type of state, dim 2 is the grid cell
-float **below_ground_ratio_crop; //dim 1 is the type of state, dim 2 is the grid cell
-float **above_ground_ratio_pasture; //dim 1 is the type of state, dim 2 is the grid cell
-float **below_ground_ratio_pasture; //dim 1 is the type of state, dim 2 is the grid cell
-float **above_ground_ratio_urban; //dim 1 is the type of state, dim 2 is the grid cell
-float **below_ground_ratio_urban; //dim 1 is the type of state, dim 2 is the grid cell
+float **above_ground_ratio; //dim 1 is the type of state, dim 2 is the hyde land cell ordinal
+float **below_ground_ratio; //dim 1 is the type of state, dim 2 is the hyde land cell ordinal
+float **above_ground_ratio_crop; //dim 1 is the type of state, dim 2 is the hyde land cell ordinal
+float **below_ground_ratio_crop; //dim 1 is the type of state, dim 2 is the hyde land cell ordinal
+float **above_ground_ratio_pasture; //dim 1 is the type of state, dim 2 is the hyde land cell ordinal
+float **below_ground_ratio_pasture; //dim 1 is the type of state, dim 2 is the hyde land cell ordinal
+float **above_ground_ratio_urban; //dim 1 is the type of state, dim 2 is the hyde land cell ordinal
+float **below_ground_ratio_urban; //dim 1 is the type of state, dim 2 is the hyde land cell ordinal
 
 // raster arrays for inputs with different resolution
 // these are also stored starting at upper left corner with lon varying fastest
@@ -302,6 +346,7 @@ int *land_cells_sage;                       // indices of the cells containing l
 int num_land_cells_sage;					// the actual number of land cell indices in land_cells_sage[]
 int *land_cells_hyde;                       // indices of the cells containing land in hyde data
 int num_land_cells_hyde;					// the actual number of land cell indices in land_cells_hyde[]
+int *land_ord_hyde;                         // ordinal of each cell in land_cells_hyde[], NOMATCH if not a hyde land cell
 int *forest_cells;                          // indices of the cells containing forest in sage pot veg data
 int num_forest_cells;						// the actual number of land cell indices in forest_cells[]
 
@@ -309,20 +354,30 @@ int num_forest_cells;						// the actual number of land cell indices in forest_c
 // the order of country is the GTAP_GCAM_ctry87 order, the order of use is the GTAP use order, and the order of original AEZs is 1-NUM_ORIG_AEZ
 float *rent_orig_aez;		// original land rent (million USD, the currency year of these values is an input)
 
+// sparse storage of the annual values of an fao data file (fao_data_utils.c)
+// only the fao country X sage crop records in the file are stored, each with all the years of the file
+typedef struct {
+	int start_year;				// the first year in the file
+	int num_yrs;				// the number of years in the file
+	int num_recs;				// the number of country X crop records stored
+	int max_recs;				// the allocated number of records in vals
+	int *rec_ind;				// the record of each country X crop; [ctry_ind * NUM_SAGE_CROP + crop_ind]; NOMATCH if not in the file
+	float *vals;				// the annual values of each record; [rec * num_yrs + year index]
+} fao_data_struct;
+
 // FAOSTAT data
-// the four associated input files need to be in the same format with the same years, in order and contiguous
-// for non-price data the year varies fastest, then crop, then fao country
+// the four associated input files need to be in the same format, with contiguous years in order
+// the years are read from each file, and the values are looked up by year with get_fao_val()
 // the order of country is the FAO order, the order of crop is the GTAP order, and the yeas are chronological
 // these are only needed if recalibrating the SAGE data to a different year (the current input data are calibrated to 1997-2003 FAO averages)
 // the yield data are actually just for diagnostics; production and harvest area are used to recalibrate yield
 // the annual values are stored for weighted averaging
-float *yield_fao;           // yield from the FAO file (metric tonnes / km^2 )
-float *harvestarea_fao;     // harvested area from the FAO file (km^2)
+fao_data_struct yield_fao;          // yield from the FAO file (metric tonnes / km^2 )
+fao_data_struct harvestarea_fao;    // harvested area from the FAO file (km^2)
 // these are needed to disaggregate the land rents across AEZs; production is also needed for recalibration
-// production data: year varies fastest, then crop, then fao country
 // crop varies fastest for price data, then ctry87; only a single value needs to be stored rather than the annual values
 // the price data are aggregated to ctry87
-float *production_fao;      // production from the FAO file (metric tonnes)
+fao_data_struct production_fao;     // production from the FAO file (metric tonnes)
 float *prodprice_fao_reglr;	// producer prices from the FAO file (USD / tonne), single year or an average
 
 // GCAM, GTAP, SAGE, LULC, and FAO variable lists and codes
@@ -661,8 +716,90 @@ typedef struct {
 	
 	//carbon enabled 1 or disabled 0 
 	int carbon_enabled;
+	
+	// parallel processing
+	int num_threads;					// threads for the per-year and per-lulc-cell land type area and per-crop processing; 0 = all available, 1 = serial
+	int mem_budget_mb;					// memory budget (MB) for the per-thread scratch grids; 0 = no limit
+	
+	// sage crop processing
+	int sage_crop_spill;				// recalibration values of each crop: 0 = keep in memory, 1 = write to temporary files
+	
+	// lulc downscaling
+	unsigned int rand_seed;				// seed for the random order of the lu cells within each lulc cell
+	
+	// land type area output
+	int land_type_area_format;				// 0 = csv, 1 = csv and binary, 2 = binary
+	char land_type_area_bin_fname[MAXCHAR];	// file name for the binary land type area output
 } args_struct;
 
+// workspace for proc_lulc_area() for a single lulc cell; each thread needs its own
+typedef struct {
+	double *lulc_area;			// the lulc areas per type for a single lulc cell
+	double *lu_area;			// the lu areas for each working grid cell in a single lulc cell; [lu cell * NUM_HYDE_TYPES + hyde type]
+	double *refveg_area_out;	// the reference veg areas in each working grid cell of a single lulc cell
+	int *refveg_them;			// the reference veg type values in each working grid cell of a single lulc cell
+	double *sum_lu_area;		// the total lu area in the lulc cell; NUM_HYDE_TYPES
+	double *lc_agg_area;		// the input lc and lu area in the lulc cell by type, aggregated to sage pot veg; NUM_LULC_TYPES
+	int *leftover_cell_inds;	// the lu cells not assigned a ref veg in the first pass; NUM_LU_CELLS
+	double *refveg_type_area_sum;	// sum of each output ref veg type within the lulc cell; NUM_SAGE_PVLT
+	double *type_area_resid;	// residual area of each ref veg type after the first pass; NUM_SAGE_PVLT
+} lulc_work_struct;
+
+// per-thread scratch space for processing one year in proc_land_type_area()
+typedef struct {
+	float *crop_grid;			// working grid crop area (km^2)
+	float *pasture_grid;		// working grid pasture area (km^2)
+	float *urban_grid;			// working grid urban area (km^2)
+	float **lu_detail_grid;		// working grid area of the rest of the hyde types; dim1=hyde types, dim2=cells
+	float **lulc_temp_grid;		// lulc input area (km^2); dim 1 = land types; dim 2 = grid cells
+	float *refveg_area_grid;	// working grid reference vegetation area (km^2)
+	int *refveg_them_out;		// working grid reference vegetation thematic data
+	int num_cell_threads;		// the number of threads for the lulc cells within the year
+	lulc_work_struct *lulc_work;	// the proc_lulc_area() workspace for each lulc cell thread; dim = num_cell_threads
+	double *chunk_lu_area;		// the lu areas of a chunk of lulc cells; [(chunk cell * NUM_LU_CELLS + lu cell) * NUM_HYDE_TYPES + hyde type]
+	double *chunk_refveg_area;	// the reference veg areas of a chunk of lulc cells; [chunk cell * NUM_LU_CELLS + lu cell]
+	int *chunk_refveg_them;		// the reference veg type values of a chunk of lulc cells; [chunk cell * NUM_LU_CELLS + lu cell]
+	double *global_lulc_in;		// for tracking global area in
+	double *global_lt_out;		// for tracking global area out
+} lta_scratch_struct;
+
+// the sage crop cell values that are recalibrated in calc_harvarea_prod_out_crop_aez()
+typedef struct {
+	int spill;							// 0 = keep the values in memory; 1 = write them to a file per crop
+	int *num_vals;						// the number of stored cells of each crop; dim1 = NUM_SAGE_CROP
+	int **cells;						// the index in land_cells_sage[] of each stored cell, in memory; dim1 = NUM_SAGE_CROP
+	float **area;						// the harvested area (km^2) of each stored cell, in memory; dim1 = NUM_SAGE_CROP
+	float **yield;						// the yield (t/km^2) of each stored cell, in memory; dim1 = NUM_SAGE_CROP
+	int *load_cells;					// read buffer for the spill file cells
+	float *load_area;					// read buffer for the spill file harvested area
+	float *load_yield;					// read buffer for the spill file yield
+} sage_crop_store_struct;
+
+// per-thread crop buffers for processing one crop in calc_harvarea_prod_crop()
+typedef struct {
+	float *harvestarea_in;		// input harvest area (km^2)
+	float *yield_in;			// input yield (metric tonnes / km^2)
+	int *crop_cells;			// the land_cells_sage[] index of each recalibration cell; NULL if not recalibrating
+	float *crop_area;			// the harvested area of each recalibration cell
+	float *crop_yield;			// the yield of each recalibration cell
+} sage_crop_scratch_struct;
+
+// the fields of one csv record, split once by split_fields() and read with the get_*_fld() functions
+typedef struct {
+	int num_fields;				// the number of fields in the current record
+	int max_fields;				// the allocated length of fptr and flen
+	char **fptr;				// the start of each field in the record string
+	int *flen;					// the length of each field, including any bracketing quotes
+} fields_struct;
+
+// a csv output file written through a large buffer by the csv_out_*() functions
+typedef struct {
+	FILE *fp;					// the open output file
+	char *buf;					// the output buffer; CSV_OUT_BUFSIZE characters
+	int len;					// the number of characters in buf
+	int err;					// OK, or ERROR_FILE after a failed write
+} csv_out_struct;
+
 // function declarations
 
 // read raster file functions
@@ -680,13 +817,19 @@ int read_urban(args_struct in_args, rinfo_struct *raster_info);
 int read_country_fao(args_struct in_args, rinfo_struct *raster_info);
 int read_country_gcam(args_struct in_args, rinfo_struct *raster_info);
 int read_region_gcam(args_struct in_args, rinfo_struct *raster_info);
-int read_sage_crop(char *fname, char *sagepath, char *cropfilebase_sage, rinfo_struct raster_info);
+int read_sage_crop(char *fname, char *sagepath, char *cropfilebase_sage, rinfo_struct raster_info, float *harv_out, float *yield_out);
+int save_sage_crop_vals(args_struct in_args, sage_crop_store_struct *store, int cropind, int num_vals, int *cells, float *area, float *yield);
+int load_sage_crop_vals(args_struct in_args, sage_crop_store_struct *store, int cropind, int **cells, float **area, float **yield);
+void free_sage_crop_vals(sage_crop_store_struct *store);
 int read_mirca(char *fname, float *mirca_grid);
 int read_protected(args_struct in_args, rinfo_struct *raster_info);
 int read_lu_hyde(args_struct in_args, int year, float *crop_grid, float *pasture_grid, float *urban_grid);
+int open_lulc_isam(args_struct in_args, int year, int *ncid);
 int read_lulc_isam(args_struct in_args, int year, float **lulc_input_grid);
 int read_lulc_land(args_struct in_args, int year, rinfo_struct *raster_info, int *land_mask_lulc);
 int read_hyde32(args_struct in_args, rinfo_struct *raster_info, int year, float* crop_grid, float* pasture_grid, float* urban_grid, float** lu_detail);
+int read_asc_grid(char *fname, float *grid, int ncells, int *ncols, int *nrows);
+int read_asc_grid_cached(char *fname, float *grid, int ncells);
 //kbn 2020-06-01 Changing soil carbon function below
 int read_soil_carbon(args_struct in_args, rinfo_struct *raster_info);
 //kbn 2020-06-01 Changing veg carbon function below
@@ -711,6 +854,11 @@ int read_water_footprint(char *fname, float *wf_grid);
 
 // raster processing functions
 int get_land_cells(args_struct in_args, rinfo_struct raster_info);
+int get_fao_code_ind(args_struct in_args);
+int get_cell_ctry_aez(args_struct in_args, rinfo_struct raster_info);
+int get_lulc_topology(args_struct in_args);
+int get_potveg_nearest(rinfo_struct raster_info);
+int get_rand_order(args_struct in_args);
 int calc_refveg_area(args_struct in_args, rinfo_struct *raster_info);
 int calc_refcarbon_area(args_struct in_args, rinfo_struct raster_info);
 int get_aez_val(int aez_array[], int index, int nrows, int ncols, int nodata_val, int *value);
@@ -718,8 +866,15 @@ int proc_water_footprint(args_struct in_args, rinfo_struct raster_info);
 
 // additional spatial data processing functions
 int proc_mirca(args_struct in_args, rinfo_struct raster_info);
-int proc_lulc_area(args_struct in_args, rinfo_struct raster_info, double *lulc_area, int *lu_indices, double **lu_area, double *refveg_area_out, int *refveg_them, int num_lu_cells, int lulc_index);
+int proc_lulc_area(args_struct in_args, rinfo_struct raster_info, lulc_work_struct *work, int *lu_indices, int num_lu_cells, int lulc_index);
+int alloc_lulc_work(lulc_work_struct *work);
+void free_lulc_work(lulc_work_struct *work);
 int proc_land_type_area(args_struct in_args, rinfo_struct raster_info);
+int proc_land_type_area_year(args_struct in_args, rinfo_struct raster_info, int year_ind, int *hyde_years, lta_scratch_struct *scratch, double ****area_out);
+int read_lta_inputs(args_struct in_args, rinfo_struct raster_info, int year_ind, int *hyde_years, lta_scratch_struct *scratch);
+int alloc_lta_scratch(lta_scratch_struct *scratch, int num_cell_threads);
+void free_lta_scratch(lta_scratch_struct *scratch);
+int alloc_carbon_buckets(args_struct in_args, rinfo_struct raster_info);
 int proc_refveg_carbon(args_struct in_args, rinfo_struct raster_info);
 int proc_refveg_crop_carbon(args_struct in_args, rinfo_struct raster_info);
 int proc_refveg_pasture_carbon(args_struct in_args, rinfo_struct raster_info);
@@ -728,20 +883,48 @@ int proc_refveg_urban_carbon(args_struct in_args, rinfo_struct raster_info);
 
 
 // text parsing utility functions (parse_utils.c)
-int get_float_field(char *line, const char *delim, int findex, float *fltval);
-int get_int_field(char *line, const char *delim, int findex, int *intval);
-int get_text_field(char *line, const char *delim, int findex, char *str_field);
-int get_field(char *line, const char *delim, int findex, char *str_field);
+int split_fields(char *line, const char *delim, fields_struct *fields);
+int get_float_fld(fields_struct *fields, int findex, float *fltval);
+int get_int_fld(fields_struct *fields, int findex, int *intval);
+int get_text_fld(fields_struct *fields, int findex, char *str_field);
+void free_fields(fields_struct *fields);
+int is_blank(char *str_field);
+
+// buffered csv output functions (csv_out_utils.c)
+int csv_out_open(csv_out_struct *out, FILE *fp);
+void csv_out_rec(csv_out_struct *out, const char *str);
+void csv_out_str(csv_out_struct *out, const char *str);
+void csv_out_int(csv_out_struct *out, int val);
+void csv_out_fixed(csv_out_struct *out, double val, int width, int prec);
+int csv_out_close(csv_out_struct *out);
+
+// stage timing and run report functions (run_report.c)
+void stage_begin(const char *name);
+void stage_end(void);
+int write_run_report(args_struct in_args, const char *in_fname);
+
+// fao data storage functions (fao_data_utils.c)
+int get_fao_years(char *header, const char *delim, int yr1col, int *start_year, int *num_yrs);
+int init_fao_data(fao_data_struct *data, int start_year, int num_yrs);
+int add_fao_rec(fao_data_struct *data, int ctry_ind, int crop_ind, int *rec);
+float get_fao_val(fao_data_struct *data, int ctry_ind, int crop_ind, int year);
+int get_fao_dense(fao_data_struct *data, float **dense);
+void free_fao_data(fao_data_struct *data);
 int rm_whitesp(char *cln_field,char *str_field);
 int rm_quotes(char *cln_field,char *str_field);
 int is_num(char *str_field);
 
 // calculation functions
 int calc_harvarea_prod_out_crop_aez(args_struct in_args, rinfo_struct raster_info);
+int calc_harvarea_prod_crop(args_struct in_args, rinfo_struct raster_info, int cropind, sage_crop_scratch_struct *scratch,
+							sage_crop_store_struct *crop_store, float *country_harvarea, float *diag_harvestarea_crop_aez,
+							float *diag_production_crop_aez, float *diag_pasturearea_aez, float *lost_harvested_area,
+							float *mismatched_harvested_area, float *mismatched_yield, int *mismatched_yield_count);
 int aggregate_crop2gcam(args_struct in_args);
 int calc_rent_ag_use_aez(args_struct in_args, rinfo_struct raster_info);
 int calc_rent_frs_use_aez(args_struct in_args, rinfo_struct raster_info);
 int aggregate_use2gcam(args_struct in_args);
+int calc_carbon_quantiles(float **state_vals, int num_vals, int num_nodata, float *state_out);
 
 // output write functions
 int write_harvestarea_crop_aez(args_struct in_args);
@@ -750,7 +933,9 @@ int write_rent_use_aez(args_struct in_args);
 int write_glu_mapping(args_struct in_args, rinfo_struct raster_info);
 
 // diagnostic write functions
+int write_land_type_area_bin(double ****area_out, int hyde_years[], args_struct in_args);
 int write_raster_float(float out_array[], int out_length, char *out_name, args_struct in_args);
+int write_raster_land_float(float land_vals[], char *out_name, args_struct in_args);
 int write_raster_int(int out_array[], int out_length, char *out_name, args_struct in_args);
 int write_raster_short(short out_array[], int out_length, char *out_name, args_struct in_args);
 int write_text_int(int out_array[], int out_length, char *out_name, args_struct in_args);
@@ -764,7 +949,5 @@ char *get_systime();
 int init_moirai(args_struct *in_args);
 int get_in_args(const char *fname, args_struct *in_args);
 int copy_to_destpath(args_struct in_args);
-// sorting function  that is used with qsort in proc_refveg_carbon.c
-int cmpfunc (const void * a, const void * b);
 
 #endif
@@ -0,0 +1,220 @@
+/**********
+ alloc_carbon_buckets.c
+
+ size and allocate the soil and veg carbon bucket arrays used to calculate the carbon states
+    (median, min, max, q1, q3) for each country X glu X land type in the proc_refveg_*carbon() functions
+
+ a bucket holds the values of all valid hyde land cells for one country X glu X land type category
+    only the unprotected land type categories (protection code 0) of unmanaged, crop, pasture, and urban land
+    are used as buckets; the states are the same for all protection categories of a land type
+    the other bucket pointers are NULL
+
+ two passes:
+    1. count the cells in each bucket over land_cells_hyde[], with the same country/glu selection as proc_refveg_carbon()
+        the counts are stored in soil_carbon_array_cells[ctry][aez][lt_cat]
+    2. allocate one contiguous slab per carbon state for soil and for veg, of the total cell count,
+        and point each bucket into the slabs at its running offset (compressed sparse row layout)
+        soil_carbon_array[ctry][aez][lt_cat][state] and veg_carbon_array[ctry][aez][lt_cat][state]
+        are the bucket start addresses in the slabs, and the bucket values are contiguous
+
+ state 0 (the weighted average) is not stored because it is accumulated separately by area,
+    so its bucket pointers are NULL and its slab is not allocated
+
+ soil_carbon_array_cells[][] must be allocated before calling this function
+ the slabs and pointer arrays are freed in main() after the proc_refveg_*carbon() functions
+
+ arguments:
+ args_struct in_args: the input file arguments
+ rinfo_struct raster_info: information about input raster data
+
+ return value:
+	integer error code: OK = 0, otherwise a non-zero error code
+
+ Created 17 Oct 2026
+
+ Moirai Land Data System (Moirai) Copyright (c) 2019, The
+ Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S.
+ Dept. of Energy).  All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Intellectual Property Office at
+ IPO@lbl.gov.
+
+ NOTICE.  This Software was developed under funding from the U.S. Department
+ of Energy and the U.S. Government consequently retains certain rights.  As
+ such, the U.S. Government has been granted for itself and others acting on
+ its behalf a paid-up, nonexclusive, irrevocable, worldwide license in the
+ Software to reproduce, distribute copies to the public, prepare derivative
+ works, and perform publicly and display publicly, and to permit other to do
+ so.
+
+ This file is part of Moirai.
+
+ Moirai is free software: you can use it under the terms of the modified BSD-3 license (see …/moirai/license.txt)
+
+ **********/
+
+#include "moirai.h"
+
+int alloc_carbon_buckets(args_struct in_args, rinfo_struct raster_info) {
+
+    int i, j, k, l;
+    int grid_ind;               // the index for looping over the raster grid
+    int rv_ind;                 // the index of the current sage reference veg land type
+    int rv_value;               // current ref veg value
+    int aez_val;                // current glu value
+    int ctry_code;              // current fao country code
+    int aez_ind;                // current glu index in ctry_aez_list[ctry_ind]
+    int ctry_ind;               // current country index in ctry_aez_list
+    int cur_lt_cat;             // current land type category
+    int cur_lt_cat_ind;         // current land type category index
+    int num_buckets = 0;        // number of non-empty buckets
+    long num_vals = 0;          // total number of cell values over all buckets
+    long offset = 0;            // running offset of the current bucket in the slabs
+    int bucket_ind = 0;         // running index of the current bucket
+
+    int num_lu_codes = 4;       // the land use codes that have carbon buckets
+    int lu_codes[4] = {0, CROP_LT_CODE, PASTURE_LT_CODE, URBAN_LT_CODE};
+
+    // pass 1: count the cells in each bucket
+    for (j = 0; j < num_land_cells_hyde; j++) {
+        grid_ind = land_cells_hyde[j];
+        aez_val = aez_bounds_new[grid_ind];
+        ctry_code = country_fao[grid_ind];
+
+        if (aez_val == raster_info.aez_new_nodata) {
+            continue;
+        }
+
+        // get the fao country index (serbia and montenegro are merged into scg) from the index raster
+        ctry_ind = cell_ctry_ind[grid_ind];
+
+        if (ctry_ind == NOMATCH || ctry2ctry87codes_gtap[ctry_ind] == NOMATCH) {
+            continue;
+        }
+        
+        // get the glu index within the country glu list from the index raster
+        aez_ind = cell_aez_ind[grid_ind];
+        if (aez_ind == NOMATCH) {
+            fprintf(fplog, "Failed to match aez %i to country %i: alloc_carbon_buckets()\n",aez_val,ctry_code);
+            return ERROR_IND;
+        }
+
+        // get index of sage pot veg; set value to 0 if unknown
+        rv_ind = NOMATCH;
+        if (refvegcarbon_thematic[grid_ind] >= 0 && refvegcarbon_thematic[grid_ind] <= max_sage_code) {
+            rv_ind = sage_code2ind[refvegcarbon_thematic[grid_ind]];
+        }
+        if (rv_ind == NOMATCH) {
+            rv_value = 0;
+        } else {
+            rv_value = refvegcarbon_thematic[grid_ind];
+        }
+
+        // each cell goes into the unprotected bucket of each land use
+        for (l = 0; l < num_lu_codes; l++) {
+            cur_lt_cat = rv_value * SCALE_POTVEG + lu_codes[l];
+            cur_lt_cat_ind = lt_cat_code2ind[cur_lt_cat];
+            if (cur_lt_cat_ind == NOMATCH) {
+                fprintf(fplog, "Failed to match lt_cat %i: alloc_carbon_buckets()\n", cur_lt_cat);
+                return ERROR_IND;
+            }
+            if (soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind] == 0) {
+                num_buckets++;
+            }
+            soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind]++;
+            num_vals++;
+        } // end for l loop over land use codes
+    } // end for j loop over valid hyde land cells
+
+    // pass 2: allocate the slabs and the bucket pointers
+
+    // the state pointers of all buckets are in one block, NUM_CARBON per bucket
+    soil_carbon_bucket_states = calloc((size_t) num_buckets * NUM_CARBON + 1, sizeof(float*));
+    if(soil_carbon_bucket_states == NULL) {
+        fprintf(fplog,"Failed to allocate memory for soil_carbon_bucket_states: alloc_carbon_buckets()\n");
+        return ERROR_MEM;
+    }
+    veg_carbon_bucket_states = calloc((size_t) num_buckets * NUM_CARBON + 1, sizeof(float*));
+    if(veg_carbon_bucket_states == NULL) {
+        fprintf(fplog,"Failed to allocate memory for veg_carbon_bucket_states: alloc_carbon_buckets()\n");
+        return ERROR_MEM;
+    }
+
+    // one slab per carbon state; state 0 is not stored
+    soil_carbon_slab = calloc(NUM_CARBON, sizeof(float*));
+    if(soil_carbon_slab == NULL) {
+        fprintf(fplog,"Failed to allocate memory for soil_carbon_slab: alloc_carbon_buckets()\n");
+        return ERROR_MEM;
+    }
+    veg_carbon_slab = calloc(NUM_CARBON, sizeof(float*));
+    if(veg_carbon_slab == NULL) {
+        fprintf(fplog,"Failed to allocate memory for veg_carbon_slab: alloc_carbon_buckets()\n");
+        return ERROR_MEM;
+    }
+    for (l = 1; l < NUM_CARBON; l++) {
+        soil_carbon_slab[l] = calloc((size_t) num_vals + 1, sizeof(float));
+        if(soil_carbon_slab[l] == NULL) {
+            fprintf(fplog,"Failed to allocate memory for soil_carbon_slab[%i]: alloc_carbon_buckets()\n", l);
+            return ERROR_MEM;
+        }
+        veg_carbon_slab[l] = calloc((size_t) num_vals + 1, sizeof(float));
+        if(veg_carbon_slab[l] == NULL) {
+            fprintf(fplog,"Failed to allocate memory for veg_carbon_slab[%i]: alloc_carbon_buckets()\n", l);
+            return ERROR_MEM;
+        }
+    }
+
+    soil_carbon_array = calloc(NUM_FAO_CTRY, sizeof(float****));
+    if(soil_carbon_array == NULL) {
+        fprintf(fplog,"Failed to allocate memory for soil_carbon_array: alloc_carbon_buckets()\n");
+        return ERROR_MEM;
+    }
+    veg_carbon_array = calloc(NUM_FAO_CTRY, sizeof(float****));
+    if(veg_carbon_array == NULL) {
+        fprintf(fplog,"Failed to allocate memory for veg_carbon_array: alloc_carbon_buckets()\n");
+        return ERROR_MEM;
+    }
+    for (i = 0; i < NUM_FAO_CTRY; i++) {
+        soil_carbon_array[i] = calloc(ctry_aez_num[i], sizeof(float***));
+        if(soil_carbon_array[i] == NULL) {
+            fprintf(fplog,"Failed to allocate memory for soil_carbon_array[%i]: alloc_carbon_buckets()\n", i);
+            return ERROR_MEM;
+        }
+        veg_carbon_array[i] = calloc(ctry_aez_num[i], sizeof(float***));
+        if(veg_carbon_array[i] == NULL) {
+            fprintf(fplog,"Failed to allocate memory for veg_carbon_array[%i]: alloc_carbon_buckets()\n", i);
+            return ERROR_MEM;
+        }
+        for (j = 0; j < ctry_aez_num[i]; j++) {
+            soil_carbon_array[i][j] = calloc(num_lt_cats, sizeof(float**));
+            if(soil_carbon_array[i][j] == NULL) {
+                fprintf(fplog,"Failed to allocate memory for soil_carbon_array[%i][%i]: alloc_carbon_buckets()\n", i, j);
+                return ERROR_MEM;
+            }
+            veg_carbon_array[i][j] = calloc(num_lt_cats, sizeof(float**));
+            if(veg_carbon_array[i][j] == NULL) {
+                fprintf(fplog,"Failed to allocate memory for veg_carbon_array[%i][%i]: alloc_carbon_buckets()\n", i, j);
+                return ERROR_MEM;
+            }
+            for (k = 0; k < num_lt_cats; k++) {
+                if (soil_carbon_array_cells[i][j][k] == 0) {
+                    continue;
+                }
+                soil_carbon_array[i][j][k] = &soil_carbon_bucket_states[bucket_ind * NUM_CARBON];
+                veg_carbon_array[i][j][k] = &veg_carbon_bucket_states[bucket_ind * NUM_CARBON];
+                for (l = 1; l < NUM_CARBON; l++) {
+                    soil_carbon_array[i][j][k][l] = &soil_carbon_slab[l][offset];
+                    veg_carbon_array[i][j][k][l] = &veg_carbon_slab[l][offset];
+                }
+                offset = offset + soil_carbon_array_cells[i][j][k];
+                bucket_ind++;
+            } // end for k loop over land types
+        } // end for j loop over glus
+    } // end for i loop over fao country
+
+    fprintf(fplog, "\nAllocated %i carbon buckets with %li cell values: alloc_carbon_buckets()\n", num_buckets, num_vals);
+
+    return OK;
+}
@@ -0,0 +1,148 @@
+/**********
+ alloc_lta_scratch.c
+
+ allocate the per-thread scratch space used by proc_land_type_area_year() to process one hyde year
+    the working grids hold the hyde inputs and the updated land use/cover grids for the year,
+    and the lulc cell arrays hold the inputs and outputs of proc_lulc_area() for a chunk of NUM_LULC_CHUNK lulc cells
+
+ each thread in proc_land_type_area() gets its own scratch space, so that years can be processed concurrently
+ each lulc cell thread within a year gets its own proc_lulc_area() workspace
+ NUM_LU_CELLS must be set before calling this function
+ the scratch space is freed with free_lta_scratch()
+
+ arguments:
+ lta_scratch_struct *scratch: the scratch space to allocate
+ int num_cell_threads: the number of threads for processing the lulc cells within a year
+
+ return value:
+	integer error code: OK = 0, otherwise a non-zero error code
+
+ Created 17 Oct 2026
+
+ Moirai Land Data System (Moirai) Copyright (c) 2019, The
+ Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S.
+ Dept. of Energy).  All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Intellectual Property Office at
+ IPO@lbl.gov.
+
+ NOTICE.  This Software was developed under funding from the U.S. Department
+ of Energy and the U.S. Government consequently retains certain rights.  As
+ such, the U.S. Government has been granted for itself and others acting on
+ its behalf a paid-up, nonexclusive, irrevocable, worldwide license in the
+ Software to reproduce, distribute copies to the public, prepare derivative
+ works, and perform publicly and display publicly, and to permit other to do
+ so.
+
+ This file is part of Moirai.
+
+ Moirai is free software: you can use it under the terms of the modified BSD-3 license (see …/moirai/license.txt)
+
+ **********/
+
+#include "moirai.h"
+
+int alloc_lta_scratch(lta_scratch_struct *scratch, int num_cell_threads) {
+	
+	int i;
+	int err = OK;		// store error code from the workspace allocation
+	
+	scratch->crop_grid = calloc(NUM_CELLS, sizeof(float));
+	if(scratch->crop_grid == NULL) {
+		fprintf(fplog,"Failed to allocate memory for crop_grid: alloc_lta_scratch()\n");
+		return ERROR_MEM;
+	}
+	scratch->pasture_grid = calloc(NUM_CELLS, sizeof(float));
+	if(scratch->pasture_grid == NULL) {
+		fprintf(fplog,"Failed to allocate memory for pasture_grid: alloc_lta_scratch()\n");
+		return ERROR_MEM;
+	}
+	scratch->urban_grid = calloc(NUM_CELLS, sizeof(float));
+	if(scratch->urban_grid == NULL) {
+		fprintf(fplog,"Failed to allocate memory for urban_grid: alloc_lta_scratch()\n");
+		return ERROR_MEM;
+	}
+	
+	scratch->lu_detail_grid = calloc(NUM_HYDE_TYPES - NUM_HYDE_TYPES_MAIN, sizeof(float*));
+	if(scratch->lu_detail_grid == NULL) {
+		fprintf(fplog,"Failed to allocate memory for lu_detail_grid: alloc_lta_scratch()\n");
+		return ERROR_MEM;
+	}
+	for (i = 0; i < NUM_HYDE_TYPES - NUM_HYDE_TYPES_MAIN; i++) {
+		scratch->lu_detail_grid[i] = calloc(NUM_CELLS, sizeof(float));
+		if(scratch->lu_detail_grid[i] == NULL) {
+			fprintf(fplog,"Failed to allocate memory for lu_detail_grid[%i]: alloc_lta_scratch()\n", i);
+			return ERROR_MEM;
+		}
+	}
+	
+	scratch->lulc_temp_grid = calloc(NUM_LULC_TYPES, sizeof(float*));
+	if(scratch->lulc_temp_grid == NULL) {
+		fprintf(fplog,"Failed to allocate memory for lulc_temp_grid: alloc_lta_scratch()\n");
+		return ERROR_MEM;
+	}
+	for (i = 0; i < NUM_LULC_TYPES; i++) {
+		scratch->lulc_temp_grid[i] = calloc(NUM_CELLS_LULC, sizeof(float));
+		if(scratch->lulc_temp_grid[i] == NULL) {
+			fprintf(fplog,"Failed to allocate memory for lulc_temp_grid[%i]: alloc_lta_scratch()\n", i);
+			return ERROR_MEM;
+		}
+	}
+	
+	scratch->refveg_area_grid = calloc(NUM_CELLS, sizeof(float));
+	if(scratch->refveg_area_grid == NULL) {
+		fprintf(fplog,"Failed to allocate memory for refveg_area_grid: alloc_lta_scratch()\n");
+		return ERROR_MEM;
+	}
+	scratch->refveg_them_out = calloc(NUM_CELLS, sizeof(int));
+	if(scratch->refveg_them_out == NULL) {
+		fprintf(fplog,"Failed to allocate memory for refveg_them_out: alloc_lta_scratch()\n");
+		return ERROR_MEM;
+	}
+	
+	// for proc_lulc_area
+	scratch->num_cell_threads = num_cell_threads;
+	scratch->lulc_work = calloc(num_cell_threads, sizeof(lulc_work_struct));
+	if(scratch->lulc_work == NULL) {
+		fprintf(fplog,"Failed to allocate memory for lulc_work: alloc_lta_scratch()\n");
+		return ERROR_MEM;
+	}
+	for (i = 0; i < num_cell_threads; i++) {
+		if ((err = alloc_lulc_work(&scratch->lulc_work[i])) != OK) {
+			return err;
+		}
+	}
+	
+	// the proc_lulc_area outputs of a chunk of lulc cells, which are added to the output in lulc cell order
+	scratch->chunk_lu_area = calloc((size_t) NUM_LULC_CHUNK * NUM_LU_CELLS * NUM_HYDE_TYPES, sizeof(double));
+	if(scratch->chunk_lu_area == NULL) {
+		fprintf(fplog,"Failed to allocate memory for chunk_lu_area: alloc_lta_scratch()\n");
+		return ERROR_MEM;
+	}
+	scratch->chunk_refveg_area = calloc((size_t) NUM_LULC_CHUNK * NUM_LU_CELLS, sizeof(double));
+	if(scratch->chunk_refveg_area == NULL) {
+		fprintf(fplog,"Failed to allocate memory for chunk_refveg_area: alloc_lta_scratch()\n");
+		return ERROR_MEM;
+	}
+	scratch->chunk_refveg_them = calloc((size_t) NUM_LULC_CHUNK * NUM_LU_CELLS, sizeof(int));
+	if(scratch->chunk_refveg_them == NULL) {
+		fprintf(fplog,"Failed to allocate memory for chunk_refveg_them: alloc_lta_scratch()\n");
+		return ERROR_MEM;
+	}
+	
+	// for tracking global area
+	scratch->global_lt_out = calloc(NUM_SAGE_PVLT + 1 + NUM_HYDE_TYPES, sizeof(double));
+	if(scratch->global_lt_out == NULL) {
+		fprintf(fplog,"Failed to allocate memory for global_lt_out: alloc_lta_scratch()\n");
+		return ERROR_MEM;
+	}
+	scratch->global_lulc_in = calloc(NUM_SAGE_PVLT + 1 + NUM_HYDE_TYPES, sizeof(double));
+	if(scratch->global_lulc_in == NULL) {
+		fprintf(fplog,"Failed to allocate memory for global_lulc_in: alloc_lta_scratch()\n");
+		return ERROR_MEM;
+	}
+	
+	return OK;
+}
@@ -0,0 +1,101 @@
+/**********
+ alloc_lulc_work.c
+
+ allocate the workspace of proc_lulc_area() for a single lulc cell
+    the caller fills lulc_area, lu_area, refveg_area_out and refveg_them for each lulc cell
+    the rest are the internal sums and cell lists of proc_lulc_area(), which resets them on each call
+ the workspace is allocated once and reused for all lulc cells, instead of allocating these arrays on every call
+ each thread needs its own workspace
+
+ lu_area is flat, with the NUM_HYDE_TYPES values of each lu cell contiguous:
+    lu_area[i * NUM_HYDE_TYPES + j] is the area of hyde type j in lu cell i
+
+ NUM_LU_CELLS must be set before calling this function
+ the workspace is freed with free_lulc_work()
+
+ arguments:
+ lulc_work_struct *work: the workspace to allocate
+
+ return value:
+	integer error code: OK = 0, otherwise a non-zero error code
+
+ Created 17 Oct 2026
+
+ Moirai Land Data System (Moirai) Copyright (c) 2019, The
+ Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S.
+ Dept. of Energy).  All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Intellectual Property Office at
+ IPO@lbl.gov.
+
+ NOTICE.  This Software was developed under funding from the U.S. Department
+ of Energy and the U.S. Government consequently retains certain rights.  As
+ such, the U.S. Government has been granted for itself and others acting on
+ its behalf a paid-up, nonexclusive, irrevocable, worldwide license in the
+ Software to reproduce, distribute copies to the public, prepare derivative
+ works, and perform publicly and display publicly, and to permit other to do
+ so.
+
+ This file is part of Moirai.
+
+ Moirai is free software: you can use it under the terms of the modified BSD-3 license (see …/moirai/license.txt)
+
+ **********/
+
+#include "moirai.h"
+
+int alloc_lulc_work(lulc_work_struct *work) {
+	
+	// inputs and outputs for a single lulc cell
+	work->lulc_area = calloc(NUM_LULC_TYPES, sizeof(double));
+	if(work->lulc_area == NULL) {
+		fprintf(fplog,"Failed to allocate memory for lulc_area: alloc_lulc_work()\n");
+		return ERROR_MEM;
+	}
+	work->lu_area = calloc((size_t) NUM_LU_CELLS * NUM_HYDE_TYPES, sizeof(double));
+	if(work->lu_area == NULL) {
+		fprintf(fplog,"Failed to allocate memory for lu_area: alloc_lulc_work()\n");
+		return ERROR_MEM;
+	}
+	work->refveg_area_out = calloc(NUM_LU_CELLS, sizeof(double));
+	if(work->refveg_area_out == NULL) {
+		fprintf(fplog,"Failed to allocate memory for refveg_area_out: alloc_lulc_work()\n");
+		return ERROR_MEM;
+	}
+	work->refveg_them = calloc(NUM_LU_CELLS, sizeof(int));
+	if(work->refveg_them == NULL) {
+		fprintf(fplog,"Failed to allocate memory for refveg_them: alloc_lulc_work()\n");
+		return ERROR_MEM;
+	}
+	
+	// internal to proc_lulc_area
+	work->sum_lu_area = calloc(NUM_HYDE_TYPES, sizeof(double));
+	if(work->sum_lu_area == NULL) {
+		fprintf(fplog,"Failed to allocate memory for sum_lu_area: alloc_lulc_work()\n");
+		return ERROR_MEM;
+	}
+	work->lc_agg_area = calloc(NUM_LULC_TYPES, sizeof(double));
+	if(work->lc_agg_area == NULL) {
+		fprintf(fplog,"Failed to allocate memory for lc_agg_area: alloc_lulc_work()\n");
+		return ERROR_MEM;
+	}
+	work->leftover_cell_inds = calloc(NUM_LU_CELLS, sizeof(int));
+	if(work->leftover_cell_inds == NULL) {
+		fprintf(fplog,"Failed to allocate memory for leftover_cell_inds: alloc_lulc_work()\n");
+		return ERROR_MEM;
+	}
+	work->refveg_type_area_sum = calloc(NUM_SAGE_PVLT, sizeof(double));
+	if(work->refveg_type_area_sum == NULL) {
+		fprintf(fplog,"Failed to allocate memory for refveg_type_area_sum: alloc_lulc_work()\n");
+		return ERROR_MEM;
+	}
+	work->type_area_resid = calloc(NUM_SAGE_PVLT, sizeof(double));
+	if(work->type_area_resid == NULL) {
+		fprintf(fplog,"Failed to allocate memory for type_area_resid: alloc_lulc_work()\n");
+		return ERROR_MEM;
+	}
+	
+	return OK;
+}
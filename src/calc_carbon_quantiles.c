@@ -0,0 +1,132 @@
+/**********
+ calc_carbon_quantiles.c
+
+ calculate the carbon state values (median, min, max, q1, q3) for one country X glu X land type bucket
+    from the complete set of cell values collected for that bucket
+
+ the carbon arrays hold one value per hyde land cell in the bucket for each carbon state
+    state 0 is the weighted average and is not used here (it is accumulated separately by area)
+    states 1-5 are median, min, max, q1, q3 of the source cell distributions
+
+ each returned value is the k-th smallest value of the corresponding state array
+    the NODATA cells sort to the front, so the order statistics are offset by the number of NODATA cells:
+    median = (n - nd) / 2 + nd
+    min = nd
+    max = n - 1
+    q1 = (int) ((n - nd) * 0.25 + nd)
+    q3 = (int) ((n - nd) * 0.75 + nd)
+    where n is the number of cells in the bucket and nd is the number of NODATA cells in the bucket
+    a state value is set to 0 if its index is not within the bucket (all cells NODATA)
+
+ the values are the same as selecting these indices from a fully sorted bucket array,
+    but each bucket is processed once with an in-place quickselect instead of being sorted
+    the state arrays are partially reordered in place
+
+ this replaces the per-cell qsort calls in the proc_refveg_*carbon() functions
+
+ arguments:
+ float **state_vals: the bucket arrays for each carbon state, [NUM_CARBON][num_vals]
+ int num_vals: the number of cells in the bucket
+ int num_nodata: the number of cells in the bucket with NODATA for all of states 1-5
+ float *state_out: the output values, [NUM_CARBON]; element 0 is not changed
+
+ return value:
+	integer error code: OK = 0, otherwise a non-zero error code
+
+ Created 17 Oct 2026
+
+ Moirai Land Data System (Moirai) Copyright (c) 2019, The
+ Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S.
+ Dept. of Energy).  All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Intellectual Property Office at
+ IPO@lbl.gov.
+
+ NOTICE.  This Software was developed under funding from the U.S. Department
+ of Energy and the U.S. Government consequently retains certain rights.  As
+ such, the U.S. Government has been granted for itself and others acting on
+ its behalf a paid-up, nonexclusive, irrevocable, worldwide license in the
+ Software to reproduce, distribute copies to the public, prepare derivative
+ works, and perform publicly and display publicly, and to permit other to do
+ so.
+
+ This file is part of Moirai.
+
+ Moirai is free software: you can use it under the terms of the modified BSD-3 license (see …/moirai/license.txt)
+
+ **********/
+
+#include "moirai.h"
+
+// return the kth smallest value of vals[0..n-1]; vals is partially reordered in place
+// iterative quickselect with median-of-three pivot
+static float select_kth_float(float *vals, int n, int kth) {
+
+    int lo = 0;
+    int hi = n - 1;
+    int mid;
+    int i, j;
+    float pivot;
+    float temp;
+
+    while (hi > lo) {
+        // order lo, mid, hi so that the pivot is the median of the three
+        mid = lo + (hi - lo) / 2;
+        if (vals[mid] < vals[lo]) { temp = vals[mid]; vals[mid] = vals[lo]; vals[lo] = temp; }
+        if (vals[hi] < vals[lo]) { temp = vals[hi]; vals[hi] = vals[lo]; vals[lo] = temp; }
+        if (vals[hi] < vals[mid]) { temp = vals[hi]; vals[hi] = vals[mid]; vals[mid] = temp; }
+        pivot = vals[mid];
+
+        // hoare partition around the pivot value
+        i = lo;
+        j = hi;
+        while (i <= j) {
+            while (vals[i] < pivot) { i++; }
+            while (pivot < vals[j]) { j--; }
+            if (i <= j) {
+                temp = vals[i]; vals[i] = vals[j]; vals[j] = temp;
+                i++;
+                j--;
+            }
+        }
+
+        // keep only the partition that holds kth
+        if (kth <= j) {
+            hi = j;
+        } else if (kth >= i) {
+            lo = i;
+        } else {
+            // kth lies between the partitions, where all values equal the pivot
+            return vals[kth];
+        }
+    } // end while partition
+
+    return vals[kth];
+}
+
+int calc_carbon_quantiles(float **state_vals, int num_vals, int num_nodata, float *state_out) {
+
+    int s;                      // carbon state index
+    int num_valid;              // number of non-NODATA cells in the bucket
+    int state_ind[NUM_CARBON];  // the sorted-array index for each state
+
+    num_valid = num_vals - num_nodata;
+
+    state_ind[1] = num_valid / 2 + num_nodata;                      // median
+    state_ind[2] = num_nodata;                                      // min
+    state_ind[3] = num_vals - 1;                                    // max
+    state_ind[4] = (int) (num_valid * 0.25 + num_nodata);           // q1
+    state_ind[5] = (int) (num_valid * 0.75 + num_nodata);           // q3
+
+    for (s = 1; s < NUM_CARBON; s++) {
+        if (state_ind[s] >= 0 && state_ind[s] < num_vals) {
+            state_out[s] = select_kth_float(state_vals[s], num_vals, state_ind[s]);
+        } else {
+            state_out[s] = 0;
+        }
+    } // end for s loop over carbon states
+
+    return OK;
+}
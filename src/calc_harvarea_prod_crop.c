@@ -0,0 +1,291 @@
+/**********
+ calc_harvarea_prod_crop.c
+ 
+ read the sage yield and harvested area of one crop and add its production and harvested area to the output arrays
+    only cells with both area and yield positive are used
+ this is the per-crop pass of calc_harvarea_prod_out_crop_aez(), which can process the crops concurrently
+ 
+ each crop writes only its own crop elements of the output and diagnostic arrays
+    the cells are added in land cell order, so the sums are the same for any number of threads
+ the first crop (cropind = 0) also aggregates pasture area, stores the countryXglu land mask, and sets the missing glu mask
+ 
+ if scratch->crop_cells is not NULL, the cells with positive area and yield in a valid country X glu are stored
+    with save_sage_crop_vals() for recalibration
+ 
+ arguments:
+ args_struct in_args: the input file arguments
+ rinfo_struct raster_info: info about input raster files
+ int cropind: the sage crop index
+ sage_crop_scratch_struct *scratch: the crop buffers of the current thread
+ sage_crop_store_struct *crop_store: the store for the recalibration cells
+ float *country_harvarea: harvested area (km^2) aggregated to fao country x crop, for recalibration
+ float *diag_harvestarea_crop_aez: diagnostic harvested area (ha) by fao country x crop x glu
+ float *diag_production_crop_aez: diagnostic production (t) by fao country x crop x glu
+ float *diag_pasturearea_aez: diagnostic pasture area (ha) by fao country x glu
+ float *lost_harvested_area: harvested area with no fao country, by crop
+ float *mismatched_harvested_area: harvested area with zero yield, by crop
+ float *mismatched_yield: sum of yield with zero harvested area, by crop
+ int *mismatched_yield_count: number of cells with yield and zero harvested area, by crop
+ 
+ return value:
+ integer error code: OK = 0, otherwise a non-zero error code
+ 
+ Created 17 Oct 2026
+ 
+ Moirai Land Data System (Moirai) Copyright (c) 2019, The
+ Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S.
+ Dept. of Energy).  All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Intellectual Property Office at
+ IPO@lbl.gov.
+
+ NOTICE.  This Software was developed under funding from the U.S. Department
+ of Energy and the U.S. Government consequently retains certain rights.  As
+ such, the U.S. Government has been granted for itself and others acting on
+ its behalf a paid-up, nonexclusive, irrevocable, worldwide license in the
+ Software to reproduce, distribute copies to the public, prepare derivative
+ works, and perform publicly and display publicly, and to permit other to do
+ so.
+
+ This file is part of Moirai.
+
+ Moirai is free software: you can use it under the terms of the modified BSD-3 license (see …/moirai/license.txt)
+
+ **********/
+
+#include "moirai.h"
+
+int calc_harvarea_prod_crop(args_struct in_args, rinfo_struct raster_info, int cropind, sage_crop_scratch_struct *scratch,
+							sage_crop_store_struct *crop_store, float *country_harvarea, float *diag_harvestarea_crop_aez,
+							float *diag_production_crop_aez, float *diag_pasturearea_aez, float *lost_harvested_area,
+							float *mismatched_harvested_area, float *mismatched_yield, int *mismatched_yield_count) {
+	
+	int i;							// looping index
+	int ctry_index;					// fao country index (output fao country index)
+	int aez_index;					// aez index for current aez_val
+	int recal_index;				// the fao_country x sage_crop index for recalibration
+	int cellind;					// index for looping over grid cells
+	int aez_val;					// the glu number for current cell
+	int land_cell;					// the current land cell
+	int all_aez_index;				// for the 1d old-format diagnostic output arrays
+	int diag_index;					// for the 1d old-format diagnostic output arrays
+	int num_vals = 0;				// the number of stored recalibration cells
+	int err = OK;					// error code
+	char fname[MAXCHAR];			// file name to open
+	
+	float *harv_in = scratch->harvestarea_in;	// input harvest area (km^2) of this crop
+	float *yld_in = scratch->yield_in;			// input yield (metric tonnes / km^2) of this crop
+	
+	char bildir[] = "sage/";					// the sage bil subdirectory of the outptus directory
+	char yieldtag[] = "_yield.bil";				// the rest of the output yield file name
+	char harvtag[] = "_harvarea.bil";			// the rest of the output yield file name
+	
+	int serbia_code = 272;			// for merging serbia (272, srb) into serbia and montenegro (186, scg)
+	int montenegro_code = 273;		// for merging montenegro (273, mne) into serbia and montenegro (186, scg)
+	int scg_code = 186;				// the fao code for accessing and storing merged serbia and montenegro (iso3 = scg)
+	
+	// read in yield and harvest area
+	// file units are converted from t/ha to t/km^2 and from fraction of land area to km^2
+	// this function ensures that valid yield and area values exist for sage land cells
+	strcpy(fname, in_args.sagepath);
+	strcat(fname, &cropfilebase_sage[cropind][0]); // the read function will determine whether the file is zipped or not
+	if ((err = read_sage_crop(fname, in_args.sagepath, &cropfilebase_sage[cropind][0], raster_info, harv_in, yld_in))) {
+		fprintf(fplog, "Failed to read yield and area for crop %s: calc_harvarea_prod_crop()\n", fname);
+		return err;
+	}
+	
+	// deprecated diagnostic: write the unit-converted data as bil files
+	// these file are written into a subdirectory of the outputs directory
+	// and currently are not written
+	//if (in_args.diagnostics) {
+	if (0) {
+		strcpy(fname, bildir);
+		strcat(fname, &cropfilebase_sage[cropind][0]);
+		strcat(fname, yieldtag);
+		if ((err = write_raster_float(yld_in, NUM_CELLS, fname, in_args))) {
+			fprintf(fplog, "Failed to write yield raster for crop %s: calc_harvarea_prod_crop()\n", fname);
+			return err;
+		}
+		strcpy(fname, bildir);
+		strcat(fname, &cropfilebase_sage[cropind][0]);
+		strcat(fname, harvtag);
+		if ((err = write_raster_float(harv_in, NUM_CELLS, fname, in_args))) {
+			fprintf(fplog, "Failed to write harvest area raster for crop %s: calc_harvarea_prod_crop()\n", fname);
+			return err;
+		}
+	}
+	
+	// initialize some arrays
+	lost_harvested_area[cropind] = 0;
+	mismatched_harvested_area[cropind] = 0;
+	mismatched_yield[cropind] = 0;
+	mismatched_yield_count[cropind] = 0;
+        
+	// loop over sage land cells
+	// determine fao country, skip if fao country not found
+	// aggregate to fao country for optional calibration
+	// aggregate to land unit (aez within each fao country)
+	for (cellind = 0; cellind < num_land_cells_sage; cellind++) {
+		land_cell = land_cells_sage[cellind];
+		// fao country index
+		if ((int) country_fao[land_cell] != raster_info.country_fao_nodata) {
+			// the index raster has serbia and montenegro merged into scg, but their separate fao index is needed here
+			ctry_index = cell_ctry_ind[land_cell];
+			if ((int) country_fao[land_cell] == serbia_code || (int) country_fao[land_cell] == montenegro_code) {
+				ctry_index = NOMATCH;
+				for (i = 0; i < NUM_FAO_CTRY; i++) {
+					if (countrycodes_fao[i] == (int) country_fao[land_cell]) {
+						ctry_index = i;
+						break;
+					}
+				}	// end for i loop over fao ctry to find fao index
+			}
+		} else {
+			//fprintf(fplog, "No fao country exists for this cell: calc_harvarea_prod_crop(); cellind = %i\n", cellind);
+			lost_harvested_area[cropind] = lost_harvested_area[cropind] + harv_in[land_cell];
+			continue;	// no country associated with these data so don't use this cell and go to the next one
+		}	// end if fao country else no country
+
+		if (ctry_index == NOMATCH) {
+			fprintf(fplog, "Error determining fao country index: calc_harvarea_prod_crop(); cellind = %i\n", cellind);
+			return ERROR_IND;
+		} else {
+			// aggregate to fao country and aez
+                
+			// get the glu number; this function retrieves the nodata value if no associated glu is found
+			// do not use this cell data if there is no associated aez
+			// the missing glu mask is the same for all crops, so only the first crop sets it
+			if (cropind == 0) {
+				if ((err = get_aez_val(aez_bounds_new, land_cell, raster_info.aez_new_nrows,
+									  raster_info.aez_new_ncols, raster_info.aez_new_nodata, &aez_val))) {
+					fprintf(fplog, "Failed to get aez_val for crop %s: calc_harvarea_prod_crop()\n", fname);
+					return err;
+				}
+			} else {
+				aez_val = aez_bounds_new[land_cell];
+			}
+			
+			// store the output values, and aggregate area to fao for recalib
+			if (aez_val != raster_info.aez_new_nodata) {
+                    
+				// data for serbia and montenegro need to be merged for processing
+				if (countrycodes_fao[ctry_index] == serbia_code || countrycodes_fao[ctry_index] == montenegro_code) {
+					for (i = 0; i < NUM_FAO_CTRY; i++) {
+						if (countrycodes_fao[i] == scg_code) {
+							ctry_index = i;
+							break;
+						}
+					}
+				}
+                    
+				// get the current glu index in the complete glu list
+				all_aez_index = NOMATCH;
+				for (i = 0; i < NUM_NEW_AEZ ; i++) {
+					if (aez_codes_new[i] == aez_val) {
+						all_aez_index = i;
+						break;
+					}
+				}
+				if (all_aez_index == NOMATCH) {
+					fprintf(fplog, "Failed to get all_aez_index for crop %s in cellind = %i: calc_harvarea_prod_crop()\n",
+							fname, cellind);
+					return ERROR_IND;
+				}
+                    
+				// get the current glu index in the country list
+				aez_index = cell_aez_ind[land_cell];
+				if (aez_index == NOMATCH) {
+					fprintf(fplog, "Failed to get aez_index for crop %s in cellind = %i: calc_harvarea_prod_crop()\n",
+							fname, cellind);
+					return ERROR_IND;
+				}
+                    
+				// both values for this cell are set to zero if either area or yield are not non-zero, positive values
+				if (harv_in[land_cell] > 0 && yld_in[land_cell] > 0) {
+					harvestarea_crop_aez[ctry_index][aez_index][cropind] =
+						harvestarea_crop_aez[ctry_index][aez_index][cropind] +
+						KMSQ2HA * harv_in[land_cell];
+					production_crop_aez[ctry_index][aez_index][cropind] =
+						production_crop_aez[ctry_index][aez_index][cropind] +
+						harv_in[land_cell] * yld_in[land_cell];
+                        
+					// fill the 1d arrays
+					diag_index = ctry_index * NUM_SAGE_CROP * NUM_NEW_AEZ + cropind * NUM_NEW_AEZ + all_aez_index;
+					diag_harvestarea_crop_aez[diag_index] = diag_harvestarea_crop_aez[diag_index] +
+						KMSQ2HA * harv_in[land_cell];
+					diag_production_crop_aez[diag_index] = diag_production_crop_aez[diag_index] +
+						harv_in[land_cell] * yld_in[land_cell];
+                        
+					// aggregate to fao countries by sage crop, for recalibration; only area is needed here
+					// do this only for data that will be included in the ctryXglu pixel output
+					// and only if both area and yield values are non-zero and positive
+					// all fao indices have valid codes
+					recal_index = ctry_index * NUM_SAGE_CROP + cropind;
+					// to do: left hand operand of + is garbage value???
+					country_harvarea[recal_index] = country_harvarea[recal_index] + harv_in[land_cell];
+					//if (recal_index == 24328) {
+					//    i=-1;
+					//}
+                        
+					// keep this cell for recalibration
+					if (scratch->crop_cells != NULL) {
+						scratch->crop_cells[num_vals] = cellind;
+						scratch->crop_area[num_vals] = harv_in[land_cell];
+						scratch->crop_yield[num_vals] = yld_in[land_cell];
+						num_vals++;
+					}
+                        
+				}else { // end if adding non-zero values from this cell to the total
+					mismatched_harvested_area[cropind] = mismatched_harvested_area[cropind] + harv_in[land_cell];
+					if (yld_in[land_cell] > 0) {
+						mismatched_yield[cropind] = mismatched_yield[cropind] + yld_in[land_cell];
+						mismatched_yield_count[cropind] = mismatched_yield_count[cropind] + 1;
+					}
+				}
+				
+				// these conditions are never true for the current sage data
+				// even before the new test for valid area and yield values above
+				/*
+				if (harvestarea_crop_aez[ctry_index][aez_index][cropind] < 0 ||
+					harvestarea_crop_aez[ctry_index][aez_index][cropind] > 30000000) {
+					fprintf(fplog, "Bad harvestarea_crop_aez = %f output at ctry_index = %i and aez_index = %i and cropind = %i: calc_harvarea_prod_crop()\n",
+							harvestarea_crop_aez[ctry_index][aez_index][cropind], ctry_index, aez_index, cropind);
+				}
+				if (production_crop_aez[ctry_index][aez_index][cropind] < 0 ||
+					production_crop_aez[ctry_index][aez_index][cropind] > 200000000) {
+					fprintf(fplog, "Bad production_crop_aez = %f output at ctry_index = %i and aez_index = %i and cropind = %i: calc_harvarea_prod_crop()\n",
+							production_crop_aez[ctry_index][aez_index][cropind], ctry_index, aez_index, cropind);
+				}
+				 */
+				
+				// only do these once, and if valid pasture are
+				if(cropind == 0 && pasture_area[land_cell] != NODATA) {
+					// pasture
+					pasturearea_aez[ctry_index][aez_index] = pasturearea_aez[ctry_index][aez_index] +
+						KMSQ2HA * pasture_area[land_cell];
+                        
+					// fill the 1d array
+					diag_index = ctry_index * NUM_NEW_AEZ + all_aez_index;
+					diag_pasturearea_aez[diag_index] = diag_pasturearea_aez[diag_index] +
+						KMSQ2HA * pasture_area[land_cell];
+					
+					// store the output countryXaez land mask
+					land_mask_ctryaez[land_cell] = 1;
+				}
+			}	// end if valid aez cell
+		}	// end if aggregating to fao country values
+		
+	}	// end for cellind loop over sage land cells
+	
+	// store the cells for recalibration
+	if (scratch->crop_cells != NULL) {
+		if ((err = save_sage_crop_vals(in_args, crop_store, cropind, num_vals, scratch->crop_cells, scratch->crop_area, scratch->crop_yield))) {
+			fprintf(fplog, "Failed to store yield and area for crop %s: calc_harvarea_prod_crop()\n", fname);
+			return err;
+		}
+	}
+	
+	return OK;
+}
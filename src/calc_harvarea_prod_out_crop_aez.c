@@ -9,6 +9,12 @@
  calibrate yields to a different reference year if desired (calibrate to fao production and harv area)
  the recalibration year is determined by the available fao data and must be consistent with prodprice_fao
   (see read_yield_fao(), read_harvestarea_fao(), read_production_fao(), and read_prodprice_fao())
+ the crops are independent in the first pass, and each crop is processed by calc_harvarea_prod_crop()
+  the crops can be processed concurrently with openmp, with separate crop buffers for each thread
+  the number of threads is in_args.num_threads (0 = all available), limited by in_args.mem_budget_mb
+  each crop writes only its own elements of the output arrays, so the outputs are the same for any number of threads
+ each crop file is read only once; when recalibrating, the first pass stores the area and yield of the cells that are recalibrated
+  in memory or in temporary spill files (in_args.sage_crop_spill; see save_sage_crop_vals()) for the recalibration pass
  
  The diagnostics do show that the 2003-2007 avg fao data are slightly farther from the gtap data than the 1997-2003 fao data
  To figure this out the prod_val_fao and harvest_val_fao need to be calculated once per countryXcrop and stored, and they should be checked in conjunction with each other for consistency
@@ -59,13 +65,11 @@ int calc_harvarea_prod_out_crop_aez(args_struct in_args, rinfo_struct raster_inf
     int in_ctry_index;              // input fao country index in case countries have to be merged (for recalibration)
     int aez_index;                  // aez index for current aez_val
     int recal_index;				// the fao_country x sage_crop index for recalibration
-	int prod_index;					// the index to get the fao production value
+	float fao_val;					// the fao harvest or production value of one year
     int temp_index;                 // temporary index for storing the pre-merged ctry_index (for recalibration)
-	int cellind;					// index for looping over grid cells
 	int cropind;					// index for looping over crops
 	int aez_val;					// the glu number for current cell
 	int land_cell;					// the current land cell
-	char fname[MAXCHAR];			// file name to open
 	
     int all_aez_index;              // for the 1d old-format diagnostic output arrays
     int diag_index;                 // for the 1d old-format diagnostic output arrays
@@ -86,14 +90,10 @@ int calc_harvarea_prod_out_crop_aez(args_struct in_args, rinfo_struct raster_inf
 	float temp_flt = 0;				// float variable for read in
 	double temp_dbl = 0;			// variable for gettin integer part of quotient
 	int start_recalib_year = 0;			// the first year of recalibration average
-	int fao_start_year_index;		// the fao year index of the starting year for averaging
 	
 	int err = OK;								// store error code from the write functions
 	int ncells = NUM_CELLS;						// the number of cells in the aez mask array
 	char out_name[] = "missing_aez_mask.bil";	// diagnositic output raster file name
-	char bildir[] = "sage/";					// the sage bil subdirectory of the outptus directory
-	char yieldtag[] = "_yield.bil";				// the rest of the output yield file name
-	char harvtag[] = "_harvarea.bil";			// the rest of the output yield file name
 	char out_name_prod[] = "production_crop_aez.csv";	// diagnostic output name for production
 	char out_name_harv[] = "harvestarea_crop_aez.csv";	// diagnostic output name for harvested area
 	char out_name_past[] = "pasturearea_aez.csv";	// diagnostic output name for pasture area
@@ -103,8 +103,22 @@ int calc_harvarea_prod_out_crop_aez(args_struct in_args, rinfo_struct raster_inf
     float mismatched_yield[NUM_SAGE_CROP];              // when harvested area=0
     int mismatched_yield_count[NUM_SAGE_CROP];          // to calc the avg mismatched yield
     
-	float *yield_recalib;				// the recalibrated yield for a single crop, if needed
-	float *area_recalib;				// the recalibrated area for a single crop, if needed
+	float *yield_recalib;				// the recalibrated yield of the stored cells of a single crop, if needed
+	float *area_recalib;				// the recalibrated area of the stored cells of a single crop, if needed
+	
+	// the crop cells needed for recalibration are stored in the first pass, so each crop file is read only once
+	
+	// the crops are processed concurrently in the first pass
+	int num_threads = 1;				// the number of threads for processing the crops
+	int max_threads;					// the number of threads allowed by the memory budget
+	double scratch_mb;					// the size (MB) of the crop buffers for one thread
+	sage_crop_scratch_struct *scratch;	// the crop buffers for each thread
+	sage_crop_store_struct crop_store;	// the stored cells of all crops, in memory or in spill files
+	int num_vals = 0;					// the number of stored cells of the current crop
+	int valind;							// index for looping over the stored cells
+	int *store_cells;					// the stored cells of a crop, for recalibration
+	float *store_area;					// the stored harvested area of a crop, for recalibration
+	float *store_yield;					// the stored yield of a crop, for recalibration
 	
     // for now, use the old-format 1d arrays for the diagnostic outputs
     // glu variest fastest, then crop, then country
@@ -138,195 +152,134 @@ int calc_harvarea_prod_out_crop_aez(args_struct in_args, rinfo_struct raster_inf
         return ERROR_MEM;
     }
 	
-	// loop over SAGE crops
-	for (cropind = 0; cropind < NUM_SAGE_CROP; cropind++) {
-		
-		// read in yield and harvest area
-		// file units are converted from t/ha to t/km^2 and from fraction of land area to km^2
-		// this function ensures that valid yield and area values exist for sage land cells
-		strcpy(fname, in_args.sagepath);
-		strcat(fname, &cropfilebase_sage[cropind][0]); // the read function will determine whether the file is zipped or not
-		if ((err = read_sage_crop(fname, in_args.sagepath, &cropfilebase_sage[cropind][0], raster_info))) {
-			fprintf(fplog, "Failed to read yield and area for crop %s: calc_harvarea_prod_out_aez()\n", fname);
-			return err;
+	// the store for the recalibration cells
+	memset(&crop_store, 0, sizeof(crop_store));
+	crop_store.spill = in_args.sage_crop_spill;
+	
+	// determine the number of threads
+	// each thread has its own crop buffers, and read_sage_crop() allocates two more grids (the quality fields)
+	scratch_mb = (double) NUM_CELLS * 4 * sizeof(float) / (1024.0 * 1024.0);
+	if (in_args.out_year_prod_ha_lr != 0) {
+		scratch_mb = scratch_mb + (double) num_land_cells_sage * (sizeof(int) + 2 * sizeof(float)) / (1024.0 * 1024.0);
+	}
+#ifdef _OPENMP
+	if (in_args.num_threads <= 0) {
+		num_threads = omp_get_max_threads();
+	} else {
+		num_threads = in_args.num_threads;
+	}
+#else
+	if (in_args.num_threads != 1) {
+		fprintf(fplog, "Warning: not compiled with openmp, so the crops are processed serially: calc_harvarea_prod_out_aez()\n");
+	}
+#endif
+	if (in_args.mem_budget_mb > 0) {
+		max_threads = (int) (in_args.mem_budget_mb / scratch_mb);
+		if (max_threads < 1) {
+			fprintf(fplog, "Warning: memory budget %i MB is less than the %.0lf MB needed for one thread: calc_harvarea_prod_out_aez()\n",
+					in_args.mem_budget_mb, scratch_mb);
+			max_threads = 1;
 		}
-		
-		// deprecated diagnostic: write the unit-converted data as bil files
-		// these file are written into a subdirectory of the outputs directory
-        // and currently are not written
-		//if (in_args.diagnostics) {
-		if (0) {
-			strcpy(fname, bildir);
-			strcat(fname, &cropfilebase_sage[cropind][0]);
-			strcat(fname, yieldtag);
-			if ((err = write_raster_float(yield_in, NUM_CELLS, fname, in_args))) {
-				fprintf(fplog, "Failed to write yield raster for crop %s: calc_harvarea_prod_out_aez()\n", fname);
-				return err;
+		if (num_threads > max_threads) {
+			num_threads = max_threads;
+		}
+	}
+	if (num_threads > NUM_SAGE_CROP) {
+		num_threads = NUM_SAGE_CROP;
+	}
+	fprintf(fplog, "\nProcessing %i sage crops with %i thread(s), %.0lf MB scratch per thread: calc_harvarea_prod_out_aez()\n",
+			NUM_SAGE_CROP, num_threads, scratch_mb);
+	
+	// the crop buffers for each thread; the first thread uses the global input buffers
+	scratch = calloc(num_threads, sizeof(sage_crop_scratch_struct));
+	if(scratch == NULL) {
+		fprintf(fplog,"Failed to allocate memory for scratch:  calc_harvarea_prod_out_aez()\n");
+		return ERROR_MEM;
+	}
+	for (i = 0; i < num_threads; i++) {
+		if (i == 0) {
+			scratch[i].harvestarea_in = harvestarea_in;
+			scratch[i].yield_in = yield_in;
+		} else {
+			scratch[i].harvestarea_in = calloc(NUM_CELLS, sizeof(float));
+			if(scratch[i].harvestarea_in == NULL) {
+				fprintf(fplog,"Failed to allocate memory for scratch[%i].harvestarea_in:  calc_harvarea_prod_out_aez()\n", i);
+				return ERROR_MEM;
 			}
-			strcpy(fname, bildir);
-			strcat(fname, &cropfilebase_sage[cropind][0]);
-			strcat(fname, harvtag);
-			if ((err = write_raster_float(harvestarea_in, NUM_CELLS, fname, in_args))) {
-				fprintf(fplog, "Failed to write harvest area raster for crop %s: calc_harvarea_prod_out_aez()\n", fname);
-				return err;
+			scratch[i].yield_in = calloc(NUM_CELLS, sizeof(float));
+			if(scratch[i].yield_in == NULL) {
+				fprintf(fplog,"Failed to allocate memory for scratch[%i].yield_in:  calc_harvarea_prod_out_aez()\n", i);
+				return ERROR_MEM;
 			}
 		}
-		
-        // initialize some arrays
-        lost_harvested_area[cropind] = 0;
-        mismatched_harvested_area[cropind] = 0;
-        mismatched_yield[cropind] = 0;
-        mismatched_yield_count[cropind] = 0;
-        
-		// loop over sage land cells
-		// determine fao country, skip if fao country not found
-		// aggregate to fao country for optional calibration
-		// aggregate to land unit (aez within each fao country)
-		for (cellind = 0; cellind < num_land_cells_sage; cellind++) {
-			land_cell = land_cells_sage[cellind];
-			// fao country index
-			if ((int) country_fao[land_cell] != raster_info.country_fao_nodata) {
-				ctry_index = NOMATCH;
-				for (i = 0; i < NUM_FAO_CTRY; i++) {
-					if (countrycodes_fao[i] == (int) country_fao[land_cell]) {
-						ctry_index = i;
-						break;
-					}
-				}	// end for i loop over fao ctry to find fao index
-			} else {
-				//fprintf(fplog, "No fao country exists for this cell: calc_harvarea_prod_out_aez(); cellind = %i\n", cellind);
-                lost_harvested_area[cropind] = lost_harvested_area[cropind] + harvestarea_in[land_cell];
-				continue;	// no country associated with these data so don't use this cell and go to the next one
-			}	// end if fao country else no country
+		// the recalibration cells of the current crop
+		if (in_args.out_year_prod_ha_lr != 0) {
+			scratch[i].crop_cells = calloc(num_land_cells_sage + 1, sizeof(int));
+			if(scratch[i].crop_cells == NULL) {
+				fprintf(fplog,"Failed to allocate memory for scratch[%i].crop_cells:  calc_harvarea_prod_out_aez()\n", i);
+				return ERROR_MEM;
+			}
+			scratch[i].crop_area = calloc(num_land_cells_sage + 1, sizeof(float));
+			if(scratch[i].crop_area == NULL) {
+				fprintf(fplog,"Failed to allocate memory for scratch[%i].crop_area:  calc_harvarea_prod_out_aez()\n", i);
+				return ERROR_MEM;
+			}
+			scratch[i].crop_yield = calloc(num_land_cells_sage + 1, sizeof(float));
+			if(scratch[i].crop_yield == NULL) {
+				fprintf(fplog,"Failed to allocate memory for scratch[%i].crop_yield:  calc_harvarea_prod_out_aez()\n", i);
+				return ERROR_MEM;
+			}
+		}
+	}
 	
-			if (ctry_index == NOMATCH) {
-				fprintf(fplog, "Error determining fao country index: calc_harvarea_prod_out_aez(); cellind = %i\n", cellind);
-				return ERROR_IND;
-            } else {
-                // aggregate to fao country and aez
-                
-				// get the glu number; this function retrieves the nodata value if no associated glu is found
-				// do not use this cell data if there is no associated aez
-				if ((err = get_aez_val(aez_bounds_new, land_cell, raster_info.aez_new_nrows,
-									  raster_info.aez_new_ncols, raster_info.aez_new_nodata, &aez_val))) {
-					fprintf(fplog, "Failed to get aez_val for crop %s: calc_harvarea_prod_out_aez()\n", fname);
-					return err;
-				}
-				
-				// store the output values, and aggregate area to fao for recalib
-				if (aez_val != raster_info.aez_new_nodata) {
-                    
-                    // data for serbia and montenegro need to be merged for processing
-                    if (countrycodes_fao[ctry_index] == serbia_code || countrycodes_fao[ctry_index] == montenegro_code) {
-                        for (i = 0; i < NUM_FAO_CTRY; i++) {
-                            if (countrycodes_fao[i] == scg_code) {
-                                ctry_index = i;
-                                break;
-                            }
-                        }
-                    }
-                    
-                    // get the current glu index in the complete glu list
-                    all_aez_index = NOMATCH;
-                    for (i = 0; i < NUM_NEW_AEZ ; i++) {
-                        if (aez_codes_new[i] == aez_val) {
-                            all_aez_index = i;
-                            break;
-                        }
-                    }
-                    if (all_aez_index == NOMATCH) {
-                        fprintf(fplog, "Failed to get all_aez_index for crop %s in cellind = %i: calc_harvarea_prod_out_aez()\n",
-                                fname, cellind);
-                        return err;
-                    }
-                    
-                    // get the current glu index in the country list
-                    aez_index = NOMATCH;
-                    for (i = 0; i < ctry_aez_num[ctry_index]; i++) {
-                        if (ctry_aez_list[ctry_index][i] == aez_val) {
-                            aez_index = i;
-                            break;
-                        }
-                    }
-                    if (aez_index == NOMATCH) {
-                        fprintf(fplog, "Failed to get aez_index for crop %s in cellind = %i: calc_harvarea_prod_out_aez()\n",
-                                fname, cellind);
-                        return err;
-                    }
-                    
-                    // both values for this cell are set to zero if either area or yield are not non-zero, positive values
-                    if (harvestarea_in[land_cell] > 0 && yield_in[land_cell] > 0) {
-                        harvestarea_crop_aez[ctry_index][aez_index][cropind] =
-                            harvestarea_crop_aez[ctry_index][aez_index][cropind] +
-                            KMSQ2HA * harvestarea_in[land_cell];
-                        production_crop_aez[ctry_index][aez_index][cropind] =
-                            production_crop_aez[ctry_index][aez_index][cropind] +
-                            harvestarea_in[land_cell] * yield_in[land_cell];
-                        
-                        // fill the 1d arrays
-                        diag_index = ctry_index * NUM_SAGE_CROP * NUM_NEW_AEZ + cropind * NUM_NEW_AEZ + all_aez_index;
-                        diag_harvestarea_crop_aez[diag_index] = diag_harvestarea_crop_aez[diag_index] +
-                            KMSQ2HA * harvestarea_in[land_cell];
-                        diag_production_crop_aez[diag_index] = diag_production_crop_aez[diag_index] +
-                            harvestarea_in[land_cell] * yield_in[land_cell];
-                        
-                        // aggregate to fao countries by sage crop, for recalibration; only area is needed here
-                        // do this only for data that will be included in the ctryXglu pixel output
-                        // and only if both area and yield values are non-zero and positive
-                        // all fao indices have valid codes
-                        recal_index = ctry_index * NUM_SAGE_CROP + cropind;
-                        // to do: left hand operand of + is garbage value???
-                        country_harvarea[recal_index] = country_harvarea[recal_index] + harvestarea_in[land_cell];
-                        //if (recal_index == 24328) {
-                        //    i=-1;
-                        //}
-                        
-                    }else { // end if adding non-zero values from this cell to the total
-                        mismatched_harvested_area[cropind] = mismatched_harvested_area[cropind] + harvestarea_in[land_cell];
-                        if (yield_in[land_cell] > 0) {
-                            mismatched_yield[cropind] = mismatched_yield[cropind] + yield_in[land_cell];
-                            mismatched_yield_count[cropind] = mismatched_yield_count[cropind] + 1;
-                        }
-                    }
-					
-					// these conditions are never true for the current sage data
-                    // even before the new test for valid area and yield values above
-					/*
-					if (harvestarea_crop_aez[ctry_index][aez_index][cropind] < 0 ||
-                        harvestarea_crop_aez[ctry_index][aez_index][cropind] > 30000000) {
-						fprintf(fplog, "Bad harvestarea_crop_aez = %f output at ctry_index = %i and aez_index = %i and cropind = %i: calc_harvarea_prod_out_aez()\n",
-								harvestarea_crop_aez[ctry_index][aez_index][cropind], ctry_index, aez_index, cropind);
-					}
-					if (production_crop_aez[ctry_index][aez_index][cropind] < 0 ||
-                        production_crop_aez[ctry_index][aez_index][cropind] > 200000000) {
-						fprintf(fplog, "Bad production_crop_aez = %f output at ctry_index = %i and aez_index = %i and cropind = %i: calc_harvarea_prod_out_aez()\n",
-								production_crop_aez[ctry_index][aez_index][cropind], ctry_index, aez_index, cropind);
-					}
-					 */
-					
-					// only do these once, and if valid pasture are
-					if(cropind == 0 && pasture_area[land_cell] != NODATA) {
-						// pasture
-						pasturearea_aez[ctry_index][aez_index] = pasturearea_aez[ctry_index][aez_index] +
-							KMSQ2HA * pasture_area[land_cell];
-                        
-                        // fill the 1d array
-                        diag_index = ctry_index * NUM_NEW_AEZ + all_aez_index;
-                        diag_pasturearea_aez[diag_index] = diag_pasturearea_aez[diag_index] +
-                            KMSQ2HA * pasture_area[land_cell];
-						
-						// store the output countryXaez land mask
-						land_mask_ctryaez[land_cell] = 1;
-					}
-				}	// end if valid aez cell
-			}	// end if aggregating to fao country values
-			
-		}	// end for cellind loop over sage land cells
+	// loop over SAGE crops
+	// the crops are independent, and each crop is processed by calc_harvarea_prod_crop()
+	// the remaining crops are skipped after an error, and the first error is returned
+#pragma omp parallel for num_threads(num_threads) schedule(dynamic, 1)
+	for (cropind = 0; cropind < NUM_SAGE_CROP; cropind++) {
+		int thread_ind = 0;		// the scratch space index of this thread
+		int cur_err;			// the current error state
+		int crop_err;			// error code for this crop
 		
+#pragma omp atomic read
+		cur_err = err;
+		if (cur_err != OK) {
+			continue;
+		}
+#ifdef _OPENMP
+		thread_ind = omp_get_thread_num();
+#endif
+		crop_err = calc_harvarea_prod_crop(in_args, raster_info, cropind, &scratch[thread_ind], &crop_store, country_harvarea,
+										   diag_harvestarea_crop_aez, diag_production_crop_aez, diag_pasturearea_aez,
+										   lost_harvested_area, mismatched_harvested_area, mismatched_yield, mismatched_yield_count);
+		if (crop_err != OK) {
+#pragma omp critical (harvarea_err)
+			if (err == OK) {
+#pragma omp atomic write
+				err = crop_err;
+			}
+		}
 	}	// end for cropind loop over sage crops
+	
+	for (i = 0; i < num_threads; i++) {
+		if (i != 0) {
+			free(scratch[i].harvestarea_in);
+			free(scratch[i].yield_in);
+		}
+		free(scratch[i].crop_cells);
+		free(scratch[i].crop_area);
+		free(scratch[i].crop_yield);
+	}
+	free(scratch);
+	
+	if (err != OK) {
+		fprintf(fplog, "Failed to process the sage crops: calc_harvarea_prod_out_aez()\n");
+		free_sage_crop_vals(&crop_store);
+		return err;
+	}
     
 	// most efficient way to recalibrate area and yield is to now loop over the crops,
-	//  then the land cells twice within the crop loop
+	//  then the stored crop cells twice within the crop loop
 	//   first to recalibrate area and calculate a new production sum
 	//   second to recalibrate the yield and calculate the output production
 	
@@ -337,27 +290,20 @@ int calc_harvarea_prod_out_crop_aez(args_struct in_args, rinfo_struct raster_inf
 		temp_flt = (float) modf(RECALIB_AVG_PERIOD / 2, &temp_dbl);
 		start_recalib_year = in_args.out_year_prod_ha_lr - (int) temp_dbl;
 		
-		// match the fao data year to the start recalib data year
-		// to get the fao year index for the first averaging year
-		fao_start_year_index = NOMATCH;
-		for (i = 0; i < NUM_FAO_YRS; i++) {
-			if ((FAO_START_YEAR + i) == start_recalib_year) {
-				fao_start_year_index = i;
-				break;
-			}
-		} // end for i loop over fao years
-		if (fao_start_year_index == NOMATCH) {
+		// the fao data have to include the start recalib data year
+		if (start_recalib_year < production_fao.start_year || start_recalib_year >= production_fao.start_year + production_fao.num_yrs ||
+			start_recalib_year < harvestarea_fao.start_year || start_recalib_year >= harvestarea_fao.start_year + harvestarea_fao.num_yrs) {
 			fprintf(fplog,"Recalibrate: Failed to find start FAO data for year %i:  calc_harvarea_prod_out_aez()\n", start_recalib_year);
 			return ERROR_IND;
 		}
 		
 		// allocate recalib area and yield arrays
-		area_recalib = calloc(NUM_CELLS, sizeof(float));
+		area_recalib = calloc(num_land_cells_sage + 1, sizeof(float));
 		if(area_recalib == NULL) {
 			fprintf(fplog,"Recalibrate: Failed to allocate memory for area_recalib:  calc_harvarea_prod_out_aez()\n");
 			return ERROR_MEM;
 		}
-		yield_recalib = calloc(NUM_CELLS, sizeof(float));
+		yield_recalib = calloc(num_land_cells_sage + 1, sizeof(float));
 		if(yield_recalib == NULL) {
 			fprintf(fplog,"Recalibrate: Failed to allocate memory for yield_recalib:  calc_harvarea_prod_out_aez()\n");
 			return ERROR_MEM;
@@ -379,26 +325,27 @@ int calc_harvarea_prod_out_crop_aez(args_struct in_args, rinfo_struct raster_inf
 			diag_harvestarea_crop_aez[i] = 0;
 		}
 		
-		// loop over crops, then cells, so that only two raster loops are needed per crop
+		// loop over crops, then the stored crop cells, so that only two loops over the cells are needed per crop
+		// the crop files are not read again; the stored cells are those with positive area and yield in a valid country X glu
 		// to do: write the recalibrated area and yield data for each crop
 		for (cropind = 0; cropind < NUM_SAGE_CROP; cropind++) {
 			
-			// read in yield and harvest area, again
-			// file units are converted from t/ha to t/km^2 and from fraction of land area to km^2
-			// this function ensures that valid yield and area values exist for sage land cells
-			strcpy(fname, in_args.sagepath);
-			strcat(fname, &cropfilebase_sage[cropind][0]); // the read function will determine whether the file is zipped or not
-			if ((err = read_sage_crop(fname, in_args.sagepath, &cropfilebase_sage[cropind][0], raster_info))) {
-				fprintf(fplog, "Failed to read yield and area for crop %s: calc_harvarea_prod_out_aez()\n", fname);
+			// get the harvest area and yield stored by the first pass
+			if ((err = load_sage_crop_vals(in_args, &crop_store, cropind, &store_cells, &store_area, &store_yield))) {
+				fprintf(fplog, "Failed to load yield and area for crop %s: calc_harvarea_prod_out_aez()\n", &cropfilebase_sage[cropind][0]);
 				return err;
 			}
+			num_vals = crop_store.num_vals[cropind];
 			
 			// area recalibration loop
-			for (cellind = 0; cellind < num_land_cells_sage; cellind++) {
-				land_cell = land_cells_sage[cellind];
-				area_recalib[land_cell] = 0;
+			for (valind = 0; valind < num_vals; valind++) {
+				land_cell = land_cells_sage[store_cells[valind]];
+				area_recalib[valind] = 0;
+				
 				// fao country index
-				if ((int) country_fao[land_cell] != raster_info.country_fao_nodata) {
+				// the index raster has serbia and montenegro merged into scg, but their separate fao index is needed here
+				ctry_index = cell_ctry_ind[land_cell];
+				if ((int) country_fao[land_cell] == serbia_code || (int) country_fao[land_cell] == montenegro_code) {
 					ctry_index = NOMATCH;
 					for (i = 0; i < NUM_FAO_CTRY; i++) {
 						if (countrycodes_fao[i] == (int) country_fao[land_cell]) {
@@ -406,157 +353,131 @@ int calc_harvarea_prod_out_crop_aez(args_struct in_args, rinfo_struct raster_inf
 							break;
 						}
 					}	// end for i loop over fao ctry to find fao index
-				} else {
-					//fprintf(fplog, "No country exists for this cell: calc_harvarea_prod_out_aez(); cellind = %i\n", cellind);
-					continue;	// no country associated with these data so don't use this cell and go to the next one
-				}	// end if fao country else no country
-				
+				}
 				if (ctry_index == NOMATCH) {
-					fprintf(fplog, "Recalibrate: Error determining fao country index: calc_harvarea_prod_out_aez(); cellind = %i\n", cellind);
+					fprintf(fplog, "Recalibrate: Error determining fao country index: calc_harvarea_prod_out_aez(); land_cell = %i\n", land_cell);
 					return ERROR_CALC;
-                } else {
-                    // aggregate to country and aez
-                    
-					// get the glu number; this function retrieves the nodata value if no associated glu is found
-					// do not use this cell data if there is no associated glu
-					if ((err = get_aez_val(aez_bounds_new, land_cell, raster_info.aez_new_nrows,
-										   raster_info.aez_new_ncols, raster_info.aez_new_nodata, &aez_val))) {
-						fprintf(fplog, "Recalibrate: Failed to get aez_val for crop %s: calc_harvarea_prod_out_aez()\n", fname);
-						return err;
+				}
+				aez_val = aez_bounds_new[land_cell];
+				
+				// the fao input data may require a different index than the output data
+				// for example, merging serbia and montenegro
+				temp_index = ctry_index;
+				
+				// data for serbia and montenegro need to be merged for processing
+				// the fao data is separate for these for years > 2005
+				if (countrycodes_fao[ctry_index] == serbia_code || countrycodes_fao[ctry_index] == montenegro_code) {
+					for (i = 0; i < NUM_FAO_CTRY; i++) {
+						if (countrycodes_fao[i] == scg_code) {
+							ctry_index = i;
+							break;
+						}
 					}
-					
-					if (aez_val != raster_info.aez_new_nodata) {
-                        
-                        // use only cells with positve values for area and yield
-                        if (harvestarea_in[land_cell] > 0 && yield_in[land_cell] > 0) {
-							
-							if (cropind == 5 && country_fao[land_cell] == 231) {
-								// maize in usa
-								;
-							}
-							
-                            // the fao input data may require a different index than the output data
-                            // for example, merging serbia and montenegro
-                            temp_index = ctry_index;
-                            
-                            // data for serbia and montenegro need to be merged for processing
-                            // the fao data is separate for these for years > 2005
-                            if (countrycodes_fao[ctry_index] == serbia_code || countrycodes_fao[ctry_index] == montenegro_code) {
-                                for (i = 0; i < NUM_FAO_CTRY; i++) {
-                                    if (countrycodes_fao[i] == scg_code) {
-                                        ctry_index = i;
-                                        break;
-                                    }
-                                }
-                            }
-                            
-                            // this average over years inefficient
-                            // first get the fao area values; average over years if desired
-                            // production is not weighted by area
-                            // keep track of the number of years where there are values
-                            // if there are no fao values, then clear the harvestarea_in value
-                            recal_index = ctry_index * NUM_SAGE_CROP + cropind;
-                            harvest_val_fao = 0;
-                            num_yrs = 0;
-
-                            for (i = 0; i < RECALIB_AVG_PERIOD; i++) {
-                                // serbia and montenegro need to be merged for processing
-                                // the fao data is separate for these for years > 2005
-                                if (countrycodes_fao[ctry_index] == serbia_code || countrycodes_fao[ctry_index] == montenegro_code) {
-                                    if (i <= scg_lastyear_index) {
-                                        // read the merged fao data
-                                        in_ctry_index = ctry_index;
-                                    } else {
-                                        // read the separate fao data
-                                        in_ctry_index = temp_index;
-                                    }
-								} else {
-									in_ctry_index = ctry_index;
-								}
-                                prod_index = in_ctry_index * NUM_SAGE_CROP * NUM_FAO_YRS + cropind * NUM_FAO_YRS + i + fao_start_year_index;
-                                if (harvestarea_fao[prod_index] != 0) {
-                                    harvest_val_fao = harvest_val_fao + harvestarea_fao[prod_index];
-                                    num_yrs = num_yrs + 1;
-                                }
-                            } // end for i loop over average period
-							
-                            if (num_yrs != 0) {
-                                harvest_val_fao = harvest_val_fao / num_yrs;
-                            }
-                            
-                            // now recalibrate the harvest area and recalculate production
-                            // but first check the denominator for abnormally low values (< 100 m^2)
-                            if (country_harvarea[recal_index] != 0) {
-                                if (country_harvarea[recal_index] < 0.0001) {
-                                    fprintf(fplog, "Recalibrate: Bad country_harvarea[%i] = %e value at ctry_index = %i and cropind = %i: calc_harvarea_prod_out_aez()\n",
-                                            recal_index, country_harvarea[recal_index], ctry_index, cropind);
-                                    area_recalib[land_cell] = 0;
-                                } else {
-                                    area_recalib[land_cell] = harvestarea_in[land_cell] * harvest_val_fao / country_harvarea[recal_index];
-                                    country_prod[recal_index] = country_prod[recal_index] +
-                                    area_recalib[land_cell] * yield_in[land_cell];
-                                }
-                            } else {
-                                area_recalib[land_cell] = 0;
-                            }
-                            
-                            // get the current aez index in the complete aez list
-                            all_aez_index = NOMATCH;
-                            for (i = 0; i < NUM_NEW_AEZ ; i++) {
-                                if (aez_codes_new[i] == aez_val) {
-                                    all_aez_index = i;
-                                    break;
-                                }
-                            }
-                            if (all_aez_index == NOMATCH) {
-                                fprintf(fplog, "Failed to get all_aez_index for crop %s for area recalib: calc_harvarea_prod_out_aez()\n", fname);
-                                return err;
-                            }
-                            
-                            // get the current aez index in the country aez list
-                            aez_index = NOMATCH;
-                            for (i = 0; i < ctry_aez_num[ctry_index]; i++) {
-                                if (ctry_aez_list[ctry_index][i] == aez_val) {
-                                    aez_index = i;
-                                    break;
-                                }
-                            }
-                            if (aez_index == NOMATCH) {
-                                fprintf(fplog, "Failed to get aez_index for crop %s for area recalib: calc_harvarea_prod_out_aez()\n", fname);
-                                return err;
-                            }
-                            
-                            // now recalculate the output harvest area
-                            // aggregate to fao country and aez
-                            harvestarea_crop_aez[ctry_index][aez_index][cropind] =
-                                harvestarea_crop_aez[ctry_index][aez_index][cropind] +
-                                KMSQ2HA * area_recalib[land_cell];
-                            
-                            if (harvestarea_crop_aez[ctry_index][aez_index][cropind] < 0 ||
-                                harvestarea_crop_aez[ctry_index][aez_index][cropind] > 30000000) {
-                                fprintf(fplog, "Recalibrate: Bad harvestarea_crop_aez = %f output at ctry_index = %i and aez_index = %i and cropind = %i: calc_harvarea_prod_out_aez()\n",
-                                        harvestarea_crop_aez[ctry_index][aez_index][cropind], ctry_index, aez_index, cropind);
-                            }
-                            
-                            // fill the 1d array
-                            diag_index = ctry_index * NUM_SAGE_CROP * NUM_NEW_AEZ + cropind * NUM_NEW_AEZ + all_aez_index;
-                            diag_harvestarea_crop_aez[diag_index] = diag_harvestarea_crop_aez[diag_index] +
-                            KMSQ2HA * area_recalib[land_cell];
-                            
-                        } // end if area and yield are both positve values for this cell
-						
-					}	// end if valid aez cell for area
-					
-				}	// end if fao country for recalibration of area
+				}
+				
+				// this average over years inefficient
+				// first get the fao area values; average over years if desired
+				// production is not weighted by area
+				// keep track of the number of years where there are values
+				// if there are no fao values, then clear the harvestarea_in value
+				recal_index = ctry_index * NUM_SAGE_CROP + cropind;
+				harvest_val_fao = 0;
+				num_yrs = 0;
+				
+				for (i = 0; i < RECALIB_AVG_PERIOD; i++) {
+					// serbia and montenegro need to be merged for processing
+					// the fao data is separate for these for years > 2005
+					if (countrycodes_fao[ctry_index] == serbia_code || countrycodes_fao[ctry_index] == montenegro_code) {
+						if (i <= scg_lastyear_index) {
+							// read the merged fao data
+							in_ctry_index = ctry_index;
+						} else {
+							// read the separate fao data
+							in_ctry_index = temp_index;
+						}
+					} else {
+						in_ctry_index = ctry_index;
+					}
+					fao_val = get_fao_val(&harvestarea_fao, in_ctry_index, cropind, start_recalib_year + i);
+					if (fao_val != 0) {
+						harvest_val_fao = harvest_val_fao + fao_val;
+						num_yrs = num_yrs + 1;
+					}
+				} // end for i loop over average period
+				
+				if (num_yrs != 0) {
+					harvest_val_fao = harvest_val_fao / num_yrs;
+				}
+				
+				// now recalibrate the harvest area and recalculate production
+				// but first check the denominator for abnormally low values (< 100 m^2)
+				if (country_harvarea[recal_index] != 0) {
+					if (country_harvarea[recal_index] < 0.0001) {
+						fprintf(fplog, "Recalibrate: Bad country_harvarea[%i] = %e value at ctry_index = %i and cropind = %i: calc_harvarea_prod_out_aez()\n",
+								recal_index, country_harvarea[recal_index], ctry_index, cropind);
+						area_recalib[valind] = 0;
+					} else {
+						area_recalib[valind] = store_area[valind] * harvest_val_fao / country_harvarea[recal_index];
+						country_prod[recal_index] = country_prod[recal_index] +
+						area_recalib[valind] * store_yield[valind];
+					}
+				} else {
+					area_recalib[valind] = 0;
+				}
+				
+				// get the current aez index in the complete aez list
+				all_aez_index = NOMATCH;
+				for (i = 0; i < NUM_NEW_AEZ ; i++) {
+					if (aez_codes_new[i] == aez_val) {
+						all_aez_index = i;
+						break;
+					}
+				}
+				if (all_aez_index == NOMATCH) {
+					fprintf(fplog, "Failed to get all_aez_index for crop %s for area recalib: calc_harvarea_prod_out_aez()\n", &cropfilebase_sage[cropind][0]);
+					return ERROR_IND;
+				}
+				
+				// get the current aez index in the country aez list
+				aez_index = cell_aez_ind[land_cell];
+				if (aez_index == NOMATCH) {
+					fprintf(fplog, "Failed to get aez_index for crop %s for area recalib: calc_harvarea_prod_out_aez()\n", &cropfilebase_sage[cropind][0]);
+					return ERROR_IND;
+				}
 				
-			}	// end for cellind loop to recalibrate area
+				// now recalculate the output harvest area
+				// aggregate to fao country and aez
+				harvestarea_crop_aez[ctry_index][aez_index][cropind] =
+					harvestarea_crop_aez[ctry_index][aez_index][cropind] +
+					KMSQ2HA * area_recalib[valind];
+				
+				if (harvestarea_crop_aez[ctry_index][aez_index][cropind] < 0 ||
+					harvestarea_crop_aez[ctry_index][aez_index][cropind] > 30000000) {
+					fprintf(fplog, "Recalibrate: Bad harvestarea_crop_aez = %f output at ctry_index = %i and aez_index = %i and cropind = %i: calc_harvarea_prod_out_aez()\n",
+							harvestarea_crop_aez[ctry_index][aez_index][cropind], ctry_index, aez_index, cropind);
+				}
+				
+				// fill the 1d array
+				diag_index = ctry_index * NUM_SAGE_CROP * NUM_NEW_AEZ + cropind * NUM_NEW_AEZ + all_aez_index;
+				diag_harvestarea_crop_aez[diag_index] = diag_harvestarea_crop_aez[diag_index] +
+				KMSQ2HA * area_recalib[valind];
+				
+			}	// end for valind loop to recalibrate area
 			
 			// now loop again to recalibrate the yields and calculate the output production
-			for (cellind = 0; cellind < num_land_cells_sage; cellind++) {
-				land_cell = land_cells_sage[cellind];
-				yield_recalib[land_cell] = 0;
+			for (valind = 0; valind < num_vals; valind++) {
+				land_cell = land_cells_sage[store_cells[valind]];
+				yield_recalib[valind] = 0;
+				
+				// do this only if the recalibrated area is positive for this cell
+				if (area_recalib[valind] <= 0) {
+					continue;
+				}
+				
 				// fao country index
-				if ((int) country_fao[land_cell] != raster_info.country_fao_nodata) {
+				// the index raster has serbia and montenegro merged into scg, but their separate fao index is needed here
+				ctry_index = cell_ctry_ind[land_cell];
+				if ((int) country_fao[land_cell] == serbia_code || (int) country_fao[land_cell] == montenegro_code) {
 					ctry_index = NOMATCH;
 					for (i = 0; i < NUM_FAO_CTRY; i++) {
 						if (countrycodes_fao[i] == (int) country_fao[land_cell]) {
@@ -564,158 +485,125 @@ int calc_harvarea_prod_out_crop_aez(args_struct in_args, rinfo_struct raster_inf
 							break;
 						}
 					}	// end for i loop over fao ctry to find fao index
-				} else {
-					//fprintf(fplog, "No country exists for this cell: calc_harvarea_prod_out_aez(); cellind = %i\n", cellind);
-					continue;	// no country associated with these data so don't use this cell and go to the next one
-				}	// end if fao country else no country
-				
+				}
 				if (ctry_index == NOMATCH) {
-					fprintf(fplog, "Recalibrate: Error determining fao country index: calc_harvarea_prod_out_aez(); cellind = %i\n", cellind);
+					fprintf(fplog, "Recalibrate: Error determining fao country index: calc_harvarea_prod_out_aez(); land_cell = %i\n", land_cell);
 					return ERROR_CALC;
-                } else {
-					// get the aez number; this function retrieves the nodata value if no associated aez is found
-					// do not use this cell data if there is no associated aez
-					if ((err = get_aez_val(aez_bounds_new, land_cell, raster_info.aez_new_nrows,
-										   raster_info.aez_new_ncols, raster_info.aez_new_nodata, &aez_val))) {
-						fprintf(fplog, "Recalibrate: Failed to get aez_val for crop %s: calc_harvarea_prod_out_aez()\n", fname);
-						return err;
+				}
+				aez_val = aez_bounds_new[land_cell];
+				
+				// the fao input data may require a different index than the output data
+				// for example, merging serbia and montenegro
+				temp_index = ctry_index;
+				
+				// data for serbia and montenegro need to be merged for processing
+				// the fao data is separate for these for years > 2005
+				if (countrycodes_fao[ctry_index] == serbia_code || countrycodes_fao[ctry_index] == montenegro_code) {
+					for (i = 0; i < NUM_FAO_CTRY; i++) {
+						if (countrycodes_fao[i] == scg_code) {
+							ctry_index = i;
+							break;
+						}
 					}
-					if (aez_val != raster_info.aez_new_nodata) {
-                        
-                        // do this only if the area and yield are positive for this cell
-                        if (area_recalib[land_cell] > 0 && yield_in[land_cell] > 0) {
-							
-							if (cropind == 5 && country_fao[land_cell] == 231) {
-								// maize in usa
-								;
-							}
-							
-							// the fao input data may require a different index than the output data
-							// for example, merging serbia and montenegro
-							temp_index = ctry_index;
-							
-							// data for serbia and montenegro need to be merged for processing
-							// the fao data is separate for these for years > 2005
-							if (countrycodes_fao[ctry_index] == serbia_code || countrycodes_fao[ctry_index] == montenegro_code) {
-								for (i = 0; i < NUM_FAO_CTRY; i++) {
-									if (countrycodes_fao[i] == scg_code) {
-										ctry_index = i;
-										break;
-									}
-								}
-							}
-							
-							// this average over years inefficient
-							// first get the fao area values; average over years if desired
-							// production is not weighted by area
-							// keep track of the number of years where there are values
-							// if there are no fao values, then clear the production_in value
-							recal_index = ctry_index * NUM_SAGE_CROP + cropind;
-							prod_val_fao = 0;
-							num_yrs = 0;
-							
-							for (i = 0; i < RECALIB_AVG_PERIOD; i++) {
-								// serbia and montenegro need to be merged for processing
-								// the fao data is separate for these for years > 2005
-								if (countrycodes_fao[ctry_index] == serbia_code || countrycodes_fao[ctry_index] == montenegro_code) {
-									if (i <= scg_lastyear_index) {
-										// read the merged fao data
-										in_ctry_index = ctry_index;
-									} else {
-										// read the separate fao data
-										in_ctry_index = temp_index;
-									}
-								} else {
-									in_ctry_index = ctry_index;
-								}
-								prod_index = in_ctry_index * NUM_SAGE_CROP * NUM_FAO_YRS + cropind * NUM_FAO_YRS + i + fao_start_year_index;
-								if (production_fao[prod_index] != 0) {
-									prod_val_fao = prod_val_fao + production_fao[prod_index];
-									num_yrs = num_yrs + 1;
-								}
-							}
-							if (num_yrs != 0) {
-								prod_val_fao = prod_val_fao / num_yrs;
-							}
-							
-							// now recalibrate the yield
-							// but first check for abnormally low values in the denominator
-							// this treshold is based on 0.1 t / km^2, or 0.001 t / ha, (min fao value is ~0.02 t / ha)
-							// so it is 0.1 t / km^2 * 1 km^2 (which is the ~ size of one grid cell at 89deglat) = 0.1 t
-							if (country_prod[recal_index] != 0) {
-								if (country_prod[recal_index] < 0.1) {
-									fprintf(fplog, "Recalibrate: Bad country_prod[recal_index][%i] = %e value at ctry_index = %i and cropind = %i: calc_harvarea_prod_out_aez()\n",
-											recal_index, country_prod[recal_index], ctry_index, cropind);
-									yield_recalib[land_cell] = 0;
-								} else {
-									yield_recalib[land_cell] = yield_in[land_cell] * prod_val_fao / country_prod[recal_index];
-								}
-							} else {
-								yield_recalib[land_cell] = 0;
-							}
-							
-							// get the current aez index in the complete aez list
-							all_aez_index = NOMATCH;
-							for (i = 0; i < NUM_NEW_AEZ ; i++) {
-								if (aez_codes_new[i] == aez_val) {
-									all_aez_index = i;
-									break;
-								}
-							}
-							if (all_aez_index == NOMATCH) {
-								fprintf(fplog, "Failed to get all_aez_index for crop %s for area recalib: calc_harvarea_prod_out_aez()\n", fname);
-								return err;
-							}
-							
-							// get the current aez index in the country aez list
-							aez_index = NOMATCH;
-							for (i = 0; i < ctry_aez_num[ctry_index]; i++) {
-								if (ctry_aez_list[ctry_index][i] == aez_val) {
-									aez_index = i;
-									break;
-								}
-							}
-							if (aez_index == NOMATCH) {
-								fprintf(fplog, "Failed to get aez_index for crop %s for area recalib: calc_harvarea_prod_out_aez()\n", fname);
-								return err;
-							}
-							
-							// now recalculate the output production
-							// aggregate to fao country and aez
-							
-							production_crop_aez[ctry_index][aez_index][cropind] =
-							production_crop_aez[ctry_index][aez_index][cropind] +
-							area_recalib[land_cell] * yield_recalib[land_cell];
-							
-							// this condition is not hit with the calibration to 2003-2007 avg annual values
-							// even without the preceding filter
-							if (production_crop_aez[ctry_index][aez_index][cropind] < 0 ||
-								production_crop_aez[ctry_index][aez_index][cropind] > 200000000) {
-								fprintf(fplog, "Recalibrate: Bad production_crop_aez = %f output at ctry_index = %i and aez_index = %i and cropind = %i: calc_harvarea_prod_out_aez()\n",
-										production_crop_aez[ctry_index][aez_index][cropind], ctry_index, aez_index, cropind);
-							}
-							
-							// fill the 1d array
-							diag_index = ctry_index * NUM_SAGE_CROP * NUM_NEW_AEZ + cropind * NUM_NEW_AEZ + all_aez_index;
-							diag_production_crop_aez[diag_index] = diag_production_crop_aez[diag_index] +
-							area_recalib[land_cell] * yield_recalib[land_cell];
-							
-						} // end if area and yield are both positive for this cell
-						
-					}	// end if valid aez cell for production/yield
-					
-				}	// end if fao country for recalibration of production/yield
+				}
 				
-			}	// end for cellind loop to recalibrate production/yield
-			
+				// this average over years inefficient
+				// first get the fao area values; average over years if desired
+				// production is not weighted by area
+				// keep track of the number of years where there are values
+				// if there are no fao values, then clear the production_in value
+				recal_index = ctry_index * NUM_SAGE_CROP + cropind;
+				prod_val_fao = 0;
+				num_yrs = 0;
+				
+				for (i = 0; i < RECALIB_AVG_PERIOD; i++) {
+					// serbia and montenegro need to be merged for processing
+					// the fao data is separate for these for years > 2005
+					if (countrycodes_fao[ctry_index] == serbia_code || countrycodes_fao[ctry_index] == montenegro_code) {
+						if (i <= scg_lastyear_index) {
+							// read the merged fao data
+							in_ctry_index = ctry_index;
+						} else {
+							// read the separate fao data
+							in_ctry_index = temp_index;
+						}
+					} else {
+						in_ctry_index = ctry_index;
+					}
+					fao_val = get_fao_val(&production_fao, in_ctry_index, cropind, start_recalib_year + i);
+					if (fao_val != 0) {
+						prod_val_fao = prod_val_fao + fao_val;
+						num_yrs = num_yrs + 1;
+					}
+				}
+				if (num_yrs != 0) {
+					prod_val_fao = prod_val_fao / num_yrs;
+				}
+				
+				// now recalibrate the yield
+				// but first check for abnormally low values in the denominator
+				// this treshold is based on 0.1 t / km^2, or 0.001 t / ha, (min fao value is ~0.02 t / ha)
+				// so it is 0.1 t / km^2 * 1 km^2 (which is the ~ size of one grid cell at 89deglat) = 0.1 t
+				if (country_prod[recal_index] != 0) {
+					if (country_prod[recal_index] < 0.1) {
+						fprintf(fplog, "Recalibrate: Bad country_prod[recal_index][%i] = %e value at ctry_index = %i and cropind = %i: calc_harvarea_prod_out_aez()\n",
+								recal_index, country_prod[recal_index], ctry_index, cropind);
+						yield_recalib[valind] = 0;
+					} else {
+						yield_recalib[valind] = store_yield[valind] * prod_val_fao / country_prod[recal_index];
+					}
+				} else {
+					yield_recalib[valind] = 0;
+				}
+				
+				// get the current aez index in the complete aez list
+				all_aez_index = NOMATCH;
+				for (i = 0; i < NUM_NEW_AEZ ; i++) {
+					if (aez_codes_new[i] == aez_val) {
+						all_aez_index = i;
+						break;
+					}
+				}
+				if (all_aez_index == NOMATCH) {
+					fprintf(fplog, "Failed to get all_aez_index for crop %s for yield recalib: calc_harvarea_prod_out_aez()\n", &cropfilebase_sage[cropind][0]);
+					return ERROR_IND;
+				}
+				
+				// get the current aez index in the country aez list
+				aez_index = cell_aez_ind[land_cell];
+				if (aez_index == NOMATCH) {
+					fprintf(fplog, "Failed to get aez_index for crop %s for yield recalib: calc_harvarea_prod_out_aez()\n", &cropfilebase_sage[cropind][0]);
+					return ERROR_IND;
+				}
+				
+				// now recalculate the output production
+				// aggregate to fao country and aez
+				
+				production_crop_aez[ctry_index][aez_index][cropind] =
+				production_crop_aez[ctry_index][aez_index][cropind] +
+				area_recalib[valind] * yield_recalib[valind];
+				
+				// this condition is not hit with the calibration to 2003-2007 avg annual values
+				// even without the preceding filter
+				if (production_crop_aez[ctry_index][aez_index][cropind] < 0 ||
+					production_crop_aez[ctry_index][aez_index][cropind] > 200000000) {
+					fprintf(fplog, "Recalibrate: Bad production_crop_aez = %f output at ctry_index = %i and aez_index = %i and cropind = %i: calc_harvarea_prod_out_aez()\n",
+							production_crop_aez[ctry_index][aez_index][cropind], ctry_index, aez_index, cropind);
+				}
+				
+				// fill the 1d array
+				diag_index = ctry_index * NUM_SAGE_CROP * NUM_NEW_AEZ + cropind * NUM_NEW_AEZ + all_aez_index;
+				diag_production_crop_aez[diag_index] = diag_production_crop_aez[diag_index] +
+				area_recalib[valind] * yield_recalib[valind];
+				
+			}	// end for valind loop to recalibrate production/yield
 			
 			// to do: this is where each recalibrated crop harvested area and yield can be written
-			if (cropind == 5) {
-				// maize
-				;
-			}
+			
 		}	// end for cropind for area and production recalibration
 		
+		free_sage_crop_vals(&crop_store);
+		
 		free(area_recalib);
 		free(yield_recalib);
 	}	// end if recalibrate
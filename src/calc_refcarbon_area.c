@@ -17,6 +17,9 @@
  this function also sets the cell order for distribution of ref veg within coarse lulc cells,
  because this is the first time the hyde and lulc data are read.
  
+ the lulc cells are processed concurrently with in_args.num_threads threads (0 = all available),
+    because each lulc cell writes only its own working grid cells
+ 
  arguments:
  args_struct in_args:	input argument structure
  rinfo_struct raster_info: information about input raster data
@@ -72,29 +75,20 @@ int calc_refcarbon_area(args_struct in_args, rinfo_struct raster_info) {
 	// all these data are on the same grid already
 	// working units are km^2, based on the sage land area data
 	
-	int i, j, m, n;
+	int i, j, m;
 	int err = OK;			// store error code from the write function
-	int count = 0;			// counting the working grid cells
+	int num_threads = 1;	// the number of threads for processing the lulc cells
 	
 	// should probably retrieve these from the info arrays
 	int urban_ind = 0;		// index in lu_area of urban values
 	int crop_ind = 1;		// index in lu_area of cropland values; may need to find these from an array
 	int pasture_ind = 2;	// index in lu_area of pasture values
 	
-    // hyde land use raster info
-    int ncols = raster_info.lu_ncols;				// num hyde lons
-	
 	// lulc raster info
-	int ncols_lulc = raster_info.lulc_input_ncols;		// num lulc input lons
 	int ncells_lulc = raster_info.lulc_input_ncells;	// number of lulc input cells
 	
 	// used to determine working grid cell indices
 	//int temp_int;			// for setting the random order
-	int num_split = 0;		// number of working grid cells in one dimension of one lulc cell
-	int grid_y_ul;				// row for ul corner working grid cell in lulc cell
-	int grid_x_ul;				// col for ul corner working grid cell in lulc cell
-	double rem_dbl;				// used to get the remainder of a decimal number
-	double int_dbl;				// used to get the integer of a decimal number
 	
 
     //float *crop_grid_carbon;  // 1d array to store current crop data; start up left corner, row by row; lon varies faster
@@ -103,56 +97,35 @@ int calc_refcarbon_area(args_struct in_args, rinfo_struct raster_info) {
 	float **lu_detail_grid;		// for the rest of the hyde types; dim1=hyde types, dim2=cells
 	float **lulc_temp_grid;		// lulc input area (km^2); dim 1 = land types; dim 2 = grid cells
 
-	double *lulc_area;		// array for the lulc areas per type for a single lulc cell
-	double **lu_area;		// array for the lu areas determined for each lulc cell; dim1=NUM_LU_CELLS, dim2 = NUM_HYDE_TYPES
-	int *lu_indices;		// array for the working grid indices for the lu cells for a single lulc cell
-	double *refveg_area_out;		// array for the reference veg areas in each working grid cell, for a single lulc cell
-	int *refveg_them;		// array for the reference veg tyep values in each working grid cell, for a single lulc cell
+	lulc_work_struct *lulc_work;	// the proc_lulc_area() workspace for each thread, which holds the lulc cell arrays
 	
-	double rfarea_check;
-	double luarea_check;
 	
 	
 	
 	
 	
-	num_split = ncols / ncols_lulc;
-	NUM_LU_CELLS = num_split * num_split;
 	
-	
-	// allocate some arrays
-	lulc_area = calloc(NUM_LULC_TYPES, sizeof(double));
-	if(lulc_area == NULL) {
-		fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for lulc_area: calc_refveg_area()\n", get_systime(), ERROR_MEM);
-		return ERROR_MEM;
+	// determine the number of threads for the lulc cells
+#ifdef _OPENMP
+	if (in_args.num_threads <= 0) {
+		num_threads = omp_get_max_threads();
+	} else {
+		num_threads = in_args.num_threads;
 	}
-	lu_area = calloc(NUM_LU_CELLS, sizeof(double*));
-	if(lu_area == NULL) {
-		fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for lu_area: calc_refveg_area()\n", get_systime(), ERROR_MEM);
+#endif
+	
+	// allocate a proc_lulc_area workspace for each thread
+	lulc_work = calloc(num_threads, sizeof(lulc_work_struct));
+	if(lulc_work == NULL) {
+		fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for lulc_work: calc_refcarbon_area()\n", get_systime(), ERROR_MEM);
 		return ERROR_MEM;
 	}
-	for (i = 0; i < NUM_LU_CELLS; i++) {
-		lu_area[i] = calloc(NUM_HYDE_TYPES, sizeof(double));
-		if(lu_area[i] == NULL) {
-			fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for lu_area[%i]: calc_refveg_area()\n", get_systime(), ERROR_MEM, i);
-			return ERROR_MEM;
+	for (i = 0; i < num_threads; i++) {
+		if ((err = alloc_lulc_work(&lulc_work[i])) != OK) {
+			fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate the proc_lulc_area workspace: calc_refcarbon_area()\n", get_systime(), err);
+			return err;
 		}
 	}
-	lu_indices = calloc(NUM_LU_CELLS, sizeof(int));
-	if(lu_indices == NULL) {
-		fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for lu_indices: calc_refveg_area()\n", get_systime(), ERROR_MEM);
-		return ERROR_MEM;
-	}
-	refveg_area_out = calloc(NUM_LU_CELLS, sizeof(double));
-	if(refveg_area_out == NULL) {
-		fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for refveg_area_out: calc_refveg_area()\n", get_systime(), ERROR_MEM);
-		return ERROR_MEM;
-	}
-	refveg_them = calloc(NUM_LU_CELLS, sizeof(float));
-	if(refveg_them == NULL) {
-		fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for refveg_them: calc_refveg_area()\n", get_systime(), ERROR_MEM);
-		return ERROR_MEM;
-	}
 
 	crop_grid_carbon = calloc(NUM_CELLS, sizeof(float));
     if(crop_grid_carbon == NULL) {
@@ -212,7 +185,33 @@ int calc_refcarbon_area(args_struct in_args, rinfo_struct raster_info) {
 	}
 	
 	// loop over the coarse lulc data
+	// each lulc cell writes only its own working grid cells, so the lulc cells are processed concurrently
+#pragma omp parallel for num_threads(num_threads) schedule(dynamic, 64) private(j, m)
 	for (i = 0; i < ncells_lulc; i++) {
+		int thread_ind = 0;		// the workspace index of this thread
+		int cur_err;			// the current error state
+		int cell_err;			// error code for this lulc cell
+		int count;				// counting the working grid cells
+		double *lulc_area;		// array for the lulc areas per type for a single lulc cell
+		double *lu_area;		// array for the lu areas determined for each lulc cell; [lu cell * NUM_HYDE_TYPES + hyde type]
+		int *lu_indices;		// the working grid indices of the lu cells in the current lulc cell, in lulc_child_cells[]
+		double *refveg_area_out;		// array for the reference veg areas in each working grid cell, for a single lulc cell
+		int *refveg_them;		// array for the reference veg tyep values in each working grid cell, for a single lulc cell
+		double rfarea_check;
+		double luarea_check;
+		
+#pragma omp atomic read
+		cur_err = err;
+		if (cur_err != OK) {
+			continue;
+		}
+#ifdef _OPENMP
+		thread_ind = omp_get_thread_num();
+#endif
+		lulc_area = lulc_work[thread_ind].lulc_area;
+		lu_area = lulc_work[thread_ind].lu_area;
+		refveg_area_out = lulc_work[thread_ind].refveg_area_out;
+		refveg_them = lulc_work[thread_ind].refveg_them;
 		
 		//if (in_args.diagnostics) {
 		//	fprintf(fplog, "\nLULC cell %i: calc_refveg_area()\n", i);
@@ -223,39 +222,31 @@ int calc_refcarbon_area(args_struct in_args, rinfo_struct raster_info) {
 			lulc_area[j] = (double) lulc_temp_grid[j][i];
 		}
 		
-		// determine the working grid 1d indices of the lu cells in this lulc cell
-		// first get the upper left corner pixel in terms of rows and columns
-		rem_dbl = fmod((double) i, (double) ncols_lulc);
-		modf((double) (i / ncols_lulc), &int_dbl);
-		grid_y_ul = (int) int_dbl * (num_split);
-		grid_x_ul = (int) rem_dbl * (num_split);
-		// now loop over the working grid cells to store the 1d indices and input areas, and initialize the ref veg values
-		count = 0;
-		for (m = grid_y_ul; m < grid_y_ul + num_split; m++) {
-			for (n = grid_x_ul; n < grid_x_ul + num_split; n++) {
-				lu_indices[count] = m * NUM_LON + n;
-				lu_area[count][urban_ind] = (double) urban_grid_carbon[lu_indices[count]];
-				lu_area[count][crop_ind] = (double) crop_grid_carbon[lu_indices[count]];
-				lu_area[count][pasture_ind] = (double) pasture_grid_carbon[lu_indices[count]];
-				for (j = NUM_HYDE_TYPES_MAIN; j < NUM_HYDE_TYPES; j++) {
-					lu_area[count][j] = (double) lu_detail_grid[j-NUM_HYDE_TYPES_MAIN][lu_indices[count]];
-				}
-				refveg_area_out[count] = 0;
-				refveg_them[count] = 0;
-				count++;
-			} // end for n loop over the columns to set
-		} // end for m loop over the rows to set
-		if (count != NUM_LU_CELLS) {
-			fprintf(fplog, "Failed to get working grid indices for lulc cell %i for reference year: calc_refveg_area()\n", i);
-			return err;
-		}
+		// the working grid 1d indices of the lu cells in this lulc cell are in lulc_child_cells[], from get_lulc_topology()
+		lu_indices = &lulc_child_cells[i * NUM_LU_CELLS];
+		// now loop over the lu cells to gather the input areas, and initialize the ref veg values
+		for (count = 0; count < NUM_LU_CELLS; count++) {
+			lu_area[count * NUM_HYDE_TYPES + urban_ind] = (double) urban_grid_carbon[lu_indices[count]];
+			lu_area[count * NUM_HYDE_TYPES + crop_ind] = (double) crop_grid_carbon[lu_indices[count]];
+			lu_area[count * NUM_HYDE_TYPES + pasture_ind] = (double) pasture_grid_carbon[lu_indices[count]];
+			for (j = NUM_HYDE_TYPES_MAIN; j < NUM_HYDE_TYPES; j++) {
+				lu_area[count * NUM_HYDE_TYPES + j] = (double) lu_detail_grid[j-NUM_HYDE_TYPES_MAIN][lu_indices[count]];
+			}
+			refveg_area_out[count] = 0;
+			refveg_them[count] = 0;
+		} // end for count loop over the lu cells
 		
 		// calculate the areas for this lulc cell
 		// this keeps the hyde land use (but checks it for land consistency), and disaggregates the lc data to the non-lu cell area
-		if ((err = proc_lulc_area(in_args, raster_info, lulc_area, lu_indices, lu_area, refveg_area_out, refveg_them, NUM_LU_CELLS, i)) != OK)
+		if ((cell_err = proc_lulc_area(in_args, raster_info, &lulc_work[thread_ind], lu_indices, NUM_LU_CELLS, i)) != OK)
 		{
-			fprintf(fplog, "Failed to process lulc cell %i for reference year: calc_refveg_area()\n", i);
-			return err;
+			fprintf(fplog, "Failed to process lulc cell %i for reference year: calc_refcarbon_area()\n", i);
+#pragma omp critical (refcarbon_err)
+			if (err == OK) {
+#pragma omp atomic write
+				err = cell_err;
+			}
+			continue;
 		}
 		
 		// store the areas in the appropriate places
@@ -264,17 +255,17 @@ int calc_refcarbon_area(args_struct in_args, rinfo_struct raster_info) {
 		luarea_check = 0;
 		for (j = 0; j < NUM_LU_CELLS; j++) {
 			if (land_area_hyde[lu_indices[j]] != raster_info.land_area_hyde_nodata) {
-				crop_grid_carbon[lu_indices[j]] = (float) lu_area[j][crop_ind];
-				pasture_grid_carbon[lu_indices[j]] = (float) lu_area[j][pasture_ind];
-				urban_grid_carbon[lu_indices[j]] = (float) lu_area[j][urban_ind];
+				crop_grid_carbon[lu_indices[j]] = (float) lu_area[j * NUM_HYDE_TYPES + crop_ind];
+				pasture_grid_carbon[lu_indices[j]] = (float) lu_area[j * NUM_HYDE_TYPES + pasture_ind];
+				urban_grid_carbon[lu_indices[j]] = (float) lu_area[j * NUM_HYDE_TYPES + urban_ind];
 				for (m = NUM_HYDE_TYPES_MAIN; m < NUM_HYDE_TYPES; m++) {
-					lu_detail_grid[m-NUM_HYDE_TYPES_MAIN][lu_indices[j]] = (float) lu_area[j][m];
+					lu_detail_grid[m-NUM_HYDE_TYPES_MAIN][lu_indices[j]] = (float) lu_area[j * NUM_HYDE_TYPES + m];
 				}
 				refcarbon_area[lu_indices[j]] = (float) refveg_area_out[j];
 				refvegcarbon_thematic[lu_indices[j]] = refveg_them[j];
 				
 				rfarea_check = rfarea_check + refveg_area_out[j];
-				luarea_check = luarea_check + lu_area[j][crop_ind] + lu_area[j][pasture_ind] +lu_area[j][urban_ind];
+				luarea_check = luarea_check + lu_area[j * NUM_HYDE_TYPES + crop_ind] + lu_area[j * NUM_HYDE_TYPES + pasture_ind] +lu_area[j * NUM_HYDE_TYPES + urban_ind];
 				
 				
 			} else {
@@ -296,6 +287,15 @@ int calc_refcarbon_area(args_struct in_args, rinfo_struct raster_info) {
 		
 	} // end for i loop over the lulc cells
 	
+	for (i = 0; i < num_threads; i++) {
+		free_lulc_work(&lulc_work[i]);
+	}
+	free(lulc_work);
+	
+	if (err != OK) {
+		return err;
+	}
+	
 	 
 	if (in_args.diagnostics) {
 		// reference vegetation area
@@ -323,14 +323,6 @@ int calc_refcarbon_area(args_struct in_args, rinfo_struct raster_info) {
 
 	}	// end if output diagnostics
 	
-	free(lulc_area);
-	free(refveg_area_out);
-	free(refveg_them);
-	free(lu_indices);
-	for (i = 0; i < NUM_LU_CELLS; i++) {
-		free(lu_area[i]);
-	}
-	free(lu_area);
 	for (i = 0; i < NUM_HYDE_TYPES - NUM_HYDE_TYPES_MAIN; i++) {
 		free(lu_detail_grid[i]);
 	}
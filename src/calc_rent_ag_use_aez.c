@@ -201,13 +201,7 @@ int calc_rent_ag_use_aez(args_struct in_args, rinfo_struct raster_info) {
         for (ctry_ind = 0; ctry_ind < NUM_FAO_CTRY; ctry_ind++) {
             
             // get the land rent region index
-            reglr_ind = NOMATCH;
-            for (i = 0; i < NUM_GTAP_CTRY87; i++) {
-                if (country87codes_gtap[i] == ctry2ctry87codes_gtap[ctry_ind]) {
-                    reglr_ind = i;
-                    break;
-                }
-            }	// end for i loop to get reglr_ind
+            reglr_ind = ctry2ctry87_ind[ctry_ind];
             
             // skip this fao country because it is not part of an economic region and thus not processed for output
             if(reglr_ind == NOMATCH) {
@@ -15,6 +15,10 @@
  As I was unable to obtain the appropriate DGTM value data and forest type and biome data,
 	this algorithm simply redistributes forest land rent to new aez boundaries based on forest area
  
+ the forest cells are bucketed by ctry87 x orig aez with a counting sort: count the cells per bucket, prefix sum the counts
+	into bucket start positions, then fill one flat index array; the cells keep their forest_cells order within each bucket
+ the ctry87 index and the new aez index within a land rent region are direct table lookups
+ 
  Created by Alan Di Vittorio on 26 June 2014
  Completed Aug 2014 by Alan Di Vittorio
  
@@ -54,14 +58,21 @@ int calc_rent_frs_use_aez(args_struct in_args, rinfo_struct raster_info) {
 	int forest_cell_ind;	// index for looping over forest_cells
 	
 	int aez_val;			// the aez number for current cell
+	int ctry87_code;		// the ctry87 code of the current cell
+	int max_ctry87_code;	// the largest ctry87 code, for the size of ctry87_code2ind
+	int max_aez_code;		// the largest new aez code, for the size of aez_code2reglr
+	int total_forest_indices;	// the number of forest cells with a valid orig aez and land rent region
 	int frs_sect = 13;		// the use index for the forest sector
 	int err = OK;
 	
 	float *forest_area;         // forest area per original aez per land rent region (aez vaeries faster) (km^2)
 	float *rent_orig_per_area;	// original rent per forest area per aez per land rent region (aez vaeries faster) (million USD/km^2)
-	int *temp_indices;			// temp array for storing the forest cell indices when lengthening the forest_indices dim2
-	int **forest_indices;		// the forest cell indices per original aez per land rent region (aez vaeries faster); cell indices in dim2
+	int *cell_fa_ind;			// the forest_area index of each forest cell; NOMATCH if the cell is not used
+	int *forest_indices;		// the forest cell indices, grouped by original aez per land rent region (aez vaeries faster)
+	int *forest_start;			// the position in forest_indices of the first cell of each bucket; last element is the total
 	int *num_forest_indices;	// the number of forest cell indices per original aez per land rent region (aez vaeries faster)
+	int *ctry87_code2ind;		// index in country87codes_gtap of each ctry87 code 0 to max_ctry87_code, NOMATCH if none
+	int *aez_code2reglr;		// index in reglr_aez_list[reglr_ind] of each new aez code, for the current land rent region
 	
 	float *newvorigrent87;		// store the new forest rent summed across aezs in USD (i.e. per ctry87, first dim is new, second dim is orig)
 	float *lrout;				// for diagnostic output in USD
@@ -86,25 +97,55 @@ int calc_rent_frs_use_aez(args_struct in_args, rinfo_struct raster_info) {
 		fprintf(fplog,"Failed to allocate memory for num_forest_indices:  calc_rent_frs_use_aez()\n");
 		return ERROR_MEM;
 	}
-	temp_indices = calloc(NUM_CELLS, sizeof(int));
-	if(temp_indices == NULL) {
-		fprintf(fplog,"Failed to allocate memory for temp_indices:  calc_rent_frs_use_aez()\n");
+	cell_fa_ind = calloc(num_forest_cells, sizeof(int));
+	if(cell_fa_ind == NULL) {
+		fprintf(fplog,"Failed to allocate memory for cell_fa_ind:  calc_rent_frs_use_aez()\n");
 		return ERROR_MEM;
 	}
-	forest_indices = calloc(NUM_GTAP_CTRY87 * NUM_ORIG_AEZ, sizeof(int *));
-	if(forest_indices == NULL) {
-		fprintf(fplog,"Failed to allocate memory for dim1 of forest_indices:  calc_rent_frs_use_aez()\n");
+	forest_start = calloc(NUM_GTAP_CTRY87 * NUM_ORIG_AEZ + 1, sizeof(int));
+	if(forest_start == NULL) {
+		fprintf(fplog,"Failed to allocate memory for forest_start:  calc_rent_frs_use_aez()\n");
 		return ERROR_MEM;
 	}
-	// the second dimension will be dynamically reallocated for each dim1 index as needed
-	// but put initial allocation here
-	for (i = 0; i < NUM_GTAP_CTRY87 * NUM_ORIG_AEZ; i++) {
-		forest_indices[i] = calloc(1, sizeof(int));
-		if(forest_indices[i] == NULL) {
-			fprintf(fplog,"Failed to allocate initial dummy memory for forest_indices[i]; i=%i:  calc_rent_frs_use_aez()\n", i);
-			return ERROR_MEM;
+	
+	// direct lookup of the ctry87 index from the ctry87 code
+	max_ctry87_code = 0;
+	for (i = 0; i < NUM_GTAP_CTRY87; i++) {
+		if (country87codes_gtap[i] > max_ctry87_code) {
+			max_ctry87_code = country87codes_gtap[i];
+		}
+	}
+	ctry87_code2ind = calloc(max_ctry87_code + 1, sizeof(int));
+	if(ctry87_code2ind == NULL) {
+		fprintf(fplog,"Failed to allocate memory for ctry87_code2ind:  calc_rent_frs_use_aez()\n");
+		return ERROR_MEM;
+	}
+	for (i = 0; i <= max_ctry87_code; i++) {
+		ctry87_code2ind[i] = NOMATCH;
+	}
+	// the first match is used, as the linear search did
+	for (i = NUM_GTAP_CTRY87 - 1; i >= 0; i--) {
+		if (country87codes_gtap[i] >= 0) {
+			ctry87_code2ind[country87codes_gtap[i]] = i;
 		}
 	}
+	
+	// direct lookup of the new aez index within a land rent region; filled and cleared per land rent region below
+	max_aez_code = 0;
+	for (i = 0; i < NUM_NEW_AEZ; i++) {
+		if (aez_codes_new[i] > max_aez_code) {
+			max_aez_code = aez_codes_new[i];
+		}
+	}
+	aez_code2reglr = calloc(max_aez_code + 1, sizeof(int));
+	if(aez_code2reglr == NULL) {
+		fprintf(fplog,"Failed to allocate memory for aez_code2reglr:  calc_rent_frs_use_aez()\n");
+		return ERROR_MEM;
+	}
+	for (i = 0; i <= max_aez_code; i++) {
+		aez_code2reglr[i] = NOMATCH;
+	}
+	
 	// allocate memory for the diagnostic output
 	newvorigrent87 = calloc(NUM_GTAP_CTRY87 * 2, sizeof(float));
 	if(newvorigrent87 == NULL) {
@@ -117,9 +158,11 @@ int calc_rent_frs_use_aez(args_struct in_args, rinfo_struct raster_info) {
 		return ERROR_MEM;
 	}
 	
-	// loop over forest_cells to calculate forest area per cell and to assign forest cells to reglrxorigaez
+	// loop over forest_cells to calculate forest area per cell and to count the forest cells per reglrxorigaez
 	for (forest_cell_ind = 0; forest_cell_ind < num_forest_cells; forest_cell_ind++) {
 		
+		cell_fa_ind[forest_cell_ind] = NOMATCH;
+		
 		// get the orig aez id; this function retrieves the nodata value if no associated aez is found
 		// do not use this cell data if there is no associated aez
 		if ((err = get_aez_val(aez_bounds_orig, forest_cells[forest_cell_ind], raster_info.aez_orig_nrows,
@@ -129,16 +172,14 @@ int calc_rent_frs_use_aez(args_struct in_args, rinfo_struct raster_info) {
 		}
 		
 		// process this cell only if there is a valid aez id and a valid land rent region code
-		if (aez_val != raster_info.aez_orig_nodata && country87_gtap[forest_cells[forest_cell_ind]] != NODATA) {
+		ctry87_code = country87_gtap[forest_cells[forest_cell_ind]];
+		if (aez_val != raster_info.aez_orig_nodata && ctry87_code != NODATA) {
 			
 			// get reglr index of this cell
 			reglr_ind = NOMATCH;
-			for (i = 0; i < NUM_GTAP_CTRY87; i++) {
-				if (country87codes_gtap[i] == country87_gtap[forest_cells[forest_cell_ind]]) {
-					reglr_ind = i;
-					break;
-				}
-			}	// end for i loop to get reglr_ind
+			if (ctry87_code >= 0 && ctry87_code <= max_ctry87_code) {
+				reglr_ind = ctry87_code2ind[ctry87_code];
+			}
 			if(reglr_ind == NOMATCH) {	// now this should not happen
 				fprintf(fplog,"Failed to find land rent region index:  calc_rent_frs_use_aez()\n");
 				return ERROR_IND;
@@ -151,43 +192,65 @@ int calc_rent_frs_use_aez(args_struct in_args, rinfo_struct raster_info) {
 			fa_ind = reglr_ind * NUM_ORIG_AEZ + aez_ind_orig; // index of the 2d forest_area array
 			forest_area[fa_ind] = forest_area[fa_ind] + refveg_area[forest_cells[forest_cell_ind]];
 			
-			// grow the dim2 as needed, per orig aez and ctry87
-			for (i = 0; i < num_forest_indices[fa_ind]; i++) {
-				temp_indices[i] = forest_indices[fa_ind][i];
-			}
-			free(forest_indices[fa_ind]);
-			forest_indices[fa_ind] = calloc(num_forest_indices[fa_ind] + 1, sizeof(int));
-			if(forest_indices[fa_ind] == NULL) {
-				fprintf(fplog,"Failed to allocate memory for forest_indices[i]; i=%i:  calc_rent_frs_use_aez()\n", i);
-				return ERROR_MEM;
-			}
-			for (i = 0; i < num_forest_indices[fa_ind]; i++) {
-				forest_indices[fa_ind][i] = temp_indices[i];
-			}
-			forest_indices[fa_ind][num_forest_indices[fa_ind]++] = forest_cells[forest_cell_ind];
+			cell_fa_ind[forest_cell_ind] = fa_ind;
+			num_forest_indices[fa_ind]++;
 		
 		}	// end if valid aez cell
 	} // end for forest_cell_ind loop over forest cells
 	
+	// prefix sum of the counts gives the start of each reglrxorigaez bucket in the flat forest_indices array
+	forest_start[0] = 0;
+	for (i = 0; i < NUM_GTAP_CTRY87 * NUM_ORIG_AEZ; i++) {
+		forest_start[i + 1] = forest_start[i] + num_forest_indices[i];
+	}
+	total_forest_indices = forest_start[NUM_GTAP_CTRY87 * NUM_ORIG_AEZ];
+	
+	// add 1 so that the allocation is not zero length when there are no valid forest cells
+	forest_indices = calloc(total_forest_indices + 1, sizeof(int));
+	if(forest_indices == NULL) {
+		fprintf(fplog,"Failed to allocate memory for forest_indices:  calc_rent_frs_use_aez()\n");
+		return ERROR_MEM;
+	}
+	
+	// fill the buckets in forest_cells order, recounting num_forest_indices as the fill position
+	for (i = 0; i < NUM_GTAP_CTRY87 * NUM_ORIG_AEZ; i++) {
+		num_forest_indices[i] = 0;
+	}
+	for (forest_cell_ind = 0; forest_cell_ind < num_forest_cells; forest_cell_ind++) {
+		fa_ind = cell_fa_ind[forest_cell_ind];
+		if (fa_ind != NOMATCH) {
+			forest_indices[forest_start[fa_ind] + num_forest_indices[fa_ind]++] = forest_cells[forest_cell_ind];
+		}
+	}
+	
+	// get the use sector index for forest sector
+	use_ind = NOMATCH;
+	for (i = 0; i < NUM_GTAP_USE; i++) {
+		if (frs_sect == usecodes_gtap[i]) {
+			use_ind = i;
+			break;
+		}
+	}
+	if (use_ind == NOMATCH) {
+		fprintf(fplog,"Failed to find use index for sector %i:  calc_rent_frs_use_aez()\n", frs_sect);
+		return ERROR_IND;
+	}
+	
 	// loop over reglrxorigaez to calculate the land rent per unit of forest area for reglrxorigaez:
 	//	rent_orig_per_area[reglrxorig_aez]=rent_orig_aez[reglrxusexorig_aez] / forest_area[reglrxorig_aez]
 	// also loop over the forest indices to calc rent_use_aez[reglr][newaez][use]:
 	//  rent_use_aez[reglr][newaez][use] =
-	//   rent_use_aez[reglr][newaez][use] + rent_orig_per_area[reglrxorig_aez] * forest_area[forest_indices[fa_ind][i]]
+	//   rent_use_aez[reglr][newaez][use] + rent_orig_per_area[reglrxorig_aez] * forest_area[forest_indices[forest_start[fa_ind] + i]]
 	for (reglr_ind = 0; reglr_ind <  NUM_GTAP_CTRY87; reglr_ind++) {
-		for (aez_ind_orig = 0; aez_ind_orig < NUM_ORIG_AEZ; aez_ind_orig++) {
-			// get the use sector index for forest sector
-			use_ind = NOMATCH;
-			for (i = 0; i < NUM_GTAP_USE; i++) {
-				if (frs_sect == usecodes_gtap[i]) {
-					use_ind = i;
-					break;
-				}
-			}
-			if (use_ind == NOMATCH) {
-				fprintf(fplog,"Failed to find use index for sector %i:  calc_rent_frs_use_aez()\n", frs_sect);
-				return ERROR_IND;
+		
+		// set the new aez lookup for this land rent region; the first match is used, as the linear search did
+		for (j = reglr_aez_num[reglr_ind] - 1; j >= 0; j--) {
+			if (reglr_aez_list[reglr_ind][j] >= 0 && reglr_aez_list[reglr_ind][j] <= max_aez_code) {
+				aez_code2reglr[reglr_aez_list[reglr_ind][j]] = j;
 			}
+		}
+		
+		for (aez_ind_orig = 0; aez_ind_orig < NUM_ORIG_AEZ; aez_ind_orig++) {
 			fa_ind = reglr_ind * NUM_ORIG_AEZ + aez_ind_orig;
 			roa_ind = reglr_ind * NUM_GTAP_USE * NUM_ORIG_AEZ + use_ind * NUM_ORIG_AEZ + aez_ind_orig;
 			
@@ -200,20 +263,17 @@ int calc_rent_frs_use_aez(args_struct in_args, rinfo_struct raster_info) {
 			for (i = 0; i < num_forest_indices[fa_ind]; i++) {
 				// get the new aez id; this function retrieves the nodata value if no associated aez is found
 				// do not use this cell data if there is no associated new aez
-				if ((err = get_aez_val(aez_bounds_new, forest_indices[fa_ind][i], raster_info.aez_new_nrows,
+				if ((err = get_aez_val(aez_bounds_new, forest_indices[forest_start[fa_ind] + i], raster_info.aez_new_nrows,
 									   raster_info.aez_new_ncols, raster_info.aez_new_nodata, &aez_val))) {
-					fprintf(fplog, "Failed to get new aez_val for forest_indices[%i][%i]: calc_rent_frs_use_aez()\n", fa_ind, i);
+					fprintf(fplog, "Failed to get new aez_val for forest bucket %i cell %i: calc_rent_frs_use_aez()\n", fa_ind, i);
 					return err;
 				}
 				if (aez_val != raster_info.aez_new_nodata) {
                     // get the new aez index in this land rent region for this cell
                     aez_ind_reglr = NOMATCH;
-                    for (j = 0; j < reglr_aez_num[reglr_ind]; j++) {
-                        if (reglr_aez_list[reglr_ind][j] == aez_val) {
-                            aez_ind_reglr = j;
-                            break;
-                        }
-                    }	// end for i loop to get reglr_ind
+                    if (aez_val >= 0 && aez_val <= max_aez_code) {
+                        aez_ind_reglr = aez_code2reglr[aez_val];
+                    }
                     if(aez_ind_reglr == NOMATCH) {	// now this should not happen
                         fprintf(fplog,"Failed to find aez index for land rent region index %i:  calc_rent_frs_use_aez()\n",
                                 reglr_ind);
@@ -221,11 +281,11 @@ int calc_rent_frs_use_aez(args_struct in_args, rinfo_struct raster_info) {
                     }
 
                     rent_use_aez[reglr_ind][aez_ind_reglr][use_ind] = rent_use_aez[reglr_ind][aez_ind_reglr][use_ind] +
-						rent_orig_per_area[fa_ind] * refveg_area[forest_indices[fa_ind][i]];
+						rent_orig_per_area[fa_ind] * refveg_area[forest_indices[forest_start[fa_ind] + i]];
                     
 					// for diagnostic output in USD, new in the first dim
 					newvorigrent87[reglr_ind * 2] = newvorigrent87[reglr_ind * 2] +
-						MIL2ONE * rent_orig_per_area[fa_ind] * refveg_area[forest_indices[fa_ind][i]];
+						MIL2ONE * rent_orig_per_area[fa_ind] * refveg_area[forest_indices[forest_start[fa_ind] + i]];
 				} // end if valid new aez value
 			}	// end for i loop over forest_indices to calc rent_use_aez
 			
@@ -271,6 +331,13 @@ int calc_rent_frs_use_aez(args_struct in_args, rinfo_struct raster_info) {
             
         } // end for loop over the new aezs in this land rent region to fill the diagnostic array
         
+        // clear the new aez lookup for the next land rent region
+        for (j = 0; j < reglr_aez_num[reglr_ind]; j++) {
+            if (reglr_aez_list[reglr_ind][j] >= 0 && reglr_aez_list[reglr_ind][j] <= max_aez_code) {
+                aez_code2reglr[reglr_aez_list[reglr_ind][j]] = NOMATCH;
+            }
+        }
+        
 	}	// end for reglr_ind loop to calc rent_orig_per_area
 
 
@@ -294,11 +361,11 @@ int calc_rent_frs_use_aez(args_struct in_args, rinfo_struct raster_info) {
 	
 	free(newvorigrent87);
 	free(forest_area);
-	for (i = 0; i < NUM_GTAP_CTRY87 * NUM_ORIG_AEZ; i++) {
-		free(forest_indices[i]);
-	}
 	free(forest_indices);
-	free(temp_indices);
+	free(forest_start);
+	free(cell_fa_ind);
+	free(ctry87_code2ind);
+	free(aez_code2reglr);
 	free(num_forest_indices);
 	free(lrout);
     free(rent_orig_per_area);
@@ -115,16 +115,30 @@ int copy_to_destpath(args_struct in_args) {
         return ERROR_COPY;
     }
     
-    // land type area
-    strcpy(fname, in_args.outpath);
-    strcat(fname, in_args.land_type_area_fname);
-    strcpy(sys_string, cp_str);
-    strcat(sys_string, fname);
-    strcat(sys_string, space_str);
-    strcat(sys_string, in_args.ldsdestpath);
-    if((err = system(sys_string)) == -1) {
-        fprintf(fplog, "\nError copying file %s to %s\n", fname, in_args.ldsdestpath);
-        return ERROR_COPY;
+    // land type area; the csv and/or binary file, as written
+    if (in_args.land_type_area_format != 2) {
+        strcpy(fname, in_args.outpath);
+        strcat(fname, in_args.land_type_area_fname);
+        strcpy(sys_string, cp_str);
+        strcat(sys_string, fname);
+        strcat(sys_string, space_str);
+        strcat(sys_string, in_args.ldsdestpath);
+        if((err = system(sys_string)) == -1) {
+            fprintf(fplog, "\nError copying file %s to %s\n", fname, in_args.ldsdestpath);
+            return ERROR_COPY;
+        }
+    }
+    if (in_args.land_type_area_format != 0) {
+        strcpy(fname, in_args.outpath);
+        strcat(fname, in_args.land_type_area_bin_fname);
+        strcpy(sys_string, cp_str);
+        strcat(sys_string, fname);
+        strcat(sys_string, space_str);
+        strcat(sys_string, in_args.ldsdestpath);
+        if((err = system(sys_string)) == -1) {
+            fprintf(fplog, "\nError copying file %s to %s\n", fname, in_args.ldsdestpath);
+            return ERROR_COPY;
+        }
     }
     
     // reference vegetation carbon
@@ -0,0 +1,223 @@
+/**********
+ csv_out_utils.c
+ 
+ contains the following functions for writing the csv output records through a large buffer (csv_out_struct):
+	csv_out_open() - attaches the buffer to an open file; the header lines can be written with fprintf() before this
+	csv_out_rec() - starts a new record ("\n%s")
+	csv_out_str() - appends a text field (",%s")
+	csv_out_int() - appends an integer field (",%i")
+	csv_out_fixed() - appends a fixed point field (",%<width>.<prec>f")
+	csv_out_close() - flushes the buffer, closes the file, and frees the buffer
+ 
+ the fields are formatted directly, without interpreting a format string, and are the same bytes as fprintf() writes
+	a fixed point value is rounded to the nearest, ties to even, as printf() does
+	when a value cannot be formatted exactly in double arithmetic (e.g., it is within rounding error of a tie,
+	too large, or not finite) snprintf() formats it
+ 
+ a failed write is kept in the struct and returned by csv_out_close(), so the append functions do not return a code
+ 
+ Created 17 Oct 2026
+ 
+ Moirai Land Data System (Moirai) Copyright (c) 2019, The
+ Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S.
+ Dept. of Energy).  All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Intellectual Property Office at
+ IPO@lbl.gov.
+
+ NOTICE.  This Software was developed under funding from the U.S. Department
+ of Energy and the U.S. Government consequently retains certain rights.  As
+ such, the U.S. Government has been granted for itself and others acting on
+ its behalf a paid-up, nonexclusive, irrevocable, worldwide license in the
+ Software to reproduce, distribute copies to the public, prepare derivative
+ works, and perform publicly and display publicly, and to permit other to do
+ so.
+
+ This file is part of Moirai.
+
+ Moirai is free software: you can use it under the terms of the modified BSD-3 license (see …/moirai/license.txt)
+
+ **********/
+
+
+#include "moirai.h"
+
+// powers of ten for the fixed point fractions
+static const double csv_pow10[] = {1.0, 1.0e1, 1.0e2, 1.0e3, 1.0e4, 1.0e5, 1.0e6, 1.0e7, 1.0e8, 1.0e9};
+
+// write the buffer to the file and empty it
+static void csv_out_flush(csv_out_struct *out) {
+	if (out->len > 0 && out->err == OK) {
+		if (fwrite(out->buf, sizeof(char), out->len, out->fp) != (size_t) out->len) {
+			out->err = ERROR_FILE;
+		}
+	}
+	out->len = 0;
+}
+
+// make room for num_chars more characters; num_chars must be at most CSV_OUT_BUFSIZE
+static void csv_out_reserve(csv_out_struct *out, int num_chars) {
+	if (out->len + num_chars > CSV_OUT_BUFSIZE) {
+		csv_out_flush(out);
+	}
+}
+
+// append a string of any length
+static void csv_out_append(csv_out_struct *out, const char *str, int slen) {
+	int nchars;
+	while (slen > 0) {
+		csv_out_reserve(out, 1);
+		nchars = CSV_OUT_BUFSIZE - out->len;
+		if (nchars > slen) {
+			nchars = slen;
+		}
+		memcpy(&out->buf[out->len], str, nchars);
+		out->len = out->len + nchars;
+		str = str + nchars;
+		slen = slen - nchars;
+	}
+}
+
+// write the digits of val in reverse order to digits[]; return the number of digits
+static int csv_out_digits(unsigned long long val, char *digits) {
+	int ndigits = 0;
+	do {
+		digits[ndigits++] = (char) ('0' + val % 10);
+		val = val / 10;
+	} while (val > 0);
+	return ndigits;
+}
+
+int csv_out_open(csv_out_struct *out, FILE *fp) {
+	out->fp = fp;
+	out->len = 0;
+	out->err = OK;
+	out->buf = malloc(CSV_OUT_BUFSIZE);
+	if (out->buf == NULL) {
+		fprintf(fplog,"Failed to allocate memory for the csv output buffer: csv_out_open()\n");
+		return ERROR_MEM;
+	}
+	return OK;
+}
+
+void csv_out_rec(csv_out_struct *out, const char *str) {
+	csv_out_reserve(out, 1);
+	out->buf[out->len++] = '\n';
+	csv_out_append(out, str, (int) strlen(str));
+}
+
+void csv_out_str(csv_out_struct *out, const char *str) {
+	csv_out_reserve(out, 1);
+	out->buf[out->len++] = ',';
+	csv_out_append(out, str, (int) strlen(str));
+}
+
+void csv_out_int(csv_out_struct *out, int val) {
+	
+	char digits[24];		// the digits in reverse order
+	int ndigits;
+	unsigned long long uval;
+	
+	csv_out_reserve(out, 32);
+	out->buf[out->len++] = ',';
+	if (val < 0) {
+		out->buf[out->len++] = '-';
+		uval = (unsigned long long) (-(long long) val);
+	} else {
+		uval = (unsigned long long) val;
+	}
+	ndigits = csv_out_digits(uval, digits);
+	while (ndigits > 0) {
+		out->buf[out->len++] = digits[--ndigits];
+	}
+}
+
+void csv_out_fixed(csv_out_struct *out, double val, int width, int prec) {
+	
+	char digits[24];		// the integer digits in reverse order
+	char field[64];			// the formatted field
+	int ndigits;
+	int flen = 0;			// the length of the formatted field
+	int i;
+	int negative;
+	double abs_val;
+	double int_part;		// the integer part of abs_val
+	double frac;			// the fraction of abs_val scaled by 10^prec
+	double frac_int;		// frac rounded to an integer
+	unsigned long long int_out, frac_out;
+	
+	negative = signbit(val) ? 1 : 0;
+	abs_val = fabs(val);
+	
+	// the integer part and the scaled fraction are exact below 2^53; the scaled fraction has an error
+	//	of at most 10^prec * 2^-53, so it is rounded here only if it is not that close to a tie
+	if (prec >= 0 && prec <= 9 && width < 32 && isfinite(val) && abs_val < 9007199254740992.0) {
+		if (prec == 0) {
+			// round the whole value so that a tie goes to the even integer
+			int_part = nearbyint(abs_val);
+			frac = 0;
+		} else {
+			int_part = floor(abs_val);
+			frac = (abs_val - int_part) * csv_pow10[prec];
+		}
+		frac_int = nearbyint(frac);
+		if (prec == 0 || fabs(frac - floor(frac) - 0.5) > 1.0e-6) {
+			int_out = (unsigned long long) int_part;
+			frac_out = (unsigned long long) frac_int;
+			if (frac_int >= csv_pow10[prec]) {
+				int_out++;
+				frac_out = 0;
+			}
+			if (negative) {
+				field[flen++] = '-';
+			}
+			ndigits = csv_out_digits(int_out, digits);
+			while (ndigits > 0) {
+				field[flen++] = digits[--ndigits];
+			}
+			if (prec > 0) {
+				field[flen++] = '.';
+				for (i = prec - 1; i >= 0; i--) {
+					field[flen + i] = (char) ('0' + frac_out % 10);
+					frac_out = frac_out / 10;
+				}
+				flen = flen + prec;
+			}
+		}
+	}
+	
+	// the value could not be formatted exactly here
+	if (flen == 0) {
+		flen = snprintf(field, sizeof(field), "%.*f", prec, val);
+		if (flen < 0 || flen >= (int) sizeof(field)) {
+			// a very large value; format it to the file directly
+			csv_out_str(out, "");
+			csv_out_flush(out);
+			if (out->err == OK && fprintf(out->fp, "%*.*f", width, prec, val) < 0) {
+				out->err = ERROR_FILE;
+			}
+			return;
+		}
+	}
+	
+	csv_out_reserve(out, 1 + width + flen);
+	out->buf[out->len++] = ',';
+	for (i = flen; i < width; i++) {
+		out->buf[out->len++] = ' ';
+	}
+	memcpy(&out->buf[out->len], field, flen);
+	out->len = out->len + flen;
+}
+
+int csv_out_close(csv_out_struct *out) {
+	csv_out_flush(out);
+	if (fclose(out->fp) != 0) {
+		out->err = ERROR_FILE;
+	}
+	free(out->buf);
+	out->buf = NULL;
+	out->fp = NULL;
+	return out->err;
+}
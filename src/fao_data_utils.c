@@ -0,0 +1,240 @@
+/**********
+ fao_data_utils.c
+ 
+ contains the following functions for the sparse storage of the annual fao data (fao_data_struct):
+	get_fao_years() - reads the year range from the header of an fao file
+	init_fao_data()
+	add_fao_rec()
+	get_fao_val()
+	get_fao_dense() - expands the data to a full country X crop X year array for diagnostic output
+	free_fao_data()
+ 
+ the records are stored in the order they are read, and rec_ind[] gives the record of each fao country X sage crop
+	so the memory is proportional to the records in the file rather than to all the countries and crops
+ 
+ Created 17 Oct 2026
+ 
+ Moirai Land Data System (Moirai) Copyright (c) 2019, The
+ Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S.
+ Dept. of Energy).  All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Intellectual Property Office at
+ IPO@lbl.gov.
+
+ NOTICE.  This Software was developed under funding from the U.S. Department
+ of Energy and the U.S. Government consequently retains certain rights.  As
+ such, the U.S. Government has been granted for itself and others acting on
+ its behalf a paid-up, nonexclusive, irrevocable, worldwide license in the
+ Software to reproduce, distribute copies to the public, prepare derivative
+ works, and perform publicly and display publicly, and to permit other to do
+ so.
+
+ This file is part of Moirai.
+
+ Moirai is free software: you can use it under the terms of the modified BSD-3 license (see …/moirai/license.txt)
+
+ **********/
+
+
+#include "moirai.h"
+
+/********
+ int get_fao_years(char *header, const char *delim, int yr1col, int *start_year, int *num_yrs)
+ header:		the header record of the fao file
+ delim:			the delimiting character
+ yr1col:		the column of the first year--this must start at one
+ start_year:	the address for storing the first year
+ num_yrs:		the address for storing the number of years
+ return:		error code
+ note:			the year columns alternate with flag columns, starting at yr1col
+ note:			a year column name is the year, possibly with a non-numeric prefix such as Y
+ note:			the years must be contiguous and in order; the first column without a year ends the list
+ ********/
+int get_fao_years(char *header, const char *delim, int yr1col, int *start_year, int *num_yrs)
+{
+	int err = OK;
+	int col;					// the current year column
+	int year;					// the year of the current column
+	char str_field[MAXCHAR];	// the current column name
+	char *cptr;					// the start of the year in the column name
+	fields_struct fields = {0, 0, NULL, NULL};	// the fields of the header
+	
+	if((err = split_fields(header, delim, &fields)) != OK) {
+		fprintf(fplog, "Error processing fao header: get_fao_years(); field split\n");
+		return err;
+	}
+	
+	*start_year = NODATA;
+	*num_yrs = 0;
+	for (col = yr1col; col <= fields.num_fields; col += 2) {
+		if((err = get_text_fld(&fields, col, str_field)) != OK) {
+			fprintf(fplog, "Error processing fao header: get_fao_years(); column=%i\n", col);
+			free_fields(&fields);
+			return err;
+		}
+		// skip the prefix and quotes
+		cptr = str_field;
+		while (*cptr && !isdigit((int) *cptr)) {
+			cptr++;
+		}
+		if (!*cptr) {
+			break;
+		}
+		year = atoi(cptr);
+		if (*num_yrs == 0) {
+			*start_year = year;
+		} else if (year != *start_year + *num_yrs) {
+			fprintf(fplog, "Error processing fao header: get_fao_years(); year %i in column %i is not %i\n",
+					year, col, *start_year + *num_yrs);
+			free_fields(&fields);
+			return ERROR_FILE;
+		}
+		(*num_yrs)++;
+	}
+	free_fields(&fields);
+	
+	if (*num_yrs == 0) {
+		fprintf(fplog, "Error processing fao header: get_fao_years(); no years starting at column %i\n", yr1col);
+		return ERROR_FILE;
+	}
+	
+	return OK;
+}
+
+/********
+ int init_fao_data(fao_data_struct *data, int start_year, int num_yrs)
+ data:			the fao data to initialize, with no records
+ start_year:	the first year of the data
+ num_yrs:		the number of years of the data
+ return:		error code
+ ********/
+int init_fao_data(fao_data_struct *data, int start_year, int num_yrs)
+{
+	int i;
+	
+	data->start_year = start_year;
+	data->num_yrs = num_yrs;
+	data->num_recs = 0;
+	data->max_recs = 0;
+	data->vals = NULL;
+	data->rec_ind = calloc(NUM_FAO_CTRY * NUM_SAGE_CROP, sizeof(int));
+	if(data->rec_ind == NULL) {
+		fprintf(fplog,"Failed to allocate memory for rec_ind: init_fao_data()\n");
+		return ERROR_MEM;
+	}
+	for (i = 0; i < NUM_FAO_CTRY * NUM_SAGE_CROP; i++) {
+		data->rec_ind[i] = NOMATCH;
+	}
+	
+	return OK;
+}
+
+/********
+ int add_fao_rec(fao_data_struct *data, int ctry_ind, int crop_ind, int *rec)
+ data:		the fao data, from init_fao_data()
+ ctry_ind:	the fao country index
+ crop_ind:	the sage crop index
+ rec:		the address for storing the record of this country X crop
+ return:	error code
+ note:		a new record has zero values; an existing record is returned as is, so a repeated record overwrites it
+ note:		the values of the record are &data->vals[*rec * data->num_yrs], which can move when a record is added
+ ********/
+int add_fao_rec(fao_data_struct *data, int ctry_ind, int crop_ind, int *rec)
+{
+	int cc_ind = ctry_ind * NUM_SAGE_CROP + crop_ind;	// the country X crop index
+	float *tmp_vals;		// for growing the values array
+	
+	if (data->rec_ind[cc_ind] != NOMATCH) {
+		*rec = data->rec_ind[cc_ind];
+		return OK;
+	}
+	
+	if (data->num_recs == data->max_recs) {
+		if (data->max_recs == 0) {
+			data->max_recs = 1024;
+		} else {
+			data->max_recs = 2 * data->max_recs;
+		}
+		tmp_vals = realloc(data->vals, (size_t) data->max_recs * data->num_yrs * sizeof(float));
+		if(tmp_vals == NULL) {
+			fprintf(fplog,"Failed to allocate memory for %i records: add_fao_rec()\n", data->max_recs);
+			return ERROR_MEM;
+		}
+		data->vals = tmp_vals;
+	}
+	
+	*rec = data->num_recs++;
+	data->rec_ind[cc_ind] = *rec;
+	memset(&data->vals[(size_t) *rec * data->num_yrs], 0, data->num_yrs * sizeof(float));
+	
+	return OK;
+}
+
+/********
+ float get_fao_val(fao_data_struct *data, int ctry_ind, int crop_ind, int year)
+ data:		the fao data
+ ctry_ind:	the fao country index
+ crop_ind:	the sage crop index
+ year:		the data year
+ return:	the value; 0 if the country X crop is not in the file or the year is not in the file
+ ********/
+float get_fao_val(fao_data_struct *data, int ctry_ind, int crop_ind, int year)
+{
+	int rec;		// the record of this country X crop
+	
+	if (data->rec_ind == NULL || year < data->start_year || year >= data->start_year + data->num_yrs) {
+		return 0;
+	}
+	rec = data->rec_ind[ctry_ind * NUM_SAGE_CROP + crop_ind];
+	if (rec == NOMATCH) {
+		return 0;
+	}
+	
+	return data->vals[(size_t) rec * data->num_yrs + year - data->start_year];
+}
+
+/********
+ int get_fao_dense(fao_data_struct *data, float **dense)
+ data:		the fao data
+ dense:		the address for storing the allocated full array; the caller frees it
+			year varies fastest, then crop, then fao country
+ return:	error code
+ ********/
+int get_fao_dense(fao_data_struct *data, float **dense)
+{
+	int i, j;
+	int rec;		// the record of the current country X crop
+	
+	*dense = calloc((size_t) NUM_FAO_CTRY * NUM_SAGE_CROP * data->num_yrs, sizeof(float));
+	if(*dense == NULL) {
+		fprintf(fplog,"Failed to allocate memory for dense: get_fao_dense()\n");
+		return ERROR_MEM;
+	}
+	for (i = 0; i < NUM_FAO_CTRY * NUM_SAGE_CROP; i++) {
+		rec = data->rec_ind[i];
+		if (rec == NOMATCH) {
+			continue;
+		}
+		for (j = 0; j < data->num_yrs; j++) {
+			(*dense)[(size_t) i * data->num_yrs + j] = data->vals[(size_t) rec * data->num_yrs + j];
+		}
+	}
+	
+	return OK;
+}
+
+/********
+ void free_fao_data(fao_data_struct *data)
+ data:		the fao data to free
+ ********/
+void free_fao_data(fao_data_struct *data)
+{
+	free(data->rec_ind);
+	free(data->vals);
+	data->rec_ind = NULL;
+	data->vals = NULL;
+	data->num_recs = 0;
+	data->max_recs = 0;
+}
@@ -0,0 +1,62 @@
+/**********
+ free_lta_scratch.c
+
+ free the per-thread scratch space allocated by alloc_lta_scratch()
+
+ arguments:
+ lta_scratch_struct *scratch: the scratch space to free
+
+ Created 17 Oct 2026
+
+ Moirai Land Data System (Moirai) Copyright (c) 2019, The
+ Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S.
+ Dept. of Energy).  All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Intellectual Property Office at
+ IPO@lbl.gov.
+
+ NOTICE.  This Software was developed under funding from the U.S. Department
+ of Energy and the U.S. Government consequently retains certain rights.  As
+ such, the U.S. Government has been granted for itself and others acting on
+ its behalf a paid-up, nonexclusive, irrevocable, worldwide license in the
+ Software to reproduce, distribute copies to the public, prepare derivative
+ works, and perform publicly and display publicly, and to permit other to do
+ so.
+
+ This file is part of Moirai.
+
+ Moirai is free software: you can use it under the terms of the modified BSD-3 license (see …/moirai/license.txt)
+
+ **********/
+
+#include "moirai.h"
+
+void free_lta_scratch(lta_scratch_struct *scratch) {
+	
+	int i;
+	
+	free(scratch->crop_grid);
+	free(scratch->pasture_grid);
+	free(scratch->urban_grid);
+	for (i = 0; i < NUM_HYDE_TYPES - NUM_HYDE_TYPES_MAIN; i++) {
+		free(scratch->lu_detail_grid[i]);
+	}
+	free(scratch->lu_detail_grid);
+	for (i = 0; i < NUM_LULC_TYPES; i++) {
+		free(scratch->lulc_temp_grid[i]);
+	}
+	free(scratch->lulc_temp_grid);
+	free(scratch->refveg_area_grid);
+	free(scratch->refveg_them_out);
+	for (i = 0; i < scratch->num_cell_threads; i++) {
+		free_lulc_work(&scratch->lulc_work[i]);
+	}
+	free(scratch->lulc_work);
+	free(scratch->chunk_lu_area);
+	free(scratch->chunk_refveg_area);
+	free(scratch->chunk_refveg_them);
+	free(scratch->global_lt_out);
+	free(scratch->global_lulc_in);
+}
@@ -0,0 +1,47 @@
+/**********
+ free_lulc_work.c
+
+ free the proc_lulc_area() workspace allocated by alloc_lulc_work()
+
+ arguments:
+ lulc_work_struct *work: the workspace to free
+
+ Created 17 Oct 2026
+
+ Moirai Land Data System (Moirai) Copyright (c) 2019, The
+ Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S.
+ Dept. of Energy).  All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Intellectual Property Office at
+ IPO@lbl.gov.
+
+ NOTICE.  This Software was developed under funding from the U.S. Department
+ of Energy and the U.S. Government consequently retains certain rights.  As
+ such, the U.S. Government has been granted for itself and others acting on
+ its behalf a paid-up, nonexclusive, irrevocable, worldwide license in the
+ Software to reproduce, distribute copies to the public, prepare derivative
+ works, and perform publicly and display publicly, and to permit other to do
+ so.
+
+ This file is part of Moirai.
+
+ Moirai is free software: you can use it under the terms of the modified BSD-3 license (see …/moirai/license.txt)
+
+ **********/
+
+#include "moirai.h"
+
+void free_lulc_work(lulc_work_struct *work) {
+	
+	free(work->lulc_area);
+	free(work->lu_area);
+	free(work->refveg_area_out);
+	free(work->refveg_them);
+	free(work->sum_lu_area);
+	free(work->lc_agg_area);
+	free(work->leftover_cell_inds);
+	free(work->refveg_type_area_sum);
+	free(work->type_area_resid);
+}
@@ -0,0 +1,62 @@
+/**********
+ free_sage_crop_vals.c
+
+ free the memory of a sage crop value store filled by save_sage_crop_vals() and load_sage_crop_vals()
+ the spill files are removed as they are loaded
+
+ arguments:
+ sage_crop_store_struct *store: the crop value store
+
+ Created 17 Oct 2026
+
+ Moirai Land Data System (Moirai) Copyright (c) 2019, The
+ Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S.
+ Dept. of Energy).  All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Intellectual Property Office at
+ IPO@lbl.gov.
+
+ NOTICE.  This Software was developed under funding from the U.S. Department
+ of Energy and the U.S. Government consequently retains certain rights.  As
+ such, the U.S. Government has been granted for itself and others acting on
+ its behalf a paid-up, nonexclusive, irrevocable, worldwide license in the
+ Software to reproduce, distribute copies to the public, prepare derivative
+ works, and perform publicly and display publicly, and to permit other to do
+ so.
+
+ This file is part of Moirai.
+
+ Moirai is free software: you can use it under the terms of the modified BSD-3 license (see …/moirai/license.txt)
+
+ **********/
+
+#include "moirai.h"
+
+void free_sage_crop_vals(sage_crop_store_struct *store) {
+	
+	int i;
+	
+	if (store->num_vals != NULL) {
+		for (i = 0; i < NUM_SAGE_CROP; i++) {
+			free(store->cells[i]);
+			free(store->area[i]);
+			free(store->yield[i]);
+		}
+	}
+	free(store->num_vals);
+	free(store->cells);
+	free(store->area);
+	free(store->yield);
+	store->num_vals = NULL;
+	store->cells = NULL;
+	store->area = NULL;
+	store->yield = NULL;
+	free(store->load_cells);
+	free(store->load_area);
+	free(store->load_yield);
+	store->load_cells = NULL;
+	store->load_area = NULL;
+	store->load_yield = NULL;
+}
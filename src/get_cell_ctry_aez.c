@@ -0,0 +1,120 @@
+/**********
+ get_cell_ctry_aez.c
+
+ build the working grid rasters of fao country index and glu index, so that the per-cell processing passes
+    can get the country X glu of a cell directly instead of searching countrycodes_fao[] and ctry_aez_list[]
+
+ cell_ctry_ind[NUM_CELLS]: the index into countrycodes_fao[] of the cell's fao country
+    serbia and montenegro are already merged into the scg record
+    NOMATCH if the cell has no fao country code or the code is not in the fao country list
+ cell_aez_ind[NUM_CELLS]: the index into ctry_aez_list[cell_ctry_ind[]] of the cell's glu
+    NOMATCH if cell_ctry_ind is NOMATCH, the glu is nodata, or the glu is not in the country's glu list
+
+ the ctry87 validity check is not applied here, because the crop harvested area and production calculations
+    keep the fao countries that are not mapped to ctry87; the per-cell passes that need it test
+    ctry2ctry87codes_gtap[cell_ctry_ind[]] == NOMATCH, which is a direct lookup
+
+ this must be called after write_glu_mapping(), which builds ctry_aez_list[][]
+    and after get_fao_code_ind(), which builds the fao country code lookup
+ the rasters are allocated here and freed in main() after the crop calculations
+
+ arguments:
+ args_struct in_args: the input file arguments
+ rinfo_struct raster_info: information about input raster data
+
+ return value:
+	integer error code: OK = 0, otherwise a non-zero error code
+
+ Created 17 Oct 2026
+
+ Moirai Land Data System (Moirai) Copyright (c) 2019, The
+ Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S.
+ Dept. of Energy).  All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Intellectual Property Office at
+ IPO@lbl.gov.
+
+ NOTICE.  This Software was developed under funding from the U.S. Department
+ of Energy and the U.S. Government consequently retains certain rights.  As
+ such, the U.S. Government has been granted for itself and others acting on
+ its behalf a paid-up, nonexclusive, irrevocable, worldwide license in the
+ Software to reproduce, distribute copies to the public, prepare derivative
+ works, and perform publicly and display publicly, and to permit other to do
+ so.
+
+ This file is part of Moirai.
+
+ Moirai is free software: you can use it under the terms of the modified BSD-3 license (see …/moirai/license.txt)
+
+ **********/
+
+#include "moirai.h"
+
+int get_cell_ctry_aez(args_struct in_args, rinfo_struct raster_info) {
+
+    int i;
+    int grid_ind;               // the index for looping over the raster grid
+    int ctry_code;              // current fao country code
+    int ctry_ind;               // current country index in countrycodes_fao
+    int aez_val;                // current glu value
+    int aez_ind;                // current glu index in ctry_aez_list[ctry_ind]
+    int scg_ind;                // the fao country index of serbia and montenegro
+    int num_valid = 0;          // number of cells with a valid country X glu
+
+    int scg_code = 186;         // fao code for serbia and montenegro
+    int srb_code = 272;         // fao code for serbia
+    int mne_code = 273;         // fao code for montenegro
+
+    // the scg index for the serbia and montenegro merge
+    scg_ind = NOMATCH;
+    if (scg_code <= max_fao_ctry_code) {
+        scg_ind = fao_ctry_code2ind[scg_code];
+    }
+    if (scg_ind == NOMATCH) {
+        // this should never happen
+        fprintf(fplog, "Error finding scg ctry index: get_cell_ctry_aez()\n");
+        return ERROR_IND;
+    }
+
+    cell_ctry_ind = calloc(NUM_CELLS, sizeof(int));
+    if(cell_ctry_ind == NULL) {
+        fprintf(fplog,"Failed to allocate memory for cell_ctry_ind: get_cell_ctry_aez()\n");
+        return ERROR_MEM;
+    }
+    cell_aez_ind = calloc(NUM_CELLS, sizeof(int));
+    if(cell_aez_ind == NULL) {
+        fprintf(fplog,"Failed to allocate memory for cell_aez_ind: get_cell_ctry_aez()\n");
+        return ERROR_MEM;
+    }
+
+    for (grid_ind = 0; grid_ind < NUM_CELLS; grid_ind++) {
+        ctry_code = country_fao[grid_ind];
+        if (ctry_code == srb_code || ctry_code == mne_code) {
+            ctry_ind = scg_ind;
+        } else if (ctry_code >= 0 && ctry_code <= max_fao_ctry_code) {
+            ctry_ind = fao_ctry_code2ind[ctry_code];
+        } else {
+            ctry_ind = NOMATCH;
+        }
+        cell_ctry_ind[grid_ind] = ctry_ind;
+
+        aez_ind = NOMATCH;
+        aez_val = aez_bounds_new[grid_ind];
+        if (ctry_ind != NOMATCH && aez_val != raster_info.aez_new_nodata) {
+            for (i = 0; i < ctry_aez_num[ctry_ind]; i++) {
+                if (ctry_aez_list[ctry_ind][i] == aez_val) {
+                    aez_ind = i;
+                    num_valid++;
+                    break;
+                }
+            } // end for i loop to get aez index
+        }
+        cell_aez_ind[grid_ind] = aez_ind;
+    } // end for grid_ind loop over working grid
+
+    fprintf(fplog, "\nIndexed %i country X glu cells: get_cell_ctry_aez()\n", num_valid);
+
+    return OK;
+}
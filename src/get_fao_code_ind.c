@@ -0,0 +1,118 @@
+/**********
+ get_fao_code_ind.c
+
+ build the direct lookup tables from the fao country and crop codes to their indices, and from the fao country index
+    to the land rent region index, so that the fao readers and the land rent calculations do not search the code lists
+
+ fao_ctry_code2ind[max_fao_ctry_code + 1]: the index into countrycodes_fao[] of each fao country code
+    NOMATCH if the code is not in the fao country list
+    serbia and montenegro are not merged here; the readers keep the codes as they are in the input files
+ fao_crop_code2ind[max_fao_crop_code + 1]: the index into cropcodes_sage2fao[] (and the sage crop arrays) of each fao crop code
+    NOMATCH if the code is not mapped to a sage crop
+ ctry2ctry87_ind[NUM_FAO_CTRY]: the index into country87codes_gtap[] of the land rent region of each fao country
+    NOMATCH if the fao country has no land rent region
+ the first match is used where a code appears more than once, as the linear searches do
+
+ codes outside 0 to the max code are not in the tables, so check the range before looking up a code from a file
+
+ this must be called after read_country_info_all(), read_country87_info(), and read_crop_info()
+ the tables are freed in main() with the info arrays
+
+ arguments:
+ args_struct in_args: the input file arguments
+
+ return value:
+	integer error code: OK = 0, otherwise a non-zero error code
+ 
+ Created 17 Oct 2026
+ 
+ Moirai Land Data System (Moirai) Copyright (c) 2019, The
+ Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S.
+ Dept. of Energy).  All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Intellectual Property Office at
+ IPO@lbl.gov.
+
+ NOTICE.  This Software was developed under funding from the U.S. Department
+ of Energy and the U.S. Government consequently retains certain rights.  As
+ such, the U.S. Government has been granted for itself and others acting on
+ its behalf a paid-up, nonexclusive, irrevocable, worldwide license in the
+ Software to reproduce, distribute copies to the public, prepare derivative
+ works, and perform publicly and display publicly, and to permit other to do
+ so.
+
+ This file is part of Moirai.
+
+ Moirai is free software: you can use it under the terms of the modified BSD-3 license (see …/moirai/license.txt)
+
+ **********/
+
+
+#include "moirai.h"
+
+int get_fao_code_ind(args_struct in_args) {
+
+    int i, j;
+
+    // fao country codes
+    max_fao_ctry_code = 0;
+    for (i = 0; i < NUM_FAO_CTRY; i++) {
+        if (countrycodes_fao[i] > max_fao_ctry_code) {
+            max_fao_ctry_code = countrycodes_fao[i];
+        }
+    }
+    fao_ctry_code2ind = calloc(max_fao_ctry_code + 1, sizeof(int));
+    if(fao_ctry_code2ind == NULL) {
+        fprintf(fplog,"Failed to allocate memory for fao_ctry_code2ind: get_fao_code_ind()\n");
+        return ERROR_MEM;
+    }
+    for (i = 0; i <= max_fao_ctry_code; i++) {
+        fao_ctry_code2ind[i] = NOMATCH;
+    }
+    for (i = NUM_FAO_CTRY - 1; i >= 0; i--) {
+        if (countrycodes_fao[i] >= 0) {
+            fao_ctry_code2ind[countrycodes_fao[i]] = i;
+        }
+    }
+
+    // fao crop codes of the sage crops
+    max_fao_crop_code = 0;
+    for (i = 0; i < NUM_SAGE_CROP; i++) {
+        if (cropcodes_sage2fao[i] > max_fao_crop_code) {
+            max_fao_crop_code = cropcodes_sage2fao[i];
+        }
+    }
+    fao_crop_code2ind = calloc(max_fao_crop_code + 1, sizeof(int));
+    if(fao_crop_code2ind == NULL) {
+        fprintf(fplog,"Failed to allocate memory for fao_crop_code2ind: get_fao_code_ind()\n");
+        return ERROR_MEM;
+    }
+    for (i = 0; i <= max_fao_crop_code; i++) {
+        fao_crop_code2ind[i] = NOMATCH;
+    }
+    for (i = NUM_SAGE_CROP - 1; i >= 0; i--) {
+        if (cropcodes_sage2fao[i] >= 0) {
+            fao_crop_code2ind[cropcodes_sage2fao[i]] = i;
+        }
+    }
+
+    // land rent region of each fao country
+    ctry2ctry87_ind = calloc(NUM_FAO_CTRY, sizeof(int));
+    if(ctry2ctry87_ind == NULL) {
+        fprintf(fplog,"Failed to allocate memory for ctry2ctry87_ind: get_fao_code_ind()\n");
+        return ERROR_MEM;
+    }
+    for (i = 0; i < NUM_FAO_CTRY; i++) {
+        ctry2ctry87_ind[i] = NOMATCH;
+        for (j = 0; j < NUM_GTAP_CTRY87; j++) {
+            if (country87codes_gtap[j] == ctry2ctry87codes_gtap[i]) {
+                ctry2ctry87_ind[i] = j;
+                break;
+            }
+        }
+    }
+
+    return OK;
+}
@@ -470,6 +470,24 @@ int get_in_args(const char *fname, args_struct *in_args) {
             case 131:
                strcpy(in_args->lt_map_fname, fld_str);
                break;
+            case 132:
+               in_args->num_threads = atoi(fld_str);
+               break;
+            case 133:
+               in_args->mem_budget_mb = atoi(fld_str);
+               break;
+            case 134:
+               in_args->sage_crop_spill = atoi(fld_str);
+               break;
+            case 135:
+               in_args->rand_seed = (unsigned int) strtoul(fld_str, NULL, 10);
+               break;
+            case 136:
+               in_args->land_type_area_format = atoi(fld_str);
+               break;
+            case 137:
+               strcpy(in_args->land_type_area_bin_fname, fld_str);
+               break;
             default:
                break;
 			}	// end switch
@@ -16,6 +16,8 @@
  find and put the indices of land cells to process for land type area (also restricted to valid output mask)
    into land_cells_hyde[num_land_cells_hyde] (based on hyde land area, which is an effecive hyde land mask)
    the hyde grid cell area matches the land area as a land mask
+   land_ord_hyde[NUM_CELLS] is the inverse map: the ordinal of each cell in land_cells_hyde[], or NOMATCH
+   the protected area and carbon state arrays are stored by this ordinal, for the hyde land cells only
  
  store forest cells based on ref veg and hyde land cells, for forest land rent calculations
    these are further restricted to valid output mask during processing
@@ -233,6 +235,7 @@ int get_land_cells(args_struct in_args, rinfo_struct raster_info) {
 		land_mask_refveg[i] = 0;
 		land_mask_forest[i] = 0;
         land_mask_ctryaez[i] = 0;
+		land_ord_hyde[i] = NOMATCH;
 		country87_gtap[i] = NODATA;
         glacier_water_area_hyde[i] = NODATA;
         region_gcam[i] = NODATA;
@@ -265,6 +268,7 @@ int get_land_cells(args_struct in_args, rinfo_struct raster_info) {
         // also keep track of residual water/ice area
 		if (land_area_hyde[i] != raster_info.land_area_hyde_nodata) {
             temp_float = land_area_hyde[i];
+            land_ord_hyde[i] = num_land_cells_hyde;
             land_cells_hyde[num_land_cells_hyde++] = i;
 			land_mask_hyde[i] = 1;
             if (cell_area_hyde[i] != raster_info.cell_area_hyde_nodata) {
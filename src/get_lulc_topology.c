@@ -0,0 +1,105 @@
+/**********
+ get_lulc_topology.c
+ 
+ build the index tables between the coarse lulc grid and the working grid, once,
+    so that the lulc readers and the lulc downscaling loops do not recompute cell positions for every cell and year
+ 
+ lulc_in2grid[NUM_CELLS_LULC]: the lulc grid index of each lulc input cell
+    the input data start at the lower left corner at 0 longitude (lon 0 to 360, lat -90 to 90)
+    the lulc grid starts at the upper left corner at -180 longitude, like the working grid
+ lulc_child_cells[NUM_CELLS_LULC * NUM_LU_CELLS]: the working grid indices of the lu cells within each lulc grid cell
+    the NUM_LU_CELLS children of lulc grid cell i start at lulc_child_cells[i * NUM_LU_CELLS], in row order
+    this is the order of the lu cells in proc_lulc_area() and in rand_order[]
+ 
+ this also sets NUM_LU_CELLS
+ assume perfect fit of working grid into lulc data, and symmetric cells
+ 
+ the tables are allocated here and freed in main() after the land type areas are processed
+ 
+ arguments:
+ args_struct in_args: the input file arguments
+ 
+ return value:
+	integer error code: OK = 0, otherwise a non-zero error code
+ 
+ Created 17 Oct 2026
+ 
+ Moirai Land Data System (Moirai) Copyright (c) 2019, The
+ Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S.
+ Dept. of Energy).  All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Intellectual Property Office at
+ IPO@lbl.gov.
+
+ NOTICE.  This Software was developed under funding from the U.S. Department
+ of Energy and the U.S. Government consequently retains certain rights.  As
+ such, the U.S. Government has been granted for itself and others acting on
+ its behalf a paid-up, nonexclusive, irrevocable, worldwide license in the
+ Software to reproduce, distribute copies to the public, prepare derivative
+ works, and perform publicly and display publicly, and to permit other to do
+ so.
+
+ This file is part of Moirai.
+
+ Moirai is free software: you can use it under the terms of the modified BSD-3 license (see …/moirai/license.txt)
+
+ **********/
+
+#include "moirai.h"
+
+int get_lulc_topology(args_struct in_args) {
+	
+	int i, m, n;
+	int num_split;				// number of working grid cells in one dimension of one lulc cell
+	int in_row;					// row of the input cell, from the bottom
+	int in_col;					// col of the input cell, from 0 longitude
+	int grid_y_ul;				// row for ul corner working grid cell in lulc cell
+	int grid_x_ul;				// col for ul corner working grid cell in lulc cell
+	int count;					// running index of the lu cells within a lulc cell
+	
+	num_split = NUM_LON / NUM_LON_LULC;
+	if (num_split * NUM_LON_LULC != NUM_LON || num_split * NUM_LAT_LULC != NUM_LAT) {
+		fprintf(fplog,"Working grid %i x %i does not nest in lulc grid %i x %i: get_lulc_topology()\n",
+				NUM_LON, NUM_LAT, NUM_LON_LULC, NUM_LAT_LULC);
+		return ERROR_IND;
+	}
+	NUM_LU_CELLS = num_split * num_split;
+	
+	lulc_in2grid = calloc(NUM_CELLS_LULC, sizeof(int));
+	if(lulc_in2grid == NULL) {
+		fprintf(fplog,"Failed to allocate memory for lulc_in2grid: get_lulc_topology()\n");
+		return ERROR_MEM;
+	}
+	lulc_child_cells = calloc((size_t) NUM_CELLS_LULC * NUM_LU_CELLS, sizeof(int));
+	if(lulc_child_cells == NULL) {
+		fprintf(fplog,"Failed to allocate memory for lulc_child_cells: get_lulc_topology()\n");
+		return ERROR_MEM;
+	}
+	
+	// flip the input rows and shift the input columns by half the globe
+	for (i = 0; i < NUM_CELLS_LULC; i++) {
+		in_row = i / NUM_LON_LULC;
+		in_col = i % NUM_LON_LULC;
+		if (in_col < NUM_LON_LULC / 2) {
+			lulc_in2grid[i] = (NUM_LAT_LULC - in_row - 1) * NUM_LON_LULC + in_col + NUM_LON_LULC / 2;
+		} else {
+			lulc_in2grid[i] = (NUM_LAT_LULC - in_row - 1) * NUM_LON_LULC + in_col - NUM_LON_LULC / 2;
+		}
+	}
+	
+	// the lu cells of each lulc grid cell, starting at the upper left corner
+	count = 0;
+	for (i = 0; i < NUM_CELLS_LULC; i++) {
+		grid_y_ul = (i / NUM_LON_LULC) * num_split;
+		grid_x_ul = (i % NUM_LON_LULC) * num_split;
+		for (m = grid_y_ul; m < grid_y_ul + num_split; m++) {
+			for (n = grid_x_ul; n < grid_x_ul + num_split; n++) {
+				lulc_child_cells[count++] = m * NUM_LON + n;
+			}
+		}
+	}
+	
+	return OK;
+}
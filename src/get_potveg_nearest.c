@@ -0,0 +1,140 @@
+/**********
+ get_potveg_nearest.c
+ 
+ precompute the substitute pot veg value that proc_lulc_area() uses for a lu cell with no pot veg value,
+    so that the ring search runs once instead of for every such cell of every lulc cell and year
+ 
+ the search is the one proc_lulc_area() did for each cell:
+    the lu cell's row and column within its lulc cell are the center of square search rings of increasing size,
+    clipped to the num_split x num_split lulc cell block
+    each ring is scanned row by row over potveg_thematic[row * num_split + col]; a value found on the top row of a ring
+    can be replaced by one found further down the same ring, and the search stops after the first ring with a value
+    the value is 0 (unknown) once the ring count reaches num_split
+ the rows and columns are those within the lulc cell, not the global working grid rows and columns,
+    so the result depends only on the position of the lu cell within its lulc cell
+    this keeps the outputs identical to the previous per-cell search, so potveg_nearest[] has only NUM_LU_CELLS values
+ 
+ potveg_nearest[NUM_LU_CELLS]: the substitute pot veg value for each lu cell position within a lulc cell
+ 
+ potveg_thematic[] and NUM_LU_CELLS (get_lulc_topology()) must be set before calling this function
+ potveg_nearest[] is allocated here and freed in main() after the land type areas are processed
+ 
+ arguments:
+ rinfo_struct raster_info: information about input raster data
+ 
+ return value:
+	integer error code: OK = 0, otherwise a non-zero error code
+ 
+ Created 17 Oct 2026
+ 
+ Moirai Land Data System (Moirai) Copyright (c) 2019, The
+ Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S.
+ Dept. of Energy).  All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Intellectual Property Office at
+ IPO@lbl.gov.
+
+ NOTICE.  This Software was developed under funding from the U.S. Department
+ of Energy and the U.S. Government consequently retains certain rights.  As
+ such, the U.S. Government has been granted for itself and others acting on
+ its behalf a paid-up, nonexclusive, irrevocable, worldwide license in the
+ Software to reproduce, distribute copies to the public, prepare derivative
+ works, and perform publicly and display publicly, and to permit other to do
+ so.
+
+ This file is part of Moirai.
+
+ Moirai is free software: you can use it under the terms of the modified BSD-3 license (see …/moirai/license.txt)
+
+ **********/
+
+#include "moirai.h"
+
+int get_potveg_nearest(rinfo_struct raster_info) {
+	
+	int i, x, y;
+	int ncols;					// number of lu cells in one dimension of a lulc cell
+	int nrows;
+	int potveg_val;				// the substitute pot veg value
+	int current_val;
+	int irow;
+	int icol;
+	int count;
+	int toprow;
+	int botrow;
+	int leftcol;
+	int rightcol;
+	
+	potveg_nearest = calloc(NUM_LU_CELLS, sizeof(int));
+	if(potveg_nearest == NULL) {
+		fprintf(fplog,"Failed to allocate memory for potveg_nearest: get_potveg_nearest()\n");
+		return ERROR_MEM;
+	}
+	
+	// assume symmetric cell size right now
+	ncols = (int) round(sqrt((double)NUM_LU_CELLS));
+	nrows = ncols;
+	
+	for (i = 0; i < NUM_LU_CELLS; i++) {
+		potveg_val = raster_info.potveg_nodata;
+		irow = i / ncols;
+		icol = i - irow * ncols;
+		// search vicinity for nearest valid pot veg value
+		count = 1;
+		while (potveg_val == raster_info.potveg_nodata) {
+			// determine rows and cols to search
+			toprow = irow - count;
+			if (toprow < 0) {
+				toprow = 0;
+			}
+			botrow = irow + count;
+			if (botrow >= nrows) {
+				botrow = nrows - 1 ;
+			}
+			leftcol = icol - count;
+			if (leftcol < 0) {
+				leftcol = 0;
+			}
+			rightcol = icol + count;
+			if (rightcol >= ncols) {
+				rightcol = ncols - 1;
+			}
+			// loop over rows
+			for (x = toprow; x <= botrow; x++) {
+				if (x == toprow || x == botrow) {
+					// loop over columns if at top or bottom of search ring
+					for (y = leftcol; y <= rightcol; y++) {
+						current_val = potveg_thematic[x * nrows + y];
+						// grab the first found value
+						if (current_val != raster_info.potveg_nodata) {
+							potveg_val = current_val;
+							break; // don't need to search this row anymore
+						}
+					}	// end for y loop over columns
+				} else {	// end if top or bottom of search ring
+					current_val = potveg_thematic[x * nrows + leftcol];
+					// grab the first found value
+					if (current_val != raster_info.potveg_nodata) {
+						potveg_val = current_val;
+						break; // don't need to search this row anymore
+					}
+					current_val = potveg_thematic[x * nrows + rightcol];
+					// grab the first found value
+					if (current_val != raster_info.potveg_nodata) {
+						potveg_val = current_val;
+						break; // don't need to search this row anymore
+					}
+				}	// end else not top or bottom of search ring
+			}	// end for x loop over rows
+			count++;
+			if (count == ncols) {
+				potveg_val = 0; // set it to unknown to end the search
+			}
+		}	// end while loop over search rings
+		potveg_nearest[i] = potveg_val;
+	} // end for i loop over lu cell positions
+	
+	return OK;
+}
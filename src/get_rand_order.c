@@ -0,0 +1,112 @@
+/**********
+ get_rand_order.c
+ 
+ set the randomized order in which proc_lulc_area() processes the lu cells within each lulc cell
+    the order is set once, so each year and each call of proc_lulc_area() uses the same order
+ 
+ each lulc cell's order is a fisher-yates shuffle of 0 to NUM_LU_CELLS-1, with random numbers from a counter-based generator
+    the generator is a splitmix64 sequence that starts from a hash of in_args.rand_seed and the lulc cell index,
+    so each cell's order depends only on the seed and the cell, and not on libc rand(), the platform, or the number of threads
+ 
+ rand_order[NUM_CELLS_LULC * NUM_LU_CELLS]: the within-lulc-cell index of the lu cell to process at each step;
+    the order of lulc cell i starts at rand_order[i * NUM_LU_CELLS]; the index order is that of lulc_child_cells[]
+ 
+ NUM_LU_CELLS (get_lulc_topology()) must be set before calling this function, and must fit in an unsigned 16 bit value
+ rand_order[] is allocated here and freed in main() after the land type areas are processed
+ 
+ arguments:
+ args_struct in_args: the input file arguments
+ 
+ return value:
+	integer error code: OK = 0, otherwise a non-zero error code
+ 
+ Created 17 Oct 2026
+ 
+ Moirai Land Data System (Moirai) Copyright (c) 2019, The
+ Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S.
+ Dept. of Energy).  All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Intellectual Property Office at
+ IPO@lbl.gov.
+
+ NOTICE.  This Software was developed under funding from the U.S. Department
+ of Energy and the U.S. Government consequently retains certain rights.  As
+ such, the U.S. Government has been granted for itself and others acting on
+ its behalf a paid-up, nonexclusive, irrevocable, worldwide license in the
+ Software to reproduce, distribute copies to the public, prepare derivative
+ works, and perform publicly and display publicly, and to permit other to do
+ so.
+
+ This file is part of Moirai.
+
+ Moirai is free software: you can use it under the terms of the modified BSD-3 license (see …/moirai/license.txt)
+
+ **********/
+
+
+#include "moirai.h"
+
+int get_rand_order(args_struct in_args) {
+	
+	int i;
+	int num_threads = 1;		// number of threads for the lulc cells
+	
+	if (NUM_LU_CELLS > UINT16_MAX + 1) {
+		fprintf(fplog,"Error: %i lu cells in a lulc cell do not fit the rand_order values: get_rand_order()\n", NUM_LU_CELLS);
+		return ERROR_CALC;
+	}
+	
+	rand_order = calloc((size_t) NUM_CELLS_LULC * NUM_LU_CELLS, sizeof(uint16_t));
+	if(rand_order == NULL) {
+		fprintf(fplog,"Failed to allocate memory for rand_order: get_rand_order()\n");
+		return ERROR_MEM;
+	}
+	
+	// determine the number of threads for the lulc cells
+#ifdef _OPENMP
+	if (in_args.num_threads <= 0) {
+		num_threads = omp_get_max_threads();
+	} else {
+		num_threads = in_args.num_threads;
+	}
+#endif
+	
+	// each lulc cell has its own generator, so the cells can be shuffled in any order
+#pragma omp parallel for schedule(static) num_threads(num_threads)
+	for (i = 0; i < NUM_CELLS_LULC; i++) {
+		int j, m;
+		uint16_t temp_ind;
+		uint16_t *order = &rand_order[(size_t) i * NUM_LU_CELLS];
+		uint64_t state;			// the generator counter for this lulc cell
+		uint64_t z;				// the current random value
+		
+		// the starting counter is a hash of the seed and the lulc cell index
+		state = ((uint64_t) in_args.rand_seed << 32) ^ (uint64_t) i;
+		state = (state ^ (state >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		state = (state ^ (state >> 27)) * 0x94D049BB133111EBULL;
+		state = state ^ (state >> 31);
+		
+		for (j = 0; j < NUM_LU_CELLS; j++) {
+			order[j] = (uint16_t) j;
+		}
+		for (j = NUM_LU_CELLS - 1; j > 0; j--) {
+			// next splitmix64 value
+			state = state + 0x9E3779B97F4A7C15ULL;
+			z = state;
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+			z = z ^ (z >> 31);
+			// scale the upper 32 bits to 0 to j
+			m = (int) (((z >> 32) * (uint64_t) (j + 1)) >> 32);
+			temp_ind = order[j];
+			order[j] = order[m];
+			order[m] = temp_ind;
+		}
+	} // end for i loop over the lulc cells
+	
+	fprintf(fplog, "\nSet the lu cell order of %i lulc cells with seed %u: get_rand_order()\n", NUM_CELLS_LULC, in_args.rand_seed);
+	
+	return OK;
+}
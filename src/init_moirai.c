@@ -192,6 +192,15 @@ int init_moirai(args_struct *in_args) {
     memset(in_args->wf_fname, '\0', MAXCHAR);
     memset(in_args->iso_map_fname, '\0', MAXCHAR);
     memset(in_args->lt_map_fname, '\0', MAXCHAR);
+	// parallel processing
+	in_args->num_threads = 1;
+	in_args->mem_budget_mb = 0;
+	in_args->sage_crop_spill = 0;
+	// lulc downscaling
+	in_args->rand_seed = 0;
+	// land type area output
+	in_args->land_type_area_format = 0;
+	memset(in_args->land_type_area_bin_fname, '\0', MAXCHAR);
 
 
 
@@ -0,0 +1,106 @@
+/**********
+ load_sage_crop_vals.c
+
+ get the harvested area and yield of one crop stored by save_sage_crop_vals()
+ the number of values is store->num_vals[cropind]
+
+ in memory (store->spill = 0) the returned arrays are the stored arrays
+ otherwise the crop spill file is read into the store's read buffers and then removed
+    the read buffers hold num_land_cells_sage values, are allocated on the first call,
+    and are overwritten by the next call
+
+ arguments:
+ args_struct in_args: the input file arguments
+ sage_crop_store_struct *store: the crop value store
+ int cropind: the sage crop index
+ int **cells: returns the index in land_cells_sage[] of each cell
+ float **area: returns the harvested area of each cell (km^2)
+ float **yield: returns the yield of each cell (t/km^2)
+
+ return value:
+	integer error code: OK = 0, otherwise a non-zero error code
+
+ Created 17 Oct 2026
+
+ Moirai Land Data System (Moirai) Copyright (c) 2019, The
+ Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S.
+ Dept. of Energy).  All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Intellectual Property Office at
+ IPO@lbl.gov.
+
+ NOTICE.  This Software was developed under funding from the U.S. Department
+ of Energy and the U.S. Government consequently retains certain rights.  As
+ such, the U.S. Government has been granted for itself and others acting on
+ its behalf a paid-up, nonexclusive, irrevocable, worldwide license in the
+ Software to reproduce, distribute copies to the public, prepare derivative
+ works, and perform publicly and display publicly, and to permit other to do
+ so.
+
+ This file is part of Moirai.
+
+ Moirai is free software: you can use it under the terms of the modified BSD-3 license (see …/moirai/license.txt)
+
+ **********/
+
+#include "moirai.h"
+
+int load_sage_crop_vals(args_struct in_args, sage_crop_store_struct *store, int cropind, int **cells, float **area, float **yield) {
+	
+	int num_vals = 0;			// the number of values in the spill file
+	char fname[MAXCHAR];		// the spill file name
+	FILE *fpin;
+	
+	if (!store->spill) {
+		*cells = store->cells[cropind];
+		*area = store->area[cropind];
+		*yield = store->yield[cropind];
+		return OK;
+	}
+	
+	if (store->load_cells == NULL) {
+		store->load_cells = malloc((num_land_cells_sage + 1) * sizeof(int));
+		if(store->load_cells == NULL) {
+			fprintf(fplog,"Failed to allocate memory for load_cells:  load_sage_crop_vals()\n");
+			return ERROR_MEM;
+		}
+		store->load_area = malloc((num_land_cells_sage + 1) * sizeof(float));
+		if(store->load_area == NULL) {
+			fprintf(fplog,"Failed to allocate memory for load_area:  load_sage_crop_vals()\n");
+			return ERROR_MEM;
+		}
+		store->load_yield = malloc((num_land_cells_sage + 1) * sizeof(float));
+		if(store->load_yield == NULL) {
+			fprintf(fplog,"Failed to allocate memory for load_yield:  load_sage_crop_vals()\n");
+			return ERROR_MEM;
+		}
+	}
+	
+	strcpy(fname, in_args.outpath);
+	strcat(fname, &cropfilebase_sage[cropind][0]);
+	strcat(fname, SAGE_SPILL_TAG);
+	if((fpin = fopen(fname, "rb")) == NULL)
+	{
+		fprintf(fplog,"Failed to open file %s:  load_sage_crop_vals()\n", fname);
+		return ERROR_FILE;
+	}
+	if (fread(&num_vals, sizeof(int), 1, fpin) != 1 || num_vals != store->num_vals[cropind] ||
+		num_vals < 0 || num_vals > num_land_cells_sage ||
+		fread(store->load_cells, sizeof(int), num_vals, fpin) != (size_t) num_vals ||
+		fread(store->load_area, sizeof(float), num_vals, fpin) != (size_t) num_vals ||
+		fread(store->load_yield, sizeof(float), num_vals, fpin) != (size_t) num_vals) {
+		fprintf(fplog,"Failed to read file %s:  load_sage_crop_vals()\n", fname);
+		fclose(fpin);
+		return ERROR_FILE;
+	}
+	fclose(fpin);
+	remove(fname);
+	
+	*cells = store->load_cells;
+	*area = store->load_area;
+	*yield = store->load_yield;
+	
+	return OK;
+}
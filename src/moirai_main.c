@@ -220,7 +220,7 @@
  	these data were generated specifically for Moirai
  	the HYDE 3.2 land use categories are preserved
  	only the years corresponding to HYDE 3.2 years are used (from 1800-2016)
- 	half-degree resolution, gzipped netCDF files; these are automatically gunzipped
+ 	half-degree resolution, gzipped netCDF files; these are decompressed in memory when read
  	see included data document for more details
  
  
@@ -300,8 +300,7 @@ soil carbon (soil only for a depth of 0-30 cms)
 
 int main(int argc, const char * argv[]) {
     
-    int i, j, k,l;
-    int array_cells =3;
+    int i, j, l;
 	char fname[MAXCHAR];		// used to open files
 	args_struct in_args;		// data structure for holding the control input file info
 	rinfo_struct raster_info;	// data structure for storing raster input file specific info
@@ -323,10 +322,6 @@ int main(int argc, const char * argv[]) {
 	
 	fprintf(stdout, "\nProgram %s started at %s\n", CODENAME, get_systime());
 	
-	// set the rand() seed
-	// want it the same each time the program is run
-	srand(0);
-	
 	// initialize all of the arrays
 	if((error_code = init_moirai(&in_args))) {
 		fprintf(stderr, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
@@ -403,62 +398,90 @@ int main(int argc, const char * argv[]) {
     // start with the text info data
     // these are csv files that determine mappings and number of aezs, crops, counties, regions
     
+    stage_begin("input_info");
+    
     ////////// read GTAP87 and GCAM region and FAO country info text files
     
     // one file	includes the alphabetical FAO country list and the FAO, VMAP0, iso ctry mapping
     // array length and allocation done within read_country_info_all()
+    stage_begin("read_country_info_all");
     if((error_code = read_country_info_all(in_args))) {
         fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
         return error_code;
     }
+    stage_end();
     
     // this includes both the GCAM/GTAP ctry87 list in land rent output order and the mapping between FAO ctry and GCAM/GTAP ctry87
     // array length and allocation done within read_country87_info()
+    stage_begin("read_country87_info");
     if((error_code = read_country87_info(in_args))) {
         fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
         return error_code;
     }
+    stage_end();
     
     // this includes GCAM region list
     // array length and allocation done within read_region_info_gcam()
+    stage_begin("read_region_info_gcam");
     if((error_code = read_region_info_gcam(in_args))) {
         fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
         return error_code;
     }
+    stage_end();
     
     ////////// read the list of new aez codes and names
     
     // this is the list of new aezs
     // array length and allocation done within read_aez_new_info()
+    stage_begin("read_aez_new_info");
     if((error_code = read_aez_new_info(in_args))) {
         fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
         return error_code;
     }
+    stage_end();
     
     ////////// read crop and use and land info text files
     
     // read GTAP use info
     // this is the list in output order for land rent
     // array length and allocation done within read_use_info_gtap()
+    stage_begin("read_use_info_gtap");
     if((error_code = read_use_info_gtap(in_args))) {
         fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
         return error_code;
     }
+    stage_end();
     
     // read SAGE land type info
     // array length and allocation done within read_lt_info_sage()
+    stage_begin("read_lulc_info");
     if((error_code = read_lulc_info(in_args))) {
         fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
         return error_code;
     }
+    stage_end();
     
     // one file includes FAO to SAGE crop and to GTAP use mapping
     // array length and allocation done within read_crop_info()
+    stage_begin("read_crop_info");
     if((error_code = read_crop_info(in_args))) {
         fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
         return error_code;
     }
+    stage_end();
     
+    // direct lookups of the fao country and crop codes, and of the land rent region of each fao country
+    // the tables are allocated within get_fao_code_ind()
+    stage_begin("get_fao_code_ind");
+    if((error_code = get_fao_code_ind(in_args))) {
+        fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
+        return error_code;
+    }
+    stage_end();
+    stage_end();
+    
+	stage_begin("input_rasters");
+	
 	////////
 	// read the raster data, except the SAGE crop data, lulc data, and hyde lu data
 	
@@ -475,10 +498,12 @@ int main(int argc, const char * argv[]) {
         fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for cell_area_hyde: main()\n", get_systime(), ERROR_MEM);
         return ERROR_MEM;
     }
+	stage_begin("get_cell_area");
 	if((error_code = get_cell_area(in_args, &raster_info))) {
 		fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
 		return error_code;
 	}
+	stage_end();
 	
 	// read the sage working grid land fraction and convert it to land area: land_area_sage[NUM_CELLS]
     // first allocate the arrays
@@ -487,10 +512,12 @@ int main(int argc, const char * argv[]) {
         fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for land_area_sage: main()\n", get_systime(), ERROR_MEM);
         return ERROR_MEM;
     }
+	stage_begin("read_land_area_sage");
 	if((error_code = read_land_area_sage(in_args, &raster_info))) {
 		fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
 		return error_code;
 	}
+	stage_end();
 	
 	// read the hyde land area: land_area_hyde[NUM_CELLS]
     // first allocate the arrays
@@ -499,10 +526,12 @@ int main(int argc, const char * argv[]) {
         fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for land_area_hyde: main()\n", get_systime(), ERROR_MEM);
         return ERROR_MEM;
     }
+	stage_begin("read_land_area_hyde");
 	if((error_code = read_land_area_hyde(in_args, &raster_info))) {
 		fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
 		return error_code;
 	}
+	stage_end();
 	
 	// read new AEZ boundaries: aez_bounds_new[NUM_CELLS]
     // first allocate the array
@@ -511,6 +540,7 @@ int main(int argc, const char * argv[]) {
         fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for aez_bounds_new: main()\n", get_systime(), ERROR_MEM);
         return ERROR_MEM;
     }
+    stage_begin("read_aez_new");
     if((error_code = read_aez_new(in_args, &raster_info))) {
 		fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
 		return error_code;
@@ -523,10 +553,13 @@ int main(int argc, const char * argv[]) {
         fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for aez_bounds_orig: main()\n", get_systime(), ERROR_MEM);
         return ERROR_MEM;
     }
+    stage_end();
+	stage_begin("read_aez_orig");
 	if((error_code = read_aez_orig(in_args, &raster_info))) {
 		fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
 		return error_code;
 	}
+	stage_end();
 	
 	// read potential vegetation data: potveg_thematic[NUM_CELLS]
     // first allocate the array
@@ -535,10 +568,12 @@ int main(int argc, const char * argv[]) {
         fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for potveg_thematic: main()\n", get_systime(), ERROR_MEM);
         return ERROR_MEM;
     }
+	stage_begin("read_potveg");
 	if((error_code = read_potveg(in_args, &raster_info))) {
 		fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
 		return error_code;
 	}
+	stage_end();
 	
 	// read FAO country code data: country_fao[NUM_CELLS]
     // first allocate array
@@ -547,10 +582,36 @@ int main(int argc, const char * argv[]) {
         fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for country_fao: main()\n", get_systime(), ERROR_MEM);
         return ERROR_MEM;
     }
+	stage_begin("read_country_fao");
 	if((error_code = read_country_fao(in_args, &raster_info))) {
 		fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
 		return error_code;
 	}
+	stage_end();
+	
+	// build the lulc grid to working grid index tables: lulc_in2grid[NUM_CELLS_LULC], lulc_child_cells[NUM_CELLS_LULC * NUM_LU_CELLS]
+	stage_begin("get_lulc_topology");
+	if((error_code = get_lulc_topology(in_args))) {
+		fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
+		return error_code;
+	}
+	stage_end();
+	
+	// find the substitute pot veg value for each lu cell position without pot veg: potveg_nearest[NUM_LU_CELLS]
+	stage_begin("get_potveg_nearest");
+	if((error_code = get_potveg_nearest(raster_info))) {
+		fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
+		return error_code;
+	}
+	stage_end();
+	
+	// set the random lu cell order within each lulc cell, the same for every year: rand_order[NUM_CELLS_LULC * NUM_LU_CELLS]
+	stage_begin("get_rand_order");
+	if((error_code = get_rand_order(in_args))) {
+		fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
+		return error_code;
+	}
+	stage_end();
 	
 	// read lulc land mask: land_mask_lulc[NUM_CELLS]
 	// first allocate array
@@ -559,11 +620,16 @@ int main(int argc, const char * argv[]) {
 		fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for land_mask_lulc: main()\n", get_systime(), ERROR_MEM);
 		return ERROR_MEM;
 	}
+	stage_begin("read_lulc_land");
 	if((error_code = read_lulc_land(in_args, REF_YEAR, &raster_info, land_mask_lulc))) {
 		fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
 		return error_code;
 	}
+	stage_end();
+	stage_end();
 	
+    stage_begin("working_grid");
+    
     /////////
     // reconcile the raster data
 	
@@ -718,6 +784,11 @@ int main(int argc, const char * argv[]) {
         fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for land_cells_hyde: main()\n", get_systime(), ERROR_MEM);
         return ERROR_MEM;
     }
+    land_ord_hyde = calloc(NUM_CELLS, sizeof(int));
+    if(land_ord_hyde == NULL) {
+        fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for land_ord_hyde: main()\n", get_systime(), ERROR_MEM);
+        return ERROR_MEM;
+    }
     forest_cells = calloc(NUM_CELLS, sizeof(int));
     if(forest_cells == NULL) {
         fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for forest_cells: main()\n", get_systime(), ERROR_MEM);
@@ -729,23 +800,28 @@ int main(int argc, const char * argv[]) {
     
     ////
     // determine the indices of the relevant land and forest cells in aez, sage, hyde, and fao data: land_cells_####[NUM_CELLS]
+    stage_begin("get_land_cells");
     if((error_code = get_land_cells(in_args, raster_info))) {
         fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
         return error_code;
     }
+    stage_end();
 
     ////
     // convert the hyde land use, lulc, and sage potential veg input data to working grid area
-    // the rand_order array is allocated here in calc_refvef_area and is deallocated in proc_refveg_carbon
+        stage_begin("calc_refveg_area");
         if((error_code = calc_refveg_area(in_args, &raster_info))) {
             fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
             return error_code;
         }	
+        stage_end();
  
+        stage_begin("calc_refcarbon_area");
         if((error_code = calc_refcarbon_area(in_args, raster_info))) {
             fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
             return error_code;
         }
+        stage_end();
     // free some raster arrays
     free(region_gcam);
     free(sage_minus_hyde_land_area);
@@ -774,17 +850,31 @@ int main(int argc, const char * argv[]) {
 
     // store the country/land rent region + aez lists
     // the arrays are allocated within write_glu_mapping()
+    stage_begin("write_glu_mapping");
     if((error_code = write_glu_mapping(in_args, raster_info))) {
         fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
         return error_code;
     }
+    stage_end();
+    
+    // index the fao country and glu of each working grid cell for the per-cell processing functions
+    // the index rasters are allocated within get_cell_ctry_aez()
+    stage_begin("get_cell_ctry_aez");
+    if((error_code = get_cell_ctry_aez(in_args, raster_info))) {
+        fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
+        return error_code;
+    }
+    stage_end();
+    stage_end();
     
     // process the mirca data
     //  mirca grid is allocated/freed within proc_mirca()
+    stage_begin("proc_mirca");
     if((error_code = proc_mirca(in_args, raster_info))) {
         fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
         return error_code;
     }
+    stage_end();
     
     //kbn 2020
     protected_EPA = calloc(NUM_EPA_PROTECTED, sizeof(float*));
@@ -793,7 +883,7 @@ int main(int argc, const char * argv[]) {
         return ERROR_MEM;
     }
     for (i = 0; i < NUM_EPA_PROTECTED; i++) {
-        protected_EPA[i] = calloc(NUM_CELLS, sizeof(float));
+        protected_EPA[i] = calloc(num_land_cells_hyde + 1, sizeof(float));
         if(protected_EPA[i] == NULL) {
             fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for protected_EPA[%i]: main()\n", get_systime(), ERROR_MEM, i);
             return ERROR_MEM;
@@ -801,14 +891,18 @@ int main(int argc, const char * argv[]) {
     }
     
     
+    stage_begin("read_protected");
     if((error_code = read_protected(in_args, &raster_info))) {
         fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
         return error_code;
     }
+    stage_end();
 	
 	
    if (in_args.carbon_enabled == 1) {
       
+      stage_begin("carbon_inputs");
+      
       //kbn 2020/06/01 Add code for read_soil_c here
       soil_carbon_sage = calloc(NUM_CARBON, sizeof(float*));
       if(soil_carbon_sage == NULL) {
@@ -816,7 +910,7 @@ int main(int argc, const char * argv[]) {
          return ERROR_MEM;
       }
       for (i = 0; i < NUM_CARBON; i++) {
-         soil_carbon_sage[i] = calloc(NUM_CELLS, sizeof(float));
+         soil_carbon_sage[i] = calloc(num_land_cells_hyde + 1, sizeof(float));
          if(soil_carbon_sage[i] == NULL) {
             fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for soil_carbon_sage[%i]: main()\n", get_systime(), ERROR_MEM, i);
             return ERROR_MEM;
@@ -831,7 +925,7 @@ int main(int argc, const char * argv[]) {
          return ERROR_MEM;
       }
       for (i = 0; i < NUM_CARBON; i++) {
-         soil_carbon_crop_sage[i] = calloc(NUM_CELLS, sizeof(float));
+         soil_carbon_crop_sage[i] = calloc(num_land_cells_hyde + 1, sizeof(float));
          if(soil_carbon_crop_sage[i] == NULL) {
             fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for soil_carbon_crop_sage[%i]: main()\n", get_systime(), ERROR_MEM, i);
             return ERROR_MEM;
@@ -844,7 +938,7 @@ int main(int argc, const char * argv[]) {
          return ERROR_MEM;
       }
       for (i = 0; i < NUM_CARBON; i++) {
-         soil_carbon_pasture_sage[i] = calloc(NUM_CELLS, sizeof(float));
+         soil_carbon_pasture_sage[i] = calloc(num_land_cells_hyde + 1, sizeof(float));
          if(soil_carbon_pasture_sage[i] == NULL) {
             fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for soil_carbon_pasture_sage[%i]: main()\n", get_systime(), ERROR_MEM, i);
             return ERROR_MEM;
@@ -857,7 +951,7 @@ int main(int argc, const char * argv[]) {
          return ERROR_MEM;
       }
       for (i = 0; i < NUM_CARBON; i++) {
-         soil_carbon_urban_sage[i] = calloc(NUM_CELLS, sizeof(float));
+         soil_carbon_urban_sage[i] = calloc(num_land_cells_hyde + 1, sizeof(float));
          if(soil_carbon_urban_sage[i] == NULL) {
             fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for soil_carbon_urban_sage[%i]: main()\n", get_systime(), ERROR_MEM, i);
             return ERROR_MEM;
@@ -886,85 +980,25 @@ int main(int argc, const char * argv[]) {
          } // end for j loop over aezs
       }
       
-      //Allocate the main soil_carbon_array
-      soil_carbon_array = calloc(NUM_FAO_CTRY, sizeof(float****));
-      if(soil_carbon_array == NULL) {
-         fprintf(fplog,"Failed to allocate memory for soil_carbon_array: proc_refveg_carbon()\n");
-         return ERROR_MEM;
-      }
-      for (i = 0; i < NUM_FAO_CTRY; i++) {
-         soil_carbon_array[i] = calloc(ctry_aez_num[i], sizeof(float***));
-         if(soil_carbon_array[i] == NULL) {
-            fprintf(fplog,"Failed to allocate memory for soil_carbon_array[%i]: proc_refveg_carbon()\n", i);
-            return ERROR_MEM;
-         }
-         for (j = 0; j < ctry_aez_num[i]; j++) {
-            soil_carbon_array[i][j] = calloc(num_lt_cats, sizeof(float**));
-            if(soil_carbon_array[i][j] == NULL) {
-               fprintf(fplog,"Failed to allocate memory for soil_carbon_array[%i][%i]: proc_refveg_carbon()\n", i, j);
-               return ERROR_MEM;
-            }
-            for (k = 0; k < num_lt_cats; k++) {
-               soil_carbon_array[i][j][k] = calloc(NUM_CARBON, sizeof(float*));
-               if(soil_carbon_array[i][j][k] == NULL) {
-                  fprintf(fplog,"Failed to allocate memory for soil_carbon_array[%i][%i][%i]: proc_refveg_carbon()\n", i, j, k);
-                  return ERROR_MEM;
-               }//The last dimension will be assigned in read_soil_carbon.c
-               for (l = 0; l < NUM_CARBON; l++) {
-                  soil_carbon_array[i][j][k][l] = calloc(array_cells, sizeof(float));
-                  if(soil_carbon_array[i][j][k][l] == NULL) {
-                     fprintf(fplog,"Failed to allocate memory for soil_carbon_array[%i][%i][%i]: proc_refveg_carbon()\n", i, j, k);
-                     return ERROR_MEM;
-                  }
-               }// end for k loop over output values
-            }// end for j loop over aezs
-         }// end for j loop over glus
-      }// end for i loop over fao country
-      
-      //Allocate the vegetation carbon arrays
-      veg_carbon_array = calloc(NUM_FAO_CTRY, sizeof(float****));
-      if(veg_carbon_array == NULL) {
-         fprintf(fplog,"Failed to allocate memory for soil_carbon_array: proc_refveg_carbon()\n");
-         return ERROR_MEM;
+      // count the cells in each carbon bucket and point the soil and veg carbon arrays into contiguous slabs
+      stage_begin("alloc_carbon_buckets");
+      if((error_code = alloc_carbon_buckets(in_args, raster_info))) {
+         fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
+         return error_code;
       }
-      for (i = 0; i < NUM_FAO_CTRY; i++) {
-         veg_carbon_array[i] = calloc(ctry_aez_num[i], sizeof(float***));
-         if(veg_carbon_array[i] == NULL) {
-            fprintf(fplog,"Failed to allocate memory for soil_carbon_array[%i]: proc_refveg_carbon()\n", i);
-            return ERROR_MEM;
-         }
-         for (j = 0; j < ctry_aez_num[i]; j++) {
-            veg_carbon_array[i][j] = calloc(num_lt_cats, sizeof(float**));
-            if(veg_carbon_array[i][j] == NULL) {
-               fprintf(fplog,"Failed to allocate memory for soil_carbon_array[%i][%i]: proc_refveg_carbon()\n", i, j);
-               return ERROR_MEM;
-            }
-            for (k = 0; k < num_lt_cats; k++) {
-               veg_carbon_array[i][j][k] = calloc(NUM_CARBON, sizeof(float*));
-               if(veg_carbon_array[i][j][k] == NULL) {
-                  fprintf(fplog,"Failed to allocate memory for soil_carbon_array[%i][%i][%i]: proc_refveg_carbon()\n", i, j, k);
-                  return ERROR_MEM;
-               }//The last dimension will be assigned in read_soil_carbon.c
-               for (l = 0; l < NUM_CARBON; l++) {
-                  veg_carbon_array[i][j][k][l] = calloc(array_cells, sizeof(float));
-                  if(veg_carbon_array[i][j][k][l] == NULL) {
-                     fprintf(fplog,"Failed to allocate memory for soil_carbon_array[%i][%i][%i]: proc_refveg_carbon()\n", i, j, k);
-                     return ERROR_MEM;
-                  }
-               }// end for k loop over output values
-            }// end for j loop over aezs
-         }// end for j loop over glus
-      }// end for i loop over fao country
+      stage_end();
       
       
       
       
       
       //Call the read soil carbon function
+      stage_begin("read_soil_carbon");
       if((error_code = read_soil_carbon(in_args, &raster_info))) {
          fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
          return error_code;
       }
+      stage_end();
       
       //kbn 2020/06/30 Add code for read_veg_c here
       veg_carbon_sage = calloc(NUM_CARBON, sizeof(float*));
@@ -973,7 +1007,7 @@ int main(int argc, const char * argv[]) {
          return ERROR_MEM;
       }
       for (i = 0; i < NUM_CARBON; i++) {
-         veg_carbon_sage[i] = calloc(NUM_CELLS, sizeof(float));
+         veg_carbon_sage[i] = calloc(num_land_cells_hyde + 1, sizeof(float));
          if(veg_carbon_sage[i] == NULL) {
             fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for veg_carbon_sage[%i]: main()\n", get_systime(), ERROR_MEM, i);
             return ERROR_MEM;
@@ -988,7 +1022,7 @@ int main(int argc, const char * argv[]) {
          return ERROR_MEM;
       }
       for (i = 0; i < NUM_CARBON; i++) {
-         veg_carbon_crop_sage[i] = calloc(NUM_CELLS, sizeof(float));
+         veg_carbon_crop_sage[i] = calloc(num_land_cells_hyde + 1, sizeof(float));
          if(veg_carbon_crop_sage[i] == NULL) {
             fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for veg_carbon_sage[%i]: main()\n", get_systime(), ERROR_MEM, i);
             return ERROR_MEM;
@@ -1002,7 +1036,7 @@ int main(int argc, const char * argv[]) {
          return ERROR_MEM;
       }
       for (i = 0; i < NUM_CARBON; i++) {
-         veg_carbon_pasture_sage[i] = calloc(NUM_CELLS, sizeof(float));
+         veg_carbon_pasture_sage[i] = calloc(num_land_cells_hyde + 1, sizeof(float));
          if(veg_carbon_pasture_sage[i] == NULL) {
             fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for veg_carbon_sage[%i]: main()\n", get_systime(), ERROR_MEM, i);
             return ERROR_MEM;
@@ -1016,7 +1050,7 @@ int main(int argc, const char * argv[]) {
          return ERROR_MEM;
       }
       for (i = 0; i < NUM_CARBON; i++) {
-         veg_carbon_urban_sage[i] = calloc(NUM_CELLS, sizeof(float));
+         veg_carbon_urban_sage[i] = calloc(num_land_cells_hyde + 1, sizeof(float));
          if(veg_carbon_urban_sage[i] == NULL) {
             fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for veg_carbon_sage[%i]: main()\n", get_systime(), ERROR_MEM, i);
             return ERROR_MEM;
@@ -1030,7 +1064,7 @@ int main(int argc, const char * argv[]) {
          return ERROR_MEM;
       }
       for (i = 0; i < NUM_CARBON; i++) {
-         above_ground_ratio[i] = calloc(NUM_CELLS, sizeof(float));
+         above_ground_ratio[i] = calloc(num_land_cells_hyde + 1, sizeof(float));
          if(above_ground_ratio[i] == NULL) {
             fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for above_ground_ratio[%i]: main()\n", get_systime(), ERROR_MEM, i);
             return ERROR_MEM;
@@ -1044,7 +1078,7 @@ int main(int argc, const char * argv[]) {
          return ERROR_MEM;
       }
       for (i = 0; i < NUM_CARBON; i++) {
-         below_ground_ratio[i] = calloc(NUM_CELLS, sizeof(float));
+         below_ground_ratio[i] = calloc(num_land_cells_hyde + 1, sizeof(float));
          if(below_ground_ratio[i] == NULL) {
             fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for below_ground_ratio[%i]: main()\n", get_systime(), ERROR_MEM, i);
             return ERROR_MEM;
@@ -1057,7 +1091,7 @@ int main(int argc, const char * argv[]) {
          return ERROR_MEM;
       }
       for (i = 0; i < NUM_CARBON; i++) {
-         above_ground_ratio_crop[i] = calloc(NUM_CELLS, sizeof(float));
+         above_ground_ratio_crop[i] = calloc(num_land_cells_hyde + 1, sizeof(float));
          if(above_ground_ratio_crop[i] == NULL) {
             fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for above_ground_ratio[%i]: main()\n", get_systime(), ERROR_MEM, i);
             return ERROR_MEM;
@@ -1071,7 +1105,7 @@ int main(int argc, const char * argv[]) {
          return ERROR_MEM;
       }
       for (i = 0; i < NUM_CARBON; i++) {
-         below_ground_ratio_crop[i] = calloc(NUM_CELLS, sizeof(float));
+         below_ground_ratio_crop[i] = calloc(num_land_cells_hyde + 1, sizeof(float));
          if(below_ground_ratio_crop[i] == NULL) {
             fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for below_ground_ratio[%i]: main()\n", get_systime(), ERROR_MEM, i);
             return ERROR_MEM;
@@ -1085,7 +1119,7 @@ int main(int argc, const char * argv[]) {
          return ERROR_MEM;
       }
       for (i = 0; i < NUM_CARBON; i++) {
-         above_ground_ratio_urban[i] = calloc(NUM_CELLS, sizeof(float));
+         above_ground_ratio_urban[i] = calloc(num_land_cells_hyde + 1, sizeof(float));
          if(above_ground_ratio_urban[i] == NULL) {
             fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for above_ground_ratio[%i]: main()\n", get_systime(), ERROR_MEM, i);
             return ERROR_MEM;
@@ -1099,7 +1133,7 @@ int main(int argc, const char * argv[]) {
          return ERROR_MEM;
       }
       for (i = 0; i < NUM_CARBON; i++) {
-         below_ground_ratio_urban[i] = calloc(NUM_CELLS, sizeof(float));
+         below_ground_ratio_urban[i] = calloc(num_land_cells_hyde + 1, sizeof(float));
          if(below_ground_ratio_urban[i] == NULL) {
             fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for below_ground_ratio[%i]: main()\n", get_systime(), ERROR_MEM, i);
             return ERROR_MEM;
@@ -1112,7 +1146,7 @@ int main(int argc, const char * argv[]) {
          return ERROR_MEM;
       }
       for (i = 0; i < NUM_CARBON; i++) {
-         above_ground_ratio_pasture[i] = calloc(NUM_CELLS, sizeof(float));
+         above_ground_ratio_pasture[i] = calloc(num_land_cells_hyde + 1, sizeof(float));
          if(above_ground_ratio_pasture[i] == NULL) {
             fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for above_ground_ratio[%i]: main()\n", get_systime(), ERROR_MEM, i);
             return ERROR_MEM;
@@ -1126,34 +1160,52 @@ int main(int argc, const char * argv[]) {
          return ERROR_MEM;
       }
       for (i = 0; i < NUM_CARBON; i++) {
-         below_ground_ratio_pasture[i] = calloc(NUM_CELLS, sizeof(float));
+         below_ground_ratio_pasture[i] = calloc(num_land_cells_hyde + 1, sizeof(float));
          if(below_ground_ratio_pasture[i] == NULL) {
             fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for below_ground_ratio[%i]: main()\n", get_systime(), ERROR_MEM, i);
             return ERROR_MEM;
          }
       }
       
+      stage_begin("read_veg_carbon");
       if((error_code = read_veg_carbon(in_args, &raster_info))) {
          fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
          return error_code;
       }
+      stage_end();
+      
+      stage_end();
    } //end carbon_enabled
    
    // process the land type area data
    //  lu grids are allocated/freed within proc_land_type_area()
+   stage_begin("proc_land_type_area");
    if((error_code = proc_land_type_area(in_args, raster_info))) {
       fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
       return error_code;
    }
+   stage_end();
+   
+   // the lulc index tables are not needed after the land type areas
+   free(lulc_in2grid);
+   free(lulc_child_cells);
+   free(potveg_nearest);
+   free(rand_order);
+   free(lulc_nc_buf);
+   free(lulc_frac_buf);
+   free(lulc_area_buf);
     
    if (in_args.carbon_enabled == 1) {
+      
+      stage_begin("carbon_outputs");
       // process the reference vegetation carbon data
       //  needed arrays are allocated/freed within proc_refveg_carbon()
-      // the rand_order array that is allocated in calc_refvef_area is deallocated in proc_refveg_carbon
+      stage_begin("proc_refveg_carbon");
       if((error_code = proc_refveg_carbon(in_args, raster_info))) {
          fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
          return error_code;
       }
+      stage_end();
       
       //kbn 2020/06/01 Add code for soil carbon here
       for (i = 0; i < NUM_CARBON; i++) {
@@ -1177,10 +1229,12 @@ int main(int argc, const char * argv[]) {
       }
       free(below_ground_ratio);
       
+      stage_begin("proc_refveg_crop_carbon");
       if((error_code = proc_refveg_crop_carbon(in_args, raster_info))) {
          fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
          return error_code;
       }
+      stage_end();
       
       for (i = 0; i < NUM_CARBON; i++) {
          free(soil_carbon_crop_sage[i]);
@@ -1203,10 +1257,12 @@ int main(int argc, const char * argv[]) {
       }
       free(below_ground_ratio_crop);
       
+      stage_begin("proc_refveg_pasture_carbon");
       if((error_code = proc_refveg_pasture_carbon(in_args, raster_info))) {
          fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
          return error_code;
       }
+      stage_end();
       
       for (i = 0; i < NUM_CARBON; i++) {
          free(soil_carbon_pasture_sage[i]);
@@ -1229,10 +1285,12 @@ int main(int argc, const char * argv[]) {
       }
       free(below_ground_ratio_pasture);
       
+      stage_begin("proc_refveg_urban_carbon");
       if((error_code = proc_refveg_urban_carbon(in_args, raster_info))) {
          fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
          return error_code;
       }
+      stage_end();
       
       for (i = 0; i < NUM_CARBON; i++) {
          free(soil_carbon_urban_sage[i]);
@@ -1263,28 +1321,27 @@ int main(int argc, const char * argv[]) {
       }free(soil_carbon_array_cells);
       fprintf(stdout, "\n Freed carbon array cells  %s\n", get_systime());
       
-      //free soil and veg carbon arrays
+      //free soil and veg carbon arrays; the bucket values are in the slabs
       for (i = 0; i < NUM_FAO_CTRY; i++) {
          for (j = 0; j < ctry_aez_num[i]; j++) {
-            for (k = 0; k < num_lt_cats; k++) {
-               for(l=0; l< NUM_CARBON;l++){
-                  free(soil_carbon_array[i][j][k][l]);
-               }free(soil_carbon_array[i][j][k]);
-            }free(soil_carbon_array[i][j]);
-         }free(soil_carbon_array[i]);
-      }free(soil_carbon_array);
-      
-      
-      for (i = 0; i < NUM_FAO_CTRY; i++) {
-         for (j = 0; j < ctry_aez_num[i]; j++) {
-            for (k = 0; k < num_lt_cats; k++) {
-               for(l=0; l<NUM_CARBON;l++){
-                  free(veg_carbon_array[i][j][k][l]);
-               }free(veg_carbon_array[i][j][k]);
-            }free(veg_carbon_array[i][j]);
-         }free(veg_carbon_array[i]);
-      }free(veg_carbon_array);
+            free(soil_carbon_array[i][j]);
+            free(veg_carbon_array[i][j]);
+         }
+         free(soil_carbon_array[i]);
+         free(veg_carbon_array[i]);
+      }
+      free(soil_carbon_array);
+      free(veg_carbon_array);
+      free(soil_carbon_bucket_states);
+      free(veg_carbon_bucket_states);
+      for (l = 1; l < NUM_CARBON; l++) {
+         free(soil_carbon_slab[l]);
+         free(veg_carbon_slab[l]);
+      }
+      free(soil_carbon_slab);
+      free(veg_carbon_slab);
       
+      stage_end();
    } //end carbon_enabled
 
    // process the water footprint data
@@ -1292,13 +1349,17 @@ int main(int argc, const char * argv[]) {
    
    fprintf(stdout, "\n Start water footprint %s\n", get_systime());
    
+   stage_begin("proc_water_footprint");
    if((error_code = proc_water_footprint(in_args, raster_info))) {
       fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
       return error_code;
    }
+   stage_end();
    
-   // free the land type category array
+   // free the land type category array and the lookup tables
    free(lt_cats);
+   free(lt_cat_code2ind);
+   free(sage_code2ind);
    
    // free some rasters
    free(urban_area);
@@ -1319,22 +1380,10 @@ int main(int argc, const char * argv[]) {
    }
    free(lulc_input_grid);
    
-    // allocate the arrays for all the fao input data (initialized to zero)
-    yield_fao = calloc(NUM_FAO_CTRY * NUM_SAGE_CROP * NUM_FAO_YRS, sizeof(float));
-    if(yield_fao == NULL) {
-        fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for yield_fao: main()\n", get_systime(), ERROR_MEM);
-        return ERROR_MEM;
-    }
-    harvestarea_fao = calloc(NUM_FAO_CTRY * NUM_SAGE_CROP * NUM_FAO_YRS, sizeof(float));
-    if(harvestarea_fao == NULL) {
-        fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for harvestarea_fao: main()\n", get_systime(), ERROR_MEM);
-        return ERROR_MEM;
-    }
-    production_fao = calloc(NUM_FAO_CTRY * NUM_SAGE_CROP * NUM_FAO_YRS, sizeof(float));
-    if(production_fao == NULL) {
-        fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for production_fao: main()\n", get_systime(), ERROR_MEM);
-        return ERROR_MEM;
-    }
+    stage_begin("crop_recalibration");
+    
+    // allocate the price array (initialized to zero)
+    // the annual fao data are stored sparsely by their read functions, with the years from the file headers
     prodprice_fao_reglr = calloc(NUM_GTAP_CTRY87 * NUM_SAGE_CROP, sizeof(float));
     if(prodprice_fao_reglr == NULL) {
         fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for prodprice_fao_reglr: main()\n", get_systime(), ERROR_MEM);
@@ -1344,24 +1393,30 @@ int main(int argc, const char * argv[]) {
     
 	// read in the FAO yield and harvest area data for optional harvested area and yield calibration
 	
-	// read FAO yield: yield_fao[NUM_FAO_CTRY * NUM_SAGE_CROP * NUM_FAO_YRS]
+	// read FAO yield: yield_fao
+	stage_begin("read_yield_fao");
 	if((error_code = read_yield_fao(in_args))) {
 		fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
 		return error_code;
 	}
+	stage_end();
 	
-	// read FAO harvested area: harvestarea_fao[NUM_FAO_CTRY * NUM_SAGE_CROP * NUM_FAO_YRS]
+	// read FAO harvested area: harvestarea_fao
+	stage_begin("read_harvestarea_fao");
 	if((error_code = read_harvestarea_fao(in_args))) {
 		fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
 		return error_code;
 	}
+	stage_end();
 	
 	// read in the FAO production data for disaggregating the land rents and re-calibrating yield and harvest inputs
-	// read FAO production: production_fao[NUM_FAO_CTRY * NUM_SAGE_CROP * NUM_FAO_YRS]
+	// read FAO production: production_fao
+	stage_begin("read_production_fao");
 	if((error_code = read_production_fao(in_args))) {
 		fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
 		return error_code;
 	}
+	stage_end();
 	
     // allocate the arrays for reading in the sage crops (initialized to zero)
     harvestarea_in = calloc(NUM_CELLS, sizeof(float));
@@ -1437,10 +1492,12 @@ int main(int argc, const char * argv[]) {
 		fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for cropland_area_sage: main()\n", get_systime(), ERROR_MEM);
 		return ERROR_MEM;
 	}
+	stage_begin("read_cropland_sage");
 	if((error_code = read_cropland_sage(in_args, &raster_info))) {
 		fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
 		return error_code;
 	}
+	stage_end();
 	
 	// calculate harvested area and production for SAGE_crop from FAO-calibrated SAGE crop data
 	//		read in data and perform calcs one crop at a time
@@ -1453,16 +1510,20 @@ int main(int argc, const char * argv[]) {
 	//		calculate output values: country by aez by SAGE_crop
 	//			harvestarea_crop_aez[NUM_FAO_CTRY][ctry_aez_num][NUM_SAGE_CROP]
 	//			production_crop_aez[NUM_FAO_CTRY][ctry_aez_num][NUM_SAGE_CROP]
+	stage_begin("calc_harvarea_prod_out_crop_aez");
 	if((error_code = calc_harvarea_prod_out_crop_aez(in_args, raster_info))) {
 		fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
 		return error_code;
 	}
+	stage_end();
 	
     // free some raster arrays
     free(harvestarea_in);
     free(yield_in);
     free(pasture_area);
     free(country_fao);
+    free(cell_ctry_ind);
+    free(cell_aez_ind);
     free(land_area_sage);
     free(land_mask_ctryaez);
     free(land_cells_sage);
@@ -1474,20 +1535,29 @@ int main(int argc, const char * argv[]) {
 	free(lu_detail_area);
 	
 	// aggregate harvest area and production to gcam land units
+	stage_begin("aggregate_crop2gcam");
 	if((error_code = aggregate_crop2gcam(in_args))) {
 		fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
 		return error_code;
 	}
+	stage_end();
 	
 	// write the output harvested area and production values
+	stage_begin("write_harvestarea_crop_aez");
 	if((error_code = write_harvestarea_crop_aez(in_args))) {
 		fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
 		return error_code;
 	}
+	stage_end();
+	stage_begin("write_production_crop_aez");
 	if((error_code = write_production_crop_aez(in_args))) {
 		fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
 		return error_code;
 	}
+	stage_end();
+	stage_end();
+	
+	stage_begin("land_rent");
 	
 	//////////////////
 	// land rents
@@ -1521,30 +1591,38 @@ int main(int argc, const char * argv[]) {
 	// read in original AgLU GTAP land rent data and fao price data needed for calculating new land rents
 	
 	// read original AgLU GTAP land rent: rent_orig_aez[NUM_GTAP_CTRY87 * NUM_GTAP_USE * NUM_ORIG_AEZ]
+	stage_begin("read_rent_orig");
 	if((error_code = read_rent_orig(in_args))) {
 		fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
 		return error_code;
 	}
+	stage_end();
 	
 	// read FAO producer prices: prodprice_fao[NUM_FAO_CTRY * NUM_FAO_CROP]
+	stage_begin("read_prodprice_fao");
 	if((error_code = read_prodprice_fao(in_args))) {
 		fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
 		return error_code;
 	}
+	stage_end();
 	
 	// calculate agricultural (including livestock) land rent values for new AEZs by GTAP_use
 	//		current GTAP reference year is ca. 2000
+	stage_begin("calc_rent_ag_use_aez");
 	if((error_code = calc_rent_ag_use_aez(in_args, raster_info))) {
 		fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
 		return error_code;
 	}
+	stage_end();
 	 
 	// calculate forest land rent values for new AEZs by GTAP_use
 	//		current GTAP reference year is ca. 2000
+	stage_begin("calc_rent_frs_use_aez");
 	if((error_code = calc_rent_frs_use_aez(in_args, raster_info))) {
 		fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
 		return error_code;
 	}
+	stage_end();
 	 
     // free some raster arrays
     free(aez_bounds_new);
@@ -1554,25 +1632,35 @@ int main(int argc, const char * argv[]) {
     free(country87_gtap);
     free(forest_cells);
     free(land_cells_hyde);
+    free(land_ord_hyde);
     free(missing_aez_mask);
     
 	// write the land rent values
+	stage_begin("write_rent_use_aez");
 	if((error_code = write_rent_use_aez(in_args))) {
 		fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
 		return error_code;
 	}
+	stage_end();
 	
 	// aggregate land rent to gcam land units
+	stage_begin("aggregate_use2gcam");
 	if((error_code = aggregate_use2gcam(in_args))) {
 		fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
 		return error_code;
 	}
+	stage_end();
+	stage_end();
 	
     // copy the gcam data system input files to the LDS destination directory
+    stage_begin("copy_to_destpath");
     if((error_code = copy_to_destpath(in_args))) {
         fprintf(fplog, "\nProgram terminated at %s with error_code = %i\n", get_systime(), error_code);
         return error_code;
     }
+    stage_end();
+    
+    stage_begin("free_memory");
    
    // free the hong kong and taiwan glu area arrays
    free(twn_glu_area);
@@ -1606,6 +1694,9 @@ int main(int argc, const char * argv[]) {
     free(countryabbrs_iso);
     free(countrynames_fao);
     free(ctry2ctry87codes_gtap);
+    free(fao_ctry_code2ind);
+    free(fao_crop_code2ind);
+    free(ctry2ctry87_ind);
     free(ctry2ctry87abbrs_gtap);
     free(country87codes_gtap);
     for (i = 0; i < NUM_GTAP_CTRY87; i++) {
@@ -1669,9 +1760,9 @@ int main(int argc, const char * argv[]) {
 	free(lulcnames);
 	
     // free the fao input data arrays
-    free(yield_fao);
-    free(harvestarea_fao);
-    free(production_fao);
+    free_fao_data(&yield_fao);
+    free_fao_data(&harvestarea_fao);
+    free_fao_data(&production_fao);
     free(prodprice_fao_reglr);
     
     // free the original land rent array
@@ -1702,6 +1793,13 @@ int main(int argc, const char * argv[]) {
     free(ctry_aez_num);
     free(reggcam_aez_num);
     
+    stage_end();
+    
+    // write the stage times and memory to the run report next to the log; a failure here does not fail the run
+    if((error_code = write_run_report(in_args, argv[1]))) {
+        fprintf(fplog, "Warning: failed to write the run report: main()\n");
+    }
+    
     fprintf(stdout, "\nSuccessful completion of program %s at %s\n", CODENAME, get_systime());
     
 	fprintf(fplog, "\nSuccessful completion of program %s at %s\n", CODENAME, get_systime());
@@ -0,0 +1,144 @@
+/**********
+ open_lulc_isam.c
+ 
+ open one ISAM LULC netcdf file for reading, for read_lulc_isam() and read_lulc_land()
+    the unzipped file ISAM_HYDE32_LANDCOVER_<year>.nc is opened if it exists
+    otherwise the gzipped file ISAM_HYDE32_LANDCOVER_<year>.nc.gz is decompressed in memory with zlib
+        and the netcdf file is opened from memory, so no unzipped copy is written to disk
+ 
+ the decompressed file is held in lulc_nc_buf[], which is kept and reused for the next file,
+    and grows only if a file is larger than the buffer
+    the buffer is freed in main() after the land type areas are processed
+ the buffer must not change while the file is open, so the callers serialize the lulc netcdf reads
+    and close the file before the next call
+ 
+ arguments:
+ args_struct in_args:   the input file arguments
+ int year:				the year of the file to open
+ int *ncid:				the netcdf id of the opened file
+ 
+ return value:
+	integer error code: OK = 0, otherwise a non-zero error code
+ 
+ Created 17 Oct 2026
+ 
+ Moirai Land Data System (Moirai) Copyright (c) 2019, The
+ Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S.
+ Dept. of Energy).  All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Intellectual Property Office at
+ IPO@lbl.gov.
+
+ NOTICE.  This Software was developed under funding from the U.S. Department
+ of Energy and the U.S. Government consequently retains certain rights.  As
+ such, the U.S. Government has been granted for itself and others acting on
+ its behalf a paid-up, nonexclusive, irrevocable, worldwide license in the
+ Software to reproduce, distribute copies to the public, prepare derivative
+ works, and perform publicly and display publicly, and to permit other to do
+ so.
+
+ This file is part of Moirai.
+
+ Moirai is free software: you can use it under the terms of the modified BSD-3 license (see …/moirai/license.txt)
+
+ **********/
+
+
+#include "moirai.h"
+
+int open_lulc_isam(args_struct in_args, int year, int *ncid) {
+	
+	char lname[MAXCHAR];			// file name to open
+	char tmp_str[MAXCHAR];			// temporary string
+	FILE *fpin;						// file pointer
+	gzFile gzin;					// gzipped file pointer
+	int ncerr;						// error return value; 0 = ok
+	int nread;						// number of bytes decompressed by the last read
+	size_t nc_len = 0;				// length of the decompressed file
+	size_t new_size;				// the grown buffer size
+	char *new_buf;					// the grown buffer
+	
+	// some input data file name prefixes and suffixes
+	const char basename[] = "ISAM_HYDE32_LANDCOVER_";		// base file name
+	const char nctag[] = ".nc";					// suffix for file names, netcdf, unzipped
+	const char ncgztag[] = ".nc.gz";			// suffix for file names, netcdf, gzipped
+	
+	size_t init_size = 64 * 1024 * 1024;		// the initial buffer size (bytes); about the size of one decompressed file
+	unsigned int chunk = 16 * 1024 * 1024;		// the maximum number of bytes to decompress at once
+	
+	// use the unzipped file if it is there
+	strcpy(lname, in_args.lulcpath);
+	strcat(lname, basename);
+	sprintf(tmp_str, "%i%s", year, nctag);
+	strcat(lname, tmp_str);
+	if((fpin = fopen(lname, "rb")) != NULL)
+	{
+		fclose(fpin);
+		if ((ncerr = nc_open(lname, NC_NOWRITE, ncid))) {
+			fprintf(fplog,"Failed to open %s for reading: open_lulc_isam(); ncerr = %i\n", lname, ncerr);
+			return ERROR_FILE;
+		}
+		return OK;
+	}
+	
+	// otherwise decompress the gzipped file into the buffer
+	strcpy(lname, in_args.lulcpath);
+	strcat(lname, basename);
+	sprintf(tmp_str, "%i%s", year, ncgztag);
+	strcat(lname, tmp_str);
+	if((gzin = gzopen(lname, "rb")) == NULL)
+	{
+		fprintf(fplog,"Failed to open %s for reading: open_lulc_isam()\n", lname);
+		return ERROR_FILE;
+	}
+	gzbuffer(gzin, 1024 * 1024);
+	
+	if (lulc_nc_buf == NULL) {
+		lulc_nc_buf = malloc(init_size);
+		if(lulc_nc_buf == NULL) {
+			fprintf(fplog,"Failed to allocate memory for lulc_nc_buf: open_lulc_isam()\n");
+			gzclose(gzin);
+			return ERROR_MEM;
+		}
+		lulc_nc_buf_size = init_size;
+	}
+	
+	while (1) {
+		// double the buffer if it is full
+		if (nc_len == lulc_nc_buf_size) {
+			new_size = 2 * lulc_nc_buf_size;
+			new_buf = realloc(lulc_nc_buf, new_size);
+			if(new_buf == NULL) {
+				fprintf(fplog,"Failed to allocate memory for lulc_nc_buf: open_lulc_isam()\n");
+				gzclose(gzin);
+				return ERROR_MEM;
+			}
+			lulc_nc_buf = new_buf;
+			lulc_nc_buf_size = new_size;
+		}
+		if (lulc_nc_buf_size - nc_len < chunk) {
+			nread = gzread(gzin, &lulc_nc_buf[nc_len], (unsigned int) (lulc_nc_buf_size - nc_len));
+		} else {
+			nread = gzread(gzin, &lulc_nc_buf[nc_len], chunk);
+		}
+		if (nread < 0) {
+			fprintf(fplog,"Failed to decompress %s: open_lulc_isam(); %s\n", lname, gzerror(gzin, &ncerr));
+			gzclose(gzin);
+			return ERROR_FILE;
+		}
+		if (nread == 0) {
+			break;
+		}
+		nc_len = nc_len + nread;
+	}
+	gzclose(gzin);
+	
+	if ((ncerr = nc_open_mem(lname, NC_NOWRITE, nc_len, lulc_nc_buf, ncid))) {
+		fprintf(fplog,"Failed to open %s for reading: open_lulc_isam(); ncerr = %i\n", lname, ncerr);
+		return ERROR_FILE;
+	}
+	
+	return OK;
+}
@@ -2,12 +2,15 @@
  parse_utils.c
  
  contains the following functions for parsing text records:
-	get_float_field()
-	get_int_field()
-	get_text_field()
-	get_field()
+	split_fields() - splits a record once into field spans
+	get_float_fld()
+	get_int_fld()
+	get_text_fld()
+	free_fields()
 	rm_whitesp()
-	is_num() - not sure i need this one
+	rm_quotes()
+	is_num()
+	is_blank()
  
  Created by Alan Di Vittorio on 6 June 2013
  
@@ -36,189 +39,204 @@
 
 #include "moirai.h"
 
-/********
- int get_float_field(char *line, const char *delim, int findex, float *fltval)
+/*******
+ int split_fields(char *line, const char *delim, fields_struct *fields)
  line:		string containing record info
  delim:		the delimiting character
- findex:	index of the desired field--this must start at one
- fltval:	the address for storing the retrieved float value
- return:	floating point field value; 0 if string is empty; ERROR_STR if field is not numeric
- ********/
-int get_float_field(char *line, const char *delim, int findex, float *fltval)
+ fields:	the field spans of the record; the arrays grow as needed and are freed by free_fields()
+			initialize the struct to zero before the first call
+ return:	error code
+ note:		the line is scanned once, and the fields point into it, so the line must not change while they are used
+ note:		double quote marks denote that at least one comma is embedded in the field,
+			 and quoted fields are delineated by the double quote marks
+ note:		a quoted field keeps its quote marks and extends from the closing quote to the next delimiter
+ note:		the last field contains whatever end of line characters might be present
+ ******/
+int split_fields(char *line, const char *delim, fields_struct *fields)
 {
-	int error_code = OK;
-	char str_field[MAXCHAR];
-	char tmp[MAXCHAR];
+	char *cptr;				// pointer for looping over characters in line
+	char **tmp_fptr;		// for growing the field start array
+	int *tmp_flen;			// for growing the field length array
 	
-	/* use get_text_field() to get the field without spaces */
-	if ((error_code = get_text_field(line, delim, findex, str_field)) != OK) {
-		fprintf(fplog, "Error parsing text record: get_float_field(); text field %i not retrieved\n", findex);
-		return error_code;
-	}
+	fields->num_fields = 0;
+	cptr = line;
+	// this is the loop over the line; each pass is one field
+	while (1) {
+		if (fields->num_fields == fields->max_fields) {
+			tmp_fptr = realloc(fields->fptr, (fields->max_fields + 64) * sizeof(char*));
+			if (tmp_fptr == NULL) {
+				fprintf(fplog, "Failed to allocate memory for fields: split_fields()\n");
+				return ERROR_MEM;
+			}
+			fields->fptr = tmp_fptr;
+			tmp_flen = realloc(fields->flen, (fields->max_fields + 64) * sizeof(int));
+			if (tmp_flen == NULL) {
+				fprintf(fplog, "Failed to allocate memory for fields: split_fields()\n");
+				return ERROR_MEM;
+			}
+			fields->flen = tmp_flen;
+			fields->max_fields = fields->max_fields + 64;
+		}
+		
+		fields->fptr[fields->num_fields] = cptr;
+		if (*cptr == '\"') {	// quoted field
+			cptr++;
+			while (*cptr && *cptr != '\"') {
+				cptr++;
+			}
+			if (*cptr) {
+				cptr++;
+			}
+		}
+		while (*cptr && *cptr != *delim) {
+			cptr++;
+		}
+		fields->flen[fields->num_fields] = (int) (cptr - fields->fptr[fields->num_fields]);
+		fields->num_fields++;
+		
+		if (!*cptr) {
+			break;
+		}
+		cptr++;	// advance past the delimiter
+	}	// end while loop over line
 	
-	// remove bracketing quotes if they exist, otherwise just copy the field as is
-	rm_quotes(tmp, str_field);
+	return OK;
+}
+
+/*******
+ int get_text_fld(fields_struct *fields, int findex, char *str_field)
+ fields:	the fields of the record, from split_fields()
+ findex:	index of the desired field--this must start at one
+ str_field:	address of character string for storing the contents of retrieved field:
+			whitespace removed; "" if empty field
+ return:	error code
+ note:		removes whitespace, but not bracketing quotes
+ note:		throws error if the field is not in the record or the field is longer than MAXCHAR
+ ******/
+int get_text_fld(fields_struct *fields, int findex, char *str_field)
+{
+	int i;
+	int len = 0;		// length of the field without whitespace
+	char *cptr;			// pointer for looping over characters in the field
 	
-	// atof() of a string that does not start with an inerpretable number returns 0 (including empty string)
-	//  interpretable numbers include decimals and scientific notation (characters .,e,E,-,+ in the proper place)
-	// so throw an error if other characters are present
-	//  this restricts atof() from operating on fields with suffix character beyond the number
-	// this will not catch typos because the return value will be zero or a different number
-	if (is_num(tmp)) {
-		*fltval = (float) atof(tmp);
+	if (findex < 1 || findex > fields->num_fields) {
+		fprintf(fplog, "Error processing file record: get_text_fld(); findex=%i not in the %i fields\n",
+				findex, fields->num_fields);
+		return ERROR_FILE;
 	}
-	else{
-		fprintf(fplog, "Error parsing text record: get_float_field(); non-numeric field %i\n", findex);
-		return ERROR_STR;
+	
+	cptr = fields->fptr[findex - 1];
+	for (i = 0; i < fields->flen[findex - 1]; i++) {
+		if (!isspace((int) cptr[i])) {
+			if (len == MAXCHAR - 1) {
+				fprintf(fplog, "Error processing file record: get_text_fld(); field %i is longer than %i\n",
+						findex, MAXCHAR - 1);
+				return ERROR_STR;
+			}
+			str_field[len++] = cptr[i];
+		}
 	}
+	str_field[len] = '\0';
 	
 	return OK;
 }
 
 /********
- int get_int_field(char *line, const char *delim, int findex, int *intval)
- line:		string containing record info
- delim:		the delimiting character
+ int get_float_fld(fields_struct *fields, int findex, float *fltval)
+ fields:	the fields of the record, from split_fields()
  findex:	index of the desired field--this must start at one
  fltval:	the address for storing the retrieved float value
- return:	integer field value; 0 if string is empty; ERROR_STR if field is not numeric
+ return:	floating point field value; 0 if string is empty; ERROR_STR if field is not numeric
  ********/
-int get_int_field(char *line, const char *delim, int findex, int *intval)
+int get_float_fld(fields_struct *fields, int findex, float *fltval)
 {
 	int error_code = OK;
 	char str_field[MAXCHAR];
-	char tmp[MAXCHAR];
+	char *num_str;			// the field without bracketing quotes
+	int len;				// length of the field
 	
-	/* use get_text_field() to get the field without spaces */
-	if ((error_code = get_text_field(line, delim, findex, str_field)) != OK) {
-		fprintf(fplog, "Error parsing text record: get_int_field(); text field %i not retrieved\n", findex);
+	/* use get_text_fld() to get the field without spaces */
+	if ((error_code = get_text_fld(fields, findex, str_field)) != OK) {
+		fprintf(fplog, "Error parsing text record: get_float_fld(); text field %i not retrieved\n", findex);
 		return error_code;
 	}
 	
-	// remove bracketing quotes if they exist, otherwise just copy the field as is
-	rm_quotes(tmp, str_field);
+	// remove bracketing quotes if they exist
+	num_str = str_field;
+	len = (int) strlen(str_field);
+	if (len >= 2 && str_field[0] == '\"') {
+		str_field[len - 1] = '\0';
+		num_str = &str_field[1];
+	}
 	
-	// atoi() of a string that does not start with an inerpretable number returns 0 (including empty string)
-	//  interpretable numbers include decimals and scientific notation (characters .,e,E,-,+ in the proper place)
-	// so throw an error if other characters are present
-	//  this restricts atoi() from operating on fields with suffix character beyond the number
-	// this will not catch typos because the return value will be zero or a different number
-	if (is_num(tmp)) {
-		*intval = atoi(tmp);
+	// atof() of a string that does not start with an interpretable number returns 0 (including empty string)
+	// so throw an error if characters other than those of a number are present
+	if (is_num(num_str)) {
+		*fltval = (float) atof(num_str);
 	}
 	else{
-		fprintf(fplog, "Error parsing text record: get_int_field(); non-numeric field %i\n", findex);
+		fprintf(fplog, "Error parsing text record: get_float_fld(); non-numeric field %i\n", findex);
 		return ERROR_STR;
 	}
 	
 	return OK;
 }
 
-/*******
- int get_text_field(char *line, const char *delim, int findex, char *str_field)
- line:		string containing record info
- delim:		delimiting character
+/********
+ int get_int_fld(fields_struct *fields, int findex, int *intval)
+ fields:	the fields of the record, from split_fields()
  findex:	index of the desired field--this must start at one
- str_field:	address of character string for storing the contents of retrieved field:
-			whitespace removed; "" if empty field or if field not found
- return:	error code
- note:		removes whitespace, but not bracketing quotes
- ******/
-int get_text_field(char *line, const char *delim, int findex, char *str_field)
+ intval:	the address for storing the retrieved integer value
+ return:	integer field value; 0 if string is empty; ERROR_STR if field is not numeric
+ ********/
+int get_int_fld(fields_struct *fields, int findex, int *intval)
 {
 	int error_code = OK;
-	char tmp[MAXCHAR];
+	char str_field[MAXCHAR];
+	char *num_str;			// the field without bracketing quotes
+	int len;				// length of the field
 	
-	/* use get_field() to retrieve the field */
-	if ((error_code = get_field(line, delim, findex, str_field)) != OK) {
-		fprintf(fplog, "Error parsing text record: get_text_field(); field %i not retrieved\n", findex);
+	/* use get_text_fld() to get the field without spaces */
+	if ((error_code = get_text_fld(fields, findex, str_field)) != OK) {
+		fprintf(fplog, "Error parsing text record: get_int_fld(); text field %i not retrieved\n", findex);
 		return error_code;
 	}
 	
-	/* remove whitespace characters if the string is not empty */
-	if (strlen(str_field) > 0) {
-		rm_whitesp(tmp, str_field);
-		strcpy(str_field, tmp);
-	}
-
-	return OK;
-}
-
-/*******
- int get_field(char *line, const char *delim, int findex, char *str_field)
- line:		string containing record info
- delim:		the delimiting character
- findex:	index of the desired field--this must start at one
- str_field:	address of character string for storing the contents of field:
-			"" if empty field or if field is not found
- return:	error code
- note:		throws error if the field is not found
- note:		does not throw whitespace error
- note:		does not remove bracketing quotes
- note:		double quote marks denote that at least one comma is embedded in the field,
-			 and quoted fields are delineated by the double quote marks
- note:		if the field is the last one in the line in will contain whatever end of line characters might be present
- todo:		remove end of line characters if necessary
- ******/
-int get_field(char *line, const char *delim, int findex, char *str_field)
-{	
-	int fld_index;			// current index in field
-	int is_newfld;			// flag to denote the end of a field
-	int count_flds = 0;		// count the number of fields
-	char *cptr;				// pointer for looping over characters in line
-	char *qchar = "\"";		// double quote for quoted fields
-	char fend[MAXCHAR];		// character denoting the end of the field
-	char fld_str[MAXCHAR];	// field string array
-
-	if (findex < 1) {
-		fprintf(fplog, "Error processing file record: get_field(); findex=%i < 1\n", findex);
-		return ERROR_FILE;
+	// remove bracketing quotes if they exist
+	num_str = str_field;
+	len = (int) strlen(str_field);
+	if (len >= 2 && str_field[0] == '\"') {
+		str_field[len - 1] = '\0';
+		num_str = &str_field[1];
 	}
-
-	/* loop to the desired field */
-	cptr = line;
-	// this is the loop over the line
-	while (count_flds++ < findex) {
-		fld_index = 0;
-		is_newfld = 0;
-		strcpy(fend, delim);
-		// this is the loop over each field
-		while (*cptr) {
-			if (!is_newfld) {
-				if (fld_index == 0 && *cptr == '\"') {	// quoted field
-					strcpy(fend, qchar);
-					fld_str[fld_index++] = *cptr++;
-				} else {
-					if (!strncmp(cptr, fend, 1)) {
-						is_newfld = 1;
-						if (*fend == '\"') {	// end of quoted field
-							fld_str[fld_index++] = *cptr;
-							cptr = cptr + 2;	// advance past the delimiter
-						} else {
-							cptr++;
-						}
-					} else {
-						fld_str[fld_index++] = *cptr++;
-					}
-				}	// end if quoted field else not quoted field
-
-			} else {
-				break;
-			}
-		} // end while loop over field
-		fld_str[fld_index] = '\0';	// terminate the field string
-		if (!*cptr && count_flds != findex) {
-			fprintf(fplog, "Error processing file record: get_field(); last field=%i reached before findex=%i\n",
-					count_flds, findex);
-			return ERROR_FILE;	// return if end of line is found before findex is reached
-		}
-	}	// end while loop over line 
 	
-	strcpy(str_field, fld_str);
+	// atoi() of a string that does not start with an interpretable number returns 0 (including empty string)
+	// so throw an error if characters other than those of a number are present
+	if (is_num(num_str)) {
+		*intval = atoi(num_str);
+	}
+	else{
+		fprintf(fplog, "Error parsing text record: get_int_fld(); non-numeric field %i\n", findex);
+		return ERROR_STR;
+	}
 	
 	return OK;
 }
 
+/********
+ void free_fields(fields_struct *fields)
+ fields:	the fields struct used with split_fields(); it is reset so it can be used again
+ ********/
+void free_fields(fields_struct *fields)
+{
+	free(fields->fptr);
+	free(fields->flen);
+	fields->fptr = NULL;
+	fields->flen = NULL;
+	fields->num_fields = 0;
+	fields->max_fields = 0;
+}
+
 /********
  int rm_whitesp(char *cln_field,char *str_field)
  cln_field:		pointer to field string with all whitespace removed
@@ -293,3 +311,19 @@ int is_num(char *str_field)
 	}
 	return 1;}
 
+/*********
+ int is_blank(char *str_field)
+ str_field:	character string, such as a record
+ return:		1 if the string is empty or all whitespace; 0 otherwise
+ **********/
+int is_blank(char *str_field)
+{
+	char *onechar;
+	
+	for (onechar = str_field; *onechar; onechar++) {
+		if (!isspace((int) *onechar)) {
+			return 0;
+		}
+	}
+	return 1;
+}
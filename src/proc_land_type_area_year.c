@@ -0,0 +1,525 @@
+/**********
+ proc_land_type_area_year.c
+
+ process one hyde year of land type area for proc_land_type_area()
+    the hyde land use and the lulc land cover data for the year have been read into the scratch space by read_lta_inputs()
+    determine the lu and reference veg areas of each working grid cell with proc_lulc_area()
+    add the areas to the year_ind slice of the country X glu X land type X year output array
+    write the land use/cover grids if this is the lulc_out_year
+
+ this is the body of the year loop in proc_land_type_area(), so see that function for the processing details
+ all working space is in the scratch space, and only area_out[][][][year_ind] is written in the shared arrays,
+    so different years can be processed concurrently with separate scratch spaces
+ the lulc cells are processed concurrently in chunks of NUM_LULC_CHUNK cells with scratch->num_cell_threads threads,
+    and then the areas of each chunk are added to the outputs in lulc cell order,
+    so the sums are the same as for serial processing, for any number of threads
+ the diagnostic log output is serialized across threads
+
+ arguments:
+ args_struct in_args: the input file arguments
+ rinfo_struct raster_info: information about input raster data
+ int year_ind: the index of the year to process in hyde_years
+ int *hyde_years: the hyde years
+ lta_scratch_struct *scratch: the scratch space for this year, from alloc_lta_scratch(), with the inputs from read_lta_inputs()
+ double ****area_out: the output area array, dim1=fao country, dim2=glu, dim3=land type category, dim4=hyde year
+
+ return value:
+	integer error code: OK = 0, otherwise a non-zero error code
+
+ Created 17 Oct 2026
+
+ Moirai Land Data System (Moirai) Copyright (c) 2019, The
+ Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S.
+ Dept. of Energy).  All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Intellectual Property Office at
+ IPO@lbl.gov.
+
+ NOTICE.  This Software was developed under funding from the U.S. Department
+ of Energy and the U.S. Government consequently retains certain rights.  As
+ such, the U.S. Government has been granted for itself and others acting on
+ its behalf a paid-up, nonexclusive, irrevocable, worldwide license in the
+ Software to reproduce, distribute copies to the public, prepare derivative
+ works, and perform publicly and display publicly, and to permit other to do
+ so.
+
+ This file is part of Moirai.
+
+ Moirai is free software: you can use it under the terms of the modified BSD-3 license (see …/moirai/license.txt)
+
+ **********/
+
+#include "moirai.h"
+
+int proc_land_type_area_year(args_struct in_args, rinfo_struct raster_info, int year_ind, int *hyde_years, lta_scratch_struct *scratch, double ****area_out) {
+	
+	int i, j, k, m;
+	int grid_ind;               // the index within the 1d grid of the current land cell
+	int rv_ind;                 // the index of the current reference veg land type
+	int err = OK;				// store error code from the write functions
+	int chunk_start;			// the first lulc cell of the current chunk
+	int chunk_end;				// one past the last lulc cell of the current chunk
+	
+	// should probably retrieve these from the info arrays
+	int urban_ind = 0;		// index in lu_area of urban values
+	int crop_ind = 1;		// index in lu_area of cropland values; may need to find these from an array
+	int pasture_ind = 2;	// index in lu_area of pasture values
+	
+	// lulc raster info
+	int ncells_lulc = raster_info.lulc_input_ncells;	// number of lulc input cells
+	
+	// the scratch space for this year
+	float *crop_grid = scratch->crop_grid;
+	float *pasture_grid = scratch->pasture_grid;
+	float *urban_grid = scratch->urban_grid;
+	float **lu_detail_grid = scratch->lu_detail_grid;
+	float **lulc_temp_grid = scratch->lulc_temp_grid;
+	float *refveg_area_grid = scratch->refveg_area_grid;
+	int *refveg_them_out = scratch->refveg_them_out;
+	double *lu_area;		// the lu areas of the current lulc cell, in the chunk arrays; [lu cell * NUM_HYDE_TYPES + hyde type]
+	int *lu_indices;		// the working grid indices of the lu cells in the current lulc cell, in lulc_child_cells[]
+	double *refveg_area_out;	// the ref veg areas of the current lulc cell, in the chunk arrays
+	int *refveg_them;		// the ref veg type values of the current lulc cell, in the chunk arrays
+	double *global_lulc_in = scratch->global_lulc_in;
+	double *global_lt_out = scratch->global_lt_out;
+	
+	// used to determine working grid cell indices
+	
+	int rv_value;           // the reference veg value for the current land type category
+	int aez_val;            // current aez value
+	int ctry_code;          // current fao country code
+	int aez_ind;            // current aez index in ctry_aez_list[ctry_ind]
+	int ctry_ind;           // current country index in ctry_aez_list
+	int cur_lt_cat;         // current land type category
+	int cur_lt_cat_ind;     // current land type category index
+	
+	double global_area_out;	// total land area out
+	double global_area_in;	// total land area in
+	float temp_frac;
+	float rfarea_check;
+	float luarea_check;
+	
+	char fname[MAXCHAR];        // current file name to write
+	char tmp_str[1100];        // temporary string
+	
+	double tmp_dbl;
+	
+	// keep this year's progress lines out of the other years' log blocks
+#pragma omp critical (fplog_write)
+	{
+		fprintf(fplog,"\nCurrently processing Year: %i",year_ind+1);
+		if (in_args.diagnostics) {
+			fprintf(fplog, "\nYear %i: proc_land_type_area()\n", hyde_years[year_ind]);
+		}
+	}
+	
+	// initialize the diagnostic tracking arrays
+	for (j = 0; j < NUM_SAGE_PVLT + 1 + NUM_HYDE_TYPES; j++) {
+		global_lt_out[j] = 0;
+		global_lulc_in[j] = 0;
+	}
+	
+	// initialize these each year, since all other variables are either read-in or initialized each loop
+	for (j = 0; j < NUM_CELLS; j++) {
+		refveg_area_grid[j] = 0;
+		refveg_them_out[j] = 0;
+	}
+	
+	// loop over the coarse lulc data in chunks of NUM_LULC_CHUNK cells
+	// each lulc cell changes only its own lu cells, so the cells of a chunk are processed concurrently into the chunk arrays
+	// then the chunk areas are added to the outputs serially in lulc cell order,
+	//	so the sums are bitwise the same for any number of threads
+	for (chunk_start = 0; chunk_start < ncells_lulc; chunk_start = chunk_start + NUM_LULC_CHUNK) {
+		chunk_end = chunk_start + NUM_LULC_CHUNK;
+		if (chunk_end > ncells_lulc) {
+			chunk_end = ncells_lulc;
+		}
+		
+		// the cells with no land take little time, so hand out the cells in small blocks
+#pragma omp parallel for num_threads(scratch->num_cell_threads) if(scratch->num_cell_threads > 1) schedule(dynamic, 16)
+		for (i = chunk_start; i < chunk_end; i++) {
+			int cell_thread_ind = 0;	// the workspace index of this thread
+			int cur_err;				// the current error state
+			int cell_err;				// error code for this lulc cell
+			int jj, lu_count;
+			int chunk_ind = i - chunk_start;	// the index of this lulc cell in the chunk arrays
+			int *cell_lu_indices;		// the working grid indices of the lu cells in this lulc cell
+			lulc_work_struct cell_work;	// the workspace for this cell, with the outputs in the chunk arrays
+			
+#pragma omp atomic read
+			cur_err = err;
+			if (cur_err != OK) {
+				continue;
+			}
+#ifdef _OPENMP
+			cell_thread_ind = omp_get_thread_num();
+#endif
+			cell_work = scratch->lulc_work[cell_thread_ind];
+			cell_work.lu_area = &scratch->chunk_lu_area[(size_t) chunk_ind * NUM_LU_CELLS * NUM_HYDE_TYPES];
+			cell_work.refveg_area_out = &scratch->chunk_refveg_area[chunk_ind * NUM_LU_CELLS];
+			cell_work.refveg_them = &scratch->chunk_refveg_them[chunk_ind * NUM_LU_CELLS];
+			
+			// get lulc areas for this cell
+			for (jj = 0; jj < NUM_LULC_TYPES; jj++) {
+				cell_work.lulc_area[jj] = (double) lulc_temp_grid[jj][i];
+			}
+			
+			// the working grid 1d indices of the lu cells in this lulc cell are in lulc_child_cells[], from get_lulc_topology()
+			cell_lu_indices = &lulc_child_cells[i * NUM_LU_CELLS];
+			// now loop over the lu cells to gather the input areas, and initialize the ref veg values
+			for (lu_count = 0; lu_count < NUM_LU_CELLS; lu_count++) {
+				cell_work.lu_area[lu_count * NUM_HYDE_TYPES + urban_ind] = (double) urban_grid[cell_lu_indices[lu_count]];
+				cell_work.lu_area[lu_count * NUM_HYDE_TYPES + crop_ind] = (double) crop_grid[cell_lu_indices[lu_count]];
+				cell_work.lu_area[lu_count * NUM_HYDE_TYPES + pasture_ind] = (double) pasture_grid[cell_lu_indices[lu_count]];
+				for (jj = NUM_HYDE_TYPES_MAIN; jj < NUM_HYDE_TYPES; jj++) {
+					cell_work.lu_area[lu_count * NUM_HYDE_TYPES + jj] = (double) lu_detail_grid[jj-NUM_HYDE_TYPES_MAIN][cell_lu_indices[lu_count]];
+				}
+				cell_work.refveg_area_out[lu_count] = 0;
+				cell_work.refveg_them[lu_count] = 0;
+			} // end for lu_count loop over the lu cells
+			
+			// calculate the areas for this lulc cell
+			// this keeps the hyde land use (but checks it for land consistency), and disaggregates the lc data to the non-lu cell area
+			cell_err = proc_lulc_area(in_args, raster_info, &cell_work, cell_lu_indices, NUM_LU_CELLS, i);
+			if (cell_err != OK) {
+				fprintf(fplog, "Failed to process lulc cell %i for year %i: proc_land_type_area()\n", i, hyde_years[year_ind]);
+#pragma omp critical (lta_cell_err)
+				if (err == OK) {
+#pragma omp atomic write
+					err = cell_err;
+				}
+			}
+		} // end for i loop over the lulc cells in the chunk
+		
+		if (err != OK) {
+			return err;
+		}
+		
+		// add the areas of the chunk to the outputs in lulc cell order
+		for (i = chunk_start; i < chunk_end; i++) {
+			
+			//fprintf(fplog,"protected category is %i,  fraction value is %f, cell number is %i",k,temp_frac,i);
+			//if (in_args.diagnostics) {
+			//	fprintf(fplog, "\nLULC cell %i: proc_land_type_area()\n", i);
+			//}
+			
+			// aggregate the lulc land cover type areas to pot veg types for global area
+			// the sage pvlt values are the indices here, because of the zero unknown value
+			// so sage pvlt data are first, then hyde data
+			for (j = 0; j < NUM_LULC_LC_TYPES; j++) {
+				if ((double) lulc_temp_grid[j][i] != raster_info.lulc_input_nodata && lulc2sagecodes[j] != -1) {
+					global_lulc_in[lulc2sagecodes[j]] = global_lulc_in[lulc2sagecodes[j]] + (double) lulc_temp_grid[j][i];
+				}
+			}
+			for (j = NUM_LULC_LC_TYPES; j < NUM_LULC_TYPES; j++) {
+				if ((double) lulc_temp_grid[j][i] != raster_info.lulc_input_nodata && lulc2hydecodes[j] != -1) {
+					global_lulc_in[NUM_SAGE_PVLT + lulc2hydecodes[j]] = global_lulc_in[NUM_SAGE_PVLT + lulc2hydecodes[j]] + (double) lulc_temp_grid[j][i];
+				}
+			}
+			
+			// this lulc cell's lu cells and its areas from proc_lulc_area() in the chunk arrays
+			lu_indices = &lulc_child_cells[i * NUM_LU_CELLS];
+			lu_area = &scratch->chunk_lu_area[(size_t) (i - chunk_start) * NUM_LU_CELLS * NUM_HYDE_TYPES];
+			refveg_area_out = &scratch->chunk_refveg_area[(i - chunk_start) * NUM_LU_CELLS];
+			refveg_them = &scratch->chunk_refveg_them[(i - chunk_start) * NUM_LU_CELLS];
+			
+
+			// add data to output array as appropriate
+			// don't need to store the updated grid data at all in the read in grids
+			//This loop ends at line ~670
+			rfarea_check = 0;
+			luarea_check = 0;
+			for (j = 0; j < NUM_LU_CELLS; j++) {
+			
+				grid_ind = lu_indices[j];
+				// process only if there is land area
+				// also skip if not a valid economic country
+			
+				// this is to output a map of the areas in the output data files, for a selected year
+				// note that the carbon output from proc_refveg_carbon is for year REF_YEAR only - it uses these same filters
+				// set cell to nodata if it is not a land cell
+				// note that some (330) artcic cells originally have zero land area
+				// additional cells are set to zero below if they are not included in the output calcs
+				//		they are not included in outputs if there is no aez or country 87 value
+			
+				if (land_area_hyde[grid_ind] != raster_info.land_area_hyde_nodata) {
+					crop_grid[grid_ind] = (float) lu_area[j * NUM_HYDE_TYPES + crop_ind];
+					pasture_grid[grid_ind] = (float) lu_area[j * NUM_HYDE_TYPES + pasture_ind];
+					urban_grid[grid_ind] = (float) lu_area[j * NUM_HYDE_TYPES + urban_ind];
+					for (m = NUM_HYDE_TYPES_MAIN; m < NUM_HYDE_TYPES; m++) {
+						lu_detail_grid[m-NUM_HYDE_TYPES_MAIN][grid_ind] = (float) lu_area[j * NUM_HYDE_TYPES + m];
+					}
+					refveg_area_grid[grid_ind] = (float) refveg_area_out[j];
+					refveg_them_out[grid_ind] = refveg_them[j];
+					// this was used to check the REF_YEAR values here against calc_refveg_area
+					rfarea_check = rfarea_check + refveg_area_out[j];
+					luarea_check = luarea_check + lu_area[j * NUM_HYDE_TYPES + crop_ind] + lu_area[j * NUM_HYDE_TYPES + pasture_ind] + lu_area[j * NUM_HYDE_TYPES + urban_ind];
+				
+				} else {
+					crop_grid[grid_ind] = NODATA;
+					pasture_grid[grid_ind] = NODATA;
+					urban_grid[grid_ind] = NODATA;
+					for (m = NUM_HYDE_TYPES_MAIN; m < NUM_HYDE_TYPES; m++) {
+						lu_detail_grid[m-NUM_HYDE_TYPES_MAIN][grid_ind] = NODATA;
+					}
+					refveg_area_grid[grid_ind] = NODATA;
+					refveg_them_out[grid_ind] = raster_info.potveg_nodata;
+				}
+			
+				//if (i == 63120) {
+				//	fprintf(cell_file, "proc_land_type_area,%i,%i,%i,%f,%lf,%lf,%lf,%lf,%lf\n", j, grid_ind, i, land_area_hyde[grid_ind], refveg_area_out[j], lu_area[j * NUM_HYDE_TYPES + crop_ind] + lu_area[j * NUM_HYDE_TYPES + pasture_ind] + lu_area[j * NUM_HYDE_TYPES + urban_ind], lu_area[j * NUM_HYDE_TYPES + 0], lu_area[j * NUM_HYDE_TYPES + 1], lu_area[j * NUM_HYDE_TYPES + 2]);
+				//}
+
+				if (land_area_hyde[grid_ind] != raster_info.land_area_hyde_nodata && land_area_hyde[grid_ind] != 0) {
+				
+					aez_val = aez_bounds_new[grid_ind];
+					ctry_code = country_fao[grid_ind];
+				
+					if (aez_val != raster_info.aez_new_nodata) {
+						// get the fao country index (serbia and montenegro are merged into scg) from the index raster
+						ctry_ind = cell_ctry_ind[grid_ind];
+					
+						// skip if not a valid economic country
+						if (ctry_ind == NOMATCH || ctry2ctry87codes_gtap[ctry_ind] == NOMATCH) {
+							// now update this year's grids to reflect that this cell is not included in the outputs
+							// set the areas to zero, and set the refveg category to nodata
+							crop_grid[grid_ind] = 0;
+							pasture_grid[grid_ind] = 0;
+							urban_grid[grid_ind] = 0;
+							for (m = NUM_HYDE_TYPES_MAIN; m < NUM_HYDE_TYPES; m++) {
+								lu_detail_grid[m-NUM_HYDE_TYPES_MAIN][grid_ind] = 0;
+							}
+							refveg_area_grid[grid_ind] = 0;
+	                 refveg_them_out[grid_ind] = raster_info.potveg_nodata;
+							continue;
+						}
+					
+						// get the glu index within the country glu list from the index raster
+						aez_ind = cell_aez_ind[grid_ind];
+					
+						// this shouldn't happen because the countryXglu list has been made already
+						if (aez_ind == NOMATCH) {
+							fprintf(fplog, "Failed to match glu %i to country %i: proc_land_type_area()\n",aez_val,ctry_code);
+							return ERROR_IND;
+						}
+					
+						// generate the land type category and add/store the area
+					
+						// get index of ref veg to make sure it is valid
+						rv_ind = NOMATCH;
+						if (refveg_them[j] >= 0 && refveg_them[j] <= max_sage_code) {
+							rv_ind = sage_code2ind[refveg_them[j]];
+						}
+					
+						// if no ref veg cat, then use the unknown value of 0, otherwise set it to the grid value
+						if (rv_ind == NOMATCH) {
+							rv_value = 0;
+						} else {
+							rv_value = refveg_them[j];
+						}
+					
+						//Print log 
+						//fprintf(fplog, "Currently processing protected category %i:proc_land_type_area()\n", k);
+						// reference veg; i.e. non-crop, non-pasture, non-urban
+					
+						//kbn 2020
+						for (k = 0; k < NUM_EPA_PROTECTED; k++){
+							//get fraction of land area of protected category
+							temp_frac = protected_EPA[k][land_ord_hyde[grid_ind]];
+						
+							// reference veg
+							cur_lt_cat = rv_value * SCALE_POTVEG + k;
+						
+							//fprintf(fplog,"cur_lt_cat is %i",cur_lt_cat);
+						
+							cur_lt_cat_ind = lt_cat_code2ind[cur_lt_cat];
+							if (cur_lt_cat_ind == NOMATCH) {
+								fprintf(fplog, "Failed to match lt_cat %i: reference veg %i, EPACAT %i proc_land_type_area()\n", rv_value, cur_lt_cat,k);
+								return ERROR_IND;
+							}
+							if (refveg_area_out[j] != NODATA) { // don't add if NODATA
+								tmp_dbl =(refveg_area_out[j]) * temp_frac;
+								area_out[ctry_ind][aez_ind][cur_lt_cat_ind][year_ind] = area_out[ctry_ind][aez_ind][cur_lt_cat_ind][year_ind] +((refveg_area_out[j]) * temp_frac);
+							
+								//if(j = 100){
+								//fprintf(fplog,"protected area is %i, reference area is %lf, cur_lt_cat is %i",protected_EPA[k][j],refveg_area_out[j],cur_lt_cat);
+								//}
+							
+								// sum the global out land type area
+								// use the rv values as the index to capture the unknown value of zero
+								global_lt_out[rv_value] = global_lt_out[rv_value] + ((refveg_area_out[j])* temp_frac);
+							}
+						
+							/*
+							if(countrycodes_fao[ctry_ind] == 58 && aez_val == 180) {
+								if(cur_lt_cat == 1007) {
+									fprintf(fplog, "ctry %i, glu %i, lt %i, rv = %i, gi = %i: ra = %lf, pf = %f \n", countrycodes_fao[ctry_ind], aez_val, cur_lt_cat, rv_ind, grid_ind, refveg_area_out[j], temp_frac);
+									if (refveg_area_out[j] != refveg_area[grid_ind]) {
+										;
+									}
+									if (temp_frac > 0) {
+										;
+									}
+								}
+								if(cur_lt_cat == 1303) {
+									fprintf(fplog, "ctry %i, glu %i, lt %i, rv = %i, gi = %i: ra = %lf, pf = %f \n", countrycodes_fao[ctry_ind], aez_val, cur_lt_cat, rv_ind, grid_ind, refveg_area_out[j], temp_frac);
+									if (refveg_area_out[j] != refveg_area[grid_ind]) {
+										;
+									}
+									if (temp_frac > 0) {
+										;
+									}
+								}
+							}
+							*/
+						
+							// crop
+							cur_lt_cat = rv_value * SCALE_POTVEG + CROP_LT_CODE + k;
+							cur_lt_cat_ind = lt_cat_code2ind[cur_lt_cat];
+							if (cur_lt_cat_ind == NOMATCH) {
+								fprintf(fplog, "Failed to match lt_cat %i:,crop proc_land_type_area()\n", cur_lt_cat);
+								return ERROR_IND;
+							}
+							if (lu_area[j * NUM_HYDE_TYPES + crop_ind] != raster_info.lu_nodata) { // don't add if nodata
+								tmp_dbl = lu_area[j * NUM_HYDE_TYPES + crop_ind];
+								area_out[ctry_ind][aez_ind][cur_lt_cat_ind][year_ind] = area_out[ctry_ind][aez_ind][cur_lt_cat_ind][year_ind] + ((lu_area[j * NUM_HYDE_TYPES + crop_ind])* temp_frac);
+								// sum the global out land type area
+								// sage types plus one are first, then hyde types
+								global_lt_out[crop_ind + NUM_SAGE_PVLT + 1] = global_lt_out[crop_ind + NUM_SAGE_PVLT + 1] + ((lu_area[j * NUM_HYDE_TYPES + crop_ind]) * temp_frac);
+							}
+						
+							// pasture
+							cur_lt_cat = rv_value * SCALE_POTVEG + PASTURE_LT_CODE + k;
+							cur_lt_cat_ind = lt_cat_code2ind[cur_lt_cat];
+							if (cur_lt_cat_ind == NOMATCH) {
+								fprintf(fplog, "Failed to match lt_cat %i:,pasture proc_land_type_area()\n", cur_lt_cat);
+								return ERROR_IND;
+							}
+							if (lu_area[j * NUM_HYDE_TYPES + pasture_ind] != raster_info.lu_nodata) { // don't add if nodata
+								tmp_dbl = lu_area[j * NUM_HYDE_TYPES + pasture_ind];
+								area_out[ctry_ind][aez_ind][cur_lt_cat_ind][year_ind] = area_out[ctry_ind][aez_ind][cur_lt_cat_ind][year_ind] + ((lu_area[j * NUM_HYDE_TYPES + pasture_ind]) * temp_frac);
+								// sum the global out land type area
+								// sage types plus one are first, then hyde types
+								global_lt_out[pasture_ind + NUM_SAGE_PVLT + 1] = global_lt_out[pasture_ind + NUM_SAGE_PVLT + 1] + ((lu_area[j * NUM_HYDE_TYPES + pasture_ind])* temp_frac);
+							}
+						
+							// urban
+							cur_lt_cat = rv_value * SCALE_POTVEG + URBAN_LT_CODE + k;
+							cur_lt_cat_ind = lt_cat_code2ind[cur_lt_cat];
+							//fprintf(fplog, "Matching categories rv_value %i:,SCALE_POT_VEG %i:,URBAN_LT_CODE %i:,  protected %i\n,cur_cat %i", rv_value,SCALE_POTVEG,URBAN_LT_CODE,protected_thematic[grid_ind],cur_lt_cat);
+							if (cur_lt_cat_ind == NOMATCH) {
+								fprintf(fplog, "Failed to match lt_cat %i:,protected_epa %i:,urban,  proc_land_type_area()\n", cur_lt_cat,grid_ind);
+								return ERROR_IND;
+							}
+							if (lu_area[j * NUM_HYDE_TYPES + urban_ind] != raster_info.lu_nodata) { // don't add if nodata
+								tmp_dbl = lu_area[j * NUM_HYDE_TYPES + urban_ind];
+								area_out[ctry_ind][aez_ind][cur_lt_cat_ind][year_ind] = area_out[ctry_ind][aez_ind][cur_lt_cat_ind][year_ind] + ((lu_area[j * NUM_HYDE_TYPES + urban_ind])* temp_frac);
+								// sum the global out land type area
+								// sage types plus one are first, then hyde types
+								global_lt_out[urban_ind + NUM_SAGE_PVLT + 1] = global_lt_out[urban_ind + NUM_SAGE_PVLT + 1] + ((lu_area[j * NUM_HYDE_TYPES + urban_ind]) * temp_frac);
+							}
+						
+							// sum the detailed lu categories also
+							for (m = NUM_HYDE_TYPES_MAIN; m < NUM_HYDE_TYPES; m++) {
+								tmp_dbl = lu_area[j * NUM_HYDE_TYPES + m];
+								if (lu_area[j * NUM_HYDE_TYPES + m] != raster_info.lu_nodata) { // don't add if nodata
+									global_lt_out[m + NUM_SAGE_PVLT + 1] = global_lt_out[m + NUM_SAGE_PVLT + 1] + (lu_area[j * NUM_HYDE_TYPES + m])* temp_frac;
+								}
+							}
+						
+						}//Finish k loop for protected areas
+					
+					} // end if valid glu cell
+				
+				} // end if valid land area
+			
+			} // end for j loop over the lu cells to store
+		
+			/*
+			if(rfarea_check != 0 || luarea_check != 0){
+				fprintf(fplog, "Check: year %i lulc cell %i refveg area %f lu area %f: proc_land_type_area()\n", hyde_years[year_ind], i, rfarea_check, luarea_check);
+				fprintf(debug_file, "proc_land_type_area,%i,%i,%f,%f,%f\n", hyde_years[year_ind], i, rfarea_check, luarea_check,rfarea_check + luarea_check);
+			}
+			 */
+		
+		} // end for i loop over the lulc cells in the chunk
+		
+	} // end for chunk_start loop over the lulc cell chunks
+	
+	// keep this year's global area check together in the log file
+#pragma omp critical (fplog_write)
+	if (in_args.diagnostics) {
+		// write the global area check to the log file
+		fprintf(fplog, "\nGlobal lulc area check for year %i: proc_land_type_area()\n", hyde_years[year_ind]);
+		fprintf(fplog, "Unknown: out =\t%lf\n", global_lt_out[0]);
+		global_area_out = global_lt_out[0];
+		global_area_in = 0;
+		tmp_dbl = global_lt_out[0];
+		for (j = 1; j <= NUM_SAGE_PVLT; j++) {
+			fprintf(fplog, "%s: out =\t%lf;\tin =\t%lf\n", landtypenames_sage[j-1], global_lt_out[j], global_lulc_in[j]);
+			global_area_out = global_area_out + global_lt_out[j];
+			tmp_dbl = global_lt_out[j];
+			global_area_in = global_area_in + global_lulc_in[j];
+			tmp_dbl = global_lulc_in[j];
+		}
+		for (j = NUM_SAGE_PVLT + 1; j < NUM_SAGE_PVLT + 1 + NUM_HYDE_TYPES; j++) {
+			fprintf(fplog, "%s: out =\t%lf;\tin =\t%lf\n", lutypenames_hyde[j - NUM_SAGE_PVLT - 1], global_lt_out[j], global_lulc_in[j]);
+			if (j < NUM_SAGE_PVLT + 1 + NUM_HYDE_TYPES_MAIN) {
+				global_area_out = global_area_out + global_lt_out[j];
+				tmp_dbl = global_lt_out[j];
+				global_area_in = global_area_in + global_lulc_in[j];
+				tmp_dbl = global_lulc_in[j];
+			}
+		}
+		fprintf(fplog, "Global land area: out =\t%lf;\tin =\t%lf\n", global_area_out, global_area_in);
+	} // end if write diagnostics
+	
+	// write specified year's land cover/use grids if desired
+	
+	if (hyde_years[year_ind] == in_args.lulc_out_year) {
+		// cropland area
+		strcpy(fname, "cropland_area_");
+		sprintf(tmp_str, "%i.bil", hyde_years[year_ind]);
+		strcat(fname, tmp_str);
+		if ((err = write_raster_float(crop_grid, NUM_CELLS, fname, in_args))) {
+			fprintf(fplog, "Error writing file %s: proc_land_type_area()\n", fname);
+			return err;
+		}
+		// pasture area
+		strcpy(fname, "pasture_area_");
+		sprintf(tmp_str, "%i.bil", hyde_years[year_ind]);
+		strcat(fname, tmp_str);
+		if ((err = write_raster_float(pasture_grid, NUM_CELLS, fname, in_args))) {
+			fprintf(fplog, "Error writing file %s: proc_land_type_area()\n", fname);
+			return err;
+		}
+		// urban area
+		strcpy(fname, "urban_area_");
+		sprintf(tmp_str, "%i.bil", hyde_years[year_ind]);
+		strcat(fname, tmp_str);
+		if ((err = write_raster_float(urban_grid, NUM_CELLS, fname, in_args))) {
+			fprintf(fplog, "Error writing file %s: proc_land_type_area()\n", fname);
+			return err;
+		}
+		// reference vegetation area
+		strcpy(fname, "refveg_area_");
+		sprintf(tmp_str, "%i.bil", hyde_years[year_ind]);
+		strcat(fname, tmp_str);
+		if ((err = write_raster_float(refveg_area_grid, NUM_CELLS, fname, in_args))) {
+			fprintf(fplog, "Error writing file %s: proc_land_type_area()\n", fname);
+			return err;
+		}
+		// reference vegetation types
+		strcpy(fname, "refveg_thematic_");
+		sprintf(tmp_str, "%i.bil", hyde_years[year_ind]);
+		strcat(fname, tmp_str);
+		if ((err = write_raster_int(refveg_them_out, NUM_CELLS, fname, in_args))) {
+			fprintf(fplog, "Error writing file %s: proc_land_type_area()\n", fname);
+			return err;
+		}
+	}
+	
+	return OK;
+}
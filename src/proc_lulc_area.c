@@ -12,16 +12,19 @@
  only one non-land-use land cover type is currently allowed in each working grid cell
  currently aggregate to sage potential veg types, because that is what gcam data system currently uses
  
- the randomized order for wg cells within each lulc cell is set once for each cell in calc_refveg_area
+ the randomized order for wg cells within each lulc cell is set once for each cell in get_rand_order
+ the nearby pot veg type for wg cells without pot veg is set once in get_potveg_nearest
  
  arguments:
  args_struct in_args:		input argument structure
  rinfo_struct raster_info: 	information about input raster data
- double *lulc_area:			array of area values for each lulc land type; length is NUM_LULC_TYPES
+ lulc_work_struct *work:	the workspace for this lulc cell, from alloc_lulc_work(); the caller fills these:
+	lulc_area:				array of area values for each lulc land type; length is NUM_LULC_TYPES
+	lu_area:				flat array of area values for each lu cell and land type; [lu cell * NUM_HYDE_TYPES + type], upper left start
+	refveg_area_out:		array of ref veg area values for each out lu cell
+	refveg_them:			array of refveg thematic out values for each lu cell
+	the other workspace arrays are reset here, so no memory is allocated per lulc cell
  int *lu_indices:			array of lu cell indices for lu_area etc., from main lu raster arrays
- double **lu_area:			2-d array of area values for each lu cell and land type; d1=num_lu_cells (upper left start), d2=NUM_HYDE_TYPES
- double *refveg_area_out:	array of ref veg area values for each out lu cell
- int *refveg_them:			array of refveg thematic out values for each lu cell
  int num_lu_cells:			number of lu cells in lulc cell
  int lulc_index:			index of the current lulc cell
 
@@ -56,9 +59,9 @@
 
 #include "moirai.h"
 
-int proc_lulc_area(args_struct in_args, rinfo_struct raster_info, double *lulc_area, int *lu_indices, double **lu_area, double *refveg_area_out, int *refveg_them, int num_lu_cells, int lulc_index) {
+int proc_lulc_area(args_struct in_args, rinfo_struct raster_info, lulc_work_struct *work, int *lu_indices, int num_lu_cells, int lulc_index) {
 	
-	int i, j, x, y, m;
+	int i, j, m;
 	int potveg_ind;			// the index of current cell potential vegeation; for refveg_type_area_sum and lc_agg_area
 	int potveg_val;				// the value of current pot veg; can be 0 (unknown)
 	// should probably retrieve these from the info arrays
@@ -79,9 +82,13 @@ int proc_lulc_area(args_struct in_args, rinfo_struct raster_info, double *lulc_a
 	double sum_lulc_veg_area = 0;	// the total input lulc non-land-use area in this lulc cell
 	double sum_refveg_area = 0;	// the total reference veg area in this lulc cell
 	double sum_lu_land_area = 0;	// the total lu land area in this lulc cell
-	double *sum_lu_area;			// the total lu area in this lulc cell; NUM_HYDE_TYPES
-	double *lc_agg_area;		// the input lc and lu area in this lulc cell by type, aggregated to sage pot veg
-	double *refveg_type_area_sum;	// sum of each output ref veg type within this lulc cell
+	double *lulc_area = work->lulc_area;		// the input lulc area by type
+	double *lu_area = work->lu_area;			// the lu areas by lu cell and hyde type
+	double *refveg_area_out = work->refveg_area_out;	// the output ref veg area of each lu cell
+	int *refveg_them = work->refveg_them;		// the output ref veg type of each lu cell
+	double *sum_lu_area = work->sum_lu_area;	// the total lu area in this lulc cell; NUM_HYDE_TYPES
+	double *lc_agg_area = work->lc_agg_area;	// the input lc and lu area in this lulc cell by type, aggregated to sage pot veg
+	double *refveg_type_area_sum = work->refveg_type_area_sum;	// sum of each output ref veg type within this lulc cell
 	
 	int temp_int;					// for swapping
 	int sub_type;					// corresponding substitute ref veg type (index)
@@ -89,54 +96,27 @@ int proc_lulc_area(args_struct in_args, rinfo_struct raster_info, double *lulc_a
 	int other_ind;					// index of the other substitute ref veg
 	int max_resid_ind;				// index of the max residual area
 	int num_leftover_cells = 0;		// number of output cells not assigned a ref veg in the first pass
-	int *leftover_cell_inds;		// the indices of the output cells not assigned a ref veg in the first pass
+	int *leftover_cell_inds = work->leftover_cell_inds;	// the indices of the output cells not assigned a ref veg in the first pass
 	double sum_area_diff;			// difference between lulc area for a given type and the ref veg area for a given type within the lulc cell
 	double max_sum_area_diff;		// the maximum sum_area_diff across types
-	double *type_area_resid;			// array of residual areas (lulc - assigned refveg within lulc cell) for the types after the first pass
+	double *type_area_resid = work->type_area_resid;	// array of residual areas (lulc - assigned refveg within lulc cell) for the types after the first pass
 	double max_resid_area;			// for finding the max resid area
 	double temp_rvt_area;			// for checking
 	double temp_dbl2;				// for checking
 	double land_area_in;				// input land area for this lulc cell
 	
-	// for searching the lu cells
-	int ncols;
-	int nrows;
-	int current_val;
 	double temp_dbl;
-	double integer_dbl;
-	int irow;
-	int icol;
-	int count;
-	int toprow;
-	int botrow;
-	int leftcol;
-	int rightcol;
 	
-	// allocate some arrays
-	sum_lu_area = calloc(NUM_HYDE_TYPES, sizeof(double));
-	if(sum_lu_area == NULL) {
-		fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for sum_lu_area: proc_lulc_area()\n", get_systime(), ERROR_MEM);
-		return ERROR_MEM;
+	// reset the workspace sums, which start at zero for each lulc cell
+	for (j = 0; j < NUM_HYDE_TYPES; j++) {
+		sum_lu_area[j] = 0;
 	}
-	lc_agg_area = calloc(NUM_LULC_TYPES, sizeof(double));
-	if(lc_agg_area == NULL) {
-		fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for lc_agg_area: proc_lulc_area()\n", get_systime(), ERROR_MEM);
-		return ERROR_MEM;
+	for (j = 0; j < NUM_LULC_TYPES; j++) {
+		lc_agg_area[j] = 0;
 	}
-	leftover_cell_inds = calloc(num_lu_cells, sizeof(int));
-	if(leftover_cell_inds == NULL) {
-		fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for leftover_cell_inds: proc_lulc_area()\n", get_systime(), ERROR_MEM);
-		return ERROR_MEM;
-	}
-	refveg_type_area_sum = calloc(NUM_SAGE_PVLT, sizeof(double));
-	if(refveg_type_area_sum == NULL) {
-		fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for refveg_type_area_sum: proc_lulc_area()\n", get_systime(), ERROR_MEM);
-		return ERROR_MEM;
-	}
-	type_area_resid = calloc(NUM_SAGE_PVLT, sizeof(double));
-	if(type_area_resid == NULL) {
-		fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for type_area_resid: proc_lulc_area()\n", get_systime(), ERROR_MEM);
-		return ERROR_MEM;
+	for (j = 0; j < NUM_SAGE_PVLT; j++) {
+		refveg_type_area_sum[j] = 0;
+		type_area_resid[j] = 0;
 	}
 	
 	// determine the reference veg area then sum the land use and ref veg area in this lulc input cell and
@@ -148,78 +128,78 @@ int proc_lulc_area(args_struct in_args, rinfo_struct raster_info, double *lulc_a
 				// there may be some zero area cells, so make the land use areas consistent
 				// zero land so set land types to 0 area
 				for (j = 0; j < NUM_HYDE_TYPES; j++) {
-					lu_area[i][j] = 0;
-					temp_dbl = lu_area[i][j];
+					lu_area[i * NUM_HYDE_TYPES + j] = 0;
+					temp_dbl = lu_area[i * NUM_HYDE_TYPES + j];
 				}
 				refveg_area_out[i] = 0;
 			} else if (land_area_hyde[lu_indices[i]] != raster_info.land_area_hyde_nodata) {
 				// check for nodata values, and set them to zero if valid land cell
 				for (j = 0; j < NUM_HYDE_TYPES; j++) {
-					if (lu_area[i][j] == raster_info.lu_nodata) {
-						lu_area[i][j] = 0;
+					if (lu_area[i * NUM_HYDE_TYPES + j] == raster_info.lu_nodata) {
+						lu_area[i * NUM_HYDE_TYPES + j] = 0;
 					}
-					temp_dbl = lu_area[i][j];
+					temp_dbl = lu_area[i * NUM_HYDE_TYPES + j];
 				}
 				refveg_area_out[i] = 0;
 				// calculate reference veg area
-				refveg_area_out[i] = land_area_hyde[lu_indices[i]] - lu_area[i][crop_ind] -
-					lu_area[i][pasture_ind] - lu_area[i][urban_ind];
+				refveg_area_out[i] = land_area_hyde[lu_indices[i]] - lu_area[i * NUM_HYDE_TYPES + crop_ind] -
+					lu_area[i * NUM_HYDE_TYPES + pasture_ind] - lu_area[i * NUM_HYDE_TYPES + urban_ind];
 				temp_dbl = refveg_area_out[i];
 				// check for negative values
 				if (refveg_area_out[i] < 0) {
 					// adjust urban area if not enough land
-					lu_area[i][urban_ind] = lu_area[i][urban_ind] + refveg_area_out[i];
+					lu_area[i * NUM_HYDE_TYPES + urban_ind] = lu_area[i * NUM_HYDE_TYPES + urban_ind] + refveg_area_out[i];
 					refveg_area_out[i] = 0;
 				}
-				temp_dbl = lu_area[i][urban_ind];
+				temp_dbl = lu_area[i * NUM_HYDE_TYPES + urban_ind];
 				// double-check for enough land and adjust pasture
-				if (lu_area[i][urban_ind] < 0) {
-					lu_area[i][pasture_ind] = lu_area[i][pasture_ind] + lu_area[i][urban_ind];
-					if (lu_area[i][pasture_ind] != 0) {
-						lu_area[i][intense_ind] = lu_area[i][intense_ind] + lu_area[i][urban_ind] * lu_area[i][intense_ind] / lu_area[i][pasture_ind];
-						lu_area[i][range_ind] = lu_area[i][range_ind] + lu_area[i][urban_ind] * lu_area[i][range_ind] / lu_area[i][pasture_ind];
+				if (lu_area[i * NUM_HYDE_TYPES + urban_ind] < 0) {
+					lu_area[i * NUM_HYDE_TYPES + pasture_ind] = lu_area[i * NUM_HYDE_TYPES + pasture_ind] + lu_area[i * NUM_HYDE_TYPES + urban_ind];
+					if (lu_area[i * NUM_HYDE_TYPES + pasture_ind] != 0) {
+						lu_area[i * NUM_HYDE_TYPES + intense_ind] = lu_area[i * NUM_HYDE_TYPES + intense_ind] + lu_area[i * NUM_HYDE_TYPES + urban_ind] * lu_area[i * NUM_HYDE_TYPES + intense_ind] / lu_area[i * NUM_HYDE_TYPES + pasture_ind];
+						lu_area[i * NUM_HYDE_TYPES + range_ind] = lu_area[i * NUM_HYDE_TYPES + range_ind] + lu_area[i * NUM_HYDE_TYPES + urban_ind] * lu_area[i * NUM_HYDE_TYPES + range_ind] / lu_area[i * NUM_HYDE_TYPES + pasture_ind];
 					} else {
-						lu_area[i][intense_ind] = 0;
-						lu_area[i][range_ind] = 0;
+						lu_area[i * NUM_HYDE_TYPES + intense_ind] = 0;
+						lu_area[i * NUM_HYDE_TYPES + range_ind] = 0;
 					}
-					lu_area[i][urban_ind] = 0;
+					lu_area[i * NUM_HYDE_TYPES + urban_ind] = 0;
 				}
-				temp_dbl = lu_area[i][pasture_ind];
+				temp_dbl = lu_area[i * NUM_HYDE_TYPES + pasture_ind];
 				// final check for enough land and adjust crops
-				if (lu_area[i][pasture_ind] < 0) {
-					lu_area[i][crop_ind] = lu_area[i][crop_ind] + lu_area[i][pasture_ind];
-					if (lu_area[i][crop_ind] != 0) {
-						lu_area[i][ir_norice_ind] = lu_area[i][ir_norice_ind] + lu_area[i][pasture_ind] * lu_area[i][ir_norice_ind] / lu_area[i][crop_ind];
-						lu_area[i][rf_norice_ind] = lu_area[i][rf_norice_ind] + lu_area[i][pasture_ind] * lu_area[i][rf_norice_ind] / lu_area[i][crop_ind];
-						lu_area[i][ir_rice_ind] = lu_area[i][ir_rice_ind] + lu_area[i][pasture_ind] * lu_area[i][ir_rice_ind] / lu_area[i][crop_ind];
-						lu_area[i][rf_rice_ind] = lu_area[i][rf_rice_ind] + lu_area[i][pasture_ind] * lu_area[i][rf_rice_ind] / lu_area[i][crop_ind];
-						lu_area[i][tot_irr_ind] = lu_area[i][tot_irr_ind] + lu_area[i][pasture_ind] * lu_area[i][tot_irr_ind] / lu_area[i][crop_ind];
-						lu_area[i][tot_rain_ind] = lu_area[i][tot_rain_ind] + lu_area[i][pasture_ind] * lu_area[i][tot_rain_ind] / lu_area[i][crop_ind];
-						lu_area[i][tot_rice_ind] = lu_area[i][tot_rice_ind] + lu_area[i][pasture_ind] * lu_area[i][tot_rice_ind] / lu_area[i][crop_ind];
+				if (lu_area[i * NUM_HYDE_TYPES + pasture_ind] < 0) {
+					lu_area[i * NUM_HYDE_TYPES + crop_ind] = lu_area[i * NUM_HYDE_TYPES + crop_ind] + lu_area[i * NUM_HYDE_TYPES + pasture_ind];
+					if (lu_area[i * NUM_HYDE_TYPES + crop_ind] != 0) {
+						lu_area[i * NUM_HYDE_TYPES + ir_norice_ind] = lu_area[i * NUM_HYDE_TYPES + ir_norice_ind] + lu_area[i * NUM_HYDE_TYPES + pasture_ind] * lu_area[i * NUM_HYDE_TYPES + ir_norice_ind] / lu_area[i * NUM_HYDE_TYPES + crop_ind];
+						lu_area[i * NUM_HYDE_TYPES + rf_norice_ind] = lu_area[i * NUM_HYDE_TYPES + rf_norice_ind] + lu_area[i * NUM_HYDE_TYPES + pasture_ind] * lu_area[i * NUM_HYDE_TYPES + rf_norice_ind] / lu_area[i * NUM_HYDE_TYPES + crop_ind];
+						lu_area[i * NUM_HYDE_TYPES + ir_rice_ind] = lu_area[i * NUM_HYDE_TYPES + ir_rice_ind] + lu_area[i * NUM_HYDE_TYPES + pasture_ind] * lu_area[i * NUM_HYDE_TYPES + ir_rice_ind] / lu_area[i * NUM_HYDE_TYPES + crop_ind];
+						lu_area[i * NUM_HYDE_TYPES + rf_rice_ind] = lu_area[i * NUM_HYDE_TYPES + rf_rice_ind] + lu_area[i * NUM_HYDE_TYPES + pasture_ind] * lu_area[i * NUM_HYDE_TYPES + rf_rice_ind] / lu_area[i * NUM_HYDE_TYPES + crop_ind];
+						lu_area[i * NUM_HYDE_TYPES + tot_irr_ind] = lu_area[i * NUM_HYDE_TYPES + tot_irr_ind] + lu_area[i * NUM_HYDE_TYPES + pasture_ind] * lu_area[i * NUM_HYDE_TYPES + tot_irr_ind] / lu_area[i * NUM_HYDE_TYPES + crop_ind];
+						lu_area[i * NUM_HYDE_TYPES + tot_rain_ind] = lu_area[i * NUM_HYDE_TYPES + tot_rain_ind] + lu_area[i * NUM_HYDE_TYPES + pasture_ind] * lu_area[i * NUM_HYDE_TYPES + tot_rain_ind] / lu_area[i * NUM_HYDE_TYPES + crop_ind];
+						lu_area[i * NUM_HYDE_TYPES + tot_rice_ind] = lu_area[i * NUM_HYDE_TYPES + tot_rice_ind] + lu_area[i * NUM_HYDE_TYPES + pasture_ind] * lu_area[i * NUM_HYDE_TYPES + tot_rice_ind] / lu_area[i * NUM_HYDE_TYPES + crop_ind];
 					} else {
-						lu_area[i][ir_norice_ind] = 0;
-						lu_area[i][rf_norice_ind] = 0;
-						lu_area[i][ir_rice_ind] = 0;
-						lu_area[i][rf_rice_ind] = 0;
-						lu_area[i][tot_irr_ind] = 0;
-						lu_area[i][tot_rain_ind] = 0;
-						lu_area[i][tot_rice_ind] = 0;
+						lu_area[i * NUM_HYDE_TYPES + ir_norice_ind] = 0;
+						lu_area[i * NUM_HYDE_TYPES + rf_norice_ind] = 0;
+						lu_area[i * NUM_HYDE_TYPES + ir_rice_ind] = 0;
+						lu_area[i * NUM_HYDE_TYPES + rf_rice_ind] = 0;
+						lu_area[i * NUM_HYDE_TYPES + tot_irr_ind] = 0;
+						lu_area[i * NUM_HYDE_TYPES + tot_rain_ind] = 0;
+						lu_area[i * NUM_HYDE_TYPES + tot_rice_ind] = 0;
 					}
-					lu_area[i][pasture_ind] = 0;
-					lu_area[i][intense_ind] = 0;
-					lu_area[i][range_ind] = 0;
+					lu_area[i * NUM_HYDE_TYPES + pasture_ind] = 0;
+					lu_area[i * NUM_HYDE_TYPES + intense_ind] = 0;
+					lu_area[i * NUM_HYDE_TYPES + range_ind] = 0;
 				}
-				temp_dbl = lu_area[i][crop_ind];
+				temp_dbl = lu_area[i * NUM_HYDE_TYPES + crop_ind];
 				// this shouldn't happen, but check anyway
-				if (lu_area[i][crop_ind] < -ZERO_THRESH) {
-					lu_area[i][crop_ind] = 0;
-					lu_area[i][ir_norice_ind] = 0;
-					lu_area[i][rf_norice_ind] = 0;
-					lu_area[i][ir_rice_ind] = 0;
-					lu_area[i][rf_rice_ind] = 0;
-					lu_area[i][tot_irr_ind] = 0;
-					lu_area[i][tot_rain_ind] = 0;
-					lu_area[i][tot_rice_ind] = 0;
+				if (lu_area[i * NUM_HYDE_TYPES + crop_ind] < -ZERO_THRESH) {
+					lu_area[i * NUM_HYDE_TYPES + crop_ind] = 0;
+					lu_area[i * NUM_HYDE_TYPES + ir_norice_ind] = 0;
+					lu_area[i * NUM_HYDE_TYPES + rf_norice_ind] = 0;
+					lu_area[i * NUM_HYDE_TYPES + ir_rice_ind] = 0;
+					lu_area[i * NUM_HYDE_TYPES + rf_rice_ind] = 0;
+					lu_area[i * NUM_HYDE_TYPES + tot_irr_ind] = 0;
+					lu_area[i * NUM_HYDE_TYPES + tot_rain_ind] = 0;
+					lu_area[i * NUM_HYDE_TYPES + tot_rice_ind] = 0;
 					fprintf(fplog, "Warning: negative crop area %lf at i %i: proc_lulc_area()\n", temp_dbl, i);
 					// some small (effectively zero) negative values appear here from time to time
 					return ERROR_CALC;
@@ -229,7 +209,7 @@ int proc_lulc_area(args_struct in_args, rinfo_struct raster_info, double *lulc_a
 				// here, hyde land area == nodata sets all land type areas to zero for this lu cell
 				// calc_refveg_area and proc_land_type_area store nodata for the types for hyde land area == nodata
 				for (j = 0; j < NUM_HYDE_TYPES; j++) {
-					lu_area[i][j] = 0;
+					lu_area[i * NUM_HYDE_TYPES + j] = 0;
 				}
 				refveg_area_out[i] = 0;
 				if (in_args.diagnostics) {
@@ -242,11 +222,11 @@ int proc_lulc_area(args_struct in_args, rinfo_struct raster_info, double *lulc_a
 		// also sum the physical lu land areas
 		temp_dbl2 = 0;
 		for (j = 0; j < NUM_HYDE_TYPES; j++) {
-			if (lu_area[i][j] != raster_info.lu_nodata) {
-				sum_lu_area[j] = sum_lu_area[j] + lu_area[i][j];
+			if (lu_area[i * NUM_HYDE_TYPES + j] != raster_info.lu_nodata) {
+				sum_lu_area[j] = sum_lu_area[j] + lu_area[i * NUM_HYDE_TYPES + j];
 			}
 			if (j < NUM_HYDE_TYPES_MAIN) {
-    			temp_dbl2 = temp_dbl2 + lu_area[i][j];
+    			temp_dbl2 = temp_dbl2 + lu_area[i * NUM_HYDE_TYPES + j];
 			}
 		}
 		
@@ -269,7 +249,7 @@ int proc_lulc_area(args_struct in_args, rinfo_struct raster_info, double *lulc_a
 		} // end sum the lu area within this cell
 
 		//if (lulc_index == 63120) {
-		//	fprintf(cell_file, "proc_lulc_area,%i,%i,%i,%f,%lf,%lf,%lf,%lf,%lf\n", i, lu_indices[i], lulc_index, land_area_hyde[lu_indices[i]], refveg_area_out[i], temp_dbl2, lu_area[i][0], lu_area[i][1], lu_area[i][2]);
+		//	fprintf(cell_file, "proc_lulc_area,%i,%i,%i,%f,%lf,%lf,%lf,%lf,%lf\n", i, lu_indices[i], lulc_index, land_area_hyde[lu_indices[i]], refveg_area_out[i], temp_dbl2, lu_area[i * NUM_HYDE_TYPES + 0], lu_area[i * NUM_HYDE_TYPES + 1], lu_area[i * NUM_HYDE_TYPES + 2]);
 		//}
 		
 	} // end i loop over the lu cells to determine total areas
@@ -324,7 +304,7 @@ int proc_lulc_area(args_struct in_args, rinfo_struct raster_info, double *lulc_a
 	// zero ref veg area sets ref veg to pot veg
 	for (m = 0; m < num_lu_cells; m++) {
 		// get the randomized cell index
-		i = rand_order[lulc_index][m];
+		i = rand_order[(size_t) lulc_index * num_lu_cells + m];
 		
 		// do this only for cells with land area
 		if (land_area_hyde[lu_indices[i]] != raster_info.land_area_hyde_nodata) {
@@ -338,70 +318,8 @@ int proc_lulc_area(args_struct in_args, rinfo_struct raster_info, double *lulc_a
 				potveg_ind = potveg_thematic[lu_indices[i]] - 1;
 				potveg_val = potveg_thematic[lu_indices[i]];
 			} else {
-				// find a nearby pot veg type
-				// assume symmetric cell size right now
-				ncols = (int) round(sqrt((double)num_lu_cells));
-				nrows = ncols;
-				potveg_val = raster_info.potveg_nodata;
-				temp_dbl = i / ncols;
-				modf(temp_dbl, &integer_dbl);
-				irow = (int) integer_dbl;
-				icol = i - irow * ncols;
-				// search vicinity for nearest valid pot veg value
-				count = 1;
-				while (potveg_val == raster_info.potveg_nodata) {
-					// determine rows and cols to search
-					toprow = irow - count;
-					if (toprow < 0) {
-						toprow = 0;
-					}
-					botrow = irow + count;
-					if (botrow >= nrows) {
-						botrow = nrows - 1 ;
-					}
-					leftcol = icol - count;
-					if (leftcol < 0) {
-						leftcol = 0;
-					}
-					rightcol = icol + count;
-					if (rightcol >= ncols) {
-						rightcol = ncols - 1;
-					}
-					// loop over rows
-					for (x = toprow; x <= botrow; x++) {
-						if (x == toprow || x == botrow) {
-							// loop over columns if at top or bottom of search ring
-							for (y = leftcol; y <= rightcol; y++) {
-								current_val = potveg_thematic[x * nrows + y];
-								// grab the first found value
-								if (current_val != raster_info.potveg_nodata) {
-									potveg_val = current_val;
-									//fprintf(fplog, "Found potveg value for index %i at index %i\n", i, x * nrows + y);
-									break; // don't need to search this row anymore
-								}
-							}	// end for y loop over columns
-						} else {	// end if top or bottom of search ring
-							current_val = potveg_thematic[x * nrows + leftcol];
-							// grab the first found value
-							if (current_val != raster_info.potveg_nodata) {
-								potveg_val = current_val;
-								//fprintf(fplog, "Found potveg value for index %i at index %i\n", i, x * nrows + leftcol);
-								break; // don't need to search this row anymore
-							}
-							current_val = potveg_thematic[x * nrows + rightcol];
-							// grab the first found value
-							if (current_val != raster_info.potveg_nodata) {
-								potveg_val = current_val;
-								//fprintf(fplog, "Found potveg value for index %i at index %i\n", i, x * nrows + rightcol);
-								break; // don't need to search this row anymore
-							}
-						}	// end else not top or bottom of search ring
-					}	// end for x loop over rows
-					count++;
-					if (count == ncols) {
-						potveg_val = 0; // set it to unknown to end the search
-					}
-				}	// end while loop over search rings
+				// use the nearby pot veg type of this lu cell position, from get_potveg_nearest()
+				potveg_val = potveg_nearest[i];
 				potveg_ind = potveg_val - 1;
 			} // end else find nearby pot veg type
 			
@@ -745,10 +663,4 @@ int proc_lulc_area(args_struct in_args, rinfo_struct raster_info, double *lulc_a
 	//	}
 	//}
 	
-	free(sum_lu_area);
-	free(lc_agg_area);
-	free(leftover_cell_inds);
-	free(refveg_type_area_sum);
-	free(type_area_resid);
-	
 	return OK;}
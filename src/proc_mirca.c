@@ -62,9 +62,6 @@ int proc_mirca(args_struct in_args, rinfo_struct raster_info) {
     int crop_index;             // the index for looping over mirca crops
     int err = OK;				// store error code from the write functions
     
-    int scg_code = 186;         // fao code for serbia and montenegro
-    int srb_code = 272;         // fao code for serbia
-    int mne_code = 273;         // fao code for montenegro
     
     float *irr_grid;  // 1d array to store current mirca raster file; start up left corner, row by row; lon varies faster
     float *rfd_grid;  // 1d array to store current mirca raster file; start up left corner, row by row; lon varies faster
@@ -88,6 +85,8 @@ int proc_mirca(args_struct in_args, rinfo_struct raster_info) {
     
     FILE *fpout;                // out file pointer for irrigation
     FILE *fpout2;               // out file pointer for rainfed
+    csv_out_struct csv_out;     // buffered record output for irrigation
+    csv_out_struct csv_out2;    // buffered record output for rainfed
 
     // mirca file names
     const char irr_base[] = "ANNUAL_AREA_HARVESTED_IRC_CROP";   // mirca irrigated file base; 5 arcmin
@@ -175,44 +174,15 @@ int proc_mirca(args_struct in_args, rinfo_struct raster_info) {
             ctry_code = country_fao[land_cells_sage[j]];
             
             if (aez_val != raster_info.aez_new_nodata) {
-                // get the fao country index
-                ctry_ind = NOMATCH;
-                for (i = 0; i < NUM_FAO_CTRY; i++) {
-                    if (countrycodes_fao[i] == ctry_code) {
-                        ctry_ind = i;
-                        break;
-                    }
-                } // end for i loop to get ctry index
+                // get the fao country index (serbia and montenegro are merged into scg) from the index raster
+                ctry_ind = cell_ctry_ind[land_cells_sage[j]];
                 
-                // merge serbia and montenegro for scg record
-                if (ctry_code == mne_code || ctry_code == srb_code) {
-                    ctry_code = scg_code;
-                    ctry_ind = NOMATCH;
-                    for (i = 0; i < NUM_FAO_CTRY; i++) {
-                        if (countrycodes_fao[i] == ctry_code) {
-                            ctry_ind = i;
-                            break;
-                        }
-                    }
-                    if (ctry_ind == NOMATCH) {
-                        // this should never happen
-                        fprintf(fplog, "Error finding scg ctry index: proc_mirca()\n");
-                        return ERROR_IND;
-                    }
-                } // end if serbia or montenegro
-				
 				if (ctry_ind == NOMATCH || ctry2ctry87codes_gtap[ctry_ind] == NOMATCH) {
 					continue;
 				}
 				
-                // get the aez index within the country aez list
-                aez_ind = NOMATCH;
-                for (i = 0; i < ctry_aez_num[ctry_ind]; i++) {
-                    if (ctry_aez_list[ctry_ind][i] == aez_val) {
-                        aez_ind = i;
-                        break;
-                    }
-                } // end for i loop to get aez index
+                // get the glu index within the country glu list from the index raster
+                aez_ind = cell_aez_ind[land_cells_sage[j]];
                 
                 // this shouldn't happen because the countryXglu list has been made already
                 if (aez_ind == NOMATCH) {
@@ -245,6 +215,10 @@ int proc_mirca(args_struct in_args, rinfo_struct raster_info) {
     fprintf(fpout,"# Original source: MIRCA2000; country raster; new glu raster\n");
     fprintf(fpout,"# ----------\n");
     fprintf(fpout,"iso,glu_code,mirca_crop,value");
+    if ((err = csv_out_open(&csv_out, fpout))) {
+        fclose(fpout);
+        return err;
+    }
     
     // rainfed
     strcpy(fname2, in_args.outpath);
@@ -262,6 +236,10 @@ int proc_mirca(args_struct in_args, rinfo_struct raster_info) {
     fprintf(fpout2,"# Original source: MIRCA2000; country raster; new glu raster\n");
     fprintf(fpout2,"# ----------\n");
     fprintf(fpout2,"iso,glu_code,mirca_crop,value");
+    if ((err = csv_out_open(&csv_out2, fpout2))) {
+        fclose(fpout2);
+        return err;
+    }
     
     // write the records (rounded to nearest integer)
     for (ctry_ind = 0; ctry_ind < NUM_FAO_CTRY ; ctry_ind++) {
@@ -271,24 +249,34 @@ int proc_mirca(args_struct in_args, rinfo_struct raster_info) {
                 outval = (float) floor((double) 0.5 + irr_out[ctry_ind][aez_ind][crop_index]);
                 // output only positive values
                 if (outval > 0) {
-                    fprintf(fpout,"\n%s,%i,%i,%.0f", countryabbrs_iso[ctry_ind], ctry_aez_list[ctry_ind][aez_ind],
-                            crop_index+1, outval);
+                    csv_out_rec(&csv_out, countryabbrs_iso[ctry_ind]);
+                    csv_out_int(&csv_out, ctry_aez_list[ctry_ind][aez_ind]);
+                    csv_out_int(&csv_out, crop_index+1);
+                    csv_out_fixed(&csv_out, outval, 0, 0);
                     nrecords_irr++;
                 } // end if value is positive
                 // rainfed
                 outval = (float) floor((double) 0.5 + rfd_out[ctry_ind][aez_ind][crop_index]);
                 // output only positive values
                 if (outval > 0) {
-                    fprintf(fpout2,"\n%s,%i,%i,%.0f", countryabbrs_iso[ctry_ind], ctry_aez_list[ctry_ind][aez_ind],
-                            crop_index+1, outval);
+                    csv_out_rec(&csv_out2, countryabbrs_iso[ctry_ind]);
+                    csv_out_int(&csv_out2, ctry_aez_list[ctry_ind][aez_ind]);
+                    csv_out_int(&csv_out2, crop_index+1);
+                    csv_out_fixed(&csv_out2, outval, 0, 0);
                     nrecords_rfd++;
                 } // end if value is positive
             } // end for crop loop
         } // end for aez loop
     } // end for country loop
     
-    fclose(fpout);
-    fclose(fpout2);
+    if ((err = csv_out_close(&csv_out))) {
+        fprintf(fplog, "Error writing file %s: proc_mirca()\n", fname);
+        return err;
+    }
+    if ((err = csv_out_close(&csv_out2))) {
+        fprintf(fplog, "Error writing file %s: proc_mirca()\n", fname2);
+        return err;
+    }
     
     fprintf(fplog, "Wrote file %s: proc_mirca(); records written=%i\n", fname, nrecords_irr);
     fprintf(fplog, "Wrote file %s: proc_mirca(); records written=%i\n", fname2, nrecords_rfd);
@@ -33,6 +33,9 @@
  
  serbia and montenegro data are merged
  
+ the carbon states (median, min, max, q1, q3) are calculated once for each complete country X glu X land type bucket
+    with calc_carbon_quantiles(), after all cells have been collected
+ 
  arguments:
  args_struct in_args: the input file arguments
  rinfo_struct *raster_info: information about input raster data
@@ -74,9 +77,6 @@ int proc_refveg_pasture_carbon(args_struct in_args, rinfo_struct raster_info) {
     int rv_ind;                 // the index of the current sage reference veg land type
     int err = OK;				// store error code from the read/write functions
     
-    int scg_code = 186;         // fao code for serbia and montenegro
-    int srb_code = 272;         // fao code for serbia
-    int mne_code = 273;         // fao code for montenegro
     
     
     float global_soilc = 0;         // total pot veg soil carbon
@@ -121,12 +121,8 @@ int proc_refveg_pasture_carbon(args_struct in_args, rinfo_struct raster_info) {
     int ***soil_carbon_array_size; //temporary size of array, used to get the grid index
     int ***soil_carbon_array_size_NODATA; //temporary size of array, used to get the grid index of the NODATA cells
     int ***veg_carbon_array_size_NODATA; //temporary size of array, used to get the grid index of the NODATA cells
-    int memory_median=0;           //These are the cell indices to be used for soil_carbon_array and veg_carbon_array
-    int memory_min=0;              //These are the cell indices to be used for soil_carbon_array and veg_carbon_array
-    int memory_max=0;              //These are the cell indices to be used for soil_carbon_array and veg_carbon_array      
-    int memory_q1=0;               //These are the cell indices to be used for soil_carbon_array and veg_carbon_array
-    int memory_q3=0;               //These are the cell indices to be used for soil_carbon_array and veg_carbon_array
-    int size_max=0;                //These are the cell indices to be used for soil_carbon_array and veg_carbon_array
+    float soil_states[NUM_CARBON];  // carbon state values for the current bucket
+    float veg_states[NUM_CARBON];
     float global_soil_temp=0;
     // output table as 4-d array
     float ***refveg_carbon_area;        // the reference area for carbon calculation  
@@ -147,9 +143,9 @@ int proc_refveg_pasture_carbon(args_struct in_args, rinfo_struct raster_info) {
     
     char fname[MAXCHAR];        // current file name to write
     FILE *fpout;                // out file pointer
+    csv_out_struct csv_out;     // buffered record output
     float temp_frac;           //Create temporary fraction for protected areas
     int size=0;                //Integer representing size of array
-    int size_temp=0;           //
     // allocate arrays
     
 
@@ -281,6 +277,7 @@ int proc_refveg_pasture_carbon(args_struct in_args, rinfo_struct raster_info) {
     
     // loop over the valid hyde land cells
     //  and skip it if no valid glu value or country value (country has to be mapped to ctry87)
+    // the protected area and carbon state arrays are indexed by the land cell ordinal j
     for (j = 0; j < num_land_cells_hyde; j++) {
     //for (j = 0; j < 10000; j++) {    
 
@@ -291,44 +288,15 @@ int proc_refveg_pasture_carbon(args_struct in_args, rinfo_struct raster_info) {
         ctry_code = country_fao[grid_ind];
         
         if (aez_val != raster_info.aez_new_nodata) {
-            // get the fao country index
-            ctry_ind = NOMATCH;
-            for (i = 0; i < NUM_FAO_CTRY; i++) {
-                if (countrycodes_fao[i] == ctry_code) {
-                    ctry_ind = i;
-                    break;
-                }
-            } // end for i loop to get ctry index
-            
-            // merge serbia and montenegro for scg record
-            if (ctry_code == mne_code || ctry_code == srb_code) {
-                ctry_code = scg_code;
-                ctry_ind = NOMATCH;
-                for (i = 0; i < NUM_FAO_CTRY; i++) {
-                    if (countrycodes_fao[i] == ctry_code) {
-                        ctry_ind = i;
-                        break;
-                    }
-                }
-                if (ctry_ind == NOMATCH) {
-                    // this should never happen
-                    fprintf(fplog, "Error finding scg ctry index: proc_refveg_carbon()\n");
-                    return ERROR_IND;
-                }
-            } // end if serbia or montenegro
-			
+            // get the fao country index (serbia and montenegro are merged into scg) from the index raster
+            ctry_ind = cell_ctry_ind[grid_ind];
+
 			if (ctry_ind == NOMATCH || ctry2ctry87codes_gtap[ctry_ind] == NOMATCH) {
 				continue;
 			}
-			
-            // get the glu index within the country glu list
-            aez_ind = NOMATCH;
-            for (i = 0; i < ctry_aez_num[ctry_ind]; i++) {
-                if (ctry_aez_list[ctry_ind][i] == aez_val) {
-                    aez_ind = i;
-                    break;
-                }
-            } // end for i loop to get aez index
+            
+            // get the glu index within the country glu list from the index raster
+            aez_ind = cell_aez_ind[grid_ind];
             
             // this shouldn't happen because the countryXglu list has been made already
             if (aez_ind == NOMATCH) {
@@ -343,11 +311,8 @@ int proc_refveg_pasture_carbon(args_struct in_args, rinfo_struct raster_info) {
             
             // get index of sage pot veg; set value to 0 if unknown
             rv_ind = NOMATCH;
-            for (i = 0; i < NUM_SAGE_PVLT; i++) {
-                if (refvegcarbon_thematic[grid_ind] == landtypecodes_sage[i]) {
-                    rv_ind = i;
-                    break;
-                }
+            if (refvegcarbon_thematic[grid_ind] >= 0 && refvegcarbon_thematic[grid_ind] <= max_sage_code) {
+                rv_ind = sage_code2ind[refvegcarbon_thematic[grid_ind]];
             }
 			// set the c values for this cell; use existing variables
             if (rv_ind == NOMATCH) {
@@ -365,14 +330,7 @@ int proc_refveg_pasture_carbon(args_struct in_args, rinfo_struct raster_info) {
             //Calculate temporary land type category. The carbon per fraction of protected area is the same. This will get split out later when we multiply each fraction's total land.
             //To save on time, we are calculating a temporary land type category.
             cur_lt_cat_temp = rv_value * SCALE_POTVEG + PASTURE_LT_CODE + 0;
-            cur_lt_cat_ind_temp = NOMATCH;
-            
-            for (i = 0; i < num_lt_cats; i++) {
-					if (lt_cats[i] == cur_lt_cat_temp) {
-						cur_lt_cat_ind_temp = i;
-						break;
-					}
-				}
+            cur_lt_cat_ind_temp = lt_cat_code2ind[cur_lt_cat_temp];
 				if (cur_lt_cat_ind_temp == NOMATCH) {
 					fprintf(fplog, "Failed to match lt_cat %i: proc_refveg_carbon()\n", cur_lt_cat);
 					return ERROR_IND;
@@ -384,18 +342,12 @@ int proc_refveg_pasture_carbon(args_struct in_args, rinfo_struct raster_info) {
 			//kbn 2020 Add code for protected areas
 			for (k=0; k< NUM_EPA_PROTECTED; k++){
 				//temporary fractions for protected areas
-				temp_frac = protected_EPA[k][grid_ind];
+				temp_frac = protected_EPA[k][j];
 				
                 
 				// get index of land category
 				cur_lt_cat = rv_value * SCALE_POTVEG + PASTURE_LT_CODE + k;
-				cur_lt_cat_ind = NOMATCH;
-				for (i = 0; i < num_lt_cats; i++) {
-					if (lt_cats[i] == cur_lt_cat) {
-						cur_lt_cat_ind = i;
-						break;
-					}
-				}
+				cur_lt_cat_ind = lt_cat_code2ind[cur_lt_cat];
 				if (cur_lt_cat_ind == NOMATCH) {
 					fprintf(fplog, "Failed to match lt_cat %i: proc_refveg_carbon()\n", cur_lt_cat);
 					return ERROR_IND;
@@ -403,232 +355,54 @@ int proc_refveg_pasture_carbon(args_struct in_args, rinfo_struct raster_info) {
                 
                 
                 //fprintf(stdout, "\nStarting cell %i country %i aez %i lt_cat %i started at %s\n", grid_ind,ctry_ind,aez_ind,cur_lt_cat_ind, get_systime());
-              if (cur_lt_cat_ind==cur_lt_cat_ind_temp){  
-              //Calculate the size here
-              soil_carbon_array_size[ctry_ind][aez_ind][cur_lt_cat_ind_temp]=soil_carbon_array_size[ctry_ind][aez_ind][cur_lt_cat_ind_temp]+1;
+              if (cur_lt_cat_ind==cur_lt_cat_ind_temp){
+              // store this cell's values in the next open slot of the country X glu X land type bucket
+              // the carbon states are calculated below from the complete buckets
+              size=soil_carbon_array_size[ctry_ind][aez_ind][cur_lt_cat_ind_temp];
+              if (size >= soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind_temp]) {
+                  fprintf(fplog, "Carbon bucket overflow for ctry %i aez %i lt_cat %i: proc_refveg_carbon()\n", ctry_code, aez_val, cur_lt_cat_temp);
+                  return ERROR_IND;
+              }
+              soil_carbon_array_size[ctry_ind][aez_ind][cur_lt_cat_ind_temp]=size+1;
 
               //Calculate the size of the NODATA cells
 
-              if(soil_carbon_pasture_sage[1][grid_ind] == NODATA && soil_carbon_pasture_sage[2][grid_ind] == NODATA && soil_carbon_pasture_sage[3][grid_ind] == NODATA && soil_carbon_pasture_sage[4][grid_ind] == NODATA && soil_carbon_pasture_sage[5][grid_ind] == NODATA){
+              if(soil_carbon_pasture_sage[1][j] == NODATA && soil_carbon_pasture_sage[2][j] == NODATA && soil_carbon_pasture_sage[3][j] == NODATA && soil_carbon_pasture_sage[4][j] == NODATA && soil_carbon_pasture_sage[5][j] == NODATA){
                soil_carbon_array_size_NODATA[ctry_ind][aez_ind][cur_lt_cat_ind_temp] = soil_carbon_array_size_NODATA[ctry_ind][aez_ind][cur_lt_cat_ind_temp]+1;   
               }
              
-             if(veg_carbon_pasture_sage[1][grid_ind] == NODATA && veg_carbon_pasture_sage[2][grid_ind] == NODATA && veg_carbon_pasture_sage[3][grid_ind] == NODATA && veg_carbon_pasture_sage[4][grid_ind] == NODATA && veg_carbon_pasture_sage[5][grid_ind] == NODATA){
+             if(veg_carbon_pasture_sage[1][j] == NODATA && veg_carbon_pasture_sage[2][j] == NODATA && veg_carbon_pasture_sage[3][j] == NODATA && veg_carbon_pasture_sage[4][j] == NODATA && veg_carbon_pasture_sage[5][j] == NODATA){
                veg_carbon_array_size_NODATA[ctry_ind][aez_ind][cur_lt_cat_ind_temp] = veg_carbon_array_size_NODATA[ctry_ind][aez_ind][cur_lt_cat_ind_temp]+1;   
               }
 
-             //Now reduce the cells by 1
-             //This ensures that we are always allocating in accordance with the size of the arrays and avoiding segmentation faults.
-             soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind_temp]= soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind_temp]-1;
-             //Make sure the number of cells is not 0              
-              //Convert the curent number of cells to an integer
-              //If number of cells is 10 we want to allocate from grid index 0-9. That's why we deduct 1 from above
-              memory_median = (float) floor((double) 0.5+ soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind_temp]);
-              memory_min = (float) floor((double) 0.5+ soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind_temp]);
-              memory_max = (float) floor((double) 0.5+ soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind_temp]);
-              memory_q1 = (float) floor((double) 0.5+ soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind_temp]);
-              memory_q3 = (float) floor((double) 0.5+ soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind_temp]);
-              
-             //Now use that as the grid index both for soil dnd vegetation carbon
-             soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][0][memory_median]=soil_carbon_pasture_sage[0][grid_ind];
-             soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][1][memory_median]=soil_carbon_pasture_sage[1][grid_ind];
-             soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][2][memory_min]=soil_carbon_pasture_sage[2][grid_ind];
-             soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][3][memory_max]=soil_carbon_pasture_sage[3][grid_ind];
-             soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][4][memory_q1]=soil_carbon_pasture_sage[4][grid_ind];
-             soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][5][memory_q3]=soil_carbon_pasture_sage[5][grid_ind];
-
-
-             veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][0][memory_median]=veg_carbon_pasture_sage[0][grid_ind];
-             veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][1][memory_median]=veg_carbon_pasture_sage[1][grid_ind];
-             veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][2][memory_min]=veg_carbon_pasture_sage[2][grid_ind];
-             veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][3][memory_max]=veg_carbon_pasture_sage[3][grid_ind];
-             veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][4][memory_q1]=veg_carbon_pasture_sage[4][grid_ind];
-             veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][5][memory_q3]=veg_carbon_pasture_sage[5][grid_ind];
-				
+             // state 0 is the weighted average, which is accumulated below and is not stored in the buckets
+             for (l = 1; l < NUM_CARBON; l++) {
+                 soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][l][size]=soil_carbon_pasture_sage[l][j];
+                 veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][l][size]=veg_carbon_pasture_sage[l][j];
+             }
+              }
                
 				// calculate an area weighted average based on ref veg area for REF_YEAR
 				// the unit conversion cancels out when the average is calculated, so don't do it here
 				//kbn 2020 Updating below for protected area fractions
-                //kbn 2020-06-02 Updating below with revised calculation for carbon states
 				// soil c
-                //sort arrays 
-                
-                //size is the current size of the array
-                size=soil_carbon_array_size[ctry_ind][aez_ind][cur_lt_cat_ind_temp];
-                
-
-                //sort the arrays based on size
-                qsort( soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][1],size,sizeof(float),cmpfunc);
-                qsort( soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][2],size,sizeof(float),cmpfunc);
-                qsort( soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][3],size,sizeof(float),cmpfunc);
-                qsort( soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][4],size,sizeof(float),cmpfunc);
-                qsort( soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][5],size,sizeof(float),cmpfunc);
-              
-
-                qsort( veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][1],size,sizeof(float),cmpfunc);
-                qsort( veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][2],size,sizeof(float),cmpfunc);
-                qsort( veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][3],size,sizeof(float),cmpfunc);
-                qsort( veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][4],size,sizeof(float),cmpfunc);
-                qsort( veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][5],size,sizeof(float),cmpfunc);
-                }
-
-                //Recalculate size since we need the 'index' now not the size. This is an issue for the max array, q3 array. 
-                size_max=size-1;
-                //1. weighted average
-                // Process only if the value is a non-NODATA value 
-               
-                if(soil_carbon_array_size_NODATA[ctry_ind][aez_ind][cur_lt_cat_ind_temp] > soil_carbon_array_size[ctry_ind][aez_ind][cur_lt_cat_ind_temp]){
-                    printf("NODATA array is bigger than original array!");
-                }
-
-               if(soil_carbon_pasture_sage[0][grid_ind] != NODATA){
+               if(soil_carbon_pasture_sage[0][j] != NODATA){
 				refveg_carbon_out[ctry_ind][aez_ind][cur_lt_cat_ind][soilc_ind][0] =
 				refveg_carbon_out[ctry_ind][aez_ind][cur_lt_cat_ind][soilc_ind][0] +
-				soil_carbon_pasture_sage[0][grid_ind] * pasture_grid_carbon[grid_ind]*temp_frac;
+				soil_carbon_pasture_sage[0][j] * pasture_grid_carbon[grid_ind]*temp_frac;
                }
 
-                //2. Median
-				size= soil_carbon_array_size[ctry_ind][aez_ind][cur_lt_cat_ind_temp];
-                size_temp=((size-soil_carbon_array_size_NODATA[ctry_ind][aez_ind][cur_lt_cat_ind_temp])/2)+soil_carbon_array_size_NODATA[ctry_ind][aez_ind][cur_lt_cat_ind_temp];
-
-                if(size_temp <= size){
-                temp_float= soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][1][size_temp];
-                
-                refveg_carbon_out[ctry_ind][aez_ind][cur_lt_cat_ind][soilc_ind][1] =
-				temp_float;
-                
-                } 
-                //
-
-                //3. Min
-                 size_temp= soil_carbon_array_size_NODATA[ctry_ind][aez_ind][cur_lt_cat_ind_temp];
-                 
-                 if(size_temp <= size){
-                 temp_float= soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][2][size_temp];
-                refveg_carbon_out[ctry_ind][aez_ind][cur_lt_cat_ind][soilc_ind][2] =
-				temp_float;
-                 }
-                //4. Max
-                size_temp=size/2;
-                
-               temp_float= soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][3][size_max];
-                               
-                refveg_carbon_out[ctry_ind][aez_ind][cur_lt_cat_ind][soilc_ind][3] =
-				temp_float ;
-
-                //5. Q1
-                
-                size_temp=(size-soil_carbon_array_size_NODATA[ctry_ind][aez_ind][cur_lt_cat_ind_temp])*0.25 + soil_carbon_array_size_NODATA[ctry_ind][aez_ind][cur_lt_cat_ind_temp];
-                if(size_temp <= size){
-                temp_float= soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][4][size_temp];
-                
-                refveg_carbon_out[ctry_ind][aez_ind][cur_lt_cat_ind][soilc_ind][4] =
-				temp_float;
-                
-                }
-
-
-                
-
-                //6. Q3
-                size_temp=(size-soil_carbon_array_size_NODATA[ctry_ind][aez_ind][cur_lt_cat_ind_temp])*0.75 + soil_carbon_array_size_NODATA[ctry_ind][aez_ind][cur_lt_cat_ind_temp];
-                if(size_temp <= size){
-                temp_float= soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][5][size_temp];
-
-                refveg_carbon_out[ctry_ind][aez_ind][cur_lt_cat_ind][soilc_ind][5] =
-				temp_float;
-                } 
 				// veg c
-                //1. weighted average
-                // Process only if the value is a non-NODATA value
-                
-
-                //Initialize the ratios for above and below ground as zeroes
-                //temp_ag_ratio = 0;
-                //temp_bg_ratio = 0;
-                
-                
-                
-                if(veg_carbon_pasture_sage[0][grid_ind] != NODATA){
+                if(veg_carbon_pasture_sage[0][j] != NODATA){
 				refveg_carbon_out[ctry_ind][aez_ind][cur_lt_cat_ind][vegc_ag_ind][0] =
 				refveg_carbon_out[ctry_ind][aez_ind][cur_lt_cat_ind][vegc_ag_ind][0] +
-				veg_carbon_pasture_sage[0][grid_ind] * pasture_grid_carbon[grid_ind] * temp_frac * above_ground_ratio_pasture[0][grid_ind];
+				veg_carbon_pasture_sage[0][j] * pasture_grid_carbon[grid_ind] * temp_frac * above_ground_ratio_pasture[0][j];
 				
                refveg_carbon_out[ctry_ind][aez_ind][cur_lt_cat_ind][vegc_bg_ind][0] =
 			   refveg_carbon_out[ctry_ind][aez_ind][cur_lt_cat_ind][vegc_bg_ind][0] +
-			   veg_carbon_pasture_sage[0][grid_ind] * pasture_grid_carbon[grid_ind] * temp_frac * below_ground_ratio_pasture[0][grid_ind];
-               
-
-               //Calculate the above ground and below ground biomass ratios below for each country-aez-landuse-carbonstate category. This ratio is calculated on the basis of weighted average value,
-                // and is applied to each state. This is because the differences in the ratios (above/below) is similar for each state.
-
-                
-               
-               
-               
+			   veg_carbon_pasture_sage[0][j] * pasture_grid_carbon[grid_ind] * temp_frac * below_ground_ratio_pasture[0][j];
                }
-            temp_ag_ratio = refveg_carbon_out[ctry_ind][aez_ind][cur_lt_cat_ind][vegc_ag_ind][0]/(refveg_carbon_out[ctry_ind][aez_ind][cur_lt_cat_ind][vegc_bg_ind][0]+refveg_carbon_out[ctry_ind][aez_ind][cur_lt_cat_ind][vegc_ag_ind][0]);
-                temp_bg_ratio = 1 - temp_ag_ratio;
-                
-                
-                //2. Median
-                size_temp=((size-veg_carbon_array_size_NODATA[ctry_ind][aez_ind][cur_lt_cat_ind_temp])/2)+veg_carbon_array_size_NODATA[ctry_ind][aez_ind][cur_lt_cat_ind_temp];
-                
-                if(size_temp <= size){
-                temp_float= veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][1][size_temp];
-                
-                refveg_carbon_out[ctry_ind][aez_ind][cur_lt_cat_ind][vegc_ag_ind][1] =
-				temp_float*temp_ag_ratio;
-
-                refveg_carbon_out[ctry_ind][aez_ind][cur_lt_cat_ind][vegc_bg_ind][1] =
-				temp_float* temp_bg_ratio;
-                }
-                //3. Min
-                
-                size_temp=veg_carbon_array_size_NODATA[ctry_ind][aez_ind][cur_lt_cat_ind_temp];
-                
-                if(size_temp <= size){
-                temp_float= veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][2][size_temp];
-                
-                refveg_carbon_out[ctry_ind][aez_ind][cur_lt_cat_ind][vegc_ag_ind][2] =
-				temp_float * temp_ag_ratio;
-                
-                refveg_carbon_out[ctry_ind][aez_ind][cur_lt_cat_ind][vegc_bg_ind][2] =
-				temp_float * temp_bg_ratio;
-                }
-                //4. Max
-                size_temp=size/2;
-                temp_float= veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][3][size_max];
-                               
-                refveg_carbon_out[ctry_ind][aez_ind][cur_lt_cat_ind][vegc_ag_ind][3] =
-				temp_float * temp_ag_ratio;
-                
-                refveg_carbon_out[ctry_ind][aez_ind][cur_lt_cat_ind][vegc_bg_ind][3] =
-				temp_float * temp_bg_ratio;
-                //5. Q1
-                size_temp=((size-veg_carbon_array_size_NODATA[ctry_ind][aez_ind][cur_lt_cat_ind_temp])*0.25)+veg_carbon_array_size_NODATA[ctry_ind][aez_ind][cur_lt_cat_ind_temp];
-                
-                if(size_temp < size){
-                temp_float= veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][4][size_temp];
-
-                refveg_carbon_out[ctry_ind][aez_ind][cur_lt_cat_ind][vegc_ag_ind][4] =
-				temp_float * temp_ag_ratio;
 
-                refveg_carbon_out[ctry_ind][aez_ind][cur_lt_cat_ind][vegc_bg_ind][4] =
-				temp_float * temp_bg_ratio;
-                }
-                //6. Q3
-                size_temp=((size-veg_carbon_array_size_NODATA[ctry_ind][aez_ind][cur_lt_cat_ind_temp])*0.75)+veg_carbon_array_size_NODATA[ctry_ind][aez_ind][cur_lt_cat_ind_temp];
-                if(size_temp < size){
-                
-                temp_float= veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp][5][size_temp];
-
-                refveg_carbon_out[ctry_ind][aez_ind][cur_lt_cat_ind][vegc_ag_ind][5] =
-				temp_float * temp_ag_ratio;
-
-                refveg_carbon_out[ctry_ind][aez_ind][cur_lt_cat_ind][vegc_bg_ind][5] =
-				temp_float * temp_bg_ratio;
-                }
 				// area
 				refveg_carbon_area[ctry_ind][aez_ind][cur_lt_cat_ind] =
 				refveg_carbon_area[ctry_ind][aez_ind][cur_lt_cat_ind] +
@@ -639,12 +413,66 @@ int proc_refveg_pasture_carbon(args_struct in_args, rinfo_struct raster_info) {
 			}	// end if valid aez cell
 		}   //end k loop for protected areas
 	}	// end for j loop over valid hyde land cells
+
+    // calculate the carbon states for each country X glu X land type bucket, now that the buckets are complete
+    // the bucket values are stored only at the temporary (unprotected) land type category,
+    //  and the states are the same for all protection categories of that land type
+    // the veg c states are split into above and below ground with the weighted average ratio of each category
+    for (ctry_ind = 0; ctry_ind < NUM_FAO_CTRY ; ctry_ind++) {
+        for (aez_ind = 0; aez_ind < ctry_aez_num[ctry_ind]; aez_ind++) {
+            for (cur_lt_cat_ind_temp = 0; cur_lt_cat_ind_temp < num_lt_cats; cur_lt_cat_ind_temp++) {
+                size = soil_carbon_array_size[ctry_ind][aez_ind][cur_lt_cat_ind_temp];
+                if (size == 0) {
+                    continue;
+                }
+                if (soil_carbon_array_size_NODATA[ctry_ind][aez_ind][cur_lt_cat_ind_temp] > size ||
+                    veg_carbon_array_size_NODATA[ctry_ind][aez_ind][cur_lt_cat_ind_temp] > size) {
+                    fprintf(fplog, "Carbon bucket NODATA count exceeds bucket size for ctry %i aez %i lt_cat %i: proc_refveg_pasture_carbon()\n",
+                            countrycodes_fao[ctry_ind], ctry_aez_list[ctry_ind][aez_ind], lt_cats[cur_lt_cat_ind_temp]);
+                    return ERROR_IND;
+                }
+                
+                calc_carbon_quantiles(soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp], size,
+                                      soil_carbon_array_size_NODATA[ctry_ind][aez_ind][cur_lt_cat_ind_temp], soil_states);
+                calc_carbon_quantiles(veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind_temp], size,
+                                      veg_carbon_array_size_NODATA[ctry_ind][aez_ind][cur_lt_cat_ind_temp], veg_states);
+                
+                for (k=0; k< NUM_EPA_PROTECTED; k++){
+                    cur_lt_cat = lt_cats[cur_lt_cat_ind_temp] + k;
+                    cur_lt_cat_ind = lt_cat_code2ind[cur_lt_cat];
+                    if (cur_lt_cat_ind == NOMATCH) {
+                        fprintf(fplog, "Failed to match lt_cat %i: proc_refveg_carbon()\n", cur_lt_cat);
+                        return ERROR_IND;
+                    }
+                    
+                    temp_ag_ratio = refveg_carbon_out[ctry_ind][aez_ind][cur_lt_cat_ind][vegc_ag_ind][0]/(refveg_carbon_out[ctry_ind][aez_ind][cur_lt_cat_ind][vegc_bg_ind][0]+refveg_carbon_out[ctry_ind][aez_ind][cur_lt_cat_ind][vegc_ag_ind][0]);
+                    temp_bg_ratio = 1 - temp_ag_ratio;
+                    
+                    for (l = 1; l < NUM_CARBON; l++) {
+                        refveg_carbon_out[ctry_ind][aez_ind][cur_lt_cat_ind][soilc_ind][l] = soil_states[l];
+                        refveg_carbon_out[ctry_ind][aez_ind][cur_lt_cat_ind][vegc_ag_ind][l] = veg_states[l] * temp_ag_ratio;
+                        refveg_carbon_out[ctry_ind][aez_ind][cur_lt_cat_ind][vegc_bg_ind][l] = veg_states[l] * temp_bg_ratio;
+                    }
+                } // end for k loop over protected categories
+            } // end for land type loop
+        } // end for glu loop
+    } // end for country loop
+	
 	
     // write the output file
 	//fprintf(stdout, "\nSuccessfully processed all cells at %s\n", get_systime());
     strcpy(fname, in_args.outpath);
     strcat(fname, in_args.refveg_carbon_fname);
     fpout = fopen(fname,"a"); //float
+    if(fpout == NULL)
+    {
+        fprintf(fplog,"Failed to open file  %s for write:  proc_refveg_pasture_carbon()\n", fname);
+        return ERROR_FILE;
+    }
+    if ((err = csv_out_open(&csv_out, fpout))) {
+        fclose(fpout);
+        return err;
+    }
     
     
     // write the records (rounded to integer)
@@ -703,14 +531,16 @@ int proc_refveg_pasture_carbon(args_struct in_args, rinfo_struct raster_info) {
                     
 					// write the value only if weighted average is over 0 and all other values are 0 or above.
 					if (outval_soilc > 0 &&  outval_soilc_median >=0 && outval_soilc_min >=0 && outval_soilc_max >=0 &&  outval_soilc_q1 >=0  && outval_soilc_q3 >= 0 ) {
-						fprintf(fpout,"\n%s,%i,%i,%s", countryabbrs_iso[ctry_ind], ctry_aez_list[ctry_ind][aez_ind],
-								lt_cats[cur_lt_cat_ind], "soil_c (0-30 cms)");
-						fprintf(fpout,",%.0f", outval_soilc);
-                        fprintf(fpout,",%.0f", outval_soilc_median);
-                        fprintf(fpout,",%.0f", outval_soilc_min);
-                        fprintf(fpout,",%.0f", outval_soilc_max);
-                        fprintf(fpout,",%.0f", outval_soilc_q1);
-                        fprintf(fpout,",%.0f", outval_soilc_q3);
+						csv_out_rec(&csv_out, countryabbrs_iso[ctry_ind]);
+						csv_out_int(&csv_out, ctry_aez_list[ctry_ind][aez_ind]);
+						csv_out_int(&csv_out, lt_cats[cur_lt_cat_ind]);
+						csv_out_str(&csv_out, "soil_c (0-30 cms)");
+						csv_out_fixed(&csv_out, outval_soilc, 0, 0);
+                        csv_out_fixed(&csv_out, outval_soilc_median, 0, 0);
+                        csv_out_fixed(&csv_out, outval_soilc_min, 0, 0);
+                        csv_out_fixed(&csv_out, outval_soilc_max, 0, 0);
+                        csv_out_fixed(&csv_out, outval_soilc_q1, 0, 0);
+                        csv_out_fixed(&csv_out, outval_soilc_q3, 0, 0);
 						nrecords++;
 					}
 					
@@ -808,26 +638,30 @@ int proc_refveg_pasture_carbon(args_struct in_args, rinfo_struct raster_info) {
 
                     // write the value only if weighted average is over 0 and all other values are 0 or above.
 					if (outval_vegc_ag > 0 &&  outval_vegc_ag_median >=0 && outval_vegc_ag_min >=0 && outval_vegc_ag_max >=0 &&  outval_vegc_ag_q1 >=0  && outval_vegc_ag_q3 >= 0 ) {
-						fprintf(fpout,"\n%s,%i,%i,%s", countryabbrs_iso[ctry_ind], ctry_aez_list[ctry_ind][aez_ind],
-								lt_cats[cur_lt_cat_ind], "veg_c (above ground biomass)");
-						fprintf(fpout,",%.0f", outval_vegc_ag);
-                        fprintf(fpout,",%.0f", outval_vegc_ag_median);
-                        fprintf(fpout,",%.0f", outval_vegc_ag_min);
-                        fprintf(fpout,",%.0f", outval_vegc_ag_max);
-                        fprintf(fpout,",%.0f", outval_vegc_ag_q1);
-                        fprintf(fpout,",%.0f", outval_vegc_ag_q3);
+						csv_out_rec(&csv_out, countryabbrs_iso[ctry_ind]);
+						csv_out_int(&csv_out, ctry_aez_list[ctry_ind][aez_ind]);
+						csv_out_int(&csv_out, lt_cats[cur_lt_cat_ind]);
+						csv_out_str(&csv_out, "veg_c (above ground biomass)");
+						csv_out_fixed(&csv_out, outval_vegc_ag, 0, 0);
+                        csv_out_fixed(&csv_out, outval_vegc_ag_median, 0, 0);
+                        csv_out_fixed(&csv_out, outval_vegc_ag_min, 0, 0);
+                        csv_out_fixed(&csv_out, outval_vegc_ag_max, 0, 0);
+                        csv_out_fixed(&csv_out, outval_vegc_ag_q1, 0, 0);
+                        csv_out_fixed(&csv_out, outval_vegc_ag_q3, 0, 0);
 						nrecords++;
 					                    }
                    
                    if (outval_vegc_bg > 0 &&  outval_vegc_bg_median >=0 && outval_vegc_bg_min >=0 && outval_vegc_bg_max >=0 &&  outval_vegc_bg_q1 >=0  && outval_vegc_bg_q3 >= 0 ) {
-						fprintf(fpout,"\n%s,%i,%i,%s", countryabbrs_iso[ctry_ind], ctry_aez_list[ctry_ind][aez_ind],
-								lt_cats[cur_lt_cat_ind], "veg_c (below ground biomass)");
-						fprintf(fpout,",%.0f", outval_vegc_bg);
-                        fprintf(fpout,",%.0f", outval_vegc_bg_median);
-                        fprintf(fpout,",%.0f", outval_vegc_bg_min);
-                        fprintf(fpout,",%.0f", outval_vegc_bg_max);
-                        fprintf(fpout,",%.0f", outval_vegc_bg_q1);
-                        fprintf(fpout,",%.0f", outval_vegc_bg_q3);
+						csv_out_rec(&csv_out, countryabbrs_iso[ctry_ind]);
+						csv_out_int(&csv_out, ctry_aez_list[ctry_ind][aez_ind]);
+						csv_out_int(&csv_out, lt_cats[cur_lt_cat_ind]);
+						csv_out_str(&csv_out, "veg_c (below ground biomass)");
+						csv_out_fixed(&csv_out, outval_vegc_bg, 0, 0);
+                        csv_out_fixed(&csv_out, outval_vegc_bg_median, 0, 0);
+                        csv_out_fixed(&csv_out, outval_vegc_bg_min, 0, 0);
+                        csv_out_fixed(&csv_out, outval_vegc_bg_max, 0, 0);
+                        csv_out_fixed(&csv_out, outval_vegc_bg_q1, 0, 0);
+                        csv_out_fixed(&csv_out, outval_vegc_bg_q3, 0, 0);
 						nrecords++;
 					                    }
                                         
@@ -837,7 +671,10 @@ int proc_refveg_pasture_carbon(args_struct in_args, rinfo_struct raster_info) {
         } // end for glu loop
     } // end for country loop
 	
-    fclose(fpout);	
+    if ((err = csv_out_close(&csv_out))) {
+        fprintf(fplog, "Error writing file %s: proc_refveg_pasture_carbon()\n", fname);
+        return err;
+    }
 
     // also write the total global carbon values to the log file
     // in Mg 
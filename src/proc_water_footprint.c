@@ -75,9 +75,6 @@ int proc_water_footprint(args_struct in_args, rinfo_struct raster_info) {
     int crop_index;             // the index for looping over wf crops
     int err = OK;				// store error code from the write functions
     
-    int scg_code = 186;         // fao code for serbia and montenegro
-    int srb_code = 272;         // fao code for serbia
-    int mne_code = 273;         // fao code for montenegro
     
     float *bl_grid;  // 1d array to store current blue raster file; start up left corner, row by row; lon varies faster
     float *gn_grid;  // 1d array to store current green raster file; start up left corner, row by row; lon varies faster
@@ -98,6 +95,7 @@ int proc_water_footprint(args_struct in_args, rinfo_struct raster_info) {
     char tmp_str[MAXCHAR];		// stores a temporary string
     char diag_name[MAXCHAR];	// for diagnostic output names
     FILE *fpout;                // out file pointer
+    csv_out_struct csv_out;     // buffered record output
     
     float wf_nodata = NODATA;  // wf binary file nodata value
     float CONV2M3 = 1000;            // mm * 1km/1000000mm * km2 * 1000000000m3/1km3 so conversion is *1000
@@ -218,44 +216,15 @@ int proc_water_footprint(args_struct in_args, rinfo_struct raster_info) {
             ctry_code = country_fao[land_cells_sage[j]];
             
             if (glu_val != raster_info.aez_new_nodata) {
-                // get the fao country index
-                ctry_ind = NOMATCH;
-                for (i = 0; i < NUM_FAO_CTRY; i++) {
-                    if (countrycodes_fao[i] == ctry_code) {
-                        ctry_ind = i;
-                        break;
-                    }
-                } // end for i loop to get ctry index
-                
-                // merge serbia and montenegro for scg record
-                if (ctry_code == mne_code || ctry_code == srb_code) {
-                    ctry_code = scg_code;
-                    ctry_ind = NOMATCH;
-                    for (i = 0; i < NUM_FAO_CTRY; i++) {
-                        if (countrycodes_fao[i] == ctry_code) {
-                            ctry_ind = i;
-                            break;
-                        }
-                    }
-                    if (ctry_ind == NOMATCH) {
-                        // this should never happen
-                        fprintf(fplog, "Error finding scg ctry index: proc_water_footprint()\n");
-                        return ERROR_IND;
-                    }
-                } // end if serbia or montenegro
-				
+                // get the fao country index (serbia and montenegro are merged into scg) from the index raster
+                ctry_ind = cell_ctry_ind[land_cells_sage[j]];
+
 				if (ctry_ind == NOMATCH || ctry2ctry87codes_gtap[ctry_ind] == NOMATCH) {
 					continue;
 				}
-				
-                // get the glu index within the country glu list
-                glu_ind = NOMATCH;
-                for (i = 0; i < ctry_aez_num[ctry_ind]; i++) {
-                    if (ctry_aez_list[ctry_ind][i] == glu_val) {
-                        glu_ind = i;
-                        break;
-                    }
-                } // end for i loop to get glu index
+                
+                // get the glu index within the country glu list from the index raster
+                glu_ind = cell_aez_ind[land_cells_sage[j]];
                 
                 // this shouldn't happen because the countryXglu list has been made already
                 if (glu_ind == NOMATCH) {
@@ -354,6 +323,10 @@ int proc_water_footprint(args_struct in_args, rinfo_struct raster_info) {
     fprintf(fpout,"# Original source: water footprint network; country raster; glu raster\n");
     fprintf(fpout,"# ----------\n");
     fprintf(fpout,"iso,glu_code,SAGE_crop,water_type,value");
+    if ((err = csv_out_open(&csv_out, fpout))) {
+        fclose(fpout);
+        return err;
+    }
     
     // write the records (rounded to nearest integer)
     for (ctry_ind = 0; ctry_ind < NUM_FAO_CTRY ; ctry_ind++) {
@@ -364,8 +337,11 @@ int proc_water_footprint(args_struct in_args, rinfo_struct raster_info) {
                     outval = (float) floor((double) 0.5 + wf_out[ctry_ind][glu_ind][crop_index][i]);
                     // output only positive values
                     if (outval > 0) {
-                        fprintf(fpout,"\n%s,%i,%s,%s,%.0f", countryabbrs_iso[ctry_ind], ctry_aez_list[ctry_ind][glu_ind],
-                                crop_names[crop_index], wftype_names[i], outval);
+                        csv_out_rec(&csv_out, countryabbrs_iso[ctry_ind]);
+                        csv_out_int(&csv_out, ctry_aez_list[ctry_ind][glu_ind]);
+                        csv_out_str(&csv_out, crop_names[crop_index]);
+                        csv_out_str(&csv_out, wftype_names[i]);
+                        csv_out_fixed(&csv_out, outval, 0, 0);
                         nrecords_wf++;
                     } // end if value is positive
                 } // end for water type loop
@@ -373,14 +349,13 @@ int proc_water_footprint(args_struct in_args, rinfo_struct raster_info) {
         } // end for glu loop
     } // end for country loop
     
-    fclose(fpout);
+    if ((err = csv_out_close(&csv_out))) {
+        fprintf(fplog, "Error writing file %s: proc_water_footprint()\n", fname);
+        return err;
+    }
     
     fprintf(fplog, "Wrote file %s: proc_water_footprint(); records written=%i\n", fname, nrecords_wf);
     
-  for (i = 0; i < raster_info.lulc_input_ncells; i++) {
-		free(rand_order[i]);
-	}
-	free(rand_order);
     free(bl_grid);
     free(gn_grid);
     free(gy_grid);
@@ -55,6 +55,7 @@ int read_aez_new_info(args_struct in_args) {
     char rec_str[MAXRECSIZE];		// string to hold one record
     const char* delim = ",";		// delimiter string for csv file
     int err = OK;					// error code for the string parsing function
+    fields_struct fields = {0, 0, NULL, NULL};	// the fields of the current record
     int out_index = 0;				// the index of the arrays to fill
     
     // create file name and open it
@@ -113,14 +114,19 @@ int read_aez_new_info(args_struct in_args) {
     // read the aez new info records
     for (i = 0; i < NUM_NEW_AEZ; i++) {
         if (fscanf(fpin, "%[^\r\n]\r\n", rec_str) != EOF) {
+            // split the record into its fields once
+            if((err = split_fields(rec_str, delim, &fields)) != OK) {
+                fprintf(fplog, "Error processing file %s: read_aez_new_info(); field split\n", fname);
+                return err;
+            }
             // get the intger code
-            if((err = get_int_field(rec_str, delim, 1, &aez_codes_new[out_index])) != OK) {
+            if((err = get_int_fld(&fields, 1, &aez_codes_new[out_index])) != OK) {
                 fprintf(fplog, "Error processing file %s: read_aez_new_info(); record=%i, column=1\n",
                         fname, i + 1);
                 return err;
             }
             // get the name
-            if((err = get_text_field(rec_str, delim, 2, &aez_names_new[out_index++][0])) != OK) {
+            if((err = get_text_fld(&fields, 2, &aez_names_new[out_index++][0])) != OK) {
                 fprintf(fplog, "Error processing file %s: read_aez_new_info(); record=%i, column=2\n",
                         fname, i + 1);
                 return err;
@@ -153,4 +159,5 @@ int read_aez_new_info(args_struct in_args) {
         }
     }	// end if diagnostics
     
+    free_fields(&fields);
     return OK;}
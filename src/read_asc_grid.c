@@ -0,0 +1,330 @@
+/**********
+ read_asc_grid.c
+
+ read the header and values of one arc (esri) ascii grid file into grid[ncells]
+ 
+ this replaces the per-value fscanf() loops in the ascii grid readers, which are much slower than the disk
+    the file is read in large blocks and each value is parsed in one pass directly from the block buffer
+ 
+ header: the lines at the start of the file that begin with a keyword, each followed by one value
+    ncols, nrows, xllcorner (or xllcenter), yllcorner (or yllcenter), cellsize, nodata_value (in any case)
+    the line endings can be \n or \r\n, and any amount of white space can separate the tokens
+    ncols and nrows are required, and ncols * nrows must equal ncells
+ values: numbers separated by white space (any space or control characters), read in file order
+ 
+ the values are the same as reading them with fscanf("%f"), which rounds the decimal value correctly to a float
+    most values are converted exactly with one double precision operation, which is the usual fast path
+    the rare values that this can not round correctly, or that are not plain decimal numbers, are converted with strtof()
+ 
+ arguments:
+ char *fname: the full path name of the arc ascii file
+ float *grid: the array to read the values into
+ int ncells: the number of values to read
+ int *ncols: the number of columns in the header; can be NULL
+ int *nrows: the number of rows in the header; can be NULL
+ 
+ return value:
+	integer error code: OK = 0, otherwise a non-zero error code
+
+ Created 17 Oct 2026
+
+ Moirai Land Data System (Moirai) Copyright (c) 2019, The
+ Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S.
+ Dept. of Energy).  All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Intellectual Property Office at
+ IPO@lbl.gov.
+
+ NOTICE.  This Software was developed under funding from the U.S. Department
+ of Energy and the U.S. Government consequently retains certain rights.  As
+ such, the U.S. Government has been granted for itself and others acting on
+ its behalf a paid-up, nonexclusive, irrevocable, worldwide license in the
+ Software to reproduce, distribute copies to the public, prepare derivative
+ works, and perform publicly and display publicly, and to permit other to do
+ so.
+
+ This file is part of Moirai.
+
+ Moirai is free software: you can use it under the terms of the modified BSD-3 license (see …/moirai/license.txt)
+
+ **********/
+
+#include <stdint.h>
+#include <float.h>
+
+#include "moirai.h"
+
+#define ASC_BLOCK_SIZE	(1 << 20)	// the number of bytes to read at a time
+#define ASC_MAX_TOKEN	256			// the longest value or header token
+
+// separator test without the locale lookup of isspace(); space and all control characters separate tokens
+#define ASC_IS_SPACE(c)	((unsigned char) (c) <= ' ')
+
+// exact powers of ten in double precision
+static const double asc_pow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+	1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// convert the token starting at tok to a float, with the same result as strtof()
+// the token ends at the first separator or at end
+// return the end of the token, or NULL if the whole token is not a number
+static const char *asc_parse_float(const char *tok, const char *end, float *value) {
+	
+	const char *p = tok;
+	int neg = 0;			// 1 = negative value
+	int ndigits = 0;		// number of significant mantissa digits stored
+	int nseen = 0;			// number of mantissa digits seen
+	int exp10 = 0;			// decimal exponent applied to the mantissa
+	int exp_val = 0;		// the explicit exponent
+	int exp_neg = 0;		// 1 = negative explicit exponent
+	int exact = 1;			// 1 = all non-zero mantissa digits are stored
+	int len;				// token length
+	uint64_t mant = 0;		// the mantissa digits
+	uint64_t bits;			// the double bits, for the rounding check
+	uint64_t low;			// the double mantissa bits dropped by rounding to float
+	double dval;			// the double value
+	float fval;				// the float value
+	char buf[ASC_MAX_TOKEN + 1];	// for the strtof() fallback
+	char *endp;
+	
+	if (p < end && (*p == '-' || *p == '+')) {
+		neg = (*p == '-');
+		p++;
+	}
+	for (; p < end && *p >= '0' && *p <= '9'; p++) {
+		nseen++;
+		if (mant == 0 && *p == '0') {
+			continue;
+		}
+		if (ndigits < 19) {
+			mant = mant * 10 + (uint64_t) (*p - '0');
+			ndigits++;
+		} else {
+			exp10++;
+			if (*p != '0') {
+				exact = 0;
+			}
+		}
+	}
+	if (p < end && *p == '.') {
+		for (p++; p < end && *p >= '0' && *p <= '9'; p++) {
+			nseen++;
+			if (mant == 0 && *p == '0') {
+				exp10--;
+				continue;
+			}
+			if (ndigits < 19) {
+				mant = mant * 10 + (uint64_t) (*p - '0');
+				ndigits++;
+				exp10--;
+			} else if (*p != '0') {
+				exact = 0;
+			}
+		}
+	}
+	if (nseen > 0 && p < end && (*p == 'e' || *p == 'E')) {
+		p++;
+		if (p < end && (*p == '-' || *p == '+')) {
+			exp_neg = (*p == '-');
+			p++;
+		}
+		if (p == end || *p < '0' || *p > '9') {
+			nseen = 0;
+		}
+		for (; p < end && *p >= '0' && *p <= '9'; p++) {
+			if (exp_val < 10000) {
+				exp_val = exp_val * 10 + (*p - '0');
+			}
+		}
+		exp10 = exp10 + (exp_neg ? -exp_val : exp_val);
+	}
+	
+	if (nseen > 0 && (p == end || ASC_IS_SPACE(*p)) && exact) {
+		if (mant == 0) {
+			*value = neg ? -0.0f : 0.0f;
+			return p;
+		}
+		if (mant < ((uint64_t) 1 << 53) && exp10 >= -22 && exp10 <= 22) {
+			// one correctly rounded double operation on exact operands
+			if (exp10 >= 0) {
+				dval = (double) mant * asc_pow10[exp10];
+			} else {
+				dval = (double) mant / asc_pow10[-exp10];
+			}
+			// rounding the double to float is correct unless the double is within one unit of a float halfway point
+			memcpy(&bits, &dval, sizeof(bits));
+			low = bits & (((uint64_t) 1 << 29) - 1);
+			if (dval >= FLT_MIN && dval <= FLT_MAX && (low < 0x0FFFFFFF || low > 0x10000001)) {
+				fval = (float) dval;
+				*value = neg ? -fval : fval;
+				return p;
+			}
+		}
+	}
+	
+	// not a plain decimal number, or the fast conversion may not round correctly
+	for (p = tok; p < end && !ASC_IS_SPACE(*p); p++) {
+		;
+	}
+	len = (int) (p - tok);
+	if (len == 0 || len > ASC_MAX_TOKEN) {
+		return NULL;
+	}
+	memcpy(buf, tok, len);
+	buf[len] = '\0';
+	*value = strtof(buf, &endp);
+	if (endp != buf + len) {
+		return NULL;
+	}
+	return p;
+}
+
+int read_asc_grid(char *fname, float *grid, int ncells, int *ncols, int *nrows) {
+	
+	int i;
+	int file_eof = 0;			// 1 = the whole file has been read
+	int in_header = 1;			// 1 = still reading header lines
+	int hdr_ncols = NOMATCH;	// header number of columns
+	int hdr_nrows = NOMATCH;	// header number of rows
+	int nvals = 0;				// number of values read
+	int tok_len;				// current header token length
+	size_t nbuf = 0;			// number of bytes in the buffer
+	size_t nread;				// number of bytes read
+	char *buf;					// the block buffer
+	const char *pos;			// current position in the buffer
+	const char *end;			// end of the data in the buffer
+	const char *refill;			// refill the buffer when pos passes this point, so that a whole token is in the buffer
+	const char *start;			// start of the current header token
+	char key[ASC_MAX_TOKEN + 1];	// current header keyword
+	char val[ASC_MAX_TOKEN + 1];	// current header value
+	FILE *fpin;
+	
+	if((fpin = fopen(fname, "rb")) == NULL)
+	{
+		fprintf(fplog,"Failed to open file %s:  read_asc_grid()\n", fname);
+		return ERROR_FILE;
+	}
+	
+	buf = malloc(ASC_BLOCK_SIZE + ASC_MAX_TOKEN);
+	if(buf == NULL) {
+		fprintf(fplog,"Failed to allocate memory for buf: read_asc_grid()\n");
+		fclose(fpin);
+		return ERROR_MEM;
+	}
+	pos = buf;
+	end = buf;
+	refill = buf;
+	
+	while (nvals < ncells) {
+		// refill the buffer if a whole token might not be in it
+		if (pos >= refill && !file_eof) {
+			nbuf = (size_t) (end - pos);
+			memmove(buf, pos, nbuf);
+			nread = fread(buf + nbuf, 1, ASC_BLOCK_SIZE + ASC_MAX_TOKEN - nbuf, fpin);
+			if (nread == 0) {
+				file_eof = 1;
+			}
+			nbuf = nbuf + nread;
+			pos = buf;
+			end = buf + nbuf;
+			refill = file_eof ? end : end - ASC_MAX_TOKEN;
+			if (refill < buf) {
+				refill = buf;
+			}
+			continue;
+		}
+		
+		if (pos >= end) {
+			break;
+		}
+		
+		// skip the separators
+		if (ASC_IS_SPACE(*pos)) {
+			while (pos < end && ASC_IS_SPACE(*pos)) {
+				pos++;
+			}
+			continue;
+		}
+		
+		// header lines start with a keyword, followed by the value
+		if (in_header && isalpha((unsigned char) *pos)) {
+			start = pos;
+			while (pos < end && !ASC_IS_SPACE(*pos)) {
+				pos++;
+			}
+			tok_len = (int) (pos - start);
+			if (tok_len > ASC_MAX_TOKEN) {
+				tok_len = ASC_MAX_TOKEN;
+			}
+			memcpy(key, start, tok_len);
+			key[tok_len] = '\0';
+			for (i = 0; i < tok_len; i++) {
+				key[i] = (char) tolower((unsigned char) key[i]);
+			}
+			while (pos < end && ASC_IS_SPACE(*pos)) {
+				pos++;
+			}
+			start = pos;
+			while (pos < end && !ASC_IS_SPACE(*pos)) {
+				pos++;
+			}
+			tok_len = (int) (pos - start);
+			if (tok_len == 0 || tok_len > ASC_MAX_TOKEN) {
+				fprintf(fplog,"Failed to read file %s header:  read_asc_grid()\n", fname);
+				free(buf);
+				fclose(fpin);
+				return ERROR_FILE;
+			}
+			memcpy(val, start, tok_len);
+			val[tok_len] = '\0';
+			if (strcmp(key, "ncols") == 0) {
+				hdr_ncols = atoi(val);
+			} else if (strcmp(key, "nrows") == 0) {
+				hdr_nrows = atoi(val);
+			}
+			continue;
+		}
+		
+		// the first value ends the header
+		if (in_header) {
+			in_header = 0;
+			if (hdr_ncols == NOMATCH || hdr_nrows == NOMATCH) {
+				fprintf(fplog,"Failed to read file %s header:  read_asc_grid()\n", fname);
+				free(buf);
+				fclose(fpin);
+				return ERROR_FILE;
+			}
+			if (ncols != NULL) {
+				*ncols = hdr_ncols;
+			}
+			if (nrows != NULL) {
+				*nrows = hdr_nrows;
+			}
+			if ((long) hdr_ncols * hdr_nrows != ncells) {
+				fprintf(fplog,"File %s has %i x %i cells, not %i:  read_asc_grid()\n", fname, hdr_nrows, hdr_ncols, ncells);
+				free(buf);
+				fclose(fpin);
+				return ERROR_FILE;
+			}
+		}
+		
+		if ((pos = asc_parse_float(pos, end, &grid[nvals])) == NULL) {
+			fprintf(fplog,"Failed to read data value %i, file %s:  read_asc_grid()\n", nvals, fname);
+			free(buf);
+			fclose(fpin);
+			return ERROR_FILE;
+		}
+		nvals++;
+	} // end while reading values
+	
+	free(buf);
+	fclose(fpin);
+	
+	if (nvals != ncells) {
+		fprintf(fplog,"Failed to read data value %i, file %s:  read_asc_grid()\n", nvals, fname);
+		return ERROR_FILE;
+	}
+	
+	return OK;
+}
@@ -0,0 +1,180 @@
+/**********
+ read_asc_grid_cached.c
+
+ read the values of one arc ascii grid file into grid[ncells], using a binary cache file beside the ascii file
+ 
+ the cache file is the ascii file name plus ASC_CACHE_TAG, and it contains a header and the values as 4 byte floats
+    the header stores the ascii file size and modification time, the number of cells, and a checksum of the values
+ if the cache file exists and matches the current ascii file size, modification time, and number of cells,
+    and the checksum is correct, the values are copied from the memory-mapped cache file
+ otherwise the ascii file is parsed and a new cache file is written
+    the cache is written to a temporary file and renamed, so a partial cache file is never used
+    failure to write the cache is not an error, because the values have been read
+ so the cache is rebuilt automatically when an ascii file changes, and deleting the cache files is always safe
+
+ the ascii file must exist, and it is read with read_asc_grid()
+
+ arguments:
+ char *fname: the full path name of the arc ascii file
+ float *grid: the array to read the values into
+ int ncells: the number of values to read
+
+ return value:
+	integer error code: OK = 0, otherwise a non-zero error code
+
+ Created 17 Oct 2026
+
+ Moirai Land Data System (Moirai) Copyright (c) 2019, The
+ Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S.
+ Dept. of Energy).  All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Intellectual Property Office at
+ IPO@lbl.gov.
+
+ NOTICE.  This Software was developed under funding from the U.S. Department
+ of Energy and the U.S. Government consequently retains certain rights.  As
+ such, the U.S. Government has been granted for itself and others acting on
+ its behalf a paid-up, nonexclusive, irrevocable, worldwide license in the
+ Software to reproduce, distribute copies to the public, prepare derivative
+ works, and perform publicly and display publicly, and to permit other to do
+ so.
+
+ This file is part of Moirai.
+
+ Moirai is free software: you can use it under the terms of the modified BSD-3 license (see …/moirai/license.txt)
+
+ **********/
+
+// mmap, stat, and the file descriptor functions are posix
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "moirai.h"
+
+#define ASC_CACHE_MAGIC		"MOIRAIAC"	// identifies a moirai ascii grid cache file
+#define ASC_CACHE_VERSION	1			// increment if the cache format changes
+
+// cache file header; the values follow immediately
+typedef struct {
+	char magic[8];				// ASC_CACHE_MAGIC
+	int32_t version;			// ASC_CACHE_VERSION
+	int32_t ncells;				// number of values
+	int64_t src_size;			// size (bytes) of the ascii file
+	int64_t src_mtime;			// modification time (seconds) of the ascii file
+	uint64_t checksum;			// checksum of the values
+} asc_cache_header;
+
+// 64 bit fnv-1a hash of the values, one 4 byte word at a time
+static uint64_t asc_cache_checksum(const float *vals, int nvals) {
+	
+	int i;
+	uint32_t word;
+	uint64_t hash = 14695981039346656037ULL;
+	
+	for (i = 0; i < nvals; i++) {
+		memcpy(&word, &vals[i], sizeof(word));
+		hash ^= word;
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+int read_asc_grid_cached(char *fname, float *grid, int ncells) {
+	
+	int err = OK;					// error code from reading the ascii file
+	int fd;							// cache file descriptor
+	struct stat src_stat;			// ascii file status
+	struct stat cache_stat;			// cache file status
+	asc_cache_header header;		// cache file header
+	const asc_cache_header *map_header;	// the mapped cache header
+	void *map;						// the mapped cache file
+	size_t cache_size;				// expected size of the cache file
+	int cache_ok = 0;				// 1 = values were read from the cache
+	char cname[MAXCHAR];			// cache file name
+	char tname[MAXCHAR];			// temporary cache file name
+	FILE *fpout;					// cache file pointer
+	
+	if (stat(fname, &src_stat) != 0) {
+		fprintf(fplog,"Failed to get status of file %s:  read_asc_grid_cached()\n", fname);
+		return ERROR_FILE;
+	}
+	
+	if (strlen(fname) + strlen(ASC_CACHE_TAG) + 8 > MAXCHAR) {
+		fprintf(fplog,"File name %s is too long for the cache name:  read_asc_grid_cached()\n", fname);
+		return ERROR_FILE;
+	}
+	strcpy(cname, fname);
+	strcat(cname, ASC_CACHE_TAG);
+	cache_size = sizeof(asc_cache_header) + (size_t) ncells * sizeof(float);
+	
+	// try the cache
+	fd = open(cname, O_RDONLY);
+	if (fd >= 0) {
+		if (fstat(fd, &cache_stat) == 0 && (size_t) cache_stat.st_size == cache_size) {
+			map = mmap(NULL, cache_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (map != MAP_FAILED) {
+				map_header = (const asc_cache_header *) map;
+				if (memcmp(map_header->magic, ASC_CACHE_MAGIC, sizeof(map_header->magic)) == 0 &&
+					map_header->version == ASC_CACHE_VERSION && map_header->ncells == ncells &&
+					map_header->src_size == (int64_t) src_stat.st_size &&
+					map_header->src_mtime == (int64_t) src_stat.st_mtime) {
+					memcpy(grid, (const char *) map + sizeof(asc_cache_header), (size_t) ncells * sizeof(float));
+					if (asc_cache_checksum(grid, ncells) == map_header->checksum) {
+						cache_ok = 1;
+					} else {
+						fprintf(fplog,"Warning: checksum mismatch in cache file %s; rereading %s:  read_asc_grid_cached()\n", cname, fname);
+					}
+				}
+				munmap(map, cache_size);
+			}
+		}
+		close(fd);
+	}
+	if (cache_ok) {
+		return OK;
+	}
+	
+	// parse the ascii file
+	if ((err = read_asc_grid(fname, grid, ncells, NULL, NULL)) != OK) {
+		fprintf(fplog,"Failed to read file %s:  read_asc_grid_cached()\n", fname);
+		return err;
+	}
+	
+	// write the cache; the temporary name is unique to this process and file
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, ASC_CACHE_MAGIC, sizeof(header.magic));
+	header.version = ASC_CACHE_VERSION;
+	header.ncells = ncells;
+	header.src_size = (int64_t) src_stat.st_size;
+	header.src_mtime = (int64_t) src_stat.st_mtime;
+	header.checksum = asc_cache_checksum(grid, ncells);
+	if (snprintf(tname, sizeof(tname), "%s.%i", cname, (int) getpid()) >= (int) sizeof(tname)) {
+		fprintf(fplog,"Warning: cache file name %s is too long for the temporary name; cache not written:  read_asc_grid_cached()\n", cname);
+		return OK;
+	}
+	if ((fpout = fopen(tname, "wb")) == NULL) {
+		fprintf(fplog,"Warning: failed to open cache file %s for writing:  read_asc_grid_cached()\n", tname);
+		return OK;
+	}
+	if (fwrite(&header, sizeof(header), 1, fpout) != 1 ||
+		fwrite(grid, sizeof(float), ncells, fpout) != (size_t) ncells) {
+		fprintf(fplog,"Warning: failed to write cache file %s:  read_asc_grid_cached()\n", tname);
+		fclose(fpout);
+		remove(tname);
+		return OK;
+	}
+	if (fclose(fpout) != 0 || rename(tname, cname) != 0) {
+		fprintf(fplog,"Warning: failed to save cache file %s:  read_asc_grid_cached()\n", cname);
+		remove(tname);
+	}
+	
+	return OK;
+}
@@ -71,6 +71,7 @@ int read_country87_info(args_struct in_args) {
 	char rec_str[MAXRECSIZE];		// string to hold one record
 	const char* delim = ",";		// delimiter string for csv file
 	int err = OK;					// error code for the string parsing function
+	fields_struct fields = {0, 0, NULL, NULL};	// the fields of the current record
 	
 	// read in the region land rent info first
 	
@@ -140,21 +141,26 @@ int read_country87_info(args_struct in_args) {
     // now read the records
     for (i = 0; i < NUM_GTAP_CTRY87; i++) {
 		if (fscanf(fpin, "%[^\r\n]\r\n", rec_str) != EOF) {
+			// split the record into its fields once
+			if((err = split_fields(rec_str, delim, &fields)) != OK) {
+				fprintf(fplog, "Error processing file %s: read_country87_info(); field split\n", fname);
+				return err;
+			}
 			
 			// get the ctry87 integer code first
-			if((err = get_int_field(rec_str, delim, 1, &country87codes_gtap[i])) != OK) {
+			if((err = get_int_fld(&fields, 1, &country87codes_gtap[i])) != OK) {
 				fprintf(fplog, "Error processing file %s: read_country87_info(); record=%i, column=1\n",
 						fname, i + 1);
 				return err;
 			}
 			// get the ctry87 abbreviation
-			if((err = get_text_field(rec_str, delim, 2, &country87abbrs_gtap[i][0])) != OK) {
+			if((err = get_text_fld(&fields, 2, &country87abbrs_gtap[i][0])) != OK) {
 				fprintf(fplog, "Error processing file %s: read_country87_info(); record=%i, column=2\n",
 						fname, i + 1);
 				return err;
 			}
 			// get the ctry87 name
-			if((err = get_text_field(rec_str, delim, 3, &country87names_gtap[i][0])) != OK) {
+			if((err = get_text_fld(&fields, 3, &country87names_gtap[i][0])) != OK) {
 				fprintf(fplog, "Error processing file %s: read_country87_info(); record=%i, column=3\n",
 						fname, i + 1);
 				return err;
@@ -216,18 +222,23 @@ int read_country87_info(args_struct in_args) {
 	// read all the records
 	for (i = 0; i < NUM_FAO_CTRY; i++) {
 		if (fscanf(fpin, "%[^\r\n]\r\n", rec_str) != EOF) {
+			// split the record into its fields once
+			if((err = split_fields(rec_str, delim, &fields)) != OK) {
+				fprintf(fplog, "Error processing file %s: read_country87_info(); field split\n", fname);
+				return err;
+			}
 			
 			// do not need to retrieve the fao code, the iso abbr, or the fao name
             // these have already been stored, and the length and order of the columns match
 			
 			// get the matching ctry87 code
-			if((err = get_int_field(rec_str, delim, 4, &ctry2ctry87codes_gtap[i])) != OK) {
+			if((err = get_int_fld(&fields, 4, &ctry2ctry87codes_gtap[i])) != OK) {
 				fprintf(fplog, "Error processing file %s: read_country87_info(); record=%i, column=4\n",
 						fname, i + 1);
 				return err;
 			}
 			// get the matching ctry87 abbr
-			if((err = get_text_field(rec_str, delim, 5, &ctry2ctry87abbrs_gtap[i][0])) != OK) {
+			if((err = get_text_fld(&fields, 5, &ctry2ctry87abbrs_gtap[i][0])) != OK) {
 				fprintf(fplog, "Error processing file %s: read_country87_info(); record=%i, column=5\n",
 						fname, i + 1);
 				return err;
@@ -275,4 +286,5 @@ int read_country87_info(args_struct in_args) {
 		}
 	}	// end if diagnostics
 	
+	free_fields(&fields);
 	return OK;}
@@ -66,6 +66,7 @@ int read_crop_info(args_struct in_args) {
 	char rec_str[MAXRECSIZE];		// string to hold one record
 	const char* delim = ",";		// delimiter string for csv file
 	int err = OK;					// error code for the string parsing function
+	fields_struct fields = {0, 0, NULL, NULL};	// the fields of the current record
 	int out_index = 0;				// the index of the arrays to fill
 	
 	// create file name and open it
@@ -166,44 +167,49 @@ int read_crop_info(args_struct in_args) {
 	// read all the records
 	for (i = 0; i < NUM_SAGE_CROP; i++) {
 		if (fscanf(fpin, "%[^\r\n]\r\n", rec_str) != EOF) {
+			// split the record into its fields once
+			if((err = split_fields(rec_str, delim, &fields)) != OK) {
+				fprintf(fplog, "Error processing file %s: read_crop_info(); field split\n", fname);
+				return err;
+			}
 			// get the SAGE crop integer code
-			if((err = get_int_field(rec_str, delim, 1, &cropcodes_sage[out_index])) != OK) {
+			if((err = get_int_fld(&fields, 1, &cropcodes_sage[out_index])) != OK) {
 				fprintf(fplog, "Error processing file %s: read_crop_info(); record=%i, column=1\n",
 						fname, i + 1);
 				return err;
 			}
 			// get the SAGE file name base
-			if((err = get_text_field(rec_str, delim, 2, &cropfilebase_sage[out_index][0])) != OK) {
+			if((err = get_text_fld(&fields, 2, &cropfilebase_sage[out_index][0])) != OK) {
 				fprintf(fplog, "Error processing file %s: read_crop_info(); record=%i, column=2\n",
 						fname, i + 1);
 				return err;
 			}
 			// get the SAGE crop description
-			if((err = get_text_field(rec_str, delim, 3, &cropdescr_sage[out_index][0])) != OK) {
+			if((err = get_text_fld(&fields, 3, &cropdescr_sage[out_index][0])) != OK) {
 				fprintf(fplog, "Error processing file %s: read_crop_info(); record=%i, column=3\n",
 						fname, i + 1);
 				return err;
 			}
 			// get the GTAP crop name
-			if((err = get_text_field(rec_str, delim, 4, &cropnames_gtap[out_index][0])) != OK) {
+			if((err = get_text_fld(&fields, 4, &cropnames_gtap[out_index][0])) != OK) {
 				fprintf(fplog, "Error processing file %s: read_crop_info(); record=%i, column=4\n",
 						fname, i + 1);
 				return err;
 			}
 			// get the GTAP use code
-			if((err = get_int_field(rec_str, delim, 5, &crop_sage2gtap_use[out_index])) != OK) {
+			if((err = get_int_fld(&fields, 5, &crop_sage2gtap_use[out_index])) != OK) {
 				fprintf(fplog, "Error processing file %s: read_crop_info(); record=%i, column=5\n",
 						fname, i + 1);
 				return err;
 			}
 			// get the FAO crop codes
-			if((err = get_int_field(rec_str, delim, 7, &cropcodes_sage2fao[out_index])) != OK) {
+			if((err = get_int_fld(&fields, 7, &cropcodes_sage2fao[out_index])) != OK) {
 				fprintf(fplog, "Error processing file %s: read_crop_info(); record=%i, column=7\n",
 						fname, i + 1);
 				return err;
 			}
 			// get the FAO crop names
-			if((err = get_text_field(rec_str, delim, 8, &cropnames_sage2fao[out_index++][0])) != OK) {
+			if((err = get_text_fld(&fields, 8, &cropnames_sage2fao[out_index++][0])) != OK) {
 				fprintf(fplog, "Error processing file %s: read_crop_info(); record=%i, column=8\n",
 						fname, i + 1);
 				return err;
@@ -261,4 +267,5 @@ int read_crop_info(args_struct in_args) {
 		}
 	}	// end if diagnostics
 	
+	free_fields(&fields);
 	return OK;}
@@ -12,6 +12,9 @@
  the first 3 files are the total crop, total pasture, and total urban area
  the remaining 9 files are the lu detail
  
+ the grid values are read with read_asc_grid_cached(), which keeps a binary cache file beside each ascii file
+    so the ascii values are parsed only once, unless the ascii file changes
+ 
  arguments:
  args_struct in_args: the input file arguments
  rinfo_struct *raster_info: the raster info structure
@@ -82,7 +85,9 @@ int read_hyde32(args_struct in_args, rinfo_struct *raster_info, int year, float*
 	double ymin;			// latitude min grid boundary
 	double ymax;			// latitude max grid boundary
 	
-	int i, k;
+	int k;
+	int err = OK;					// error code from the grid reads
+	float *out_grid;				// the array to read the current file into
 	int sysrv;						// system return value
 	
 	char fname[MAXCHAR];            // file name to open
@@ -193,57 +198,24 @@ int read_hyde32(args_struct in_args, rinfo_struct *raster_info, int year, float*
 		sprintf(tmp_str, "%i%s", year, atag);
 		strcat(fname, tmp_str);
 		
-		if((fpin = fopen(fname, "r")) == NULL)
-		{
-			fprintf(fplog,"Failed to open file %s:  read_hyde32()\n", fname);
-			return ERROR_FILE;
-		}
-		
-		// skip the header
-		if(fscanf(fpin,"%*[^\r\n]\r\n%*[^\r\n]\r\n%*[^\r\n]\r\n%*[^\r\n]\r\n%*[^\r\n]\r\n%*[^\r\n]\r\n") == EOF)
-		{
-			fprintf(stderr,"Failed to read file %s header:  read_hyde32()\n", fname);
-			return ERROR_FILE;
-		}
-		
 		// if crop, pasture, or urban totals, put into explicit arrays
 		// otherwise put into lu_detail_area
+		if (k == 0) {
+			out_grid = urban_grid;
+		} else if (k == 1) {
+			out_grid = crop_grid;
+		} else if (k == 2) {
+			out_grid = pasture_grid;
+		} else {
+			out_grid = lu_detail_area[k - NUM_HYDE_TYPES_MAIN];
+		}
 		
-		// loop over all values in file
-		for(i = 0; i < ncells; i++)
+		// read all values in the file, from the binary cache if it is current
+		if((err = read_asc_grid_cached(fname, out_grid, ncells)) != OK)
 		{
-			if (k == 0) {
-				// read single value
-				if(fscanf(fpin, "%f", &urban_grid[i]) == EOF)
-				{
-					fprintf(stderr,"Failed to read data value %i, file %s:  read_hyde32()\n", i, fname);
-					return ERROR_FILE;
-				}
-			} else if (k == 1) {
-				// read single value
-				if(fscanf(fpin, "%f", &crop_grid[i]) == EOF)
-				{
-					fprintf(stderr,"Failed to read data value %i, file %s:  read_hyde32()\n", i, fname);
-					return ERROR_FILE;
-				}
-			} else if (k == 2) {
-				// read single value
-				if(fscanf(fpin, "%f", &pasture_grid[i]) == EOF)
-				{
-					fprintf(stderr,"Failed to read data value %i, file %s:  read_hyde32()\n", i, fname);
-					return ERROR_FILE;
-				}
-			} else {
-				// read single value
-				if(fscanf(fpin, "%f", &lu_detail_area[k - NUM_HYDE_TYPES_MAIN][i]) == EOF)
-				{
-					fprintf(stderr,"Failed to read data value %i, file %s:  read_hyde32()\n", i, fname);
-					return ERROR_FILE;
-				}
-			}
-		} // end i loop over ncells
-		
-		fclose(fpin);
+			fprintf(fplog,"Failed to read file %s:  read_hyde32()\n", fname);
+			return err;
+		}
 	} // end k loop over hyde files
 	
 	return OK;}
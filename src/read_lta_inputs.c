@@ -0,0 +1,79 @@
+/**********
+ read_lta_inputs.c
+ 
+ read the inputs of one hyde year for proc_land_type_area_year() into a scratch space
+    the hyde land use areas go into the crop, pasture, urban, and detail grids
+    the lulc land cover areas go into the lulc grid
+ 
+ this is the input stage of the year processing, so that proc_land_type_area() can read the next year
+    into a free scratch space while the current years are being processed
+ the lulc netcdf reads are serialized across threads
+ 
+ arguments:
+ args_struct in_args: the input file arguments
+ rinfo_struct raster_info: information about input raster data; the hyde info is updated in this copy
+ int year_ind: the index of the year to read in hyde_years
+ int *hyde_years: the hyde years
+ lta_scratch_struct *scratch: the scratch space to read into, from alloc_lta_scratch()
+ 
+ return value:
+	integer error code: OK = 0, otherwise a non-zero error code
+ 
+ Created 17 Oct 2026
+ 
+ Moirai Land Data System (Moirai) Copyright (c) 2019, The
+ Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S.
+ Dept. of Energy).  All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Intellectual Property Office at
+ IPO@lbl.gov.
+
+ NOTICE.  This Software was developed under funding from the U.S. Department
+ of Energy and the U.S. Government consequently retains certain rights.  As
+ such, the U.S. Government has been granted for itself and others acting on
+ its behalf a paid-up, nonexclusive, irrevocable, worldwide license in the
+ Software to reproduce, distribute copies to the public, prepare derivative
+ works, and perform publicly and display publicly, and to permit other to do
+ so.
+
+ This file is part of Moirai.
+
+ Moirai is free software: you can use it under the terms of the modified BSD-3 license (see …/moirai/license.txt)
+
+ **********/
+
+
+#include "moirai.h"
+
+int read_lta_inputs(args_struct in_args, rinfo_struct raster_info, int year_ind, int *hyde_years, lta_scratch_struct *scratch) {
+	
+	int err = OK;				// store error code from the read functions
+	int lulc_year;				// current lulc year to read
+	
+	// first read in the appropriate hyde land use area data
+	if((err = read_hyde32(in_args, &raster_info, hyde_years[year_ind], scratch->crop_grid, scratch->pasture_grid,
+						  scratch->urban_grid, scratch->lu_detail_grid)) != OK)
+	{
+		fprintf(fplog, "Failed to read lu hyde data for year %i: read_lta_inputs()\n", hyde_years[year_ind]);
+		return err;
+	}
+	
+	// read the appropriate lulc data
+	if (hyde_years[year_ind] < LULC_START_YEAR) {
+		lulc_year = LULC_START_YEAR;
+	} else {
+		lulc_year = hyde_years[year_ind];
+	}
+	// the netcdf library is not thread safe, so only one thread reads lulc data at a time
+#pragma omp critical (netcdf_read)
+	err = read_lulc_isam(in_args, lulc_year, scratch->lulc_temp_grid);
+	if(err != OK)
+	{
+		fprintf(fplog, "Failed to read lulc data for year %i: read_lta_inputs()\n", lulc_year);
+		return err;
+	}
+	
+	return OK;
+}
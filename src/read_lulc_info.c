@@ -98,6 +98,7 @@ int read_lulc_info(args_struct in_args) {
 	char rec_str[MAXRECSIZE];		// string to hold one record
 	const char* delim = ",";		// delimiter string for csv file
 	int err = OK;					// error code for the string parsing function
+	fields_struct fields = {0, 0, NULL, NULL};	// the fields of the current record
 	int out_index = 0;				// the index of the arrays to fill
 	int num_lulc_lctypes = 23;		// the number of lulc land cover categories
 	
@@ -161,14 +162,19 @@ int read_lulc_info(args_struct in_args) {
 	out_index = 0;
 	for (i = 0; i < NUM_SAGE_PVLT; i++) {
 		if (fscanf(fpin, "%[^\r\n]\r\n", rec_str) != EOF) {
+            // split the record into its fields once
+            if((err = split_fields(rec_str, delim, &fields)) != OK) {
+                fprintf(fplog, "Error processing file %s: read_lulc_info(); field split\n", fname);
+                return err;
+            }
             // get the integer code
-            if((err = get_int_field(rec_str, delim, 1, &landtypecodes_sage[out_index])) != OK) {
+            if((err = get_int_fld(&fields, 1, &landtypecodes_sage[out_index])) != OK) {
                 fprintf(fplog, "Error processing file %s: read_lulc_info(); record=%i, column=1\n",
                         fname, i + 1);
                 return err;
             }
 			// get the name
-			if((err = get_text_field(rec_str, delim, 2, &landtypenames_sage[out_index++][0])) != OK) {
+			if((err = get_text_fld(&fields, 2, &landtypenames_sage[out_index++][0])) != OK) {
 				fprintf(fplog, "Error processing file %s: read_lulc_info(); record=%i, column=2\n",
 						fname, i + 1);
 				return err;
@@ -248,14 +254,19 @@ int read_lulc_info(args_struct in_args) {
 	out_index = 0;
 	for (i = 0; i < NUM_HYDE_TYPES; i++) {
 		if (fscanf(fpin, "%[^\r\n]\r\n", rec_str) != EOF) {
+			// split the record into its fields once
+			if((err = split_fields(rec_str, delim, &fields)) != OK) {
+				fprintf(fplog, "Error processing file %s: read_lulc_info(); field split\n", fname);
+				return err;
+			}
 			// get the integer code
-			if((err = get_int_field(rec_str, delim, 1, &lutypecodes_hyde[out_index])) != OK) {
+			if((err = get_int_fld(&fields, 1, &lutypecodes_hyde[out_index])) != OK) {
 				fprintf(fplog, "Error processing file %s: read_lulc_info(); record=%i, column=1\n",
 						fname, i + 1);
 				return err;
 			}
 			// get the name
-			if((err = get_text_field(rec_str, delim, 2, &lutypenames_hyde[out_index++][0])) != OK) {
+			if((err = get_text_fld(&fields, 2, &lutypenames_hyde[out_index++][0])) != OK) {
 				fprintf(fplog, "Error processing file %s: read_lulc_info(); record=%i, column=2\n",
 						fname, i + 1);
 				return err;
@@ -347,21 +358,26 @@ int read_lulc_info(args_struct in_args) {
 	out_index = 0;
 	for (i = 0; i < NUM_LULC_TYPES; i++) {
 		if (fscanf(fpin, "%[^\r\n]\r\n", rec_str) != EOF) {
+			// split the record into its fields once
+			if((err = split_fields(rec_str, delim, &fields)) != OK) {
+				fprintf(fplog, "Error processing file %s: read_lulc_info(); field split\n", fname);
+				return err;
+			}
 			// get the lulc integer code
-			if((err = get_int_field(rec_str, delim, 1, &lulccodes[out_index])) != OK) {
+			if((err = get_int_fld(&fields, 1, &lulccodes[out_index])) != OK) {
 				fprintf(fplog, "Error processing file %s: read_lulc_info(); record=%i, column=1\n",
 						fname, i + 1);
 				return err;
 			}
 			// get the lulc name
-			if((err = get_text_field(rec_str, delim, 2, &lulcnames[out_index][0])) != OK) {
+			if((err = get_text_fld(&fields, 2, &lulcnames[out_index][0])) != OK) {
 				fprintf(fplog, "Error processing file %s: read_lulc_info(); record=%i, column=2\n",
 						fname, i + 1);
 				return err;
 			}
 			if (i < num_lulc_lctypes) {
 				// get the sage integer code for mapping
-				if((err = get_int_field(rec_str, delim, 3, &lulc2sagecodes[out_index])) != OK) {
+				if((err = get_int_fld(&fields, 3, &lulc2sagecodes[out_index])) != OK) {
 					fprintf(fplog, "Error processing file %s: read_lulc_info(); record=%i, column=1\n",
 							fname, i + 1);
 					return err;
@@ -369,7 +385,7 @@ int read_lulc_info(args_struct in_args) {
 				lulc2hydecodes[out_index++] = NOMATCH;
 			} else {
 				// get the hyde integer code for mapping
-				if((err = get_int_field(rec_str, delim, 3, &lulc2hydecodes[out_index])) != OK) {
+				if((err = get_int_fld(&fields, 3, &lulc2hydecodes[out_index])) != OK) {
 					fprintf(fplog, "Error processing file %s: read_lulc_info(); record=%i, column=1\n",
 							fname, i + 1);
 					return err;
@@ -408,4 +424,5 @@ int read_lulc_info(args_struct in_args) {
 		}
 	}	// end if diagnostics
 	
+	free_fields(&fields);
 	return OK;}
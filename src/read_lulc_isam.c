@@ -3,7 +3,7 @@
  
  read one ISAM LULC netcdf file
 	the files are gzipped orignially
-	this function will unzip them if necessary and then leave them unzipped (and keep the zipped file)
+	open_lulc_isam() opens the unzipped file if it exists, otherwise it decompresses the gzipped file in memory
     these are half-degree files (for now)
     origin is: lower left corner at -90 lat and 0 lon
 
@@ -12,6 +12,11 @@
  	starting with upper left corner, lon varying fastest (like other rasters)
  	so the input data has to be shifted
  
+ all lc types are read with one hyperslab read into lulc_frac_buf[], and the cell area into lulc_area_buf[]
+ 	these buffers are allocated at the first call and kept for the next years; they are freed in main()
+ 	so the lulc netcdf reads must be serialized, as they are in read_lta_inputs()
+ the unit conversion and the shift are done in one pass over the contiguous runs of lulc_in2grid[]
+ 
  the file has 3 attribute variables and one additional dimension index:
 	longitude (360), latitude (720), lc_type (34, enumerated, no actual attribute variable), time (1)
  the 34 lc_types are merely an index in the LC_fraction variable
@@ -62,7 +67,7 @@
 
 int read_lulc_isam(args_struct in_args, int year, float **lulc_input_grid) {
     
-    int i, j;
+    int j, k;
     int nrows = NUM_LAT_LULC;				// num input lats
     int ncols = NUM_LON_LULC;				// num input lons
     int ncells = nrows * ncols;		// number of input grid cells
@@ -74,138 +79,93 @@ int read_lulc_isam(args_struct in_args, int year, float **lulc_input_grid) {
     //double ymax = 90.0;			// latitude max grid boundary
 	float frac_scalar = 0.0001;		// scalar to convert the input value to an actual fraction
     
-    char lname[MAXCHAR];			// file name to open
-	char tmp_str[MAXCHAR];			// temporary string
-    FILE *fpin;						// file pointer
-    int sysrv;						// system return value
+    int err = OK;					// store error code from the file open
     int ncid;						// netcdf file id
     int ncvarid;					// variable id returned by nc_inq_varid()
     int ncerr;						// error return value; 0 = ok
     const char lcfrac_name[] = "LC_fraction";         // the lc frac variable to read
     const char cell_area_name[] = "Grid_area";        // the grid cell area variable to read
-    size_t start_lcfrac[] = {0, 0, 0};              // start indices for lc fraction - the first value will change for each lc type
+    size_t start_lcfrac[] = {0, 0, 0};              // start indices for lc fraction
+    size_t count_lcfrac[] = {0, NUM_LAT_LULC, NUM_LON_LULC};   // lengths for reading lc fraction; all lc types are read at once
     static size_t start_grid[] = {0, 0};            // start indices for other data variables
-    static size_t count_lcfrac[] = {1, 360, 720};   // lengths for reading lc fraction
-    static size_t count_grid[] = {360, 720};        // lengths for reading other data variables
-	
-	int grid_y;				// row for ul corner working grid cell in input cell
-	int grid_x;				// col for ul corner working grid cell in input cell
-	int grid_index;					// index of working grid cell to set
-	double rem_dbl;				// used to get the remainder of a decimal number
-	double int_dbl;				// used to get the integer of a decimal number
-	
-	float *lulc_cell_area;			// needed to get the area
-	float **temp_grid;				// needed for reading in so can shift the data
+    static size_t count_grid[] = {NUM_LAT_LULC, NUM_LON_LULC};        // lengths for reading other data variables
 	
-    // some input data file name prefixes and suffixes
-    const char basename[] = "ISAM_HYDE32_LANDCOVER_";		// base file name
-    const char nctag[] = ".nc";					// suffix for file names, netcdf, unzipped
-    const char ncgztag[] = ".nc.gz";			// suffix for file names, netcdf, gzipped
+	int run_start;					// the first input cell of a run of consecutive lulc grid cells
+	int run_len;					// the number of cells in the run
+	int grid_index;					// the lulc grid cell of the first cell in the run
+	float *frac_in;					// the input fractions of the run for the current type
+	float *area_in;					// the input cell areas of the run
+	float *grid_out;				// the output areas of the run for the current type
 	
-	// allcate array for the grid cell area
-	lulc_cell_area = calloc(ncells, sizeof(float));
-	if(lulc_cell_area == NULL) {
-		fprintf(fplog,"Failed to allocate memory for lulc_cell_area: read_lulc_isam()\n");
-		return ERROR_MEM;
-	}
-	
-	// allocate temp array for the data
-	temp_grid = calloc(NUM_LULC_TYPES, sizeof(float*));
-	if(temp_grid == NULL) {
-		fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for temp_grid: main()\n", get_systime(), ERROR_MEM);
-		return ERROR_MEM;
+	// allocate the read buffers the first time
+	if (lulc_frac_buf == NULL) {
+		lulc_frac_buf = calloc((size_t) NUM_LULC_TYPES * NUM_CELLS_LULC, sizeof(float));
+		if(lulc_frac_buf == NULL) {
+			fprintf(fplog,"Failed to allocate memory for lulc_frac_buf: read_lulc_isam()\n");
+			return ERROR_MEM;
+		}
 	}
-	for (i = 0; i < NUM_LULC_TYPES; i++) {
-		temp_grid[i] = calloc(NUM_CELLS_LULC, sizeof(float));
-		if(temp_grid[i] == NULL) {
-			fprintf(fplog,"\nProgram terminated at %s with error_code = %i\nFailed to allocate memory for temp_grid[%i]: main()\n", get_systime(), ERROR_MEM, i);
+	if (lulc_area_buf == NULL) {
+		lulc_area_buf = calloc(NUM_CELLS_LULC, sizeof(float));
+		if(lulc_area_buf == NULL) {
+			fprintf(fplog,"Failed to allocate memory for lulc_area_buf: read_lulc_isam()\n");
 			return ERROR_MEM;
 		}
 	}
 	
-    // finish file name and try to open it; if it fails, then it has not been unzipped
-    strcpy(lname, in_args.lulcpath);
-    strcat(lname, basename);
-	sprintf(tmp_str, "%i%s", year, nctag);
-    strcat(lname, tmp_str);
-    if((fpin = fopen(lname, "rb")) == NULL)
-    {
-        // gunzip this file
-        strcpy(lname, "gunzip -k ");
-        strcat(lname, in_args.lulcpath);
-        strcat(lname, basename);
-		sprintf(tmp_str, "%i%s", year, ncgztag);
-        strcat(lname, tmp_str);
-        sysrv = system(lname);
-    } else {
-        fclose(fpin);
-    }
-    
-    // now make the unzipped file name again
-    strcpy(lname, in_args.lulcpath);
-    strcat(lname, basename);
-	sprintf(tmp_str, "%i%s", year, nctag);
-    strcat(lname, tmp_str);
-    
-    if ((ncerr = nc_open(lname, NC_NOWRITE, &ncid))) {
-        fprintf(fplog,"Failed to open %s for reading: read_lulc_isam(); ncerr = %i\n", lname, ncerr);
-        return ERROR_FILE;
-    }
+	if ((err = open_lulc_isam(in_args, year, &ncid)) != OK) {
+		fprintf(fplog,"Failed to open lulc file for year %i: read_lulc_isam()\n", year);
+		return err;
+	}
     
     // get the grid cell area
 	if ((ncerr = nc_inq_varid(ncid, cell_area_name, &ncvarid))) {
 		fprintf(fplog,"Error %i when getting netcdf var id for %s: read_lulc_isam()\n", ncerr, cell_area_name);
+		nc_close(ncid);
 		return ERROR_FILE;
 	}
-	if ((ncerr = nc_get_vara_float(ncid, ncvarid, start_grid, count_grid, lulc_cell_area))) {
+	if ((ncerr = nc_get_vara_float(ncid, ncvarid, start_grid, count_grid, lulc_area_buf))) {
 		fprintf(fplog,"Error %i when reading netcdf var %s: read_lulc_isam()\n", ncerr, cell_area_name);
+		nc_close(ncid);
 		return ERROR_FILE;
 	}
 	
-    // loop over the land cover types to read them in
+    // read all the land cover types at once; the types are the slowest varying dimension
 	if ((ncerr = nc_inq_varid(ncid, lcfrac_name, &ncvarid))) {
 		fprintf(fplog,"Error %i when getting netcdf var id for %s: read_lulc_isam()\n", ncerr, lcfrac_name);
+		nc_close(ncid);
 		return ERROR_FILE;
 	}
-	for (i = 0; i < NUM_LULC_TYPES; i++) {
-		start_lcfrac[0] = i;
-		if ((ncerr = nc_get_vara_float(ncid, ncvarid, start_lcfrac, count_lcfrac, &temp_grid[i][0]))) {
-			fprintf(fplog,"Error %i when reading netcdf var %s: read_lulc_isam()\n", ncerr, lcfrac_name);
-			return ERROR_FILE;
-		}
-	} // end for i loop over the lulc types
+	count_lcfrac[0] = NUM_LULC_TYPES;
+	if ((ncerr = nc_get_vara_float(ncid, ncvarid, start_lcfrac, count_lcfrac, lulc_frac_buf))) {
+		fprintf(fplog,"Error %i when reading netcdf var %s: read_lulc_isam()\n", ncerr, lcfrac_name);
+		nc_close(ncid);
+		return ERROR_FILE;
+	}
+	
+    nc_close(ncid);
 	
-    // loop over all the data to convert the values to working units and shift the data to start at upper left
+    // convert the values to working units and shift the data to start at upper left
     // do the land type aggregation and the grid disaggregation in a different function
 	//	because eventually they may not be necessary
-    for (i = 0; i < ncells; i++) {
+    // the input cell to lulc grid cell index is in lulc_in2grid[], from get_lulc_topology()
+	// the input cells map to runs of consecutive lulc grid cells (half an input row each),
+	//	so each run is converted with contiguous loads and stores
+    for (run_start = 0; run_start < ncells; run_start = run_start + run_len) {
+		grid_index = lulc_in2grid[run_start];
+		run_len = 1;
+		while (run_start + run_len < ncells && lulc_in2grid[run_start + run_len] == grid_index + run_len) {
+			run_len++;
+		}
+		area_in = &lulc_area_buf[run_start];
 		// loop over the land types
 		for (j = 0; j < NUM_LULC_TYPES; j++) {
-			
-			rem_dbl = fmod((double) i, (double) ncols);
-			modf((double) (i / ncols), &int_dbl);
-			grid_y = NUM_LAT_LULC - (int) int_dbl - 1;
-			if (rem_dbl < ncols / 2) {
-				grid_x = (int) rem_dbl + NUM_LON_LULC / 2;
-			} else {
-				grid_x = ((int) rem_dbl - ncols / 2);
-			}
-			grid_index = grid_y * NUM_LON_LULC + grid_x;
-			if (lulc_cell_area[i] > 0) {
-				lulc_input_grid[j][grid_index] = temp_grid[j][i] * frac_scalar * MSQ2KMSQ * lulc_cell_area[i];
-			} else {
-				lulc_input_grid[j][grid_index] = 0;
+			frac_in = &lulc_frac_buf[(size_t) j * ncells + run_start];
+			grid_out = &lulc_input_grid[j][grid_index];
+			for (k = 0; k < run_len; k++) {
+				grid_out[k] = (area_in[k] > 0) ? frac_in[k] * frac_scalar * MSQ2KMSQ * area_in[k] : 0;
 			}
 		} // end j loop over the land types
-    }	// end for i loop over all grid cells
-    
-    nc_close(ncid);
-	
-	free(lulc_cell_area);
-	
-	for (i = 0; i < NUM_LULC_TYPES; i++) {
-		free(temp_grid[i]);
-	}
-	free(temp_grid);
+    }	// end for run_start loop over the runs of input grid cells
 	
     return OK;}
@@ -3,7 +3,7 @@
  
  read one ISAM LULC netcdf file to get the land mask
 	the files are gzipped orignially
-	this function will unzip them if necessary and then leave them unzipped
+	open_lulc_isam() opens the unzipped file if it exists, otherwise it decompresses the gzipped file in memory
  these are half-degree files (for now)
  origin is: lower left corner at -90 lat and 0 lon
  
@@ -60,7 +60,7 @@
 
 int read_lulc_land(args_struct in_args, int year, rinfo_struct *raster_info, int *land_mask_lulc) {
 	
-	int i, m, n;
+	int i, n;
 	int nrows = 360;				// num input lats
 	int ncols = 720;				// num input lons
 	int ncells = nrows * ncols;		// number of input grid cells
@@ -71,10 +71,6 @@ int read_lulc_land(args_struct in_args, int year, rinfo_struct *raster_info, int
 	double ymin = -90.0;			// input latitude min grid boundary
 	double ymax = 90.0;				// input latitude max grid boundary
 	
-	char lname[MAXCHAR];			// file name to open
-	char tmp_str[MAXCHAR];			// temporary string
-	FILE *fpin;						// file pointer
-	int sysrv;						// system return value
 	int ncid;						// netcdf file id
 	int ncvarid;					// variable id returned by nc_inq_varid()
 	int ncerr;						// error return value; 0 = ok
@@ -82,20 +78,10 @@ int read_lulc_land(args_struct in_args, int year, rinfo_struct *raster_info, int
 	static size_t start_grid[] = {0, 0};            // start indices for other data variables
 	static size_t count_grid[] = {360, 720};        // lengths for reading other data variables
 	
-	int num_split;					// the number of cells to disaggregate to in 1 dimension
-	int grid_y_ul;				// row for ul corner working grid cell in input cell
-	int grid_x_ul;				// col for ul corner working grid cell in input cell
-	int ind_1d;					// index of working grid cell to set
-	double rem_dbl;				// used to get the remainder of a decimal number
-	double int_dbl;				// used to get the integer of a decimal number
+	int *lu_cells;				// the working grid cells within the current input cell
 	int *lulc_input_mask;			// read into here
 	
-	// some input data file name prefixes and suffixes
-	const char basename[] = "ISAM_HYDE32_LANDCOVER_";		// base file name
-	const char nctag[] = ".nc";					// suffix for file names, netcdf, unzipped
-	const char ncgztag[] = ".nc.gz";			// suffix for file names, netcdf, gzipped
-	
-	int err = OK;								// store error code from the write file
+	int err = OK;								// store error code from the file open and the write file
 	char out_name[] = "land_mask_lulc.bil";		// diagnositic output raster file name
 	
 	// store file specific info
@@ -116,33 +102,9 @@ int read_lulc_land(args_struct in_args, int year, rinfo_struct *raster_info, int
 		return ERROR_MEM;
 	}
 	
-	// finish file name and try to open it; if it fails, then it has not been unzipped
-	strcpy(lname, in_args.lulcpath);
-	strcat(lname, basename);
-	sprintf(tmp_str, "%i%s", year, nctag);
-	strcat(lname, tmp_str);
-	if((fpin = fopen(lname, "rb")) == NULL)
-	{
-		// gunzip this file
-		strcpy(lname, "gunzip -k ");
-		strcat(lname, in_args.lulcpath);
-		strcat(lname, basename);
-		sprintf(tmp_str, "%i%s", year, ncgztag);
-		strcat(lname, tmp_str);
-		sysrv = system(lname);
-	} else {
-		fclose(fpin);
-	}
-	
-	// now make the unzipped file name again
-	strcpy(lname, in_args.lulcpath);
-	strcat(lname, basename);
-	sprintf(tmp_str, "%i%s", year, nctag);
-	strcat(lname, tmp_str);
-	
-	if ((ncerr = nc_open(lname, NC_NOWRITE, &ncid))) {
-		fprintf(fplog,"Failed to open %s for reading: read_lulc_land(); ncerr = %i\n", lname, ncerr);
-		return ERROR_FILE;
+	if ((err = open_lulc_isam(in_args, year, &ncid)) != OK) {
+		fprintf(fplog,"Failed to open lulc file for year %i: read_lulc_land()\n", year);
+		return err;
 	}
 	
 	// get the land mask
@@ -157,26 +119,14 @@ int read_lulc_land(args_struct in_args, int year, rinfo_struct *raster_info, int
 	nc_close(ncid);
 	
 	// loop over all the data to convert the values to working grid
-	num_split = NUM_LON / ncols;
+	// the input cell to lulc grid cell index and the working grid cells within each lulc grid cell are from get_lulc_topology()
 	for (i = 0; i < ncells; i++) {
-		rem_dbl = fmod((double) i, (double) ncols);
-		modf((double) (i / ncols), &int_dbl);
-		grid_y_ul = NUM_LAT - (int) int_dbl * (num_split) - num_split;
-		if (rem_dbl < ncols / 2) {
-			grid_x_ul = (int) rem_dbl * (num_split) + NUM_LON / 2;
-		} else {
-			grid_x_ul = ((int) rem_dbl - ncols / 2) * (num_split);
-		}
+		lu_cells = &lulc_child_cells[lulc_in2grid[i] * NUM_LU_CELLS];
 		
 		// now loop over the working grid cells to set the land mask
-		for (m = grid_y_ul; m < grid_y_ul + num_split; m++) {
-			// first calc the 1-d index of the first pixel in this row
-			ind_1d = m * NUM_LON + grid_x_ul;
-			for (n = ind_1d; n < ind_1d + num_split; n++) {
-				land_mask_lulc[n] = lulc_input_mask[i];
-			} // end for n loop over the cells to set
-		} // end for m loop over the rows to set
-		
+		for (n = 0; n < NUM_LU_CELLS; n++) {
+			land_mask_lulc[lu_cells[n]] = lulc_input_mask[i];
+		} // end for n loop over the cells to set
 	}	// end for i loop over all input grid cells
 	
 	free(lulc_input_mask);
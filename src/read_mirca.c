@@ -17,6 +17,8 @@
  
  also store hectares - no unit conversion
  
+ the file is read with read_asc_grid()
+ 
  arguments:
   char* fname:          file name to open, with path
   float* mirca_grid:    the array to load the data into
@@ -60,31 +62,15 @@ int read_mirca(char *fname, float *mirca_grid) {
     // 5 arcmin resolution, extent = (-180,180, -90, 90), ?WGS84?
     // read in double values
     
-    int i;
     int nrows = 0;			// num input lats = 2160
     int ncols = 0;			// num input lons = 4320
-    int ncells = 0;         // number of input grid cells = nrows*ncols
-    int nodata = 0;			// nodata value = -9
-    double res = 0;         // resolution = 5.0 / 60.0 = 0.083333333333333
-    double xmin = 0;		// longitude min grid boundary = xllcorner = -180
-    //double xmax = 180.0;	// longitude max grid boundary
-    double ymin = 0;		// latitude min grid boundary = yllcorner = -90
-    //double ymax = 90.0;		// latitude max grid boundary
-    
-    FILE *fpin;						// file pointer
-    float value;						// each value read in
+    int err = OK;           // error code from reading the grid
     
-    if((fpin = fopen(fname, "r")) == NULL)
+    // read the header and the data
+    if ((err = read_asc_grid(fname, mirca_grid, NUM_CELLS, &ncols, &nrows)) != OK)
     {
-        fprintf(fplog,"Failed to open file %s:  read_mirca()\r\n", fname);
-        return ERROR_FILE;
-    }
-    
-    // read the header lines
-    if(fscanf(fpin,"%*s%i%*s%i%*s%lf%*s%lf%*s%lf%*s%i%*[^\r\n]\r\n", &ncols, &nrows, &xmin, &ymin, &res, &nodata) == EOF)
-    {
-        fprintf(fplog, "Failed to read file %s header:  read_mirca()\n", fname);
-        return ERROR_FILE;
+        fprintf(fplog, "Failed to read file %s:  read_mirca()\n", fname);
+        return err;
     }
     
     // check the res
@@ -93,26 +79,6 @@ int read_mirca(char *fname, float *mirca_grid) {
         return ERROR_FILE;
     }
     
-    //fprintf(fplog,"Start reading mirca at %s :  read_mirca()\n", get_systime());
-    
-    // read the data
-    ncells = nrows * ncols;
-    for (i = 0; i < ncells; i++) {
-        if (fscanf(fpin, "%f", &value) != EOF) {
-            // no need to convert units
-            mirca_grid[i] = value;
-        } else {
-            if (i == ncells) {
-                //fprintf(fplog,"Finished reading mirca at %s:  read_mirca()\n", get_systime());
-            } else {
-                fprintf(fplog, "Failed to read mirca at %s:  read_mirca()\n", get_systime());
-                return ERROR_FILE;
-            }	// end if all data read in else error
-            
-        }	// end if read and set value else check for end of file or error
-        
-    }	// end for i loop to read the data
-    
-    fclose(fpin);
+    // no need to convert units
     
     return OK;}
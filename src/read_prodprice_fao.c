@@ -13,7 +13,8 @@
  calculate production weighted average annual price for the appropriate data years
 	the stored average will be for the GTAP 87 countries, rather than the FAO countries
  
- the price data file must be the same format and contain the same years as the production, yield, and harvest area data files
+ the price data file must be the same format as the production, yield, and harvest area data files
+ the years are read from the header, and must be contiguous and in order; they must include the averaging years
  year value fields must be empty or numeric
  
  only the 175 SAGE crops are stored
@@ -81,11 +82,10 @@ int read_prodprice_fao(args_struct in_args) {
 	char fname[MAXCHAR];			// file name to open
 	FILE *fpin;						// file pointer
 	char rec_str[MAXRECSIZE];		// string to hold one record
-	char temp_str[MAXRECSIZE];		// string to test for blank line
 	const char* delim = ",";		// delimiter string for csv file
 	int err = OK;					// error code for the string parsing function
 	int out_index = -1;				// the index of the price array to fill
-	int prod_index = -1;			// the index of the production array to read
+	float prod_val;					// the production of the current country, crop, and year
 	int ctry_ind = -1;				// the FAO country index with respect to countrycodes_fao[]
 	int crop_ind = -1;				// the SAGE crop index with respect to int cropcodes_sage2fao[] and cropcodes_sage[]
 	int temp_ctry = NODATA;			// temporary country code
@@ -100,13 +100,15 @@ int read_prodprice_fao(args_struct in_args) {
 	int num_avg;					// number of years to average
 	int avg_cols[100];				// the columns to average
 	int start_recalib_year = 0;			// the first year of recalibration average
-	int fao_start_year_index = NOMATCH;		// the fao year index of the starting year for averaging
+	int avg_start_year;				// the first year of the average
+	int price_start_year;			// the first year in the price file
+	int price_num_yrs;				// the number of years in the price file
 	
 	long flen = 0;					// length of file in bytes
 	long count_lines = 0;			// count the number of lines to skip the header
 	long count_recs = 0;			// count the number of records read
-	long rec_index = -1;			// the index of the record string to fill
-	int is_newrec = 0;				// flag to denote end of record
+	char *rec_ptr;					// the current record, terminated in place in the file buffer
+	fields_struct fields = {0, 0, NULL, NULL};	// the fields of the current record
 	char *sptr;						// dynamically allocated buffer for whole file as a string
 	char *cptr;						// pointer to traverse the file string
 	
@@ -116,6 +118,7 @@ int read_prodprice_fao(args_struct in_args) {
 	int cpi_year[100];				// list of usd cpi years
 	float cpi_val[100];				// list of cpi values
 	int cpi_index = 0;				// the index for storing values
+	int cpi_avg_ind[100];			// the cpi index of each averaging year; NOMATCH if not in the cpi list
 	float cpi_out_val = 0;			// the cpi value for the output year
 	float cpi_in_val = 0;			// the cpi value for the intput year
 	
@@ -146,48 +149,17 @@ int read_prodprice_fao(args_struct in_args) {
 	}
 	
 	// deal with output crop data year here
+	// the price columns of the averaging years are found from the price file header
 	if (in_args.out_year_prod_ha_lr != 0) {
-		// data have been recalibrated
-		// get the appropriate columns for prod price
+		// data have been recalibrated, so average the recalib years
 		num_avg = RECALIB_AVG_PERIOD;
 		temp_flt = (float) modf(RECALIB_AVG_PERIOD / 2, &temp_dbl);
 		start_recalib_year = in_args.out_year_prod_ha_lr - (int) temp_dbl;
-		// columns for averaging recalib years
-		for (i = 0; i < RECALIB_AVG_PERIOD; i++) {
-			// match the fao data year col to the recalib data years
-			// and get the fao year index for the first averaging year
-			for (j = 0; j < NUM_FAO_YRS; j++) {
-				if ((FAO_START_YEAR + j) == (start_recalib_year + i)) {
-					avg_cols[i] = FAO_START_YEAR_COL + (j * 2);
-					if (i == 0) {
-						fao_start_year_index = j;
-					}
-				}
-			} // end for j loop over fao years
-		} // end for i loop over average period
-		if (fao_start_year_index == NOMATCH) {
-			fprintf(fplog,"Recalibrate: Failed to find start FAO data for year %i:  read_prodprice_fao()\n", start_recalib_year);
-			return ERROR_IND;
-		}
+		avg_start_year = start_recalib_year;
 	} else {
+		// average the years matching sage 175 input data
 		num_avg = SAGE_AVG_PERIOD;
-		// columns for averaging years matching sage 175 input data
-		for (i = 0; i < SAGE_AVG_PERIOD; i++) {
-			// match the fao data year col to the sage data years
-			// and get the fao year index for the first averaging year
-			for (j = 0; j < NUM_FAO_YRS; j++) {
-				if ((FAO_START_YEAR + j) == (SAGE_START_YEAR + i)) {
-					avg_cols[i] = FAO_START_YEAR_COL + (j * 2);
-					if (i == 0) {
-						fao_start_year_index = j;
-					}
-				}
-			} // end for j loop over fao years
-		} // end for i loop over average period
-		if (fao_start_year_index == NOMATCH) {
-			fprintf(fplog,"Recalibrate: Failed to find start FAO data for year %i:  read_prodprice_fao()\n", SAGE_START_YEAR);
-			return ERROR_IND;
-		}
+		avg_start_year = SAGE_START_YEAR;
 	} // end else use the input sage average period
 	
 	// read the cpi values
@@ -206,14 +178,19 @@ int read_prodprice_fao(args_struct in_args) {
 	}
 
 	while (fscanf(fpin, "%[^\r\n]\r\n", rec_str) != EOF) {
+			// split the record into its fields once
+			if((err = split_fields(rec_str, delim, &fields)) != OK) {
+				fprintf(fplog, "Error processing file %s: read_prodprice_fao(); field split\n", fname);
+				return err;
+			}
 			// get the input year
-			if((err = get_int_field(rec_str, delim, 1, &cpi_year[cpi_index])) != OK) {
+			if((err = get_int_fld(&fields, 1, &cpi_year[cpi_index])) != OK) {
 				fprintf(fplog, "Error processing file %s: read_prodprice_fao(); record=%i, column=1\n",
 						fname, num_cpi_years + 1);
 				return err;
 			}
 			// get the corresponding value
-			if((err = get_float_field(rec_str, delim, 2, &cpi_val[cpi_index++])) != OK) {
+			if((err = get_float_fld(&fields, 2, &cpi_val[cpi_index++])) != OK) {
 				fprintf(fplog, "Error processing file %s: read_prodprice_fao(); record=%i, column=2\n",
 						fname, num_cpi_years + 1);
 				return err;
@@ -222,6 +199,17 @@ int read_prodprice_fao(args_struct in_args) {
 	} // end while loop for reading cpi file
 	fclose(fpin);
 	
+	// get the cpi index of each averaging year, so the cpi table is not searched for each record
+	for (j = 0; j < num_avg; j++) {
+		cpi_avg_ind[j] = NOMATCH;
+		for (i = 0; i < num_cpi_years; i++) {
+			if ((avg_start_year + j) == cpi_year[i]) {
+				cpi_avg_ind[j] = i;
+				break;
+			}
+		}
+	}
+	
 	// get the cpi value for the output price data
 	for (i = 0; i < num_cpi_years; i++) {
 		if (in_args.out_year_usd == cpi_year[i]) {
@@ -264,93 +252,99 @@ int read_prodprice_fao(args_struct in_args) {
 	// this is the loop over the whole file
 	// this reads in and skips whitespace lines, rather than throwing an error, but doesn't count them as records 
 	while (*cptr) {
-		rec_index = 0;
-		is_newrec = 0;
-		// this is the loop to obtain each record string
-		while (*cptr) {
-			if (!is_newrec) {
-				if (*cptr == '\n') {
-					is_newrec = 1;
+		// find the end of this record and terminate it in place in the file buffer
+		rec_ptr = cptr;
+		while (*cptr && *cptr != '\n') {
+			cptr++;
+		}
+		if (*cptr) {
+			*cptr++ = '\0';
+		}
+		
+		// get the years from the last header line, and the columns of the averaging years
+		if (count_lines == nhead - 1) {
+			if((err = get_fao_years(rec_ptr, delim, FAO_START_YEAR_COL, &price_start_year, &price_num_yrs)) != OK) {
+				fprintf(fplog, "Error processing file %s header: read_prodprice_fao()\n", fname);
+				return err;
+			}
+			for (i = 0; i < num_avg; i++) {
+				if (avg_start_year + i < price_start_year || avg_start_year + i >= price_start_year + price_num_yrs) {
+					fprintf(fplog,"Failed to find FAO data for year %i in file %s:  read_prodprice_fao()\n", avg_start_year + i, fname);
+					return ERROR_IND;
 				}
-			} else {
-				break;
+				avg_cols[i] = FAO_START_YEAR_COL + (avg_start_year + i - price_start_year) * 2;
 			}
-			
-			// store the current character in the record string
-			rec_str[rec_index++] = *cptr++;
-		} // end while loop over record
-		rec_str[rec_index] = '\0';	// terminate the record string
+		}
 		
 		// process this record if it is not a header and it is not a blank record
-		rm_whitesp(temp_str, rec_str);
-		if (!(count_lines++ < nhead) && strlen(temp_str)) {
+		if (!(count_lines++ < nhead) && !is_blank(rec_ptr)) {
 			count_recs++;
 			
+			// split the record into its fields once
+			if((err = split_fields(rec_ptr, delim, &fields)) != OK) {
+				fprintf(fplog, "Error processing file %s: read_prodprice_fao(); record=%li, field split\n",
+						fname, count_recs);
+				return err;
+			}
+			
 			// get the country code
-			if((err = get_int_field(rec_str, delim, 1, &temp_ctry)) != OK) {
+			if((err = get_int_fld(&fields, 1, &temp_ctry)) != OK) {
 				fprintf(fplog, "Error processing file %s: read_prodprice_fao(); record=%li, column=2\n",
 						fname, count_recs);
 				return err;
 			}
 			
 			// get the crop code
-			if((err = get_int_field(rec_str, delim, 3, &temp_crop)) != OK) {
+			if((err = get_int_fld(&fields, 3, &temp_crop)) != OK) {
 				fprintf(fplog, "Error processing file %s: read_prodprice_fao(); record=%li, column=4\n",
 						fname, count_recs);
 				return err;
 			}
 			
 			// determine the output index for this record in the local temp price storage array
-			ctry_ind = -1;
-			for (j = 0; j < NUM_FAO_CTRY; j++) {
-				if (countrycodes_fao[j] == temp_ctry) {
-					ctry_ind = j;
-					break;
-				}
+			ctry_ind = NOMATCH;
+			if (temp_ctry >= 0 && temp_ctry <= max_fao_ctry_code) {
+				ctry_ind = fao_ctry_code2ind[temp_ctry];
 			}
 			
 			// process record only if there is an fao country match
-			if (ctry_ind != -1) {
-				crop_ind = -1;
-				for (j = 0; j < NUM_SAGE_CROP; j++) {
-					if (cropcodes_sage2fao[j] == temp_crop) {
-						crop_ind = j;
-						out_index = ctry_ind * NUM_SAGE_CROP + crop_ind;
-						break;
-					}
+			if (ctry_ind != NOMATCH) {
+				crop_ind = NOMATCH;
+				if (temp_crop >= 0 && temp_crop <= max_fao_crop_code) {
+					crop_ind = fao_crop_code2ind[temp_crop];
 				}
 				
 				// process record only if there is a sage crop match
-				if (crop_ind != -1) {
+				if (crop_ind != NOMATCH) {
+					out_index = ctry_ind * NUM_SAGE_CROP + crop_ind;
+					
 					// get the annual data for sevaral years and average it
 					// need to weight this average by annual production
 					avg_sum = 0;
 					for (j = 0; j < num_avg; j++) {
-						if((err = get_float_field(rec_str, delim, avg_cols[j], &temp_flt)) != OK) {
+						if((err = get_float_fld(&fields, avg_cols[j], &temp_flt)) != OK) {
 							fprintf(fplog, "Error processing file %s: read_prodprice_fao(); record=%li, column=%i\n",
 									fname, count_recs, avg_cols[j]);
 							return err;
 						}
 						
-						// get the cpi index for this input year
-						for (i = 0; i < num_cpi_years; i++) {
-							if ((FAO_START_YEAR + j + fao_start_year_index) == cpi_year[i]) {
-								if (cpi_val[i] != 0) {
-									cpi_in_val = cpi_val[i];
-								}else {
-									fprintf(fplog,"Invalid in year cpi value %f for year %i:  read_prodprice_fao()\n", cpi_val[i], cpi_year[i]);
-									return ERROR_FILE;
-								}
-								break;
+						// get the cpi value for this input year
+						i = cpi_avg_ind[j];
+						if (i != NOMATCH) {
+							if (cpi_val[i] != 0) {
+								cpi_in_val = cpi_val[i];
+							}else {
+								fprintf(fplog,"Invalid in year cpi value %f for year %i:  read_prodprice_fao()\n", cpi_val[i], cpi_year[i]);
+								return ERROR_FILE;
 							}
 						}
 						
-						// determine the index of the production data for this year and country and crop
-						prod_index = ctry_ind * NUM_SAGE_CROP * NUM_FAO_YRS + crop_ind * NUM_FAO_YRS + j + fao_start_year_index;
+						// get the production for this year and country and crop
+						prod_val = get_fao_val(&production_fao, ctry_ind, crop_ind, avg_start_year + j);
 						
 						// get the averaging sums; multiply the cpi ratio
-						prod_sum[out_index] = prod_sum[out_index] + production_fao[prod_index];
-						avg_sum = avg_sum + production_fao[prod_index] * temp_flt * cpi_out_val / cpi_in_val;
+						prod_sum[out_index] = prod_sum[out_index] + prod_val;
+						avg_sum = avg_sum + prod_val * temp_flt * cpi_out_val / cpi_in_val;
 					}
 					
 					// make the conversion to output USD year after the temporal average is calculated
@@ -385,6 +379,7 @@ int read_prodprice_fao(args_struct in_args) {
 	} // end while loop over file
 	
 	free(sptr);
+	free_fields(&fields);
 	
 	/* this no longer applies because the fao data includes extra records
 	if(count_recs != nrecords)
@@ -403,18 +398,13 @@ int read_prodprice_fao(args_struct in_args) {
 			
             // aggregate if fao country has an economic region
             temp_ctry = ctry2ctry87codes_gtap[ctry_ind];
-            if (temp_ctry == NOMATCH) {
+            if (temp_ctry == NOMATCH || ctry2ctry87_ind[ctry_ind] == NOMATCH) {
 				if (in_args.diagnostics){
                 	fprintf(fplog, "Warning: FAO country %i has no economic region: read_prodprice_fao()\n", countrycodes_fao[ctry_ind]);
 				}
                 continue;
             }else {
-                for (i = 0; i < NUM_GTAP_CTRY87; i++) {
-                    if (country87codes_gtap[i] == temp_ctry) {
-                        out_index = i * NUM_SAGE_CROP + crop_ind;
-                        break;
-                    }
-                }	// end for i loop to get new out index
+                out_index = ctry2ctry87_ind[ctry_ind] * NUM_SAGE_CROP + crop_ind;
                 
                 j = ctry_ind * NUM_SAGE_CROP + crop_ind;
                 prod_tot[out_index] = prod_tot[out_index] + prod_sum[j];
@@ -4,10 +4,12 @@
  read FAOSTAT production file for weighting the price average across years and countries
   and for calibrating yield and harvested area data to a different year
  
- the production data file must be the same formt as and contain the same years as the price, yield, and harvested area data files
+ the production data file must be the same format as the price, yield, and harvested area data files
+ the years are read from the header, and must be contiguous and in order
  year value fields must be empty or numeric
  
  only the 175 SAGE crops are stored and the moirai countries
+ only the country X crop records in the file are stored, see fao_data_utils.c
  
  the fao file is in ha, so convert to km^2 for storage array
  
@@ -70,11 +72,12 @@ int read_production_fao(args_struct in_args) {
 	
 	char fname[MAXCHAR];			// file name to open
 	FILE *fpin;						// file pointer
-	char rec_str[MAXRECSIZE];		// string to hold one record
-	char temp_str[MAXRECSIZE];		// string to test for blank line
 	const char* delim = ",";		// delimiter string for csv file
 	int err = OK;					// error code for the string parsing function
-	int out_index = 0;				// the index of the production array to fill
+	int start_year;					// the first year in the file
+	int num_yrs;					// the number of years in the file
+	int rec;						// the stored record of the current country and crop
+	float *rec_vals;				// the annual values of the current record
 	int ctry_ind = 0;				// the FAO country index with respect to countrycodes_fao[]
 	int crop_ind = 0;				// the SAGE crop index with respect to int cropcodes_sage2fao[] and cropcodes_sage[]
 	int temp_ctry = NODATA;			// temporary country code
@@ -83,12 +86,15 @@ int read_production_fao(args_struct in_args) {
 	long flen = 0;					// length of file in bytes
 	long count_lines = 0;			// count the number of lines to skip the header
 	long count_recs = 0;			// count the number of records read
-	long rec_index = 0;				// the index of the record string to fill
-	int is_newrec = 0;				// flag to denote end of record
+	char *rec_ptr;					// the current record, terminated in place in the file buffer
+	fields_struct fields = {0, 0, NULL, NULL};	// the fields of the current record
 	char *sptr;						// dynamically allocated buffer for whole file as a string
 	char *cptr;						// pointer to traverse the file string
 	
-	double tmp_dbl, dbl_int;		// for checking fao area-production consistency
+	int year;						// for checking fao area-production consistency
+	float harv_val, prod_val;		// for checking fao area-production consistency
+	
+	float *dense_out;				// the full country X crop X year array for diagnostic output
 	
 	char out_name[] = "production_fao.csv";	// diagnositic output csv file name
 	
@@ -121,36 +127,47 @@ int read_production_fao(args_struct in_args) {
 	// this is the loop over the whole file
 	// this reads in and skips whitespace lines, rather than throwing an error, but doesn't count them as records 
 	while (*cptr) {
-		rec_index = 0;
-		is_newrec = 0;
-		// this is the loop over the records
-		while (*cptr) {
-			if (!is_newrec) {
-				if (*cptr == '\n') {
-					is_newrec = 1;
-				}
-			} else {
-				break;
+		// find the end of this record and terminate it in place in the file buffer
+		rec_ptr = cptr;
+		while (*cptr && *cptr != '\n') {
+			cptr++;
+		}
+		if (*cptr) {
+			*cptr++ = '\0';
+		}
+		
+		// get the years from the last header line
+		if (count_lines == nhead - 1) {
+			if((err = get_fao_years(rec_ptr, delim, yr1col, &start_year, &num_yrs)) != OK) {
+				fprintf(fplog, "Error processing file %s header: read_production_fao()\n", fname);
+				return err;
 			}
-			// store the current character in the record string
-			rec_str[rec_index++] = *cptr++;
-		} // end while loop over record
-		rec_str[rec_index] = '\0';	// terminate the record string
+			if((err = init_fao_data(&production_fao, start_year, num_yrs)) != OK) {
+				fprintf(fplog, "Error allocating storage for file %s: read_production_fao()\n", fname);
+				return err;
+			}
+		}
 		
 		// process this record if it is not a header and it is not a blank record
-		rm_whitesp(temp_str, rec_str);
-		if (!(count_lines++ < nhead) && strlen(temp_str)) {
+		if (!(count_lines++ < nhead) && !is_blank(rec_ptr)) {
 			count_recs++;
+			
+			// split the record into its fields once
+			if((err = split_fields(rec_ptr, delim, &fields)) != OK) {
+				fprintf(fplog, "Error processing file %s: read_production_fao(); record=%li, field split\n",
+						fname, count_recs);
+				return err;
+			}
 		
 			// get the country code
-			if((err = get_int_field(rec_str, delim, 1, &temp_ctry)) != OK) {
+			if((err = get_int_fld(&fields, 1, &temp_ctry)) != OK) {
 				fprintf(fplog, "Error processing file %s: read_production_fao(); record=%li, country code check\n",
 						fname, count_recs);
 				return err;
 			}
 			
 			// get the crop code
-			if((err = get_int_field(rec_str, delim, 3, &temp_crop)) != OK) {
+			if((err = get_int_fld(&fields, 3, &temp_crop)) != OK) {
 				fprintf(fplog, "Error processing file %s: read_production_fao(); record=%li, column=4\n",
 						fname, count_recs);
 				return err;
@@ -159,11 +176,8 @@ int read_production_fao(args_struct in_args) {
 			// determine the country and crop indices for this record
 			// skip record if country or crop do not match fao to sage mappings
 			ctry_ind = NOMATCH;
-			for (j = 0; j < NUM_FAO_CTRY; j++) {
-				if (countrycodes_fao[j] == temp_ctry) {
-					ctry_ind = j;
-					break;
-				}
+			if (temp_ctry >= 0 && temp_ctry <= max_fao_ctry_code) {
+				ctry_ind = fao_ctry_code2ind[temp_ctry];
 			}
 			if(ctry_ind == NOMATCH) {
 				//fprintf(fplog, "Extra FAO country code %i in %s: read_production_fao(); record=%li\n",
@@ -171,11 +185,8 @@ int read_production_fao(args_struct in_args) {
 				continue;
 			}
 			crop_ind = NOMATCH;
-			for (j = 0; j < NUM_SAGE_CROP; j++) {
-				if (cropcodes_sage2fao[j] == temp_crop) {
-					crop_ind = j;
-					break;
-				}
+			if (temp_crop >= 0 && temp_crop <= max_fao_crop_code) {
+				crop_ind = fao_crop_code2ind[temp_crop];
 			}
 			if(crop_ind == NOMATCH) {
 				//fprintf(fplog, "Extra FAO crop code %i in %s: read_production_fao(); record=%li\n",
@@ -183,12 +194,16 @@ int read_production_fao(args_struct in_args) {
 				continue;
 			}
 			
+			// get the record for this country and crop
+			if((err = add_fao_rec(&production_fao, ctry_ind, crop_ind, &rec)) != OK) {
+				fprintf(fplog, "Error storing record %li of file %s: read_production_fao()\n", count_recs, fname);
+				return err;
+			}
+			rec_vals = &production_fao.vals[(size_t) rec * production_fao.num_yrs];
+			
 			// get the annual data
-			for (j = 0; j < NUM_FAO_YRS; j++) {
-				// determine the index of the production data for this year and country and crop
-				out_index = ctry_ind * NUM_SAGE_CROP * NUM_FAO_YRS + crop_ind * NUM_FAO_YRS + j;
-				
-				if((err = get_float_field(rec_str, delim, (j * 2) + yr1col, &production_fao[out_index])) != OK) {
+			for (j = 0; j < production_fao.num_yrs; j++) {
+				if((err = get_float_fld(&fields, (j * 2) + yr1col, &rec_vals[j])) != OK) {
 					fprintf(fplog, "Error processing file %s: read_production_fao(); record=%li, year column=%i\n",
 							fname, count_recs, j);
 					return err;
@@ -199,23 +214,26 @@ int read_production_fao(args_struct in_args) {
 	} // end while loop over file
 	
 	free(sptr);
+	free_fields(&fields);
 	
 	// check for inconsistent values in the input fao data
-	for (j = 0; j < NUM_SAGE_CROP * NUM_FAO_CTRY * NUM_FAO_YRS; j++) {
-		tmp_dbl = modf((double) (j / (NUM_SAGE_CROP *  NUM_FAO_YRS)), &dbl_int);
-		ctry_ind = (int) dbl_int;
-		temp_crop = j - ctry_ind * NUM_FAO_YRS * NUM_SAGE_CROP;
-		tmp_dbl = modf((double) (temp_crop / NUM_FAO_YRS), &dbl_int);
-		crop_ind = (int) dbl_int;
-		if (harvestarea_fao[j] != 0 && production_fao[j] == 0) {
-			//fprintf(fplog, "FAO inconsistency for zero production at index %i: read_production_fao(); harvestarea_fao = %f\n\tctry_ind = %i\tcrop_ind = %i\n",
-					//j, harvestarea_fao[j], ctry_ind, crop_ind);
-		}
-		if (harvestarea_fao[j] == 0 && production_fao[j] != 0) {
-			//fprintf(fplog, "FAO inconsistency for zero area at index %i: read_production_fao(); production_fao = %f\n\tctry_ind = %i\tcrop_ind = %i\n",
-					//j, production_fao[j], ctry_ind, crop_ind);
+	for (ctry_ind = 0; ctry_ind < NUM_FAO_CTRY; ctry_ind++) {
+		for (crop_ind = 0; crop_ind < NUM_SAGE_CROP; crop_ind++) {
+			for (j = 0; j < production_fao.num_yrs; j++) {
+				year = production_fao.start_year + j;
+				harv_val = get_fao_val(&harvestarea_fao, ctry_ind, crop_ind, year);
+				prod_val = get_fao_val(&production_fao, ctry_ind, crop_ind, year);
+				if (harv_val != 0 && prod_val == 0) {
+					//fprintf(fplog, "FAO inconsistency for zero production in year %i: read_production_fao(); harvestarea_fao = %f\n\tctry_ind = %i\tcrop_ind = %i\n",
+							//year, harv_val, ctry_ind, crop_ind);
+				}
+				if (harv_val == 0 && prod_val != 0) {
+					//fprintf(fplog, "FAO inconsistency for zero area in year %i: read_production_fao(); production_fao = %f\n\tctry_ind = %i\tcrop_ind = %i\n",
+							//year, prod_val, ctry_ind, crop_ind);
+				}
+			}
 		}
-	}	
+	}
 	
 	/* this no longer applies because the fao data includes extra records
 	if(count_recs != nrecords)
@@ -227,11 +245,16 @@ int read_production_fao(args_struct in_args) {
 	 */
 	
 	if (in_args.diagnostics) {
-		if ((err = write_csv_float3d(production_fao, countrycodes_fao, cropcodes_sage,
-									NUM_FAO_CTRY, NUM_SAGE_CROP, NUM_FAO_YRS, out_name, in_args))) {
+		if ((err = get_fao_dense(&production_fao, &dense_out)) != OK) {
+			fprintf(fplog, "Error expanding the data for file %s: read_production_fao()\n", out_name);
+			return err;
+		}
+		if ((err = write_csv_float3d(dense_out, countrycodes_fao, cropcodes_sage,
+									NUM_FAO_CTRY, NUM_SAGE_CROP, production_fao.num_yrs, out_name, in_args))) {
 			fprintf(fplog, "Error writing file %s: read_production_fao()\n", out_name);
 			return err;
 		}
+		free(dense_out);
 	}
 	 
 	return OK;}
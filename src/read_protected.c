@@ -1,7 +1,9 @@
 /**********
  read_protected.c
  
- read the protected/suitable data into protected_EPA[ncells][0-7]
+ read the protected/suitable data into protected_EPA[0-7][num_land_cells_hyde]
+ only the hyde land cells are stored, indexed by their ordinal in land_cells_hyde[]
+ the diagnostic rasters are expanded to the working grid with nodata in the non-land cells
  there are six files, and the 0 index is for land area with unkown suitability/protection, which does not appear to occur
  
  The six input layers are:
@@ -76,6 +78,7 @@ int read_protected(args_struct in_args, rinfo_struct *raster_info) {
     // values are integers
     
     int i,j,k;
+    int land_ind;					// ordinal of the current cell in land_cells_hyde[]
     int nrows = 2160;				// num input lats
     int ncols = 4320;				// num input lons
     int ncells = nrows * ncols;		// number of input grid cells
@@ -306,71 +309,73 @@ int read_protected(args_struct in_args, rinfo_struct *raster_info) {
 
 
    //kbn calc category data from input arrays
-    for (i = 0; i < ncells; i++) {
+   // only the hyde land cells are stored, by land cell ordinal land_ind; i is the grid cell
+    for (land_ind = 0; land_ind < num_land_cells_hyde; land_ind++) {
+        i = land_cells_hyde[land_ind];
 		
         //Category 1
-        protected_EPA[1][i] = 1 - ALL_IUCN_array[i] - L4_array[i];
-        //protected_EPA[1][i] =floor()
+        protected_EPA[1][land_ind] = 1 - ALL_IUCN_array[i] - L4_array[i];
+        //protected_EPA[1][land_ind] =floor()
         //Category 2
-        protected_EPA[2][i] = L4_array[i];
+        protected_EPA[2][land_ind] = L4_array[i];
         //Category 3
-        protected_EPA[3][i] = L1_array[i] - L3_array[i];
+        protected_EPA[3][land_ind] = L1_array[i] - L3_array[i];
         //Category 4
-        protected_EPA[4][i] = L3_array[i] - L2_array[i];
+        protected_EPA[4][land_ind] = L3_array[i] - L2_array[i];
         //Category 5
-        protected_EPA[5][i] = L2_array[i] - L4_array[i];
+        protected_EPA[5][land_ind] = L2_array[i] - L4_array[i];
         //Category 6
-        protected_EPA[6][i] = IUCN_1a_1b_2_array[i] - L1_array[i] + L2_array[i];
+        protected_EPA[6][land_ind] = IUCN_1a_1b_2_array[i] - L1_array[i] + L2_array[i];
         //Category 7
-        protected_EPA[7][i] = ALL_IUCN_array[i] - L2_array[i] + L4_array[i] - IUCN_1a_1b_2_array[i];
+        protected_EPA[7][land_ind] = ALL_IUCN_array[i] - L2_array[i] + L4_array[i] - IUCN_1a_1b_2_array[i];
 		
 		// check for negative category values
 		// only cat 6 or 7 may be negative, and can be adjusted
 		// also sum the categories
 		land_check = 0.0;
 		for (j = 1; j < NUM_EPA_PROTECTED; j++) {
-			if (protected_EPA[j][i] < 0) {
+			if (protected_EPA[j][land_ind] < 0) {
 				if (j==6 || j==7) {	// this adjustment is sometimes necessary
 					if (j==6) { k = 7;
 					} else { k = 6; }
-					tmp_check = protected_EPA[k][i];
-					protected_EPA[k][i] = protected_EPA[k][i] + protected_EPA[j][i];
+					tmp_check = protected_EPA[k][land_ind];
+					protected_EPA[k][land_ind] = protected_EPA[k][land_ind] + protected_EPA[j][land_ind];
 					// check for adjustment going negative, which happens due to previous adjustments
-					if (protected_EPA[k][i] < 0) {
-						if (protected_EPA[k][i] < -ROUND_TOLERANCE) {
-							//fprintf(fplog, "Warning: prior fraction %f, corrected fraction %f cat %i, cell %i set to zero: read_protected()\n", tmp_check, protected_EPA[k][i], j, i);
+					if (protected_EPA[k][land_ind] < 0) {
+						if (protected_EPA[k][land_ind] < -ROUND_TOLERANCE) {
+							//fprintf(fplog, "Warning: prior fraction %f, corrected fraction %f cat %i, cell %i set to zero: read_protected()\n", tmp_check, protected_EPA[k][land_ind], j, i);
 							// correct this by adjusting cat 1 - unsuitable unprotected
-							if (protected_EPA[1][i] >= -protected_EPA[k][i]) {
-								protected_EPA[1][i] = protected_EPA[1][i] + protected_EPA[k][i];
+							if (protected_EPA[1][land_ind] >= -protected_EPA[k][land_ind]) {
+								protected_EPA[1][land_ind] = protected_EPA[1][land_ind] + protected_EPA[k][land_ind];
 							} else {
-								protected_EPA[1][i] = 0;
+								protected_EPA[1][land_ind] = 0;
 							}
 						} // end if correction is more negative than tolerance
-						protected_EPA[k][i] = 0;
+						protected_EPA[k][land_ind] = 0;
 					} // end if correction is negative
-					protected_EPA[j][i] = 0;
+					protected_EPA[j][land_ind] = 0;
 				} else {
 					// this shouldn't happen because of preprocessing, but preprocessing missed a couple of cases
 					// but sometimes it happens due to rounding and other times due to small erroneous values
-					if (protected_EPA[j][i] > -ROUND_TOLERANCE) {
+					if (protected_EPA[j][land_ind] > -ROUND_TOLERANCE) {
 						// just rounding error
-						protected_EPA[j][i] = 0;
+						protected_EPA[j][land_ind] = 0;
 					} else {
-						if (protected_EPA[5][i] < 0) {
+						if (protected_EPA[5][land_ind] < 0) {
 							// this happens when L4 > L2
 							// reduce L4 and adjust cats 1, 2, and 7 accordingly
-							protected_EPA[1][i] = protected_EPA[1][i] - protected_EPA[5][i];
-							protected_EPA[2][i] = protected_EPA[2][i] + protected_EPA[5][i];
-							protected_EPA[7][i] = protected_EPA[7][i] + protected_EPA[5][i];
-							protected_EPA[5][i] = 0;
-						} else if (protected_EPA[3][i] < 0) {
+							protected_EPA[1][land_ind] = protected_EPA[1][land_ind] - protected_EPA[5][land_ind];
+							protected_EPA[2][land_ind] = protected_EPA[2][land_ind] + protected_EPA[5][land_ind];
+							protected_EPA[7][land_ind] = protected_EPA[7][land_ind] + protected_EPA[5][land_ind];
+							protected_EPA[5][land_ind] = 0;
+						} else if (protected_EPA[3][land_ind] < 0) {
 							// this happens only once: when L3 > L1 in cell 2700721
 							// reduce L3 and adjust cat 4
-							protected_EPA[4][i] = protected_EPA[4][i] + protected_EPA[3][i];
-							protected_EPA[3][i] = 0;
+							protected_EPA[4][land_ind] = protected_EPA[4][land_ind] + protected_EPA[3][land_ind];
+							protected_EPA[3][land_ind] = 0;
 						} else {
 							fprintf(fplog, "Error in protected fraction cat %i, cell %i: read_protected(); %f is negative\n",
-									j, i, protected_EPA[j][i]);
+									j, i, protected_EPA[j][land_ind]);
 							
 							return ERROR_CALC;
 						}
@@ -378,9 +383,9 @@ int read_protected(args_struct in_args, rinfo_struct *raster_info) {
 					
 					// need to recheck for negatives again, but 6 and 7 are checked after this separtely
 					for (j = 1; j <= 4; j++) {
-						if (protected_EPA[j][i] < 0) {
+						if (protected_EPA[j][land_ind] < 0) {
 							fprintf(fplog, "Error after correction in protected fraction cat %i, cell %i: read_protected(); %f is negative\n",
-									j, i, protected_EPA[j][i]);
+									j, i, protected_EPA[j][land_ind]);
 							return ERROR_CALC;
 						}
 					}
@@ -390,14 +395,14 @@ int read_protected(args_struct in_args, rinfo_struct *raster_info) {
 		} // end for j loop over protected category negative check
 		
 		// Check for negative or zero grid cells
-		land_check = protected_EPA[2][i] + protected_EPA[3][i] + protected_EPA[4][i] + protected_EPA[5][i];
-		tmp_check = land_check + protected_EPA[1][i] + protected_EPA[6][i] + protected_EPA[7][i];
+		land_check = protected_EPA[2][land_ind] + protected_EPA[3][land_ind] + protected_EPA[4][land_ind] + protected_EPA[5][land_ind];
+		tmp_check = land_check + protected_EPA[1][land_ind] + protected_EPA[6][land_ind] + protected_EPA[7][land_ind];
 		
 		// Check if there is hyde area where there is no protected area.
 		// so far this does not exist
 		if(tmp_check == 0 ){
 			if (land_area_hyde[i] > 0){
-				protected_EPA[0][i] = 1;
+				protected_EPA[0][land_ind] = 1;
 			}
 		}
 		
@@ -413,159 +418,150 @@ int read_protected(args_struct in_args, rinfo_struct *raster_info) {
 		// And this condition is currently always false
 		tmp_sum = 1 + ROUND_TOLERANCE;
 		tmp_float = 1 - ROUND_TOLERANCE;
-		if((tmp_check + protected_EPA[0][i]) > (1 + ROUND_TOLERANCE) || (tmp_check + protected_EPA[0][i]) < (1 - ROUND_TOLERANCE))
+		if((tmp_check + protected_EPA[0][land_ind]) > (1 + ROUND_TOLERANCE) || (tmp_check + protected_EPA[0][land_ind]) < (1 - ROUND_TOLERANCE))
 		{
-			fprintf(fplog, "Error before land normalization: cell sum %f != 1+-tolerance in cell=%i; read_protected()\n",tmp_check + protected_EPA[0][i],i);
+			fprintf(fplog, "Error before land normalization: cell sum %f != 1+-tolerance in cell=%i; read_protected()\n",tmp_check + protected_EPA[0][land_ind],i);
 			return ERROR_CALC;
 		}
 		
-		// fill non-land cells with nodata value, and normalize the rest to fraction of land area
-		if (land_area_hyde[i] == raster_info->land_area_hyde_nodata) {
-			for (j = 0; j < NUM_EPA_PROTECTED; j++) {
-				protected_EPA[j][i] = NODATA;
-			}
-		} else {
-			// don't need to do this if protected area is unknown
-			if (protected_EPA[0][i] != 1) {
-			
-				// scale the values if there isn't enough land for cats 2-5
-				tmp_check = land_check * cell_area_hyde[i];
-				if (tmp_check > land_area_hyde[i] && tmp_check > 0) {
-					//fprintf(fplog, "Warning: protected land cat area %f > land area %f in cell %i; read_protected()\n",
-							//tmp_check,land_area_hyde[i], i);
-					fact = land_area_hyde[i] / tmp_check;
-					tmp_sum = 0.0;
-					for (j = 2; j < 6; j++) {
-						protected_EPA[j][i] = fact * protected_EPA[j][i];
-						tmp_sum += protected_EPA[j][i];
-					}
-					// don't need to worry about unkown cat0 cuz it is only non-zero (1) if all others are zero
-					tmp_check = 1 - tmp_sum;
-					tmp_sum = protected_EPA[1][i] + protected_EPA[6][i] + protected_EPA[7][i];
-					if (tmp_sum == 0) {
-						// put the remainder in unsuitable unprotected as it likely is water
-						protected_EPA[1][i] = tmp_check;
-						protected_EPA[6][i] = 0;
-						protected_EPA[7][i] = 0;
-					} else{
-						// distribute the remainder proportionally
-						fact = tmp_check / tmp_sum;
-						protected_EPA[1][i] = fact * protected_EPA[1][i];
-						protected_EPA[6][i] = fact * protected_EPA[6][i];
-						protected_EPA[7][i] = fact * protected_EPA[7][i];
-					}
-				} // end if scale to land area
-				
-				// normalize the total cell fractions to fractions of land area
-				// cats 2-5 are all land
-				// cats 1, 6, and 7 may include water
-				// so loop over 2-5 first
+		// normalize to fraction of land area
+		// don't need to do this if protected area is unknown
+		if (protected_EPA[0][land_ind] != 1) {
+		
+			// scale the values if there isn't enough land for cats 2-5
+			tmp_check = land_check * cell_area_hyde[i];
+			if (tmp_check > land_area_hyde[i] && tmp_check > 0) {
+				//fprintf(fplog, "Warning: protected land cat area %f > land area %f in cell %i; read_protected()\n",
+						//tmp_check,land_area_hyde[i], i);
+				fact = land_area_hyde[i] / tmp_check;
 				tmp_sum = 0.0;
 				for (j = 2; j < 6; j++) {
-					tmp_check = protected_EPA[j][i] * cell_area_hyde[i];
-					if (land_area_hyde[i] > 0) {
-						protected_EPA[j][i] = tmp_check / land_area_hyde[i];
-					} else {
-						protected_EPA[j][i] = 0.0;
-					}
-					tmp_sum += protected_EPA[j][i];
-				} // end for loop over protected land categories
-				
-				// need to assign rest of cats to land as necessary, proportionally
-				land_check = land_area_hyde[i] - tmp_sum * land_area_hyde[i];
-				if (land_check > 0 && land_area_hyde[i] > 0) {   // this shouldn't be negative as it is scaled above
-					tmp_sum = protected_EPA[1][i] + protected_EPA[6][i] + protected_EPA[7][i];
-					if (tmp_sum == 0) {
-						// this shouldn't happen cuz cat 1 is filled above if this sum is zero, but do it again in case
-						// due to rounding error land_check can be ~3x10^-6 while tmp_sum==0
-						// since land_check is just above the current round tolerance, just give cat 1 a tiny value
-						protected_EPA[1][i] = land_check / land_area_hyde[i];
-						protected_EPA[6][i] = 0;
-						protected_EPA[7][i] = 0;
-					} else {
-						// distribute the remaining land proportionally
-						fact = land_check / tmp_sum / land_area_hyde[i];
-						protected_EPA[1][i] = fact * protected_EPA[1][i];
-						protected_EPA[6][i] = fact * protected_EPA[6][i];
-						protected_EPA[7][i] = fact * protected_EPA[7][i];
-					}
-				} else if (land_area_hyde[i] > 0) {
-					// reset these only if there is land and land_check is zero (other cats cover all land)
-					protected_EPA[1][i] = 0.0;
-					protected_EPA[6][i] = 0.0;
-					protected_EPA[7][i] = 0.0;
+					protected_EPA[j][land_ind] = fact * protected_EPA[j][land_ind];
+					tmp_sum += protected_EPA[j][land_ind];
 				}
-				
-			} // end if protected area status is known
-		} // end else normalize land cells to land area
-		
-		// final check on valid cells
-		if (land_area_hyde[i] != raster_info->land_area_hyde_nodata) {
-		
-			tmp_check = 0.0;
-			for (j = 0; j < NUM_EPA_PROTECTED; j++) {
-				tmp_check += protected_EPA[j][i];
-			}
+				// don't need to worry about unkown cat0 cuz it is only non-zero (1) if all others are zero
+				tmp_check = 1 - tmp_sum;
+				tmp_sum = protected_EPA[1][land_ind] + protected_EPA[6][land_ind] + protected_EPA[7][land_ind];
+				if (tmp_sum == 0) {
+					// put the remainder in unsuitable unprotected as it likely is water
+					protected_EPA[1][land_ind] = tmp_check;
+					protected_EPA[6][land_ind] = 0;
+					protected_EPA[7][land_ind] = 0;
+				} else{
+					// distribute the remainder proportionally
+					fact = tmp_check / tmp_sum;
+					protected_EPA[1][land_ind] = fact * protected_EPA[1][land_ind];
+					protected_EPA[6][land_ind] = fact * protected_EPA[6][land_ind];
+					protected_EPA[7][land_ind] = fact * protected_EPA[7][land_ind];
+				}
+			} // end if scale to land area
 			
-			// Check again if total value is negative in any grid cell. This should never happen as negatives are captured above.
-			if(tmp_check < 0)
-			{
-				fprintf(fplog, "Error after land normalization: cell %i has negative sum %f; read_protected()\n", i, tmp_check);
-				return ERROR_CALC;
-			}
+			// normalize the total cell fractions to fractions of land area
+			// cats 2-5 are all land
+			// cats 1, 6, and 7 may include water
+			// so loop over 2-5 first
+			tmp_sum = 0.0;
+			for (j = 2; j < 6; j++) {
+				tmp_check = protected_EPA[j][land_ind] * cell_area_hyde[i];
+				if (land_area_hyde[i] > 0) {
+					protected_EPA[j][land_ind] = tmp_check / land_area_hyde[i];
+				} else {
+					protected_EPA[j][land_ind] = 0.0;
+				}
+				tmp_sum += protected_EPA[j][land_ind];
+			} // end for loop over protected land categories
 			
-			// Check again to ensure grid cells add up to 1
-			// currently it is always within rounding tolerance
-			tmp_sum = 1 + ROUND_TOLERANCE;
-			tmp_float = 1 - ROUND_TOLERANCE;
-			if((tmp_check + protected_EPA[0][i]) > (1 + ROUND_TOLERANCE) || (tmp_check + protected_EPA[0][i]) < (1 - ROUND_TOLERANCE))
-			{
-				fprintf(fplog, "Warning after land normalization: cell sum %f != 1+-tolerance in cell=%i; read_protected()\n",tmp_check + protected_EPA[0][i],i);
-				return ERROR_CALC;
+			// need to assign rest of cats to land as necessary, proportionally
+			land_check = land_area_hyde[i] - tmp_sum * land_area_hyde[i];
+			if (land_check > 0 && land_area_hyde[i] > 0) {   // this shouldn't be negative as it is scaled above
+				tmp_sum = protected_EPA[1][land_ind] + protected_EPA[6][land_ind] + protected_EPA[7][land_ind];
+				if (tmp_sum == 0) {
+					// this shouldn't happen cuz cat 1 is filled above if this sum is zero, but do it again in case
+					// due to rounding error land_check can be ~3x10^-6 while tmp_sum==0
+					// since land_check is just above the current round tolerance, just give cat 1 a tiny value
+					protected_EPA[1][land_ind] = land_check / land_area_hyde[i];
+					protected_EPA[6][land_ind] = 0;
+					protected_EPA[7][land_ind] = 0;
+				} else {
+					// distribute the remaining land proportionally
+					fact = land_check / tmp_sum / land_area_hyde[i];
+					protected_EPA[1][land_ind] = fact * protected_EPA[1][land_ind];
+					protected_EPA[6][land_ind] = fact * protected_EPA[6][land_ind];
+					protected_EPA[7][land_ind] = fact * protected_EPA[7][land_ind];
+				}
+			} else if (land_area_hyde[i] > 0) {
+				// reset these only if there is land and land_check is zero (other cats cover all land)
+				protected_EPA[1][land_ind] = 0.0;
+				protected_EPA[6][land_ind] = 0.0;
+				protected_EPA[7][land_ind] = 0.0;
 			}
 			
-		} // end if valid cell check protected fractions
+		} // end if protected area status is known
+		
+		// final check on land cells
+		tmp_check = 0.0;
+		for (j = 0; j < NUM_EPA_PROTECTED; j++) {
+			tmp_check += protected_EPA[j][land_ind];
+		}
+		
+		// Check again if total value is negative in any grid cell. This should never happen as negatives are captured above.
+		if(tmp_check < 0)
+		{
+			fprintf(fplog, "Error after land normalization: cell %i has negative sum %f; read_protected()\n", i, tmp_check);
+			return ERROR_CALC;
+		}
+		
+		// Check again to ensure grid cells add up to 1
+		// currently it is always within rounding tolerance
+		tmp_sum = 1 + ROUND_TOLERANCE;
+		tmp_float = 1 - ROUND_TOLERANCE;
+		if((tmp_check + protected_EPA[0][land_ind]) > (1 + ROUND_TOLERANCE) || (tmp_check + protected_EPA[0][land_ind]) < (1 - ROUND_TOLERANCE))
+		{
+			fprintf(fplog, "Warning after land normalization: cell sum %f != 1+-tolerance in cell=%i; read_protected()\n",tmp_check + protected_EPA[0][land_ind],i);
+			return ERROR_CALC;
+		}
+		
 		
-    } // end for loop over cells
+    } // end for loop over land cells
 	
    //Write Category data out for diagnostics
     if (in_args.diagnostics) {
-        if ((err = write_raster_float(protected_EPA[1], ncells, out_name_Cat1, in_args))) {
+        if ((err = write_raster_land_float(protected_EPA[1], out_name_Cat1, in_args))) {
             fprintf(fplog, "Error writing file %s: read_protected()\n", out_name_Cat1);
             return ERROR_FILE;
         }
 
-        if ((err = write_raster_float(protected_EPA[2], ncells, out_name_Cat2, in_args))) {
+        if ((err = write_raster_land_float(protected_EPA[2], out_name_Cat2, in_args))) {
             fprintf(fplog, "Error writing file %s: read_protected()\n", out_name_Cat2);
             return ERROR_FILE;
         }
 
-        if ((err = write_raster_float(protected_EPA[3], ncells, out_name_Cat3, in_args))) {
+        if ((err = write_raster_land_float(protected_EPA[3], out_name_Cat3, in_args))) {
             fprintf(fplog, "Error writing file %s: read_protected()\n", out_name_Cat3);
             return ERROR_FILE;
         }
 
-        if ((err = write_raster_float(protected_EPA[4], ncells, out_name_Cat4, in_args))) {
+        if ((err = write_raster_land_float(protected_EPA[4], out_name_Cat4, in_args))) {
             fprintf(fplog, "Error writing file %s: read_protected()\n", out_name_Cat4);
             return ERROR_FILE;
         }
 
-        if ((err = write_raster_float(protected_EPA[5], ncells, out_name_Cat5, in_args))) {
+        if ((err = write_raster_land_float(protected_EPA[5], out_name_Cat5, in_args))) {
             fprintf(fplog, "Error writing file %s: read_protected()\n", out_name_Cat5);
             return ERROR_FILE;
         }
 
-        if ((err = write_raster_float(protected_EPA[6], ncells, out_name_Cat6, in_args))) {
+        if ((err = write_raster_land_float(protected_EPA[6], out_name_Cat6, in_args))) {
             fprintf(fplog, "Error writing file %s: read_protected()\n", out_name_Cat6);
             return ERROR_FILE;
         }
 
-        if ((err = write_raster_float(protected_EPA[7], ncells, out_name_Cat7, in_args))) {
+        if ((err = write_raster_land_float(protected_EPA[7], out_name_Cat7, in_args))) {
             fprintf(fplog, "Error writing file %s: read_protected()\n", out_name_Cat7);
             return ERROR_FILE;
         }
 
-        if ((err = write_raster_float(protected_EPA[0], ncells, out_name_Cat0, in_args))) {
+        if ((err = write_raster_land_float(protected_EPA[0], out_name_Cat0, in_args))) {
             fprintf(fplog, "Error writing file %s: read_protected()\n", out_name_Cat0);
             return ERROR_FILE;
         }
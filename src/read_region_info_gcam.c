@@ -73,6 +73,7 @@ int read_region_info_gcam(args_struct in_args) {
 	char rec_str[MAXRECSIZE];		// string to hold one record
 	const char* delim = ",";		// delimiter string for csv file
 	int err = OK;					// error code for the string parsing function
+	fields_struct fields = {0, 0, NULL, NULL};	// the fields of the current record
 
 	//////////
 	// read in the GCAM region list
@@ -134,15 +135,20 @@ int read_region_info_gcam(args_struct in_args) {
 	// read the expected number of records
 	for (i = 0; i < NUM_GCAM_RGN; i++) {
 		if (fscanf(fpin, "%[^\r\n]\r\n", rec_str) != EOF) {
+			// split the record into its fields once
+			if((err = split_fields(rec_str, delim, &fields)) != OK) {
+				fprintf(fplog, "Error processing file %s: read_region_info_gcam(); field split\n", fname);
+				return err;
+			}
 			
 			// get the gcam region integer code
-			if((err = get_int_field(rec_str, delim, 1, &regioncodes_gcam[i])) != OK) {
+			if((err = get_int_fld(&fields, 1, &regioncodes_gcam[i])) != OK) {
 				fprintf(fplog, "Error processing file %s: read_country_info_gcam(); record=%i, column=1\n",
 						fname, i + 1);
 				return err;
 			}
 			// get the gcam region name
-			if((err = get_text_field(rec_str, delim, 2, &regionnames_gcam[i][0])) != OK) {
+			if((err = get_text_fld(&fields, 2, &regionnames_gcam[i][0])) != OK) {
 				fprintf(fplog, "Error processing file %s: read_country_info_gcam(); record=%i, column=2\n",
 						fname, i + 1);
 				return err;
@@ -230,15 +236,20 @@ int read_region_info_gcam(args_struct in_args) {
 	// should change this to read the whole file then double-check the number (or set it here)
 	for (i = 0; i < NUM_GCAM_ISO_CTRY; i++) {
 		if (fscanf(fpin, "%[^\r\n]\r\n", rec_str) != EOF) {
+			// split the record into its fields once
+			if((err = split_fields(rec_str, delim, &fields)) != OK) {
+				fprintf(fplog, "Error processing file %s: read_region_info_gcam(); field split\n", fname);
+				return err;
+			}
 			
 			// get the iso abbreviation
-			if((err = get_text_field(rec_str, delim, 1, &countryabbrs_gcam_iso[i][0])) != OK) {
+			if((err = get_text_fld(&fields, 1, &countryabbrs_gcam_iso[i][0])) != OK) {
 				fprintf(fplog, "Error processing file %s: read_country_info_gcam(); record=%i, column=1\n",
 						fname, i + 1);
 				return err;
 			}
 			// get the gcam region integer code
-			if((err = get_int_field(rec_str, delim, 4, &country_gcamiso2regioncodes_gcam[i])) != OK) {
+			if((err = get_int_fld(&fields, 4, &country_gcamiso2regioncodes_gcam[i])) != OK) {
 				fprintf(fplog, "Error processing file %s: read_country_info_gcam(); record=%i, column=4\n",
 						fname, i + 1);
 				return err;
@@ -292,4 +303,5 @@ int read_region_info_gcam(args_struct in_args) {
 		}
 	}	// end if diagnostics
 	
+	free_fields(&fields);
 	return OK;}
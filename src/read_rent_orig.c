@@ -62,7 +62,6 @@ int read_rent_orig(args_struct in_args) {
 	char fname[MAXCHAR];			// file name to open
 	FILE *fpin;						// file pointer
 	char rec_str[MAXRECSIZE];		// string to hold one record
-	char temp_str[MAXRECSIZE];		// string to test for blank line
 	const char *delim = ",";		// delimiter string for csv file
 	int err = OK;					// error code for the string parsing function
 	int out_index = 0;				// the index of the rent_orig_aez[] array to fill
@@ -70,8 +69,8 @@ int read_rent_orig(args_struct in_args) {
 	long flen = 0;					// length of file in bytes
 	long count_lines = 0;			// count the number of lines to skip the header
 	long count_recs = 0;			// count the number of records read
-	long rec_index = 0;				// the index of the record string to fill
-	int is_newrec = 0;				// flag to denote end of record
+	char *rec_ptr;					// the current record, terminated in place in the file buffer
+	fields_struct fields = {0, 0, NULL, NULL};	// the fields of the current record
 	char *sptr;						// dynamically allocated buffer for whole file as a string
 	char *cptr;						// pointer to traverse the file string
 	
@@ -111,14 +110,19 @@ int read_rent_orig(args_struct in_args) {
 	}
 
 	while (fscanf(fpin, "%[^\r\n]\r\n", rec_str) != EOF) {
+		// split the record into its fields once
+		if((err = split_fields(rec_str, delim, &fields)) != OK) {
+			fprintf(fplog, "Error processing file %s: read_rent_orig(); field split\n", fname);
+			return err;
+		}
 		// get the input year
-		if((err = get_int_field(rec_str, delim, 1, &cpi_year[cpi_index])) != OK) {
+		if((err = get_int_fld(&fields, 1, &cpi_year[cpi_index])) != OK) {
 			fprintf(fplog, "Error processing file %s: read_rent_orig(); record=%i, column=1\n",
 					fname, num_cpi_years + 1);
 			return err;
 		}
 		// get the corresponding value
-		if((err = get_float_field(rec_str, delim, 2, &cpi_val[cpi_index++])) != OK) {
+		if((err = get_float_fld(&fields, 2, &cpi_val[cpi_index++])) != OK) {
 			fprintf(fplog, "Error processing file %s: read_rent_orig(); record=%i, column=2\n",
 					fname, num_cpi_years + 1);
 			return err;
@@ -181,30 +185,29 @@ int read_rent_orig(args_struct in_args) {
 	// this is the loop over the whole file
 	// this reads in and skips whitespace lines, rather than throwing an error, but doesn't count them as records 
 	while (*cptr) {
-		rec_index = 0;
-		is_newrec = 0;
-		// this is the loop over each record
-		while (*cptr) {
-			if (!is_newrec) {
-				if (*cptr == '\n') {
-					is_newrec = 1;
-				}
-			} else {
-				break;
-			}
-			// store the current character in the record string
-			rec_str[rec_index++] = *cptr++;
-		} // end while loop over record
-		rec_str[rec_index] = '\0';	// terminate the record string
+		// find the end of this record and terminate it in place in the file buffer
+		rec_ptr = cptr;
+		while (*cptr && *cptr != '\n') {
+			cptr++;
+		}
+		if (*cptr) {
+			*cptr++ = '\0';
+		}
 		
 		// process this record if it is not a header and it is not a blank record
-		rm_whitesp(temp_str, rec_str);
-		if (!(count_lines++ < nhead) && strlen(temp_str)) {
+		if (!(count_lines++ < nhead) && !is_blank(rec_ptr)) {
 			count_recs++;
+			
+			// split the record into its fields once
+			if((err = split_fields(rec_ptr, delim, &fields)) != OK) {
+				fprintf(fplog, "Error processing file %s: read_rent_orig(); record=%li, field split\n",
+						fname, count_recs);
+				return err;
+			}
 			// loop over the values and fill the array (skip the first two columns)
-			// note that field index starts at 1 for get_float_field
+			// note that field index starts at 1 for get_float_fld
 			for (j = 3; j <= ncols; j++) {
-				if((err = get_float_field(rec_str, delim, j, &rent_orig_aez[out_index++])) != OK) {
+				if((err = get_float_fld(&fields, j, &rent_orig_aez[out_index++])) != OK) {
 					fprintf(fplog, "Error processing file %s: read_rent_orig(); record=%li, column=%i\n",
 							fname, count_recs, j);
 					return err;
@@ -225,6 +228,7 @@ int read_rent_orig(args_struct in_args) {
 	} // end while loop over file
 	
 	free(sptr);
+	free_fields(&fields);
 	
 	if(count_recs != nrecords)
 	{
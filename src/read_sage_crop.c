@@ -44,7 +44,14 @@
 
  arguments:
  char *fname:	path and base filename for sage crop file to read
+ char *sagepath: the sage input directory, for unzipping
+ char *cropfilebase_sage: the sage crop base file name
  rinfo_struct raster_info:	raster info structure
+ float *harv_out: the harvest area grid to fill (km^2)
+ float *yield_out: the yield grid to fill (t/km^2)
+
+ the output grids are arguments so that crops can be read concurrently into separate buffers
+ the netcdf reads are serialized with the other netcdf readers
 
  return value:
  integer error code: OK = 0, otherwise a non-zero error code
@@ -76,7 +83,7 @@
 
 #include "moirai.h"
 
-int read_sage_crop(char *fname, char *sagepath, char *cropfilebase_sage, rinfo_struct raster_info) {
+int read_sage_crop(char *fname, char *sagepath, char *cropfilebase_sage, rinfo_struct raster_info, float *harv_out, float *yield_out) {
 
 	int i;
 	int nrows = 2160;				// num input lats
@@ -98,6 +105,7 @@ int read_sage_crop(char *fname, char *sagepath, char *cropfilebase_sage, rinfo_s
 	int ncid;						// netcdf file id
 	int ncvarid;					// variable id returned by nc_inq_varid()
 	int ncerr;						// error return value; 0 = ok
+	int err = OK;					// error return value
 	// char *varname = "cropdata";		// name of the variable to read
 	char varname[MAXCHAR];  // name of the variable to read
 	static size_t start_yield[] = {0, 1, 0, 0};		// start indices for yield
@@ -145,37 +153,34 @@ int read_sage_crop(char *fname, char *sagepath, char *cropfilebase_sage, rinfo_s
 	strcpy(lname, fname);
 	strcat(lname, sage_crop_nctag);
 
-	if ((ncerr = nc_open(lname, NC_NOWRITE, &ncid))) {
-		fprintf(fplog,"Failed to open %s for reading: read_sage_crop(); ncerr = %i\n", lname, ncerr);
-		return ERROR_FILE;
-	}
-
-  strcpy(varname,cropfilebase_sage);
-  strcat(varname,"Data");
-
-	if ((ncerr = nc_inq_varid(ncid, varname, &ncvarid))) {
-		fprintf(fplog,"Error %i when getting netcdf var id for %s: read_sage_crop()\n", ncerr, varname);
-		return ERROR_FILE;
-	}
-
-	if ((ncerr = nc_get_vara_float(ncid, ncvarid, start_yield, count, yield_in))) {
-		fprintf(fplog,"Error %i when reading netcdf var %s: read_sage_crop()\n", ncerr, varname);
-		return ERROR_FILE;
-	}
-
-	if ((ncerr = nc_get_vara_float(ncid, ncvarid, start_qual_yield, count, qual_yield))) {
-		fprintf(fplog,"Error %i when reading netcdf var %s: read_sage_crop()\n", ncerr, varname);
-		return ERROR_FILE;
-	}
-
-	if ((ncerr = nc_get_vara_float(ncid, ncvarid, start_harv, count, harvestarea_in))) {
-		fprintf(fplog,"Error %i when reading netcdf var %s: read_sage_crop()\n", ncerr, varname);
-		return ERROR_FILE;
-	}
-
-	if ((ncerr = nc_get_vara_float(ncid, ncvarid, start_qual_harv, count, qual_harv))) {
-		fprintf(fplog,"Error %i when reading netcdf var %s: read_sage_crop()\n", ncerr, varname);
-		return ERROR_FILE;
+	// the netcdf library is not thread safe, so only one thread reads at a time
+	err = OK;
+#pragma omp critical (netcdf_read)
+	{
+		if ((ncerr = nc_open(lname, NC_NOWRITE, &ncid))) {
+			fprintf(fplog,"Failed to open %s for reading: read_sage_crop(); ncerr = %i\n", lname, ncerr);
+			err = ERROR_FILE;
+		} else {
+			strcpy(varname,cropfilebase_sage);
+			strcat(varname,"Data");
+			
+			if ((ncerr = nc_inq_varid(ncid, varname, &ncvarid))) {
+				fprintf(fplog,"Error %i when getting netcdf var id for %s: read_sage_crop()\n", ncerr, varname);
+				err = ERROR_FILE;
+			} else if ((ncerr = nc_get_vara_float(ncid, ncvarid, start_yield, count, yield_out)) ||
+					   (ncerr = nc_get_vara_float(ncid, ncvarid, start_qual_yield, count, qual_yield)) ||
+					   (ncerr = nc_get_vara_float(ncid, ncvarid, start_harv, count, harv_out)) ||
+					   (ncerr = nc_get_vara_float(ncid, ncvarid, start_qual_harv, count, qual_harv))) {
+				fprintf(fplog,"Error %i when reading netcdf var %s: read_sage_crop()\n", ncerr, varname);
+				err = ERROR_FILE;
+			}
+			nc_close(ncid);
+		}
+	} // end critical netcdf_read
+	if (err != OK) {
+		free(qual_harv);
+		free(qual_yield);
+		return err;
 	}
 
 	// loop over all the data to convert the values to working units
@@ -184,39 +189,39 @@ int read_sage_crop(char *fname, char *sagepath, char *cropfilebase_sage, rinfo_s
 		// do harvested area first to calibrate the sage individual crop data to the sage physical crop area
 		// this applies the sage cropping fraction to the hyde physical cropland area
 		// convert land area fraction to km^2
-		if (harvestarea_in[i] == nodata) {
+		if (harv_out[i] == nodata) {
 			if (land_area_sage[i] == raster_info.land_area_sage_nodata) {
-				harvestarea_in[i] = NODATA;
+				harv_out[i] = NODATA;
 			} else {
-				harvestarea_in[i] = 0;
+				harv_out[i] = 0;
 			}
 		} else {
 			if (land_area_sage[i] == raster_info.land_area_sage_nodata) {
-				harvestarea_in[i] = 0;
+				harv_out[i] = 0;
 			} else {
 				// this threshold (1e-8) is the fraction corresponding to 1 m^2 if a cell has 100 km^2 of land area
 				//  (max sage cell land area is ~86 km^2)
 				// remove these very small values from processing
-				if (harvestarea_in[i] < harvest_thresh && harvestarea_in[i] != nodata && harvestarea_in[i] !=0) {
+				if (harv_out[i] < harvest_thresh && harv_out[i] != nodata && harv_out[i] !=0) {
 					//fprintf(fplog,"Warning: fraction in[%i] = %e < %f for crop %s: read_sage_crop()\n", i, harvestarea_in[i], , harvest_thresh, fname);
-					harvestarea_in[i] = 0;
+					harv_out[i] = 0;
 					// end if bad data then remove
 				} else if (qual_harv[i] != 0) {
 					if (cropland_area_sage[i] == raster_info.cropland_sage_nodata || cropland_area_sage[i] == 0) {
-						harvestarea_in[i] = 0;
+						harv_out[i] = 0;
 					} else {
 						// get the original harvestarea_in in km^2
-						temp_flt = harvestarea_in[i]  * land_area_sage[i];
+						temp_flt = harv_out[i]  * land_area_sage[i];
 						// now store adjusted harvestarea in km^2
 						// sage in harvested area fraction * sage land area / sage physical crop area * hyde physical crop area
-						harvestarea_in[i] = harvestarea_in[i]  * land_area_sage[i] / cropland_area_sage[i] * cropland_area[i];
+						harv_out[i] = harv_out[i]  * land_area_sage[i] / cropland_area_sage[i] * cropland_area[i];
 					}
-					if (qual_harv[i] == nodata && harvestarea_in[i] != 0) {
+					if (qual_harv[i] == nodata && harv_out[i] != 0) {
 						// this condition does not occur
-						fprintf(fplog,"Warning: qual_harv[%i] = nodata and fraction _in[%i] = %e for crop %s:  read_sage_crop()\n", i, i, harvestarea_in[i], fname);
+						fprintf(fplog,"Warning: qual_harv[%i] = nodata and fraction _in[%i] = %e for crop %s:  read_sage_crop()\n", i, i, harv_out[i], fname);
 					}
 				} else { // no valid harvest area
-					harvestarea_in[i] = 0;
+					harv_out[i] = 0;
 					if (qual_harv[i] == 0) {
 						// the in fraction is always zero where the quality flag is zero
 						//fprintf(fplog,"Warning: qual_harv[%i] = 0 and fraction in[%i] = %e for crop %s:  read_sage_crop()\n", i, i, harvestarea_in[i], fname);
@@ -226,36 +231,36 @@ int read_sage_crop(char *fname, char *sagepath, char *cropfilebase_sage, rinfo_s
 		}	// end if harvested area nodata else valid harevested area data
 		
 		// normalize this yield to the sage input production and the normalized harvested area
-		if (yield_in[i] == nodata) {
+		if (yield_out[i] == nodata) {
 			if (land_area_sage[i] == raster_info.land_area_sage_nodata) {
-				yield_in[i] = NODATA;
+				yield_out[i] = NODATA;
 			} else {
-				yield_in[i] = 0;
+				yield_out[i] = 0;
 			}
 		} else {
-			if (land_area_sage[i] == raster_info.land_area_sage_nodata || harvestarea_in[i] == nodata || harvestarea_in[i] == 0 || harvestarea_in[i] == NODATA) {
-				yield_in[i] = 0;
+			if (land_area_sage[i] == raster_info.land_area_sage_nodata || harv_out[i] == nodata || harv_out[i] == 0 || harv_out[i] == NODATA) {
+				yield_out[i] = 0;
 			} else {
 				// this treshold is  0.01 t / km^2, or 0.0001 t / ha, (min fao value is ~0.02 t / ha)
 				// abnormal values are usually on the order of 1e-19, which is unrealistic
 				// remove these abnormal values from processing
-				if (yield_in[i] < yield_thresh && yield_in[i] != nodata && yield_in[i] !=0) {
+				if (yield_out[i] < yield_thresh && yield_out[i] != nodata && yield_out[i] !=0) {
 					//fprintf(fplog,"Warning: yield_in[%i] = %e < %f t / ha for crop %s: read_sage_crop()\n", i, yield_in[i], yield_thresh, fname);
-					yield_in[i] = 0;
+					yield_out[i] = 0;
 					// end if bad data then remove
 				} else if (qual_yield[i] != 0) {
 					// convert yield to tonnes per km^2, calculate original production, then calculate normalized yield
-					yield_in[i] = yield_in[i] / HA2KMSQ * temp_flt / harvestarea_in[i];
-					if (qual_yield[i] == nodata && yield_in[i] != 0) {
+					yield_out[i] = yield_out[i] / HA2KMSQ * temp_flt / harv_out[i];
+					if (qual_yield[i] == nodata && yield_out[i] != 0) {
 						// this condition does not occur
-						fprintf(fplog,"Warning: qual_yield[%i] = nodata and yield_in[%i] = %e for crop %s:  read_sage_crop()\n", i, i, yield_in[i], fname);
+						fprintf(fplog,"Warning: qual_yield[%i] = nodata and yield_in[%i] = %e for crop %s:  read_sage_crop()\n", i, i, yield_out[i], fname);
 					}
 				} else { // no valid yield
-					yield_in[i] = 0;
-					if (qual_yield[i] == 0 && yield_in[i] != 0) {
+					yield_out[i] = 0;
+					if (qual_yield[i] == 0 && yield_out[i] != 0) {
 						// qual == 0 and yield == 0 does occur
 						// but qual ==0 and yield != 0 does not occur
-						fprintf(fplog,"Warning: qual_yield[%i] = 0 and yield_in[%i] = %e for crop %s:  read_sage_crop()\n", i, i, yield_in[i], fname);
+						fprintf(fplog,"Warning: qual_yield[%i] = 0 and yield_in[%i] = %e for crop %s:  read_sage_crop()\n", i, i, yield_out[i], fname);
 					}
 				} // end else no valid yield
 			}	// end if land area nodata else land area data
@@ -263,8 +268,6 @@ int read_sage_crop(char *fname, char *sagepath, char *cropfilebase_sage, rinfo_s
 		
 	}	// end for i loop over all grid cells
 
-	nc_close(ncid);
-
 	free(qual_harv);
 	free(qual_yield);
 
@@ -56,8 +56,7 @@ int read_soil_carbon(args_struct in_args, rinfo_struct *raster_info) {
     double xmax = 180.0;			// longitude max grid boundary
     double ymin = -90.0;			// latitude min grid boundary
     double ymax = 90.0;				// latitude max grid boundary
-    int rv_ind;
-    int i,j, k=0;
+    int j;
     int grid_ind;
     char fname[MAXCHAR];			// file name to open
     FILE *fpin;
@@ -99,21 +98,10 @@ int read_soil_carbon(args_struct in_args, rinfo_struct *raster_info) {
     char out_name10[] = "soil_carbon_max_crop.bil";       // file name for output diagnostics raster file
     char out_name11[] = "soil_carbon_crop_q1.bil";        // file name for output diagnostics raster file
     char out_name12[] = "soil_carbon_crop_q3.bil";        // file name for output diagnostics raster file
-    int scg_code = 186;         // fao code for serbia and montenegro
-    int srb_code = 272;         // fao code for serbia
-    int mne_code = 273;         // fao code for montenegro
-    int rv_value;           // current ref veg value
     int aez_val;            // current glu value
     int ctry_code;          // current fao country code
     int aez_ind;            // current glu index in ctry_aez_list[ctry_ind]
     int ctry_ind;           // current country index in ctry_aez_list
-    int cur_lt_cat;             // current land type category
-    int cur_lt_cat_ind;             // current land type category index
-    int memory_median=0;        // This is used to calculate memory to be allocated
-    int memory_min=0;           // This is used to calculate memory to be allocated 
-    int memory_max=0;           // This is used to calculate memory to be allocated
-    int memory_q1=0;            // This is used to calculate memory to be allocated 
-    int memory_q3=0;            // This is used to calculate memory to be allocated
     
     
     //This is just overwriting protected areas raster info. But does not matter as both arrays have similar domensions. 
@@ -772,10 +760,10 @@ int read_soil_carbon(args_struct in_args, rinfo_struct *raster_info) {
         return ERROR_FILE;
     } 
                 
-    //fprintf(stdout, "\nSuccessfully starting first for loop in read_soil_c  at %s\n", grid_ind,ctry_ind,aez_ind,cur_lt_cat_ind, get_systime());
-
-    //First loop to get the number of cells per array
-     for (j = 0; j < ncells ; j++){//for each cell
+    // load the carbon values for the valid hyde land cells that are mapped to a country and glu
+    // the carbon bucket arrays are sized and allocated in alloc_carbon_buckets()
+    // the soil carbon state arrays are stored by hyde land cell ordinal j, not by grid cell
+     for (j = 0; j < num_land_cells_hyde ; j++){//for each land cell
                //assign a grid index
                grid_ind = land_cells_hyde[j];                              
                //assign aez and country code
@@ -783,377 +771,20 @@ int read_soil_carbon(args_struct in_args, rinfo_struct *raster_info) {
                ctry_code = country_fao[grid_ind];
 
                if (aez_val != -9999) {
-            // get the fao country index
-            
-            ctry_ind = NOMATCH;
-            for (i = 0; i < NUM_FAO_CTRY; i++) {
-                if (countrycodes_fao[i] == ctry_code) {
-                    ctry_ind = i;
-                    break;
-                }
-            } // end for i loop to get ctry index
-            
-
-             // merge serbia and montenegro for scg record
-            if (ctry_code == mne_code || ctry_code == srb_code) {
-                ctry_code = scg_code;
-                ctry_ind = NOMATCH;
-                for (i = 0; i < NUM_FAO_CTRY; i++) {
-                    if (countrycodes_fao[i] == ctry_code) {
-                        ctry_ind = i;
-                        break;
-                    }
-                }
-                if (ctry_ind == NOMATCH) {
-                    // this should never happen
-                    fprintf(fplog, "Error finding scg ctry index: proc_refveg_carbon()\n");
-                    return ERROR_IND;
-                }
-            } // end if serbia or montenegro
-            
+            // get the fao country index (serbia and montenegro are merged into scg) from the index raster
+            ctry_ind = cell_ctry_ind[grid_ind];
 
-           
             if (ctry_ind == NOMATCH || ctry2ctry87codes_gtap[ctry_ind] == NOMATCH) {
 				continue;
 			}
-
-            aez_ind = NOMATCH;
-            for (i = 0; i < ctry_aez_num[ctry_ind]; i++) {
-                if (ctry_aez_list[ctry_ind][i] == aez_val) {
-                    aez_ind = i;
-                    break;
-                }
-            }// end for i loop to get aez index
+            
+            // get the glu index within the country glu list from the index raster
+            aez_ind = cell_aez_ind[grid_ind];
             if (aez_ind == NOMATCH) {
                 fprintf(fplog, "Failed to match aez %i to country %i: proc_refveg_carbon()\n",aez_val,ctry_code);
                 return ERROR_IND;
             }
 
-            // get index of sage pot veg; set value to 0 if unknown
-            rv_ind = NOMATCH;
-            for (i = 0; i < NUM_SAGE_PVLT; i++) {
-                if (refvegcarbon_thematic[grid_ind] == landtypecodes_sage[i]) {
-                    rv_ind = i;
-                    break;
-                }
-            }
-			// set the c values for this cell; use existing variables
-            if (rv_ind == NOMATCH) {
-                rv_value = 0;
-				}else {
-                rv_value = refvegcarbon_thematic[grid_ind];
-				
-            }
-
-            for (k=0; k< NUM_EPA_PROTECTED; k++){
-				// get index of land category
-				
-                //START with allocation for unamanged land 
-                cur_lt_cat = rv_value * SCALE_POTVEG + k;
-				cur_lt_cat_ind = NOMATCH;
-				for (i = 0; i < num_lt_cats; i++) {
-					if (lt_cats[i] == cur_lt_cat) {
-						cur_lt_cat_ind = i;
-						break;
-					}
-				}
-				if (cur_lt_cat_ind == NOMATCH) {
-					fprintf(fplog, "Failed to match lt_cat %i: proc_refveg_carbon()\n", cur_lt_cat);
-					return ERROR_IND;
-				}
-				
-                //assign the actual soil carbon numbers
-               // Don't assign a value if the value is a NODATA value. 
-               
-				//unmanaged
-                
-
-                //calculate the number of cells to hold within each array
-                
-                soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind]= soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind]+ 1; 
-                
-             
-             //Convert this to an integer
-              memory_median = (float) floor((double) 0.5+ soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind]);
-              memory_min = (float) floor((double) 0.5+  soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind]);
-              memory_max = (float) floor((double) 0.5+  soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind]);
-              memory_q1 = (float) floor((double) 0.5+ soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind]);
-              memory_q3 = (float) floor((double) 0.5+ soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind]);   
-               
-                
-                //use the calculated number of cells to allocate memory for the soil_carbon_array. The number of cells won't change for veg_carbon so allocate the size of that array here as well. 
-                //Don't allocate 0 memory. If size is 0, then keep size at 1. This reduces problems during the free() calls later
-                if(memory_median>0){
-                
-                free(soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][0]);  
-                soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][0]=calloc(memory_median,sizeof(float));
-                
-                free(soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][1]);  
-                soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][1]=calloc(memory_median,sizeof(float));
-            
-                free(soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][2]);
-                soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][2]=calloc(memory_min,sizeof(float));
-            
-                free(soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][3]);
-                soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][3]=calloc(memory_max,sizeof(float));
-            
-                free(soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][4]);
-                soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][4]=calloc(memory_q1,sizeof(float));
-            
-                free(soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][5]);
-                soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][5]=calloc(memory_q3,sizeof(float));
-
-                free(veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][0]);  
-                veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][0]=calloc(memory_median,sizeof(float));
-
-                free(veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][1]);  
-                veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][1]=calloc(memory_median,sizeof(float));
-            
-                free(veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][2]);
-                veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][2]=calloc(memory_min,sizeof(float));
-            
-                free(veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][3]);
-                veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][3]=calloc(memory_max,sizeof(float));
-            
-                free(veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][4]);
-                veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][4]=calloc(memory_q1,sizeof(float));
-            
-                free(veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][5]);
-                veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][5]=calloc(memory_q3,sizeof(float));
-                }
-            
-
-            //Now do allocation for cropland 
-                cur_lt_cat = rv_value * SCALE_POTVEG + CROP_LT_CODE + k;
-				cur_lt_cat_ind = NOMATCH;
-				for (i = 0; i < num_lt_cats; i++) {
-					if (lt_cats[i] == cur_lt_cat) {
-						cur_lt_cat_ind = i;
-						break;
-					}
-				}
-				if (cur_lt_cat_ind == NOMATCH) {
-					fprintf(fplog, "Failed to match lt_cat %i: proc_refveg_carbon()\n", cur_lt_cat);
-					return ERROR_IND;
-				}
-				
-                //assign the actual soil carbon numbers
-               // Don't assign a value if the value is a NODATA value. 
-               
-				//unmanaged
-                
-
-                //calculate the number of cells to hold within each array
-                
-                soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind]= soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind]+ 1; 
-                
-             
-             //Convert this to an integer
-              memory_median = (float) floor((double) 0.5+ soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind]);
-              memory_min = (float) floor((double) 0.5+  soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind]);
-              memory_max = (float) floor((double) 0.5+  soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind]);
-              memory_q1 = (float) floor((double) 0.5+ soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind]);
-              memory_q3 = (float) floor((double) 0.5+ soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind]);   
-               
-                
-                //use the calculated number of cells to allocate memory for the soil_carbon_array. The number of cells won't change for veg_carbon so allocate the size of that array here as well. 
-                //Don't allocate 0 memory. If size is 0, then keep size at 1. This reduces problems during the free() calls later
-                if(memory_median>0){
-                
-                free(soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][0]);  
-                soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][0]=calloc(memory_median,sizeof(float));
-                
-                free(soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][1]);  
-                soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][1]=calloc(memory_median,sizeof(float));
-            
-                free(soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][2]);
-                soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][2]=calloc(memory_min,sizeof(float));
-            
-                free(soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][3]);
-                soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][3]=calloc(memory_max,sizeof(float));
-            
-                free(soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][4]);
-                soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][4]=calloc(memory_q1,sizeof(float));
-            
-                free(soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][5]);
-                soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][5]=calloc(memory_q3,sizeof(float));
-
-                free(veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][0]);  
-                veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][0]=calloc(memory_median,sizeof(float));
-
-                free(veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][1]);  
-                veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][1]=calloc(memory_median,sizeof(float));
-            
-                free(veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][2]);
-                veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][2]=calloc(memory_min,sizeof(float));
-            
-                free(veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][3]);
-                veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][3]=calloc(memory_max,sizeof(float));
-            
-                free(veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][4]);
-                veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][4]=calloc(memory_q1,sizeof(float));
-            
-                free(veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][5]);
-                veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][5]=calloc(memory_q3,sizeof(float));
-                }
-
-                //Now do allocation for pasture 
-                cur_lt_cat = rv_value * SCALE_POTVEG + PASTURE_LT_CODE + k;
-				cur_lt_cat_ind = NOMATCH;
-				for (i = 0; i < num_lt_cats; i++) {
-					if (lt_cats[i] == cur_lt_cat) {
-						cur_lt_cat_ind = i;
-						break;
-					}
-				}
-				if (cur_lt_cat_ind == NOMATCH) {
-					fprintf(fplog, "Failed to match lt_cat %i: proc_refveg_carbon()\n", cur_lt_cat);
-					return ERROR_IND;
-				}
-				
-                //assign the actual soil carbon numbers
-               // Don't assign a value if the value is a NODATA value. 
-               
-				//unmanaged
-                
-
-                //calculate the number of cells to hold within each array
-                
-                soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind]= soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind]+ 1; 
-                
-             
-             //Convert this to an integer
-              memory_median = (float) floor((double) 0.5+ soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind]);
-              memory_min = (float) floor((double) 0.5+  soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind]);
-              memory_max = (float) floor((double) 0.5+  soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind]);
-              memory_q1 = (float) floor((double) 0.5+ soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind]);
-              memory_q3 = (float) floor((double) 0.5+ soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind]);   
-               
-                
-                //use the calculated number of cells to allocate memory for the soil_carbon_array. The number of cells won't change for veg_carbon so allocate the size of that array here as well. 
-                //Don't allocate 0 memory. If size is 0, then keep size at 1. This reduces problems during the free() calls later
-                if(memory_median>0){
-                
-                free(soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][0]);  
-                soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][0]=calloc(memory_median,sizeof(float));
-                
-                free(soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][1]);  
-                soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][1]=calloc(memory_median,sizeof(float));
-            
-                free(soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][2]);
-                soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][2]=calloc(memory_min,sizeof(float));
-            
-                free(soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][3]);
-                soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][3]=calloc(memory_max,sizeof(float));
-            
-                free(soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][4]);
-                soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][4]=calloc(memory_q1,sizeof(float));
-            
-                free(soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][5]);
-                soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][5]=calloc(memory_q3,sizeof(float));
-
-                free(veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][0]);  
-                veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][0]=calloc(memory_median,sizeof(float));
-
-                free(veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][1]);  
-                veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][1]=calloc(memory_median,sizeof(float));
-            
-                free(veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][2]);
-                veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][2]=calloc(memory_min,sizeof(float));
-            
-                free(veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][3]);
-                veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][3]=calloc(memory_max,sizeof(float));
-            
-                free(veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][4]);
-                veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][4]=calloc(memory_q1,sizeof(float));
-            
-                free(veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][5]);
-                veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][5]=calloc(memory_q3,sizeof(float));
-                }
-
-                //Now do allocation for Unmanaged land 
-                cur_lt_cat = rv_value * SCALE_POTVEG + URBAN_LT_CODE + k;
-				cur_lt_cat_ind = NOMATCH;
-				for (i = 0; i < num_lt_cats; i++) {
-					if (lt_cats[i] == cur_lt_cat) {
-						cur_lt_cat_ind = i;
-						break;
-					}
-				}
-				if (cur_lt_cat_ind == NOMATCH) {
-					fprintf(fplog, "Failed to match lt_cat %i: proc_refveg_carbon()\n", cur_lt_cat);
-					return ERROR_IND;
-				}
-				
-                //assign the actual soil carbon numbers
-               // Don't assign a value if the value is a NODATA value. 
-               
-				//unmanaged
-                
-
-                //calculate the number of cells to hold within each array
-                
-                soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind]= soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind]+ 1; 
-                
-             
-             //Convert this to an integer
-              memory_median = (float) floor((double) 0.5+ soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind]);
-              memory_min = (float) floor((double) 0.5+  soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind]);
-              memory_max = (float) floor((double) 0.5+  soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind]);
-              memory_q1 = (float) floor((double) 0.5+ soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind]);
-              memory_q3 = (float) floor((double) 0.5+ soil_carbon_array_cells[ctry_ind][aez_ind][cur_lt_cat_ind]);   
-               
-                
-                //use the calculated number of cells to allocate memory for the soil_carbon_array. The number of cells won't change for veg_carbon so allocate the size of that array here as well. 
-                //Don't allocate 0 memory. If size is 0, then keep size at 1. This reduces problems during the free() calls later
-                if(memory_median>0){
-                
-                free(soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][0]);  
-                soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][0]=calloc(memory_median,sizeof(float));
-                
-                free(soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][1]);  
-                soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][1]=calloc(memory_median,sizeof(float));
-            
-                free(soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][2]);
-                soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][2]=calloc(memory_min,sizeof(float));
-            
-                free(soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][3]);
-                soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][3]=calloc(memory_max,sizeof(float));
-            
-                free(soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][4]);
-                soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][4]=calloc(memory_q1,sizeof(float));
-            
-                free(soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][5]);
-                soil_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][5]=calloc(memory_q3,sizeof(float));
-
-                free(veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][0]);  
-                veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][0]=calloc(memory_median,sizeof(float));
-
-                free(veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][1]);  
-                veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][1]=calloc(memory_median,sizeof(float));
-            
-                free(veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][2]);
-                veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][2]=calloc(memory_min,sizeof(float));
-            
-                free(veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][3]);
-                veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][3]=calloc(memory_max,sizeof(float));
-            
-                free(veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][4]);
-                veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][4]=calloc(memory_q1,sizeof(float));
-            
-                free(veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][5]);
-                veg_carbon_array[ctry_ind][aez_ind][cur_lt_cat_ind][5]=calloc(memory_q3,sizeof(float));
-                }
-           
-
-
-
-
-            
-
-
-
-            }//finish loop for protected areas
         }//finish loop for aez
     
     
@@ -1161,81 +792,81 @@ int read_soil_carbon(args_struct in_args, rinfo_struct *raster_info) {
 
             if( wavg_array[grid_ind] < 0){
                 
-                soil_carbon_sage[0][grid_ind]= NODATA;
-                soil_carbon_sage[1][grid_ind]= NODATA;
-                soil_carbon_sage[2][grid_ind]= NODATA;
-                soil_carbon_sage[3][grid_ind]= NODATA;
-                soil_carbon_sage[4][grid_ind]= NODATA;
-                soil_carbon_sage[5][grid_ind]= NODATA;
+                soil_carbon_sage[0][j]= NODATA;
+                soil_carbon_sage[1][j]= NODATA;
+                soil_carbon_sage[2][j]= NODATA;
+                soil_carbon_sage[3][j]= NODATA;
+                soil_carbon_sage[4][j]= NODATA;
+                soil_carbon_sage[5][j]= NODATA;
                 
                 }else{
 
-                soil_carbon_sage[0][grid_ind]=wavg_array[grid_ind];
-                soil_carbon_sage[1][grid_ind]=median_array[grid_ind];
-                soil_carbon_sage[2][grid_ind]=min_array[grid_ind];
-                soil_carbon_sage[3][grid_ind]=max_array[grid_ind];
-                soil_carbon_sage[4][grid_ind]=q1_array[grid_ind];
-                soil_carbon_sage[5][grid_ind]=q3_array[grid_ind];    
+                soil_carbon_sage[0][j]=wavg_array[grid_ind];
+                soil_carbon_sage[1][j]=median_array[grid_ind];
+                soil_carbon_sage[2][j]=min_array[grid_ind];
+                soil_carbon_sage[3][j]=max_array[grid_ind];
+                soil_carbon_sage[4][j]=q1_array[grid_ind];
+                soil_carbon_sage[5][j]=q3_array[grid_ind];    
 				
                 }
 				//cropland
 				if( wavg_crop_array[grid_ind] < 0){
                 
-                soil_carbon_crop_sage[0][grid_ind]= NODATA;
-                soil_carbon_crop_sage[1][grid_ind]= NODATA;
-                soil_carbon_crop_sage[2][grid_ind]= NODATA;
-                soil_carbon_crop_sage[3][grid_ind]= NODATA;
-                soil_carbon_crop_sage[4][grid_ind]= NODATA;
-                soil_carbon_crop_sage[5][grid_ind]= NODATA;
+                soil_carbon_crop_sage[0][j]= NODATA;
+                soil_carbon_crop_sage[1][j]= NODATA;
+                soil_carbon_crop_sage[2][j]= NODATA;
+                soil_carbon_crop_sage[3][j]= NODATA;
+                soil_carbon_crop_sage[4][j]= NODATA;
+                soil_carbon_crop_sage[5][j]= NODATA;
                 
                 }else{
 
-                soil_carbon_crop_sage[0][grid_ind]=wavg_crop_array[grid_ind];
-                soil_carbon_crop_sage[1][grid_ind]=median_crop_array[grid_ind];
-                soil_carbon_crop_sage[2][grid_ind]=min_crop_array[grid_ind];
-                soil_carbon_crop_sage[3][grid_ind]=max_crop_array[grid_ind];
-                soil_carbon_crop_sage[4][grid_ind]=q1_crop_array[grid_ind];
-                soil_carbon_crop_sage[5][grid_ind]=q3_crop_array[grid_ind];    
+                soil_carbon_crop_sage[0][j]=wavg_crop_array[grid_ind];
+                soil_carbon_crop_sage[1][j]=median_crop_array[grid_ind];
+                soil_carbon_crop_sage[2][j]=min_crop_array[grid_ind];
+                soil_carbon_crop_sage[3][j]=max_crop_array[grid_ind];
+                soil_carbon_crop_sage[4][j]=q1_crop_array[grid_ind];
+                soil_carbon_crop_sage[5][j]=q3_crop_array[grid_ind];    
 				
                 }
 				//pasture
 				if( wavg_pasture_array[grid_ind] < 0){
                 
-                soil_carbon_pasture_sage[0][grid_ind]= NODATA;
-                soil_carbon_pasture_sage[1][grid_ind]= NODATA;
-                soil_carbon_pasture_sage[2][grid_ind]= NODATA;
-                soil_carbon_pasture_sage[3][grid_ind]= NODATA;
-                soil_carbon_pasture_sage[4][grid_ind]= NODATA;
-                soil_carbon_pasture_sage[5][grid_ind]= NODATA;
+                soil_carbon_pasture_sage[0][j]= NODATA;
+                soil_carbon_pasture_sage[1][j]= NODATA;
+                soil_carbon_pasture_sage[2][j]= NODATA;
+                soil_carbon_pasture_sage[3][j]= NODATA;
+                soil_carbon_pasture_sage[4][j]= NODATA;
+                soil_carbon_pasture_sage[5][j]= NODATA;
                 
                 }else{
 
-                soil_carbon_pasture_sage[0][grid_ind]=wavg_pasture_array[grid_ind];
-                soil_carbon_pasture_sage[1][grid_ind]=median_pasture_array[grid_ind];
-                soil_carbon_pasture_sage[2][grid_ind]=min_pasture_array[grid_ind];
-                soil_carbon_pasture_sage[3][grid_ind]=max_pasture_array[grid_ind];
-                soil_carbon_pasture_sage[4][grid_ind]=q1_pasture_array[grid_ind];
-                soil_carbon_pasture_sage[5][grid_ind]=q3_pasture_array[grid_ind];    
+                soil_carbon_pasture_sage[0][j]=wavg_pasture_array[grid_ind];
+                soil_carbon_pasture_sage[1][j]=median_pasture_array[grid_ind];
+                soil_carbon_pasture_sage[2][j]=min_pasture_array[grid_ind];
+                soil_carbon_pasture_sage[3][j]=max_pasture_array[grid_ind];
+                soil_carbon_pasture_sage[4][j]=q1_pasture_array[grid_ind];
+                soil_carbon_pasture_sage[5][j]=q3_pasture_array[grid_ind];    
 				
                 }
 				//urban
 				if( wavg_urban_array[grid_ind] < 0){
                 
-                soil_carbon_urban_sage[0][grid_ind]= NODATA;
-                soil_carbon_urban_sage[1][grid_ind]= NODATA;
-                soil_carbon_urban_sage[2][grid_ind]= NODATA;
-                soil_carbon_urban_sage[3][grid_ind]= NODATA;
-                soil_carbon_urban_sage[4][grid_ind]= NODATA;
-                soil_carbon_urban_sage[5][grid_ind]= NODATA;
+                soil_carbon_urban_sage[0][j]= NODATA;
+                soil_carbon_urban_sage[1][j]= NODATA;
+                soil_carbon_urban_sage[2][j]= NODATA;
+                soil_carbon_urban_sage[3][j]= NODATA;
+                soil_carbon_urban_sage[4][j]= NODATA;
+                soil_carbon_urban_sage[5][j]= NODATA;
                 
                 }else{
 
-                soil_carbon_urban_sage[0][grid_ind]=wavg_urban_array[grid_ind];
-                soil_carbon_urban_sage[1][grid_ind]=median_urban_array[grid_ind];
-                soil_carbon_urban_sage[2][grid_ind]=min_urban_array[grid_ind];
-                soil_carbon_urban_sage[3][grid_ind]=max_urban_array[grid_ind];
-                soil_carbon_urban_sage[4][grid_ind]=q1_urban_array[grid_ind];
-                soil_carbon_urban_sage[5][grid_ind]=q3_urban_array[grid_ind];    
+                soil_carbon_urban_sage[0][j]=wavg_urban_array[grid_ind];
+                soil_carbon_urban_sage[1][j]=median_urban_array[grid_ind];
+                soil_carbon_urban_sage[2][j]=min_urban_array[grid_ind];
+                soil_carbon_urban_sage[3][j]=max_urban_array[grid_ind];
+                soil_carbon_urban_sage[4][j]=q1_urban_array[grid_ind];
+                soil_carbon_urban_sage[5][j]=q3_urban_array[grid_ind];    
 				
                 }
     
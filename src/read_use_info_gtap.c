@@ -56,6 +56,7 @@ int read_use_info_gtap(args_struct in_args) {
 	char rec_str[MAXRECSIZE];		// string to hold one record
 	const char* delim = ",";		// delimiter string for csv file
 	int err = OK;					// error code for the string parsing function
+	fields_struct fields = {0, 0, NULL, NULL};	// the fields of the current record
 	int out_index = 0;				// the index of the gtap use arrays to fill
 	
 	// create file name and open it
@@ -124,21 +125,26 @@ int read_use_info_gtap(args_struct in_args) {
 	// read all the records
 	for (i = 0; i < NUM_GTAP_USE; i++) {
 		if (fscanf(fpin, "%[^\r\n]\r\n", rec_str) != EOF) {
+			// split the record into its fields once
+			if((err = split_fields(rec_str, delim, &fields)) != OK) {
+				fprintf(fplog, "Error processing file %s: read_use_info_gtap(); field split\n", fname);
+				return err;
+			}
 			
 			// get the integer code
-			if((err = get_int_field(rec_str, delim, 1, &usecodes_gtap[out_index])) != OK) {
+			if((err = get_int_fld(&fields, 1, &usecodes_gtap[out_index])) != OK) {
 				fprintf(fplog, "Error processing file %s: read_use_info_gtap(); record=%i, column=1\n",
 						fname, i + 1);
 				return err;
 			}
 			// get the abbreviation (name)
-			if((err = get_text_field(rec_str, delim, 2, &usenames_gtap[out_index][0])) != OK) {
+			if((err = get_text_fld(&fields, 2, &usenames_gtap[out_index][0])) != OK) {
 				fprintf(fplog, "Error processing file %s: read_use_info_gtap(); record=%i, column=2\n",
 						fname, i + 1);
 				return err;
 			}
 			// get the description
-			if((err = get_text_field(rec_str, delim, 3, &usedescr_gtap[out_index++][0])) != OK) {
+			if((err = get_text_fld(&fields, 3, &usedescr_gtap[out_index++][0])) != OK) {
 				fprintf(fplog, "Error processing file %s: read_use_info_gtap(); record=%i, column=3\n",
 						fname, i + 1);
 				return err;
@@ -176,4 +182,5 @@ int read_use_info_gtap(args_struct in_args) {
 		}
 	}	// end if diagnostics
 	
+	free_fields(&fields);
 	return OK;}
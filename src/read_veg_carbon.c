@@ -55,7 +55,7 @@ int read_veg_carbon(args_struct in_args, rinfo_struct *raster_info) {
     double ymin = -90.0;			// latitude min grid boundary
     double ymax = 90.0;				// latitude max grid boundary
     
-    int i;
+    int i, j;
     char fname[MAXCHAR];			// file name to open
     
     FILE *fpin;
@@ -1429,74 +1429,76 @@ int read_veg_carbon(args_struct in_args, rinfo_struct *raster_info) {
 
 
       //kbn calc category data from input arrays
-    for (i = 0; i < ncells; i++) {
+    // the veg carbon state and ratio arrays are stored by hyde land cell ordinal j, not by grid cell
+    for (j = 0; j < num_land_cells_hyde; j++) {
+        i = land_cells_hyde[j];
         //above ground +below ground * scaling factor (0.1)
         //TODO: based on feedback, we may want to write out above and below ground biomass separately. Currently we aggegate the two for speed. 
         // First, check if we have only below ground data
         if(wavg_array[i] == NODATA && wavg_bg_array[i] != NODATA ){
-        veg_carbon_sage[0][i] = (wavg_bg_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_sage[1][i] = (median_bg_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_sage[2][i] = (min_bg_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_sage[3][i] = (max_bg_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_sage[4][i] = (q1_bg_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_sage[5][i] = (q3_bg_array[i])*VEG_CARBON_SCALER;
-
-        above_ground_ratio[0][i] = 0;
-        above_ground_ratio[1][i] = 0;
-        above_ground_ratio[2][i] = 0;
-        above_ground_ratio[3][i] = 0;
-        above_ground_ratio[4][i] = 0;
-        above_ground_ratio[5][i] = 0;
+        veg_carbon_sage[0][j] = (wavg_bg_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_sage[1][j] = (median_bg_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_sage[2][j] = (min_bg_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_sage[3][j] = (max_bg_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_sage[4][j] = (q1_bg_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_sage[5][j] = (q3_bg_array[i])*VEG_CARBON_SCALER;
+
+        above_ground_ratio[0][j] = 0;
+        above_ground_ratio[1][j] = 0;
+        above_ground_ratio[2][j] = 0;
+        above_ground_ratio[3][j] = 0;
+        above_ground_ratio[4][j] = 0;
+        above_ground_ratio[5][j] = 0;
        
 
         // Now, check if we have only above ground data
         }else if(wavg_bg_array[i] == NODATA && wavg_array[i] != NODATA){
-        veg_carbon_sage[0][i] = (wavg_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_sage[1][i] = (median_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_sage[2][i] = (min_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_sage[3][i] = (max_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_sage[4][i] = (q1_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_sage[5][i] = (q3_array[i])*VEG_CARBON_SCALER;
-
-        above_ground_ratio[0][i] = 1;
-        above_ground_ratio[1][i] = 1;
-        above_ground_ratio[2][i] = 1;
-        above_ground_ratio[3][i] = 1;
-        above_ground_ratio[4][i] = 1;
-        above_ground_ratio[5][i] = 1;
+        veg_carbon_sage[0][j] = (wavg_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_sage[1][j] = (median_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_sage[2][j] = (min_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_sage[3][j] = (max_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_sage[4][j] = (q1_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_sage[5][j] = (q3_array[i])*VEG_CARBON_SCALER;
+
+        above_ground_ratio[0][j] = 1;
+        above_ground_ratio[1][j] = 1;
+        above_ground_ratio[2][j] = 1;
+        above_ground_ratio[3][j] = 1;
+        above_ground_ratio[4][j] = 1;
+        above_ground_ratio[5][j] = 1;
         
         //Now, check if we don't have both. Assume that the ratio is 0.5. It won't be used in the actual processing.
         }else if(wavg_bg_array[i] == NODATA && wavg_array[i] == NODATA){
-        veg_carbon_sage[0][i] = -9999;
-        veg_carbon_sage[1][i] = -9999;
-        veg_carbon_sage[2][i] = -9999;
-        veg_carbon_sage[3][i] = -9999;
-        veg_carbon_sage[4][i] = -9999;
-        veg_carbon_sage[5][i] = -9999;
-
-        above_ground_ratio[0][i] = 0.5;
-        above_ground_ratio[1][i] = 0.5;
-        above_ground_ratio[2][i] = 0.5;
-        above_ground_ratio[3][i] = 0.5;
-        above_ground_ratio[4][i] = 0.5;
-        above_ground_ratio[5][i] = 0.5;
+        veg_carbon_sage[0][j] = -9999;
+        veg_carbon_sage[1][j] = -9999;
+        veg_carbon_sage[2][j] = -9999;
+        veg_carbon_sage[3][j] = -9999;
+        veg_carbon_sage[4][j] = -9999;
+        veg_carbon_sage[5][j] = -9999;
+
+        above_ground_ratio[0][j] = 0.5;
+        above_ground_ratio[1][j] = 0.5;
+        above_ground_ratio[2][j] = 0.5;
+        above_ground_ratio[3][j] = 0.5;
+        above_ground_ratio[4][j] = 0.5;
+        above_ground_ratio[5][j] = 0.5;
         
 
         //Now, if we have both data,
         }else{
-        veg_carbon_sage[0][i] = (wavg_array[i]+wavg_bg_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_sage[1][i] = (median_array[i]+median_bg_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_sage[2][i] = (min_array[i]+min_bg_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_sage[3][i] = (max_array[i]+max_bg_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_sage[4][i] = (q1_array[i]+q1_bg_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_sage[5][i] = (q3_array[i]+q3_bg_array[i])*VEG_CARBON_SCALER;
-
-        above_ground_ratio[0][i] = wavg_array[i]/((wavg_array[i]+wavg_bg_array[i]));
-        above_ground_ratio[1][i] = median_array[i]/((median_array[i]+median_bg_array[i]));
-        above_ground_ratio[2][i] = min_array[i]/((min_array[i]+min_bg_array[i]));
-        above_ground_ratio[3][i] = max_array[i]/((max_array[i]+max_bg_array[i]));
-        above_ground_ratio[4][i] = q1_array[i]/((q1_array[i]+q1_bg_array[i]));
-        above_ground_ratio[5][i] = q3_array[i]/((q3_array[i]+q3_bg_array[i]));
+        veg_carbon_sage[0][j] = (wavg_array[i]+wavg_bg_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_sage[1][j] = (median_array[i]+median_bg_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_sage[2][j] = (min_array[i]+min_bg_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_sage[3][j] = (max_array[i]+max_bg_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_sage[4][j] = (q1_array[i]+q1_bg_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_sage[5][j] = (q3_array[i]+q3_bg_array[i])*VEG_CARBON_SCALER;
+
+        above_ground_ratio[0][j] = wavg_array[i]/((wavg_array[i]+wavg_bg_array[i]));
+        above_ground_ratio[1][j] = median_array[i]/((median_array[i]+median_bg_array[i]));
+        above_ground_ratio[2][j] = min_array[i]/((min_array[i]+min_bg_array[i]));
+        above_ground_ratio[3][j] = max_array[i]/((max_array[i]+max_bg_array[i]));
+        above_ground_ratio[4][j] = q1_array[i]/((q1_array[i]+q1_bg_array[i]));
+        above_ground_ratio[5][j] = q3_array[i]/((q3_array[i]+q3_bg_array[i]));
         }
 
 
@@ -1504,155 +1506,155 @@ int read_veg_carbon(args_struct in_args, rinfo_struct *raster_info) {
         
         
         //Below ground should be 1 - above ground.
-        below_ground_ratio[0][i] = 1 - above_ground_ratio[0][i];  
-        below_ground_ratio[1][i] = 1 - above_ground_ratio[1][i];
-        below_ground_ratio[2][i] = 1 - above_ground_ratio[2][i];
-        below_ground_ratio[3][i] = 1 - above_ground_ratio[3][i];
-        below_ground_ratio[4][i] = 1 - above_ground_ratio[4][i];
-        below_ground_ratio[5][i] = 1 - above_ground_ratio[5][i];
+        below_ground_ratio[0][j] = 1 - above_ground_ratio[0][j];  
+        below_ground_ratio[1][j] = 1 - above_ground_ratio[1][j];
+        below_ground_ratio[2][j] = 1 - above_ground_ratio[2][j];
+        below_ground_ratio[3][j] = 1 - above_ground_ratio[3][j];
+        below_ground_ratio[4][j] = 1 - above_ground_ratio[4][j];
+        below_ground_ratio[5][j] = 1 - above_ground_ratio[5][j];
 
         /// Above was for unmanaged. Repeat calculations for Crop
         if(wavg_crop_array[i] == NODATA && wavg_bg_crop_array[i] != NODATA ){
-        veg_carbon_crop_sage[0][i] = (wavg_bg_crop_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_crop_sage[1][i] = (median_bg_crop_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_crop_sage[2][i] = (min_bg_crop_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_crop_sage[3][i] = (max_bg_crop_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_crop_sage[4][i] = (q1_bg_crop_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_crop_sage[5][i] = (q3_bg_crop_array[i])*VEG_CARBON_SCALER;
-
-        above_ground_ratio_crop[0][i] = 0;
-        above_ground_ratio_crop[1][i] = 0;
-        above_ground_ratio_crop[2][i] = 0;
-        above_ground_ratio_crop[3][i] = 0;
-        above_ground_ratio_crop[4][i] = 0;
-        above_ground_ratio_crop[5][i] = 0;
+        veg_carbon_crop_sage[0][j] = (wavg_bg_crop_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_crop_sage[1][j] = (median_bg_crop_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_crop_sage[2][j] = (min_bg_crop_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_crop_sage[3][j] = (max_bg_crop_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_crop_sage[4][j] = (q1_bg_crop_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_crop_sage[5][j] = (q3_bg_crop_array[i])*VEG_CARBON_SCALER;
+
+        above_ground_ratio_crop[0][j] = 0;
+        above_ground_ratio_crop[1][j] = 0;
+        above_ground_ratio_crop[2][j] = 0;
+        above_ground_ratio_crop[3][j] = 0;
+        above_ground_ratio_crop[4][j] = 0;
+        above_ground_ratio_crop[5][j] = 0;
        
 
         // Now, check if we have only above ground data
         }else if(wavg_bg_crop_array[i] == NODATA && wavg_crop_array[i] != NODATA){
-        veg_carbon_crop_sage[0][i] = (wavg_crop_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_crop_sage[1][i] = (median_crop_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_crop_sage[2][i] = (min_crop_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_crop_sage[3][i] = (max_crop_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_crop_sage[4][i] = (q1_crop_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_crop_sage[5][i] = (q3_crop_array[i])*VEG_CARBON_SCALER;
-
-        above_ground_ratio_crop[0][i] = 1;
-        above_ground_ratio_crop[1][i] = 1;
-        above_ground_ratio_crop[2][i] = 1;
-        above_ground_ratio_crop[3][i] = 1;
-        above_ground_ratio_crop[4][i] = 1;
-        above_ground_ratio_crop[5][i] = 1;
+        veg_carbon_crop_sage[0][j] = (wavg_crop_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_crop_sage[1][j] = (median_crop_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_crop_sage[2][j] = (min_crop_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_crop_sage[3][j] = (max_crop_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_crop_sage[4][j] = (q1_crop_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_crop_sage[5][j] = (q3_crop_array[i])*VEG_CARBON_SCALER;
+
+        above_ground_ratio_crop[0][j] = 1;
+        above_ground_ratio_crop[1][j] = 1;
+        above_ground_ratio_crop[2][j] = 1;
+        above_ground_ratio_crop[3][j] = 1;
+        above_ground_ratio_crop[4][j] = 1;
+        above_ground_ratio_crop[5][j] = 1;
         
         //Now, check if we don't have both. Assume that the ratio is 0.5. It won't be used in the actual processing.
         }else if(wavg_crop_array[i] == NODATA && wavg_bg_crop_array[i] == NODATA){
-        veg_carbon_crop_sage[0][i] = -9999;
-        veg_carbon_crop_sage[1][i] = -9999;
-        veg_carbon_crop_sage[2][i] = -9999;
-        veg_carbon_crop_sage[3][i] = -9999;
-        veg_carbon_crop_sage[4][i] = -9999;
-        veg_carbon_crop_sage[5][i] = -9999;
-
-        above_ground_ratio_crop[0][i] = 0.5;
-        above_ground_ratio_crop[1][i] = 0.5;
-        above_ground_ratio_crop[2][i] = 0.5;
-        above_ground_ratio_crop[3][i] = 0.5;
-        above_ground_ratio_crop[4][i] = 0.5;
-        above_ground_ratio_crop[5][i] = 0.5;
+        veg_carbon_crop_sage[0][j] = -9999;
+        veg_carbon_crop_sage[1][j] = -9999;
+        veg_carbon_crop_sage[2][j] = -9999;
+        veg_carbon_crop_sage[3][j] = -9999;
+        veg_carbon_crop_sage[4][j] = -9999;
+        veg_carbon_crop_sage[5][j] = -9999;
+
+        above_ground_ratio_crop[0][j] = 0.5;
+        above_ground_ratio_crop[1][j] = 0.5;
+        above_ground_ratio_crop[2][j] = 0.5;
+        above_ground_ratio_crop[3][j] = 0.5;
+        above_ground_ratio_crop[4][j] = 0.5;
+        above_ground_ratio_crop[5][j] = 0.5;
         
 
         //Now, if we have both data,
         }else{
-        veg_carbon_crop_sage[0][i] = (wavg_crop_array[i]+wavg_bg_crop_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_crop_sage[1][i] = (median_crop_array[i]+median_bg_crop_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_crop_sage[2][i] = (min_crop_array[i]+min_bg_crop_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_crop_sage[3][i] = (max_crop_array[i]+max_bg_crop_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_crop_sage[4][i] = (q1_crop_array[i]+q1_bg_crop_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_crop_sage[5][i] = (q3_crop_array[i]+q3_bg_crop_array[i])*VEG_CARBON_SCALER;
-
-        above_ground_ratio_crop[0][i] = wavg_crop_array[i]/((wavg_crop_array[i]+wavg_bg_crop_array[i]));
-        above_ground_ratio_crop[1][i] = median_crop_array[i]/((median_crop_array[i]+median_bg_crop_array[i]));
-        above_ground_ratio_crop[2][i] = min_crop_array[i]/((min_crop_array[i]+min_bg_crop_array[i]));
-        above_ground_ratio_crop[3][i] = max_crop_array[i]/((max_crop_array[i]+max_bg_crop_array[i]));
-        above_ground_ratio_crop[4][i] = q1_crop_array[i]/((q1_crop_array[i]+q1_bg_crop_array[i]));
-        above_ground_ratio_crop[5][i] = q3_crop_array[i]/((q3_crop_array[i]+q3_bg_crop_array[i]));
+        veg_carbon_crop_sage[0][j] = (wavg_crop_array[i]+wavg_bg_crop_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_crop_sage[1][j] = (median_crop_array[i]+median_bg_crop_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_crop_sage[2][j] = (min_crop_array[i]+min_bg_crop_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_crop_sage[3][j] = (max_crop_array[i]+max_bg_crop_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_crop_sage[4][j] = (q1_crop_array[i]+q1_bg_crop_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_crop_sage[5][j] = (q3_crop_array[i]+q3_bg_crop_array[i])*VEG_CARBON_SCALER;
+
+        above_ground_ratio_crop[0][j] = wavg_crop_array[i]/((wavg_crop_array[i]+wavg_bg_crop_array[i]));
+        above_ground_ratio_crop[1][j] = median_crop_array[i]/((median_crop_array[i]+median_bg_crop_array[i]));
+        above_ground_ratio_crop[2][j] = min_crop_array[i]/((min_crop_array[i]+min_bg_crop_array[i]));
+        above_ground_ratio_crop[3][j] = max_crop_array[i]/((max_crop_array[i]+max_bg_crop_array[i]));
+        above_ground_ratio_crop[4][j] = q1_crop_array[i]/((q1_crop_array[i]+q1_bg_crop_array[i]));
+        above_ground_ratio_crop[5][j] = q3_crop_array[i]/((q3_crop_array[i]+q3_bg_crop_array[i]));
         }
    
         
         //Below ground should be 1 - above ground.
-        below_ground_ratio_crop[0][i] = 1 - above_ground_ratio_crop[0][i];  
-        below_ground_ratio_crop[1][i] = 1 - above_ground_ratio_crop[1][i];
-        below_ground_ratio_crop[2][i] = 1 - above_ground_ratio_crop[2][i];
-        below_ground_ratio_crop[3][i] = 1 - above_ground_ratio_crop[3][i];
-        below_ground_ratio_crop[4][i] = 1 - above_ground_ratio_crop[4][i];
-        below_ground_ratio_crop[5][i] = 1 - above_ground_ratio_crop[5][i];
+        below_ground_ratio_crop[0][j] = 1 - above_ground_ratio_crop[0][j];  
+        below_ground_ratio_crop[1][j] = 1 - above_ground_ratio_crop[1][j];
+        below_ground_ratio_crop[2][j] = 1 - above_ground_ratio_crop[2][j];
+        below_ground_ratio_crop[3][j] = 1 - above_ground_ratio_crop[3][j];
+        below_ground_ratio_crop[4][j] = 1 - above_ground_ratio_crop[4][j];
+        below_ground_ratio_crop[5][j] = 1 - above_ground_ratio_crop[5][j];
 
 
         ///Repeat calculations for Pasture
         if(wavg_pasture_array[i] == NODATA && wavg_bg_pasture_array[i] != NODATA ){
-        veg_carbon_pasture_sage[0][i] = (wavg_bg_pasture_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_pasture_sage[1][i] = (median_bg_pasture_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_pasture_sage[2][i] = (min_bg_pasture_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_pasture_sage[3][i] = (max_bg_pasture_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_pasture_sage[4][i] = (q1_bg_pasture_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_pasture_sage[5][i] = (q3_bg_pasture_array[i])*VEG_CARBON_SCALER;
-
-        above_ground_ratio_pasture[0][i] = 0;
-        above_ground_ratio_pasture[1][i] = 0;
-        above_ground_ratio_pasture[2][i] = 0;
-        above_ground_ratio_pasture[3][i] = 0;
-        above_ground_ratio_pasture[4][i] = 0;
-        above_ground_ratio_pasture[5][i] = 0;
+        veg_carbon_pasture_sage[0][j] = (wavg_bg_pasture_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_pasture_sage[1][j] = (median_bg_pasture_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_pasture_sage[2][j] = (min_bg_pasture_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_pasture_sage[3][j] = (max_bg_pasture_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_pasture_sage[4][j] = (q1_bg_pasture_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_pasture_sage[5][j] = (q3_bg_pasture_array[i])*VEG_CARBON_SCALER;
+
+        above_ground_ratio_pasture[0][j] = 0;
+        above_ground_ratio_pasture[1][j] = 0;
+        above_ground_ratio_pasture[2][j] = 0;
+        above_ground_ratio_pasture[3][j] = 0;
+        above_ground_ratio_pasture[4][j] = 0;
+        above_ground_ratio_pasture[5][j] = 0;
        
 
         // Now, check if we have only above ground data
         }else if(wavg_bg_pasture_array[i] == NODATA && wavg_pasture_array[i] != NODATA){
-        veg_carbon_pasture_sage[0][i] = (wavg_pasture_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_pasture_sage[1][i] = (median_pasture_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_pasture_sage[2][i] = (min_pasture_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_pasture_sage[3][i] = (max_pasture_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_pasture_sage[4][i] = (q1_pasture_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_pasture_sage[5][i] = (q3_pasture_array[i])*VEG_CARBON_SCALER;
-
-        above_ground_ratio_pasture[0][i] = 1;
-        above_ground_ratio_pasture[1][i] = 1;
-        above_ground_ratio_pasture[2][i] = 1;
-        above_ground_ratio_pasture[3][i] = 1;
-        above_ground_ratio_pasture[4][i] = 1;
-        above_ground_ratio_pasture[5][i] = 1;
+        veg_carbon_pasture_sage[0][j] = (wavg_pasture_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_pasture_sage[1][j] = (median_pasture_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_pasture_sage[2][j] = (min_pasture_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_pasture_sage[3][j] = (max_pasture_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_pasture_sage[4][j] = (q1_pasture_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_pasture_sage[5][j] = (q3_pasture_array[i])*VEG_CARBON_SCALER;
+
+        above_ground_ratio_pasture[0][j] = 1;
+        above_ground_ratio_pasture[1][j] = 1;
+        above_ground_ratio_pasture[2][j] = 1;
+        above_ground_ratio_pasture[3][j] = 1;
+        above_ground_ratio_pasture[4][j] = 1;
+        above_ground_ratio_pasture[5][j] = 1;
         
         //Now, check if we don't have both. Assume that the ratio is 0.5. It won't be used in the actual processing.
         }else if(wavg_pasture_array[i] == NODATA && wavg_bg_pasture_array[i] == NODATA){
-        veg_carbon_pasture_sage[0][i] = -9999;
-        veg_carbon_pasture_sage[1][i] = -9999;
-        veg_carbon_pasture_sage[2][i] = -9999;
-        veg_carbon_pasture_sage[3][i] = -9999;
-        veg_carbon_pasture_sage[4][i] = -9999;
-        veg_carbon_pasture_sage[5][i] = -9999;
-
-        above_ground_ratio_pasture[0][i] = 0.5;
-        above_ground_ratio_pasture[1][i] = 0.5;
-        above_ground_ratio_pasture[2][i] = 0.5;
-        above_ground_ratio_pasture[3][i] = 0.5;
-        above_ground_ratio_pasture[4][i] = 0.5;
-        above_ground_ratio_pasture[5][i] = 0.5;
+        veg_carbon_pasture_sage[0][j] = -9999;
+        veg_carbon_pasture_sage[1][j] = -9999;
+        veg_carbon_pasture_sage[2][j] = -9999;
+        veg_carbon_pasture_sage[3][j] = -9999;
+        veg_carbon_pasture_sage[4][j] = -9999;
+        veg_carbon_pasture_sage[5][j] = -9999;
+
+        above_ground_ratio_pasture[0][j] = 0.5;
+        above_ground_ratio_pasture[1][j] = 0.5;
+        above_ground_ratio_pasture[2][j] = 0.5;
+        above_ground_ratio_pasture[3][j] = 0.5;
+        above_ground_ratio_pasture[4][j] = 0.5;
+        above_ground_ratio_pasture[5][j] = 0.5;
         
 
         //Now, if we have both data,
         }else{
-        veg_carbon_pasture_sage[0][i] = (wavg_pasture_array[i]+wavg_bg_pasture_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_pasture_sage[1][i] = (median_pasture_array[i]+median_bg_pasture_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_pasture_sage[2][i] = (min_pasture_array[i]+min_bg_pasture_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_pasture_sage[3][i] = (max_pasture_array[i]+max_bg_pasture_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_pasture_sage[4][i] = (q1_pasture_array[i]+q1_bg_pasture_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_pasture_sage[5][i] = (q3_pasture_array[i]+q3_bg_pasture_array[i])*VEG_CARBON_SCALER;
-
-        above_ground_ratio_pasture[0][i] = wavg_pasture_array[i]/((wavg_pasture_array[i]+wavg_bg_pasture_array[i]));
-        above_ground_ratio_pasture[1][i] = median_pasture_array[i]/((median_pasture_array[i]+median_bg_pasture_array[i]));
-        above_ground_ratio_pasture[2][i] = min_pasture_array[i]/((min_pasture_array[i]+min_bg_pasture_array[i]));
-        above_ground_ratio_pasture[3][i] = max_pasture_array[i]/((max_pasture_array[i]+max_bg_pasture_array[i]));
-        above_ground_ratio_pasture[4][i] = q1_pasture_array[i]/((q1_pasture_array[i]+q1_bg_pasture_array[i]));
-        above_ground_ratio_pasture[5][i] = q3_pasture_array[i]/((q3_pasture_array[i]+q3_bg_pasture_array[i]));
+        veg_carbon_pasture_sage[0][j] = (wavg_pasture_array[i]+wavg_bg_pasture_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_pasture_sage[1][j] = (median_pasture_array[i]+median_bg_pasture_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_pasture_sage[2][j] = (min_pasture_array[i]+min_bg_pasture_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_pasture_sage[3][j] = (max_pasture_array[i]+max_bg_pasture_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_pasture_sage[4][j] = (q1_pasture_array[i]+q1_bg_pasture_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_pasture_sage[5][j] = (q3_pasture_array[i]+q3_bg_pasture_array[i])*VEG_CARBON_SCALER;
+
+        above_ground_ratio_pasture[0][j] = wavg_pasture_array[i]/((wavg_pasture_array[i]+wavg_bg_pasture_array[i]));
+        above_ground_ratio_pasture[1][j] = median_pasture_array[i]/((median_pasture_array[i]+median_bg_pasture_array[i]));
+        above_ground_ratio_pasture[2][j] = min_pasture_array[i]/((min_pasture_array[i]+min_bg_pasture_array[i]));
+        above_ground_ratio_pasture[3][j] = max_pasture_array[i]/((max_pasture_array[i]+max_bg_pasture_array[i]));
+        above_ground_ratio_pasture[4][j] = q1_pasture_array[i]/((q1_pasture_array[i]+q1_bg_pasture_array[i]));
+        above_ground_ratio_pasture[5][j] = q3_pasture_array[i]/((q3_pasture_array[i]+q3_bg_pasture_array[i]));
         }
 
 
@@ -1660,78 +1662,78 @@ int read_veg_carbon(args_struct in_args, rinfo_struct *raster_info) {
         
         
         //Below ground should be 1 - above ground.
-        below_ground_ratio_pasture[0][i] = 1 - above_ground_ratio_pasture[0][i];  
-        below_ground_ratio_pasture[1][i] = 1 - above_ground_ratio_pasture[1][i];
-        below_ground_ratio_pasture[2][i] = 1 - above_ground_ratio_pasture[2][i];
-        below_ground_ratio_pasture[3][i] = 1 - above_ground_ratio_pasture[3][i];
-        below_ground_ratio_pasture[4][i] = 1 - above_ground_ratio_pasture[4][i];
-        below_ground_ratio_pasture[5][i] = 1 - above_ground_ratio_pasture[5][i];
+        below_ground_ratio_pasture[0][j] = 1 - above_ground_ratio_pasture[0][j];  
+        below_ground_ratio_pasture[1][j] = 1 - above_ground_ratio_pasture[1][j];
+        below_ground_ratio_pasture[2][j] = 1 - above_ground_ratio_pasture[2][j];
+        below_ground_ratio_pasture[3][j] = 1 - above_ground_ratio_pasture[3][j];
+        below_ground_ratio_pasture[4][j] = 1 - above_ground_ratio_pasture[4][j];
+        below_ground_ratio_pasture[5][j] = 1 - above_ground_ratio_pasture[5][j];
 
         ///Repeat calculations for Urban
         if(wavg_urban_array[i] == NODATA && wavg_bg_urban_array[i] != NODATA ){
-        veg_carbon_urban_sage[0][i] = (wavg_bg_urban_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_urban_sage[1][i] = (median_bg_urban_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_urban_sage[2][i] = (min_bg_urban_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_urban_sage[3][i] = (max_bg_urban_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_urban_sage[4][i] = (q1_bg_urban_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_urban_sage[5][i] = (q3_bg_urban_array[i])*VEG_CARBON_SCALER;
-
-        above_ground_ratio_urban[0][i] = 0;
-        above_ground_ratio_urban[1][i] = 0;
-        above_ground_ratio_urban[2][i] = 0;
-        above_ground_ratio_urban[3][i] = 0;
-        above_ground_ratio_urban[4][i] = 0;
-        above_ground_ratio_urban[5][i] = 0;
+        veg_carbon_urban_sage[0][j] = (wavg_bg_urban_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_urban_sage[1][j] = (median_bg_urban_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_urban_sage[2][j] = (min_bg_urban_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_urban_sage[3][j] = (max_bg_urban_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_urban_sage[4][j] = (q1_bg_urban_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_urban_sage[5][j] = (q3_bg_urban_array[i])*VEG_CARBON_SCALER;
+
+        above_ground_ratio_urban[0][j] = 0;
+        above_ground_ratio_urban[1][j] = 0;
+        above_ground_ratio_urban[2][j] = 0;
+        above_ground_ratio_urban[3][j] = 0;
+        above_ground_ratio_urban[4][j] = 0;
+        above_ground_ratio_urban[5][j] = 0;
        
 
         // Now, check if we have only above ground data
         }else if(wavg_bg_urban_array[i] == NODATA && wavg_urban_array[i] != NODATA){
-        veg_carbon_urban_sage[0][i] = (wavg_urban_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_urban_sage[1][i] = (median_urban_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_urban_sage[2][i] = (min_urban_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_urban_sage[3][i] = (max_urban_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_urban_sage[4][i] = (q1_urban_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_urban_sage[5][i] = (q3_urban_array[i])*VEG_CARBON_SCALER;
-
-        above_ground_ratio_urban[0][i] = 1;
-        above_ground_ratio_urban[1][i] = 1;
-        above_ground_ratio_urban[2][i] = 1;
-        above_ground_ratio_urban[3][i] = 1;
-        above_ground_ratio_urban[4][i] = 1;
-        above_ground_ratio_urban[5][i] = 1;
+        veg_carbon_urban_sage[0][j] = (wavg_urban_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_urban_sage[1][j] = (median_urban_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_urban_sage[2][j] = (min_urban_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_urban_sage[3][j] = (max_urban_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_urban_sage[4][j] = (q1_urban_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_urban_sage[5][j] = (q3_urban_array[i])*VEG_CARBON_SCALER;
+
+        above_ground_ratio_urban[0][j] = 1;
+        above_ground_ratio_urban[1][j] = 1;
+        above_ground_ratio_urban[2][j] = 1;
+        above_ground_ratio_urban[3][j] = 1;
+        above_ground_ratio_urban[4][j] = 1;
+        above_ground_ratio_urban[5][j] = 1;
         
         //Now, check if we don't have both. Assume that the ratio is 0.5. It won't be used in the actual processing.
         }else if(wavg_urban_array[i] == NODATA && wavg_bg_urban_array[i] == NODATA){
-        veg_carbon_urban_sage[0][i] = -9999;
-        veg_carbon_urban_sage[1][i] = -9999;
-        veg_carbon_urban_sage[2][i] = -9999;
-        veg_carbon_urban_sage[3][i] = -9999;
-        veg_carbon_urban_sage[4][i] = -9999;
-        veg_carbon_urban_sage[5][i] = -9999;
-
-        above_ground_ratio_urban[0][i] = 0.5;
-        above_ground_ratio_urban[1][i] = 0.5;
-        above_ground_ratio_urban[2][i] = 0.5;
-        above_ground_ratio_urban[3][i] = 0.5;
-        above_ground_ratio_urban[4][i] = 0.5;
-        above_ground_ratio_urban[5][i] = 0.5;
+        veg_carbon_urban_sage[0][j] = -9999;
+        veg_carbon_urban_sage[1][j] = -9999;
+        veg_carbon_urban_sage[2][j] = -9999;
+        veg_carbon_urban_sage[3][j] = -9999;
+        veg_carbon_urban_sage[4][j] = -9999;
+        veg_carbon_urban_sage[5][j] = -9999;
+
+        above_ground_ratio_urban[0][j] = 0.5;
+        above_ground_ratio_urban[1][j] = 0.5;
+        above_ground_ratio_urban[2][j] = 0.5;
+        above_ground_ratio_urban[3][j] = 0.5;
+        above_ground_ratio_urban[4][j] = 0.5;
+        above_ground_ratio_urban[5][j] = 0.5;
         
 
         //Now, if we have both data,
         }else{
-        veg_carbon_urban_sage[0][i] = (wavg_urban_array[i]+wavg_bg_urban_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_urban_sage[1][i] = (median_urban_array[i]+median_bg_urban_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_urban_sage[2][i] = (min_urban_array[i]+min_bg_urban_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_urban_sage[3][i] = (max_urban_array[i]+max_bg_urban_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_urban_sage[4][i] = (q1_urban_array[i]+q1_bg_urban_array[i])*VEG_CARBON_SCALER;
-        veg_carbon_urban_sage[5][i] = (q3_urban_array[i]+q3_bg_urban_array[i])*VEG_CARBON_SCALER;
-
-        above_ground_ratio_urban[0][i] = wavg_urban_array[i]/((wavg_urban_array[i]+wavg_bg_urban_array[i]));
-        above_ground_ratio_urban[1][i] = median_urban_array[i]/((median_urban_array[i]+median_bg_urban_array[i]));
-        above_ground_ratio_urban[2][i] = min_urban_array[i]/((min_urban_array[i]+min_bg_urban_array[i]));
-        above_ground_ratio_urban[3][i] = max_urban_array[i]/((max_urban_array[i]+max_bg_urban_array[i]));
-        above_ground_ratio_urban[4][i] = q1_urban_array[i]/((q1_urban_array[i]+q1_bg_urban_array[i]));
-        above_ground_ratio_urban[5][i] = q3_urban_array[i]/((q3_urban_array[i]+q3_bg_urban_array[i]));
+        veg_carbon_urban_sage[0][j] = (wavg_urban_array[i]+wavg_bg_urban_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_urban_sage[1][j] = (median_urban_array[i]+median_bg_urban_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_urban_sage[2][j] = (min_urban_array[i]+min_bg_urban_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_urban_sage[3][j] = (max_urban_array[i]+max_bg_urban_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_urban_sage[4][j] = (q1_urban_array[i]+q1_bg_urban_array[i])*VEG_CARBON_SCALER;
+        veg_carbon_urban_sage[5][j] = (q3_urban_array[i]+q3_bg_urban_array[i])*VEG_CARBON_SCALER;
+
+        above_ground_ratio_urban[0][j] = wavg_urban_array[i]/((wavg_urban_array[i]+wavg_bg_urban_array[i]));
+        above_ground_ratio_urban[1][j] = median_urban_array[i]/((median_urban_array[i]+median_bg_urban_array[i]));
+        above_ground_ratio_urban[2][j] = min_urban_array[i]/((min_urban_array[i]+min_bg_urban_array[i]));
+        above_ground_ratio_urban[3][j] = max_urban_array[i]/((max_urban_array[i]+max_bg_urban_array[i]));
+        above_ground_ratio_urban[4][j] = q1_urban_array[i]/((q1_urban_array[i]+q1_bg_urban_array[i]));
+        above_ground_ratio_urban[5][j] = q3_urban_array[i]/((q3_urban_array[i]+q3_bg_urban_array[i]));
         }
 
 
@@ -1739,12 +1741,12 @@ int read_veg_carbon(args_struct in_args, rinfo_struct *raster_info) {
         
         
         //Below ground should be 1 - above ground.
-        below_ground_ratio_urban[0][i] = 1 - above_ground_ratio_urban[0][i];  
-        below_ground_ratio_urban[1][i] = 1 - above_ground_ratio_urban[1][i];
-        below_ground_ratio_urban[2][i] = 1 - above_ground_ratio_urban[2][i];
-        below_ground_ratio_urban[3][i] = 1 - above_ground_ratio_urban[3][i];
-        below_ground_ratio_urban[4][i] = 1 - above_ground_ratio_urban[4][i];
-        below_ground_ratio_urban[5][i] = 1 - above_ground_ratio_urban[5][i]; 
+        below_ground_ratio_urban[0][j] = 1 - above_ground_ratio_urban[0][j];  
+        below_ground_ratio_urban[1][j] = 1 - above_ground_ratio_urban[1][j];
+        below_ground_ratio_urban[2][j] = 1 - above_ground_ratio_urban[2][j];
+        below_ground_ratio_urban[3][j] = 1 - above_ground_ratio_urban[3][j];
+        below_ground_ratio_urban[4][j] = 1 - above_ground_ratio_urban[4][j];
+        below_ground_ratio_urban[5][j] = 1 - above_ground_ratio_urban[5][j]; 
          
     }
 
@@ -1753,45 +1755,45 @@ int read_veg_carbon(args_struct in_args, rinfo_struct *raster_info) {
 	
    //Write diagnostics
     if (in_args.diagnostics) {
-        if ((err = write_raster_float(veg_carbon_sage[0], ncells, out_name1, in_args))) {
+        if ((err = write_raster_land_float(veg_carbon_sage[0], out_name1, in_args))) {
             fprintf(fplog, "Error writing file %s: read_protected()\n", out_name1);
             return ERROR_FILE;
         }
         
-        if ((err = write_raster_float(veg_carbon_sage[1], ncells, out_name2, in_args))) {
+        if ((err = write_raster_land_float(veg_carbon_sage[1], out_name2, in_args))) {
             fprintf(fplog, "Error writing file %s: read_protected()\n", out_name2);
             return ERROR_FILE;
         }
         
-        if ((err = write_raster_float(veg_carbon_sage[2], ncells, out_name3, in_args))) {
+        if ((err = write_raster_land_float(veg_carbon_sage[2], out_name3, in_args))) {
             fprintf(fplog, "Error writing file %s: read_protected()\n", out_name3);
             return ERROR_FILE;
         }
 
-        if ((err = write_raster_float(veg_carbon_sage[3], ncells, out_name4, in_args))) {
+        if ((err = write_raster_land_float(veg_carbon_sage[3], out_name4, in_args))) {
             fprintf(fplog, "Error writing file %s: read_protected()\n", out_name4);
             return ERROR_FILE;
         }
 
-        if ((err = write_raster_float(veg_carbon_sage[4], ncells, out_name5, in_args))) {
+        if ((err = write_raster_land_float(veg_carbon_sage[4], out_name5, in_args))) {
             fprintf(fplog, "Error writing file %s: read_protected()\n", out_name5);
             return ERROR_FILE;
         }
 
-        if ((err = write_raster_float(veg_carbon_sage[5], ncells, out_name6, in_args))) {
+        if ((err = write_raster_land_float(veg_carbon_sage[5], out_name6, in_args))) {
             fprintf(fplog, "Error writing file %s: read_protected()\n", out_name6);
             return ERROR_FILE;
         }
 
-        if ((err = write_raster_float(veg_carbon_crop_sage[5], ncells, out_name7, in_args))) {
+        if ((err = write_raster_land_float(veg_carbon_crop_sage[5], out_name7, in_args))) {
             fprintf(fplog, "Error writing file %s: read_protected()\n", out_name6);
             return ERROR_FILE;
         }
-        if ((err = write_raster_float(veg_carbon_urban_sage[5], ncells, out_name8, in_args))) {
+        if ((err = write_raster_land_float(veg_carbon_urban_sage[5], out_name8, in_args))) {
             fprintf(fplog, "Error writing file %s: read_protected()\n", out_name6);
             return ERROR_FILE;
         }
-        if ((err = write_raster_float(veg_carbon_pasture_sage[5], ncells, out_name9, in_args))) {
+        if ((err = write_raster_land_float(veg_carbon_pasture_sage[5], out_name9, in_args))) {
             fprintf(fplog, "Error writing file %s: read_protected()\n", out_name6);
             return ERROR_FILE;
         }
@@ -0,0 +1,277 @@
+/**********
+ run_report.c
+ 
+ contains the following functions for timing the processing stages of main() and writing a run report:
+	stage_begin() - starts a stage; stages can be nested, e.g., a group of stages within a processing block
+	stage_end() - ends the most recently started stage
+	write_run_report() - writes the stages to json and csv files next to the log file
+ 
+ each stage records:
+	the wall clock and cpu time (s); the cpu time includes all threads, so cpu / wall shows the parallel use
+	the resident memory (MB) at the start and end of the stage, and the peak resident memory of the run at the end
+		the change in resident memory is the memory the stage allocated and kept
+	the bytes read and written by the process during the stage
+ the memory and byte counts are from /proc/self on linux; they are -1 where this is not available
+ 
+ the stages must be started and ended by one thread only (main() calls these)
+ the report is written only if the program completes
+ 
+ Created 17 Oct 2026
+ 
+ Moirai Land Data System (Moirai) Copyright (c) 2019, The
+ Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S.
+ Dept. of Energy).  All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Intellectual Property Office at
+ IPO@lbl.gov.
+
+ NOTICE.  This Software was developed under funding from the U.S. Department
+ of Energy and the U.S. Government consequently retains certain rights.  As
+ such, the U.S. Government has been granted for itself and others acting on
+ its behalf a paid-up, nonexclusive, irrevocable, worldwide license in the
+ Software to reproduce, distribute copies to the public, prepare derivative
+ works, and perform publicly and display publicly, and to permit other to do
+ so.
+
+ This file is part of Moirai.
+
+ Moirai is free software: you can use it under the terms of the modified BSD-3 license (see …/moirai/license.txt)
+
+ **********/
+
+
+// clock_gettime and getrusage are posix
+#define _POSIX_C_SOURCE 200809L
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include "moirai.h"
+
+// one stage
+typedef struct {
+	char name[MAXSTAGENAME];	// stage name
+	int depth;					// nesting depth; 0 = top level
+	double wall_start;			// wall clock time at the start (s)
+	double wall;				// elapsed wall clock time (s)
+	double cpu_start;			// cpu time at the start (s)
+	double cpu;					// elapsed cpu time (s)
+	double rss_start;			// resident memory at the start (MB)
+	double rss_end;				// resident memory at the end (MB)
+	double peak_rss;			// peak resident memory of the run at the end (MB)
+	long long read_start;		// bytes read by the process at the start
+	long long read_bytes;		// bytes read during the stage
+	long long write_start;		// bytes written by the process at the start
+	long long write_bytes;		// bytes written during the stage
+} stage_struct;
+
+static stage_struct stages[MAX_STAGES];	// the stages in start order
+static int num_stages = 0;				// the number of stages started
+static int open_stages[MAX_STAGES];		// the indices of the stages in progress, innermost last
+static int num_open = 0;				// the number of stages in progress
+static int num_skipped = 0;				// the number of stages in progress that are past MAX_STAGES
+static double run_start = -1;			// wall clock time at the first stage (s)
+
+static double report_wall(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1.0e9;
+}
+
+static double report_cpu(void) {
+	return (double) clock() / CLOCKS_PER_SEC;
+}
+
+// current resident memory (MB); -1 if not available
+static double report_rss(void) {
+	FILE *fp;
+	long pages_total, pages_res;
+	double rss = -1;
+	if ((fp = fopen("/proc/self/statm", "r")) != NULL) {
+		if (fscanf(fp, "%ld %ld", &pages_total, &pages_res) == 2) {
+			rss = (double) pages_res * sysconf(_SC_PAGESIZE) / 1048576.0;
+		}
+		fclose(fp);
+	}
+	return rss;
+}
+
+// peak resident memory of the run (MB); ru_maxrss is in KB on linux
+static double report_peak_rss(void) {
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0) {
+		return -1;
+	}
+	return usage.ru_maxrss / 1024.0;
+}
+
+// bytes read and written by the process, including the netcdf and zlib reads; -1 if not available
+static void report_io(long long *read_bytes, long long *write_bytes) {
+	FILE *fp;
+	char key[64];
+	long long val;
+	*read_bytes = -1;
+	*write_bytes = -1;
+	if ((fp = fopen("/proc/self/io", "r")) != NULL) {
+		while (fscanf(fp, "%63s %lld", key, &val) == 2) {
+			if (strcmp(key, "rchar:") == 0) {
+				*read_bytes = val;
+			} else if (strcmp(key, "wchar:") == 0) {
+				*write_bytes = val;
+			}
+		}
+		fclose(fp);
+	}
+}
+
+// write a json string value, escaping the quotes and backslashes, e.g., in windows paths
+static void report_json_str(FILE *fp, const char *key, const char *str) {
+	fprintf(fp, "  \"%s\": \"", key);
+	for (; *str != '\0'; str++) {
+		if (*str == '"' || *str == '\\') {
+			fputc('\\', fp);
+		}
+		fputc(*str, fp);
+	}
+	fprintf(fp, "\",\n");
+}
+
+void stage_begin(const char *name) {
+	
+	stage_struct *stage;
+	
+	// stages past the limit are not recorded
+	if (num_stages == MAX_STAGES) {
+		num_skipped++;
+		return;
+	}
+	
+	stage = &stages[num_stages];
+	strncpy(stage->name, name, MAXSTAGENAME - 1);
+	stage->name[MAXSTAGENAME - 1] = '\0';
+	stage->depth = num_open;
+	stage->rss_start = report_rss();
+	report_io(&stage->read_start, &stage->write_start);
+	stage->cpu_start = report_cpu();
+	stage->wall_start = report_wall();
+	if (run_start < 0) {
+		run_start = stage->wall_start;
+	}
+	
+	open_stages[num_open++] = num_stages++;
+}
+
+void stage_end(void) {
+	
+	stage_struct *stage;
+	long long read_end, write_end;
+	
+	if (num_skipped > 0) {
+		num_skipped--;
+		return;
+	}
+	if (num_open == 0) {
+		return;
+	}
+	
+	stage = &stages[open_stages[--num_open]];
+	stage->wall = report_wall() - stage->wall_start;
+	stage->cpu = report_cpu() - stage->cpu_start;
+	stage->rss_end = report_rss();
+	stage->peak_rss = report_peak_rss();
+	report_io(&read_end, &write_end);
+	stage->read_bytes = (read_end < 0 || stage->read_start < 0) ? -1 : read_end - stage->read_start;
+	stage->write_bytes = (write_end < 0 || stage->write_start < 0) ? -1 : write_end - stage->write_start;
+}
+
+int write_run_report(args_struct in_args, const char *in_fname) {
+	
+	int i;
+	int len;
+	double total_wall;
+	double peak_rss;
+	char base[MAXCHAR];			// the log file name without the extension
+	char fname[MAXCHAR];		// the report file name
+	char *ext;
+	FILE *fpjson;
+	FILE *fpcsv;
+	stage_struct *stage;
+	
+	// end any stages still in progress
+	while (num_open > 0) {
+		stage_end();
+	}
+	total_wall = (run_start < 0) ? 0 : report_wall() - run_start;
+	peak_rss = report_peak_rss();
+	
+	// the reports are next to the log file, with the log file name as the base
+	strcpy(base, in_args.outpath);
+	strcat(base, in_args.lds_logname);
+	ext = strrchr(base, '.');
+	if (ext != NULL && strchr(ext, '/') == NULL) {
+		*ext = '\0';
+	}
+	
+	strcpy(fname, base);
+	strcat(fname, "_run_report.json");
+	if ((fpjson = fopen(fname, "w")) == NULL) {
+		fprintf(fplog, "Failed to open file %s for write: write_run_report()\n", fname);
+		return ERROR_FILE;
+	}
+	fprintf(fpjson, "{\n");
+	fprintf(fpjson, "  \"program\": \"%s\",\n", CODENAME);
+	report_json_str(fpjson, "input_file", in_fname);
+	report_json_str(fpjson, "aez_new_fname", in_args.aez_new_fname);
+	fprintf(fpjson, "  \"num_new_aez\": %i,\n", NUM_NEW_AEZ);
+	fprintf(fpjson, "  \"num_fao_ctry\": %i,\n", NUM_FAO_CTRY);
+	fprintf(fpjson, "  \"out_year_prod_ha_lr\": %i,\n", in_args.out_year_prod_ha_lr);
+	fprintf(fpjson, "  \"carbon_enabled\": %i,\n", in_args.carbon_enabled);
+	fprintf(fpjson, "  \"num_threads\": %i,\n", in_args.num_threads);
+	fprintf(fpjson, "  \"total_wall_s\": %.3f,\n", total_wall);
+	fprintf(fpjson, "  \"peak_rss_mb\": %.1f,\n", peak_rss);
+	fprintf(fpjson, "  \"stages\": [");
+	for (i = 0; i < num_stages; i++) {
+		stage = &stages[i];
+		fprintf(fpjson, "%s\n    {\"name\": \"%s\", \"depth\": %i, \"wall_s\": %.3f, \"cpu_s\": %.3f, "
+				"\"rss_start_mb\": %.1f, \"rss_end_mb\": %.1f, \"peak_rss_mb\": %.1f, \"read_bytes\": %lld, \"write_bytes\": %lld}",
+				(i == 0) ? "" : ",", stage->name, stage->depth, stage->wall, stage->cpu,
+				stage->rss_start, stage->rss_end, stage->peak_rss, stage->read_bytes, stage->write_bytes);
+	}
+	fprintf(fpjson, "\n  ]\n}\n");
+	if (fclose(fpjson) != 0) {
+		fprintf(fplog, "Error writing file %s: write_run_report()\n", fname);
+		return ERROR_FILE;
+	}
+	fprintf(fplog, "Wrote file %s: write_run_report(); stages written=%i\n", fname, num_stages);
+	
+	strcpy(fname, base);
+	strcat(fname, "_run_report.csv");
+	if ((fpcsv = fopen(fname, "w")) == NULL) {
+		fprintf(fplog, "Failed to open file %s for write: write_run_report()\n", fname);
+		return ERROR_FILE;
+	}
+	fprintf(fpcsv, "stage,depth,wall_s,cpu_s,rss_start_mb,rss_end_mb,peak_rss_mb,read_bytes,write_bytes");
+	for (i = 0; i < num_stages; i++) {
+		stage = &stages[i];
+		fprintf(fpcsv, "\n%s,%i,%.3f,%.3f,%.1f,%.1f,%.1f,%lld,%lld", stage->name, stage->depth, stage->wall, stage->cpu,
+				stage->rss_start, stage->rss_end, stage->peak_rss, stage->read_bytes, stage->write_bytes);
+	}
+	if (fclose(fpcsv) != 0) {
+		fprintf(fplog, "Error writing file %s: write_run_report()\n", fname);
+		return ERROR_FILE;
+	}
+	fprintf(fplog, "Wrote file %s: write_run_report(); stages written=%i\n", fname, num_stages);
+	
+	// also summarize the stages in the log, indented by depth
+	fprintf(fplog, "\nStage times (s) and peak memory (MB):\n");
+	for (i = 0; i < num_stages; i++) {
+		stage = &stages[i];
+		len = 2 * stage->depth;
+		fprintf(fplog, "%*s%-*s %10.3f %10.1f\n", len, "", 40 - len, stage->name, stage->wall, stage->peak_rss);
+	}
+	fprintf(fplog, "%-40s %10.3f %10.1f\n", "total", total_wall, peak_rss);
+	
+	return OK;
+}
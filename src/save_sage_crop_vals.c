@@ -0,0 +1,127 @@
+/**********
+ save_sage_crop_vals.c
+
+ store the harvested area and yield of the sage land cells of one crop that are used by the recalibration,
+    so that calc_harvarea_prod_out_crop_aez() reads each crop file only once
+ only the cells with a valid country X glu and positive area and yield are stored, in land cell order,
+    which are the only cells that contribute to the recalibrated outputs
+
+ store->spill selects the memory and disk trade-off:
+    0 = copy the values into memory; up to about 12 bytes per stored cell, for all crops
+    1 = write the values to a temporary file per crop in the output directory (the crop file base name + SAGE_SPILL_TAG)
+        the file is removed by load_sage_crop_vals()
+
+ the per-crop arrays of the store are allocated on the first call
+ different crops can be stored concurrently by different threads
+ the spill file is the number of values (int), followed by the cells (int), area (float), and yield (float) arrays
+
+ arguments:
+ args_struct in_args: the input file arguments
+ sage_crop_store_struct *store: the crop value store
+ int cropind: the sage crop index
+ int num_vals: the number of cells to store
+ int *cells: the index in land_cells_sage[] of each cell
+ float *area: the harvested area of each cell (km^2)
+ float *yield: the yield of each cell (t/km^2)
+
+ return value:
+	integer error code: OK = 0, otherwise a non-zero error code
+
+ Created 17 Oct 2026
+
+ Moirai Land Data System (Moirai) Copyright (c) 2019, The
+ Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S.
+ Dept. of Energy).  All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Intellectual Property Office at
+ IPO@lbl.gov.
+
+ NOTICE.  This Software was developed under funding from the U.S. Department
+ of Energy and the U.S. Government consequently retains certain rights.  As
+ such, the U.S. Government has been granted for itself and others acting on
+ its behalf a paid-up, nonexclusive, irrevocable, worldwide license in the
+ Software to reproduce, distribute copies to the public, prepare derivative
+ works, and perform publicly and display publicly, and to permit other to do
+ so.
+
+ This file is part of Moirai.
+
+ Moirai is free software: you can use it under the terms of the modified BSD-3 license (see …/moirai/license.txt)
+
+ **********/
+
+#include "moirai.h"
+
+int save_sage_crop_vals(args_struct in_args, sage_crop_store_struct *store, int cropind, int num_vals, int *cells, float *area, float *yield) {
+	
+	int err = OK;				// error code
+	char fname[MAXCHAR];		// the spill file name
+	FILE *fpout;
+	
+	// the crops can be stored concurrently, so only one thread allocates the per-crop arrays
+#pragma omp critical (sage_crop_store)
+	{
+		if (store->num_vals == NULL) {
+			store->num_vals = calloc(NUM_SAGE_CROP, sizeof(int));
+			store->cells = calloc(NUM_SAGE_CROP, sizeof(int*));
+			store->area = calloc(NUM_SAGE_CROP, sizeof(float*));
+			store->yield = calloc(NUM_SAGE_CROP, sizeof(float*));
+		}
+		if(store->num_vals == NULL || store->cells == NULL || store->area == NULL || store->yield == NULL) {
+			fprintf(fplog,"Failed to allocate memory for the crop store:  save_sage_crop_vals()\n");
+			err = ERROR_MEM;
+		}
+	}
+	if (err != OK) {
+		return err;
+	}
+	
+	store->num_vals[cropind] = num_vals;
+	
+	if (store->spill) {
+		strcpy(fname, in_args.outpath);
+		strcat(fname, &cropfilebase_sage[cropind][0]);
+		strcat(fname, SAGE_SPILL_TAG);
+		if((fpout = fopen(fname, "wb")) == NULL)
+		{
+			fprintf(fplog,"Failed to open file %s:  save_sage_crop_vals()\n", fname);
+			return ERROR_FILE;
+		}
+		if (fwrite(&num_vals, sizeof(int), 1, fpout) != 1 ||
+			fwrite(cells, sizeof(int), num_vals, fpout) != (size_t) num_vals ||
+			fwrite(area, sizeof(float), num_vals, fpout) != (size_t) num_vals ||
+			fwrite(yield, sizeof(float), num_vals, fpout) != (size_t) num_vals) {
+			fprintf(fplog,"Failed to write file %s:  save_sage_crop_vals()\n", fname);
+			fclose(fpout);
+			return ERROR_FILE;
+		}
+		if (fclose(fpout) != 0) {
+			fprintf(fplog,"Failed to close file %s:  save_sage_crop_vals()\n", fname);
+			return ERROR_FILE;
+		}
+		return OK;
+	}
+	
+	store->cells[cropind] = malloc((num_vals + 1) * sizeof(int));
+	if(store->cells[cropind] == NULL) {
+		fprintf(fplog,"Failed to allocate memory for cells[%i]:  save_sage_crop_vals()\n", cropind);
+		return ERROR_MEM;
+	}
+	store->area[cropind] = malloc((num_vals + 1) * sizeof(float));
+	if(store->area[cropind] == NULL) {
+		fprintf(fplog,"Failed to allocate memory for area[%i]:  save_sage_crop_vals()\n", cropind);
+		return ERROR_MEM;
+	}
+	store->yield[cropind] = malloc((num_vals + 1) * sizeof(float));
+	if(store->yield[cropind] == NULL) {
+		fprintf(fplog,"Failed to allocate memory for yield[%i]:  save_sage_crop_vals()\n", cropind);
+		return ERROR_MEM;
+	}
+	memcpy(store->cells[cropind], cells, num_vals * sizeof(int));
+	memcpy(store->area[cropind], area, num_vals * sizeof(float));
+	memcpy(store->yield[cropind], yield, num_vals * sizeof(float));
+	
+	return OK;
+}
@@ -25,6 +25,10 @@
  land use code: 0=unmanaged, 10=cropland, 20=pasture, 30=urbanland (crop, pasture, and urban are set in moirai.h)
  protected code: 0 to 7, see read_protected
  corresponds with the land type area and potveg carbon output csv files
+ also build the direct lookup tables for the land type category and sage pot veg code indices:
+ lt_cat_code2ind[category code] = index in lt_cats, sage_code2ind[sage code] = index in landtypecodes_sage
+ a category code is keyed by pot veg code and land use + protected code, and all codes up to
+    (max_sage_code + 1) * SCALE_POTVEG - 1 are in the table; codes that are not categories are NOMATCH
  
  write only as a diagnostic:
  MOIRAI_reglr_GLU.csv    // file name for diagnostic gcam reglr+gluid to lr region abbr mapping
@@ -92,6 +96,7 @@ int write_glu_mapping(args_struct in_args, rinfo_struct raster_info) {
    int reggcam_ind;    // gcam region index
    int aez_val;		// new aez value
    int cur_lt_cat_ind; // for creating the land type category array
+   int num_lt_codes;   // the size of the land type category code lookup table
    
    int temp_vals[NUM_NEW_AEZ];	// temp storage for the aezs and region indices
    
@@ -227,6 +232,43 @@ int write_glu_mapping(args_struct in_args, rinfo_struct raster_info) {
    
    fclose(fpout1);
    
+   // direct lookup of the sage pot veg index from the sage code; include the potveg range of lt_cats
+   max_sage_code = NUM_SAGE_PVLT;
+   for (i = 0; i < NUM_SAGE_PVLT; i++) {
+      if (landtypecodes_sage[i] > max_sage_code) {
+         max_sage_code = landtypecodes_sage[i];
+      }
+   }
+   sage_code2ind = calloc(max_sage_code + 1, sizeof(int));
+   if(sage_code2ind == NULL) {
+      fprintf(fplog,"Failed to allocate memory for sage_code2ind: write_glu_mapping()\n");
+      return ERROR_MEM;
+   }
+   for (i = 0; i <= max_sage_code; i++) {
+      sage_code2ind[i] = NOMATCH;
+   }
+   // use the first match, as the linear searches do
+   for (i = NUM_SAGE_PVLT - 1; i >= 0; i--) {
+      if (landtypecodes_sage[i] >= 0) {
+         sage_code2ind[landtypecodes_sage[i]] = i;
+      }
+   }
+   
+   // direct lookup of the land type category index from the category code
+   // a valid pot veg code (or 0 for unknown) times SCALE_POTVEG plus any lu + protected code is within the table
+   num_lt_codes = (max_sage_code + 1) * SCALE_POTVEG;
+   lt_cat_code2ind = calloc(num_lt_codes, sizeof(int));
+   if(lt_cat_code2ind == NULL) {
+      fprintf(fplog,"Failed to allocate memory for lt_cat_code2ind: write_glu_mapping()\n");
+      return ERROR_MEM;
+   }
+   for (i = 0; i < num_lt_codes; i++) {
+      lt_cat_code2ind[i] = NOMATCH;
+   }
+   for (i = num_lt_cats - 1; i >= 0; i--) {
+      lt_cat_code2ind[lt_cats[i]] = i;
+   }
+   
    // get the aezs associated with the countries
    // include all fao countries here
    for (land_cell_ind = 0; land_cell_ind < num_land_cells_aez_new; land_cell_ind++) {
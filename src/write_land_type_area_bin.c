@@ -0,0 +1,233 @@
+/**********
+ write_land_type_area_bin.c
+
+ write the land type area table to a columnar binary file, as an alternative to the csv output of proc_land_type_area()
+ the iso, glu, and land type labels are dictionary encoded and the years are an axis, so each value is stored once
+    without any text formatting
+ the values are the same as in the csv: ha, rounded to the nearest integer, with 0 where the csv has no record
+ the series (country x glu x land type) are in the csv record order, and only series with a positive value are written
+ bin/lta_bin2csv converts the file to the csv (see tools/lta_bin2csv.c)
+
+ layout (all integers are 32-bit signed and all values are 64-bit doubles, in the native byte order):
+    char magic[8]               LTA_BIN_MAGIC with its terminating null
+    int version                 LTA_BIN_VERSION
+    int byte_order              LTA_BIN_BYTE_ORDER, to check the byte order of the reader
+    int num_iso                 the number of countries in the iso dictionary (NUM_FAO_CTRY)
+    int iso_len                 the fixed length of each iso entry, including the null padding
+    int num_lt                  the number of land types
+    int num_years               the number of years
+    int num_regions             the number of country x glu regions
+    int num_series              the number of region x land type series
+    char iso[num_iso][iso_len]  the iso abbreviations, null padded
+    int lt_codes[num_lt]        the land type codes
+    int years[num_years]        the years
+    int region_iso[num_regions] the iso dictionary index of each region
+    int region_glu[num_regions] the glu code of each region
+    int series_region[num_series]   the region index of each series
+    int series_lt[num_series]       the land type dictionary index of each series
+    double values[num_series][num_years]    the land type area (ha); year varies fastest
+
+ arguments:
+ double ****area_out:   the land type area (km^2); [ctry_ind][aez_ind][lt_cat_ind][year_ind]
+ int hyde_years[]:      the years of area_out
+ args_struct in_args:   the input argument structure
+
+ return value:
+ integer error code: OK = 0, otherwise a non-zero error code
+
+ Created 17 Oct 2026
+
+ Moirai Land Data System (Moirai) Copyright (c) 2019, The
+ Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S.
+ Dept. of Energy).  All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Intellectual Property Office at
+ IPO@lbl.gov.
+
+ NOTICE.  This Software was developed under funding from the U.S. Department
+ of Energy and the U.S. Government consequently retains certain rights.  As
+ such, the U.S. Government has been granted for itself and others acting on
+ its behalf a paid-up, nonexclusive, irrevocable, worldwide license in the
+ Software to reproduce, distribute copies to the public, prepare derivative
+ works, and perform publicly and display publicly, and to permit other to do
+ so.
+
+ This file is part of Moirai.
+
+ Moirai is free software: you can use it under the terms of the modified BSD-3 license (see …/moirai/license.txt)
+
+ **********/
+
+#include "moirai.h"
+
+int write_land_type_area_bin(double ****area_out, int hyde_years[], args_struct in_args) {
+    
+    int i, j;
+    int ctry_ind;           // current country index in ctry_aez_list
+    int aez_ind;            // current aez index in ctry_aez_list[ctry_ind]
+    int cur_lt_cat_ind;     // current land type category index
+    int year_ind;           // current year index
+    int region_ind;         // current region index
+    int num_regions = 0;    // the number of country x glu regions
+    int num_series = 0;     // the number of series with a positive value
+    int iso_len = 1;        // the fixed length of the iso entries
+    int has_value;          // 1 if the current series has a positive value
+    int hdr[8];             // the header integers after the magic
+    int err = OK;
+    
+    int *region_iso;        // the iso index of each region
+    int *region_glu;        // the glu code of each region
+    int *series_region;     // the region index of each series
+    int *series_lt;         // the land type index of each series
+    char *iso_buf;          // one null padded iso entry
+    double *vals;           // the values of one series
+    double outval;          // the rounded value in ha
+    
+    char magic[8] = LTA_BIN_MAGIC;  // the file identifier
+    char fname[MAXCHAR];    // the file name to write
+    FILE *fpout;            // the file pointer
+    
+    // count the regions and get the iso entry length
+    for (ctry_ind = 0; ctry_ind < NUM_FAO_CTRY; ctry_ind++) {
+        num_regions = num_regions + ctry_aez_num[ctry_ind];
+        if ((int) strlen(countryabbrs_iso[ctry_ind]) + 1 > iso_len) {
+            iso_len = (int) strlen(countryabbrs_iso[ctry_ind]) + 1;
+        }
+    }
+    
+    // add 1 so that the allocations are not zero length
+    region_iso = calloc(num_regions + 1, sizeof(int));
+    if(region_iso == NULL) {
+        fprintf(fplog,"Failed to allocate memory for region_iso: write_land_type_area_bin()\n");
+        return ERROR_MEM;
+    }
+    region_glu = calloc(num_regions + 1, sizeof(int));
+    if(region_glu == NULL) {
+        fprintf(fplog,"Failed to allocate memory for region_glu: write_land_type_area_bin()\n");
+        return ERROR_MEM;
+    }
+    series_region = calloc(num_regions * num_lt_cats + 1, sizeof(int));
+    if(series_region == NULL) {
+        fprintf(fplog,"Failed to allocate memory for series_region: write_land_type_area_bin()\n");
+        return ERROR_MEM;
+    }
+    series_lt = calloc(num_regions * num_lt_cats + 1, sizeof(int));
+    if(series_lt == NULL) {
+        fprintf(fplog,"Failed to allocate memory for series_lt: write_land_type_area_bin()\n");
+        return ERROR_MEM;
+    }
+    iso_buf = calloc(iso_len, sizeof(char));
+    if(iso_buf == NULL) {
+        fprintf(fplog,"Failed to allocate memory for iso_buf: write_land_type_area_bin()\n");
+        return ERROR_MEM;
+    }
+    vals = calloc(NUM_HYDE_YEARS, sizeof(double));
+    if(vals == NULL) {
+        fprintf(fplog,"Failed to allocate memory for vals: write_land_type_area_bin()\n");
+        return ERROR_MEM;
+    }
+    
+    // the regions and the series that have a positive value, in the csv record order
+    region_ind = 0;
+    for (ctry_ind = 0; ctry_ind < NUM_FAO_CTRY; ctry_ind++) {
+        for (aez_ind = 0; aez_ind < ctry_aez_num[ctry_ind]; aez_ind++) {
+            region_iso[region_ind] = ctry_ind;
+            region_glu[region_ind] = ctry_aez_list[ctry_ind][aez_ind];
+            for (cur_lt_cat_ind = 0; cur_lt_cat_ind < num_lt_cats; cur_lt_cat_ind++) {
+                has_value = 0;
+                for (year_ind = 0; year_ind < NUM_HYDE_YEARS; year_ind++) {
+                    outval = floor(0.5 + area_out[ctry_ind][aez_ind][cur_lt_cat_ind][year_ind] * KMSQ2HA);
+                    if (outval > 0) {
+                        has_value = 1;
+                        break;
+                    }
+                }
+                if (has_value) {
+                    series_region[num_series] = region_ind;
+                    series_lt[num_series] = cur_lt_cat_ind;
+                    num_series++;
+                }
+            } // end for land type loop
+            region_ind++;
+        } // end for aez loop
+    } // end for country loop
+    
+    strcpy(fname, in_args.outpath);
+    strcat(fname, in_args.land_type_area_bin_fname);
+    if((fpout = fopen(fname, "wb")) == NULL)
+    {
+        fprintf(fplog,"Failed to open file %s for write: write_land_type_area_bin()\n", fname);
+        return ERROR_FILE;
+    }
+    
+    // header
+    hdr[0] = LTA_BIN_VERSION;
+    hdr[1] = LTA_BIN_BYTE_ORDER;
+    hdr[2] = NUM_FAO_CTRY;
+    hdr[3] = iso_len;
+    hdr[4] = num_lt_cats;
+    hdr[5] = NUM_HYDE_YEARS;
+    hdr[6] = num_regions;
+    hdr[7] = num_series;
+    fwrite(magic, sizeof(char), 8, fpout);
+    fwrite(hdr, sizeof(int), 8, fpout);
+    
+    // dictionaries and axes
+    for (i = 0; i < NUM_FAO_CTRY; i++) {
+        memset(iso_buf, '\0', iso_len);
+        for (j = 0; j < iso_len && countryabbrs_iso[i][j] != '\0'; j++) {
+            iso_buf[j] = countryabbrs_iso[i][j];
+        }
+        fwrite(iso_buf, sizeof(char), iso_len, fpout);
+    }
+    fwrite(lt_cats, sizeof(int), num_lt_cats, fpout);
+    fwrite(hyde_years, sizeof(int), NUM_HYDE_YEARS, fpout);
+    
+    // region and series columns
+    fwrite(region_iso, sizeof(int), num_regions, fpout);
+    fwrite(region_glu, sizeof(int), num_regions, fpout);
+    fwrite(series_region, sizeof(int), num_series, fpout);
+    fwrite(series_lt, sizeof(int), num_series, fpout);
+    
+    // values (convert to ha and round to nearest integer, as for the csv)
+    region_ind = 0;
+    i = 0;
+    for (ctry_ind = 0; ctry_ind < NUM_FAO_CTRY && i < num_series; ctry_ind++) {
+        for (aez_ind = 0; aez_ind < ctry_aez_num[ctry_ind]; aez_ind++) {
+            while (i < num_series && series_region[i] == region_ind) {
+                cur_lt_cat_ind = series_lt[i];
+                for (year_ind = 0; year_ind < NUM_HYDE_YEARS; year_ind++) {
+                    outval = floor(0.5 + area_out[ctry_ind][aez_ind][cur_lt_cat_ind][year_ind] * KMSQ2HA);
+                    vals[year_ind] = (outval > 0) ? outval : 0;
+                }
+                fwrite(vals, sizeof(double), NUM_HYDE_YEARS, fpout);
+                i++;
+            }
+            region_ind++;
+        } // end for aez loop
+    } // end for country loop
+    
+    if (ferror(fpout)) {
+        err = ERROR_FILE;
+    }
+    if (fclose(fpout) != 0) {
+        err = ERROR_FILE;
+    }
+    if (err != OK) {
+        fprintf(fplog, "Error writing file %s: write_land_type_area_bin()\n", fname);
+        return err;
+    }
+    
+    fprintf(fplog, "Wrote file %s: write_land_type_area_bin(); series written=%i\n", fname, num_series);
+    
+    free(region_iso);
+    free(region_glu);
+    free(series_region);
+    free(series_lt);
+    free(iso_buf);
+    free(vals);
+    
+    return OK;
+}
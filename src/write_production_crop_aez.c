@@ -62,6 +62,8 @@ int write_production_crop_aez(args_struct in_args) {
 	
 	char fname[MAXCHAR];			// file name to open
 	FILE *fpout;					// file pointer
+	csv_out_struct csv_out;			// buffered record output
+	int err = OK;
 	int ctry_index = 0;				// the index of the country to write
     int aez_index = 0;				// the index of the aez to write
 	int crop_index = 0;				// the index of the crop to write
@@ -85,6 +87,10 @@ int write_production_crop_aez(args_struct in_args) {
 	fprintf(fpout,"# Original source: many, including HYDE and SAGE\n");
 	fprintf(fpout,"# ----------\n");
 	fprintf(fpout,"ctry_iso,glu_code,SAGE_crop,value");
+	if ((err = csv_out_open(&csv_out, fpout))) {
+		fclose(fpout);
+		return err;
+	}
 	
 	// write the records (round the values first)
 	for (ctry_index = 0; ctry_index < NUM_FAO_CTRY; ctry_index++) {
@@ -106,8 +112,10 @@ int write_production_crop_aez(args_struct in_args) {
                                     cropcodes_sage[crop_index]);
 							}
 						} else {
-							fprintf(fpout,"\n%s,%i,%s,%.0f", countryabbrs_iso[ctry_index], ctry_aez_list[ctry_index][aez_index],
-									cropnames_gtap[crop_index], outval);
+							csv_out_rec(&csv_out, countryabbrs_iso[ctry_index]);
+							csv_out_int(&csv_out, ctry_aez_list[ctry_index][aez_index]);
+							csv_out_str(&csv_out, cropnames_gtap[crop_index]);
+							csv_out_fixed(&csv_out, outval, 0, 0);
 							nrecords++;
 						}
 						
@@ -121,7 +129,10 @@ int write_production_crop_aez(args_struct in_args) {
         } // end else write output
     } // end for ctry_index loop over number of records in output array
 
-	fclose(fpout);
+	if ((err = csv_out_close(&csv_out))) {
+		fprintf(fplog, "Error writing file %s: write_production_crop_aez()\n", fname);
+		return err;
+	}
     
 	fprintf(fplog, "Wrote file %s: write_production_crop_aez(); records written=%i != countries skipped=%i\n",
 			fname, nrecords, count_skip);
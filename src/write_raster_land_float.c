@@ -0,0 +1,68 @@
+/**********
+ write_raster_land_float.c
+ 
+ write a float raster image from values stored only for the hyde land cells
+ the land values are indexed by land cell ordinal, i.e. land_vals[j] is the value of cell land_cells_hyde[j]
+ the values are expanded to a full working grid raster, with NODATA in the non-land cells,
+    and written with write_raster_float(), so the output matches a full-grid diagnostic raster
+ the expansion buffer is allocated and freed here, so only diagnostic output pays for the full grid
+ 
+ arguments:
+ float land_vals[]:		land cell values to write, num_land_cells_hyde long
+ char *out_name:		name of output file
+ args_struct in_args:	the input argument structure
+
+ return value:
+ integer error code: OK = 0, otherwise a non-zero error code
+ 
+ Created 17 Oct 2026
+ 
+ Moirai Land Data System (Moirai) Copyright (c) 2019, The
+ Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S.
+ Dept. of Energy).  All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Intellectual Property Office at
+ IPO@lbl.gov.
+
+ NOTICE.  This Software was developed under funding from the U.S. Department
+ of Energy and the U.S. Government consequently retains certain rights.  As
+ such, the U.S. Government has been granted for itself and others acting on
+ its behalf a paid-up, nonexclusive, irrevocable, worldwide license in the
+ Software to reproduce, distribute copies to the public, prepare derivative
+ works, and perform publicly and display publicly, and to permit other to do
+ so.
+
+ This file is part of Moirai.
+
+ Moirai is free software: you can use it under the terms of the modified BSD-3 license (see …/moirai/license.txt)
+
+ **********/
+
+#include "moirai.h"
+
+int write_raster_land_float(float land_vals[], char *out_name, args_struct in_args) {
+
+	int i;
+	int err = OK;					// store error code from the write file
+	float *out_array;				// the expanded working grid raster
+
+	out_array = calloc(NUM_CELLS, sizeof(float));
+	if(out_array == NULL) {
+		fprintf(fplog,"Failed to allocate memory for out_array: write_raster_land_float()\n");
+		return ERROR_MEM;
+	}
+	
+	for (i = 0; i < NUM_CELLS; i++) {
+		out_array[i] = NODATA;
+	}
+	for (i = 0; i < num_land_cells_hyde; i++) {
+		out_array[land_cells_hyde[i]] = land_vals[i];
+	}
+	
+	err = write_raster_float(out_array, NUM_CELLS, out_name, in_args);
+	
+	free(out_array);
+	
+	return err;}
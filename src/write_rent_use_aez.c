@@ -57,6 +57,8 @@ int write_rent_use_aez(args_struct in_args) {
 	
 	char fname[MAXCHAR];			// file name to open
 	FILE *fpout;					// file pointer
+	csv_out_struct csv_out;			// buffered record output
+	int err = OK;
 	int reglr_index = 0;			// the index of the land rent region to write
     int aez_index = 0;				// the index of the aez to write
 	int use_index = 0;				// the index of the use to write
@@ -78,6 +80,10 @@ int write_rent_use_aez(args_struct in_args) {
 	fprintf(fpout,"# Original source: many, including HYDE and SAGE\n");
 	fprintf(fpout,"# ----------\n");
 	fprintf(fpout,"reglr_iso,glu_code,use_sector,value");
+	if ((err = csv_out_open(&csv_out, fpout))) {
+		fclose(fpout);
+		return err;
+	}
 	
 	// write the records (these are not rounded, but are output to 9 decimals)
 	for (reglr_index = 0; reglr_index < NUM_GTAP_CTRY87 ; reglr_index++) {
@@ -85,15 +91,20 @@ int write_rent_use_aez(args_struct in_args) {
             for (use_index = 0; use_index < NUM_GTAP_USE; use_index++) {
                 // output only positive values
                 if (rent_use_aez[reglr_index][aez_index][use_index] > 0) {
-                    fprintf(fpout,"\n%s,%i,%s,%11.9f", country87abbrs_gtap[reglr_index], reglr_aez_list[reglr_index][aez_index],
-                            usenames_gtap[use_index], rent_use_aez[reglr_index][aez_index][use_index]);
+                    csv_out_rec(&csv_out, country87abbrs_gtap[reglr_index]);
+                    csv_out_int(&csv_out, reglr_aez_list[reglr_index][aez_index]);
+                    csv_out_str(&csv_out, usenames_gtap[use_index]);
+                    csv_out_fixed(&csv_out, rent_use_aez[reglr_index][aez_index][use_index], 11, 9);
                     nrecords++;
                 } // end if value is positive
             } // end for use loop
 		} // end for aez loop
 	} // end for land rent region loop
 	
-	fclose(fpout);
+	if ((err = csv_out_close(&csv_out))) {
+		fprintf(fplog, "Error writing file %s: write_rent_use_aez()\n", fname);
+		return err;
+	}
 	
 	fprintf(fplog, "Wrote file %s: write_rent_use_aez(); records written=%i\n", fname, nrecords);
 	
@@ -0,0 +1,186 @@
+/**********
+ lta_bin2csv.c
+
+ convert the binary land type area file from write_land_type_area_bin() to the land type area csv of proc_land_type_area()
+ the csv is the same as the one moirai writes, byte for byte, when the csv file name is given as moirai would write it
+    (outpath followed by land_type_area_fname), because the name is in the first header line
+
+ build and run from the project directory:
+    make lta_bin2csv
+    bin/lta_bin2csv <binary file> <csv file>
+
+ return value:
+	0 if the file is converted, otherwise 1
+
+ Created 17 Oct 2026
+
+ Moirai Land Data System (Moirai) Copyright (c) 2019, The
+ Regents of the University of California, through Lawrence Berkeley National
+ Laboratory (subject to receipt of any required approvals from the U.S.
+ Dept. of Energy).  All rights reserved.
+
+ If you have questions about your rights to use or distribute this software,
+ please contact Berkeley Lab's Intellectual Property Office at
+ IPO@lbl.gov.
+
+ NOTICE.  This Software was developed under funding from the U.S. Department
+ of Energy and the U.S. Government consequently retains certain rights.  As
+ such, the U.S. Government has been granted for itself and others acting on
+ its behalf a paid-up, nonexclusive, irrevocable, worldwide license in the
+ Software to reproduce, distribute copies to the public, prepare derivative
+ works, and perform publicly and display publicly, and to permit other to do
+ so.
+
+ This file is part of Moirai.
+
+ Moirai is free software: you can use it under the terms of the modified BSD-3 license (see …/moirai/license.txt)
+
+ **********/
+
+#include "moirai.h"
+
+// read count elements, and report a short file
+static int lta_read(void *buf, size_t size, size_t count, FILE *fpin, const char *what) {
+	if (fread(buf, size, count, fpin) != count) {
+		fprintf(stderr, "Failed to read %s: lta_bin2csv\n", what);
+		return ERROR_FILE;
+	}
+	return OK;
+}
+
+int main(int argc, const char * argv[]) {
+	
+	int i, year_ind;
+	int num_iso, iso_len, num_lt, num_years, num_regions, num_series;
+	int region_ind;			// the region of the current series
+	int nrecords = 0;		// count # of records written
+	int hdr[8];				// the header integers after the magic
+	char magic[8];			// the file identifier
+	
+	char *iso;				// the iso dictionary; [num_iso][iso_len]
+	int *lt_codes;			// the land type dictionary
+	int *years;				// the year axis
+	int *region_iso;		// the iso index of each region
+	int *region_glu;		// the glu code of each region
+	int *series_region;		// the region index of each series
+	int *series_lt;			// the land type index of each series
+	double *vals;			// the values of one series
+	
+	FILE *fpin;
+	FILE *fpout;
+	csv_out_struct csv_out;	// buffered record output
+	
+	fplog = stderr;
+	
+	if (argc != 3) {
+		fprintf(stderr, "Usage: lta_bin2csv <binary file> <csv file>\n");
+		return 1;
+	}
+	
+	if((fpin = fopen(argv[1], "rb")) == NULL) {
+		fprintf(stderr, "Failed to open file %s: lta_bin2csv\n", argv[1]);
+		return 1;
+	}
+	
+	// header
+	if (lta_read(magic, sizeof(char), 8, fpin, "magic") || lta_read(hdr, sizeof(int), 8, fpin, "header")) {
+		return 1;
+	}
+	if (strncmp(magic, LTA_BIN_MAGIC, 8) != 0) {
+		fprintf(stderr, "File %s is not a moirai land type area file: lta_bin2csv\n", argv[1]);
+		return 1;
+	}
+	if (hdr[0] != LTA_BIN_VERSION) {
+		fprintf(stderr, "File %s has version %i, but version %i is supported: lta_bin2csv\n", argv[1], hdr[0], LTA_BIN_VERSION);
+		return 1;
+	}
+	if (hdr[1] != LTA_BIN_BYTE_ORDER) {
+		fprintf(stderr, "File %s was written with a different byte order: lta_bin2csv\n", argv[1]);
+		return 1;
+	}
+	num_iso = hdr[2];
+	iso_len = hdr[3];
+	num_lt = hdr[4];
+	num_years = hdr[5];
+	num_regions = hdr[6];
+	num_series = hdr[7];
+	
+	// add 1 so that the allocations are not zero length
+	iso = calloc((size_t) num_iso * iso_len + 1, sizeof(char));
+	lt_codes = calloc(num_lt + 1, sizeof(int));
+	years = calloc(num_years + 1, sizeof(int));
+	region_iso = calloc(num_regions + 1, sizeof(int));
+	region_glu = calloc(num_regions + 1, sizeof(int));
+	series_region = calloc(num_series + 1, sizeof(int));
+	series_lt = calloc(num_series + 1, sizeof(int));
+	vals = calloc(num_years + 1, sizeof(double));
+	if (iso == NULL || lt_codes == NULL || years == NULL || region_iso == NULL || region_glu == NULL ||
+		series_region == NULL || series_lt == NULL || vals == NULL) {
+		fprintf(stderr, "Failed to allocate memory: lta_bin2csv\n");
+		return 1;
+	}
+	
+	// dictionaries, axes, and columns
+	if (lta_read(iso, sizeof(char), (size_t) num_iso * iso_len, fpin, "iso dictionary") ||
+		lta_read(lt_codes, sizeof(int), num_lt, fpin, "land type dictionary") ||
+		lta_read(years, sizeof(int), num_years, fpin, "years") ||
+		lta_read(region_iso, sizeof(int), num_regions, fpin, "region iso") ||
+		lta_read(region_glu, sizeof(int), num_regions, fpin, "region glu") ||
+		lta_read(series_region, sizeof(int), num_series, fpin, "series region") ||
+		lta_read(series_lt, sizeof(int), num_series, fpin, "series land type")) {
+		return 1;
+	}
+	
+	if((fpout = fopen(argv[2], "w")) == NULL) {
+		fprintf(stderr, "Failed to open file %s for write: lta_bin2csv\n", argv[2]);
+		return 1;
+	}
+	
+	// write header lines, as in proc_land_type_area()
+	fprintf(fpout,"# File: %s\n", argv[2]);
+	fprintf(fpout,"# Author: %s\n", CODENAME);
+	fprintf(fpout,"# Description: area (ha) for land cells in country X glu X land type X protected category X year\n");
+	fprintf(fpout,"# Original source: hyde land use areas; reference veg; land cover; country raster; glu raster; hyde land area\n");
+	fprintf(fpout,"# ----------\n");
+	fprintf(fpout,"iso,glu_code,land_type,year,value");
+	if (csv_out_open(&csv_out, fpout)) {
+		return 1;
+	}
+	
+	// write the records; only positive values
+	for (i = 0; i < num_series; i++) {
+		if (lta_read(vals, sizeof(double), num_years, fpin, "values")) {
+			return 1;
+		}
+		region_ind = series_region[i];
+		for (year_ind = 0; year_ind < num_years; year_ind++) {
+			if (vals[year_ind] > 0) {
+				csv_out_rec(&csv_out, &iso[(size_t) region_iso[region_ind] * iso_len]);
+				csv_out_int(&csv_out, region_glu[region_ind]);
+				csv_out_int(&csv_out, lt_codes[series_lt[i]]);
+				csv_out_int(&csv_out, years[year_ind]);
+				csv_out_fixed(&csv_out, vals[year_ind], 0, 0);
+				nrecords++;
+			}
+		}
+	}
+	
+	fclose(fpin);
+	if (csv_out_close(&csv_out)) {
+		fprintf(stderr, "Error writing file %s: lta_bin2csv\n", argv[2]);
+		return 1;
+	}
+	
+	fprintf(stdout, "Wrote file %s: lta_bin2csv; records written=%i\n", argv[2], nrecords);
+	
+	free(iso);
+	free(lt_codes);
+	free(years);
+	free(region_iso);
+	free(region_glu);
+	free(series_region);
+	free(series_lt);
+	free(vals);
+	
+	return 0;
+}